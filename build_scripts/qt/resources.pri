@@ -1,16 +1,15 @@
 project_dir = $$PWD/../../
 
-win32:LIBS += -L"$$project_dir/third-party/openvr/lib/win64" -luser32 -lole32
+win32:LIBS += -L"$$project_dir/third-party/openvr/lib/win64" -luser32 -lole32 -lpsapi
 unix:LIBS += -L"$$project_dir/third-party/openvr/lib/linux64"
 LIBS += -lopenvr_api
+# shm_open for the shared state segment.
+unix:LIBS += -lrt
 
 RESOURCES += src/res/resources.qrc
 
 DISTFILES += \
     src/res/sounds/alarm01.wav \
-    src/res/img/audio/microphone/ptt_notification.png \
-    src/res/img/audio/microphone/ptt_notification.svg \
-    src/res/img/battery/* \
     src/res/img/icons/* \
     src/res/qml/qmldir \
     src/res/qml/audio_page/* \
@@ -11,6 +11,24 @@ SOURCES += src/main.cpp\
     src/tabcontrollers/UtilitiesTabController.cpp \
     src/tabcontrollers/PttController.cpp \
     src/utils/ChaperoneUtils.cpp \
+    src/utils/EventBus.cpp \
+    src/utils/EventLoad.cpp \
+    src/utils/UniverseTransform.cpp \
+    src/utils/FloorDriftMonitor.cpp \
+    src/utils/RasterCanvas.cpp \
+    src/utils/NotificationCompositor.cpp \
+    src/utils/ProcessMonitor.cpp \
+    src/utils/ProcessScheduler.cpp \
+    src/utils/GestureRecognizer.cpp \
+    src/utils/StatisticsLog.cpp \
+    src/utils/Odometer.cpp \
+    src/utils/ChaperoneLocator.cpp \
+    src/utils/PolylineSimplifier.cpp \
+    src/utils/PolygonUnion.cpp \
+    src/utils/SharedState.cpp \
+    src/utils/StreamingQuantile.cpp \
+    src/utils/Debounce.cpp \
+    src/utils/ProximityMute.cpp \
     src/tabcontrollers/audiomanager/AudioManagerDummy.cpp \
     src/tabcontrollers/keyboardinput/KeyboardInputDummy.cpp \
     src/overlaycontroller/openvr_init.cpp \
@@ -31,6 +49,25 @@ HEADERS += src/overlaycontroller.h \
     src/tabcontrollers/KeyboardInput.h \
     src/utils/Matrix.h \
     src/utils/ChaperoneUtils.h \
+    src/utils/EventBus.h \
+    src/utils/EventLoad.h \
+    src/utils/UniverseTransform.h \
+    src/utils/FloorDriftMonitor.h \
+    src/utils/RasterCanvas.h \
+    src/utils/NotificationCompositor.h \
+    src/utils/ProcessMonitor.h \
+    src/utils/ProcessScheduler.h \
+    src/utils/GestureRecognizer.h \
+    src/utils/StatisticsLog.h \
+    src/utils/Odometer.h \
+    src/utils/ProfileSchema.h \
+    src/utils/ChaperoneLocator.h \
+    src/utils/PolylineSimplifier.h \
+    src/utils/PolygonUnion.h \
+    src/utils/SharedState.h \
+    src/utils/StreamingQuantile.h \
+    src/utils/Debounce.h \
+    src/utils/ProximityMute.h \
     src/tabcontrollers/audiomanager/AudioManagerDummy.h \
     src/tabcontrollers/keyboardinput/KeyboardInputDummy.h \
     src/overlaycontroller/openvr_init.h \
@@ -0,0 +1,160 @@
+#include "Test.h"
+#include "utils/ChaperoneLocator.h"
+#include <cmath>
+#include <random>
+
+namespace
+{
+constexpr vr::HmdMatrix34_t k_identity
+    = { { { 1, 0, 0, 0 }, { 0, 1, 0, 0 }, { 0, 0, 1, 0 } } };
+
+// Walls of an axis aligned rectangle on the floor, 2.5 m high.
+std::vector<vr::HmdQuad_t>
+    rectangle( float minX, float minZ, float maxX, float maxZ )
+{
+    const float corners[4][2]
+        = { { minX, minZ }, { maxX, minZ }, { maxX, maxZ }, { minX, maxZ } };
+    std::vector<vr::HmdQuad_t> quads( 4 );
+    for ( size_t i = 0; i < 4; i++ )
+    {
+        const auto& a = corners[i];
+        const auto& b = corners[( i + 1 ) % 4];
+        quads[i].vCorners[0] = { { a[0], 0.0f, a[1] } };
+        quads[i].vCorners[1] = { { a[0], 2.5f, a[1] } };
+        quads[i].vCorners[2] = { { b[0], 2.5f, b[1] } };
+        quads[i].vCorners[3] = { { b[0], 0.0f, b[1] } };
+    }
+    return quads;
+}
+
+void add( utils::ChaperoneLocator& locator,
+          int id,
+          const std::vector<vr::HmdQuad_t>& quads,
+          const std::string& signature = "",
+          const vr::HmdMatrix34_t& standingToRaw = k_identity )
+{
+    locator.add( id,
+                 signature,
+                 quads.data(),
+                 static_cast<uint32_t>( quads.size() ),
+                 standingToRaw );
+}
+
+} // namespace
+
+TEST_CASE( ChaperoneLocatorFindsSmallestSpace )
+{
+    utils::ChaperoneLocator locator;
+    // A room, a corner of it, and a room next door.
+    add( locator, 0, rectangle( 0.0f, 0.0f, 5.0f, 4.0f ) );
+    add( locator, 1, rectangle( 3.0f, 2.0f, 5.0f, 4.0f ) );
+    add( locator, 2, rectangle( 5.5f, 0.0f, 9.0f, 4.0f ) );
+    CHECK( locator.size() == 3 );
+    CHECK( locator.locate( 1.0f, 1.0f ) == 0 );
+    CHECK( locator.locate( 4.0f, 3.0f ) == 1 );
+    CHECK( locator.locate( 7.0f, 1.0f ) == 2 );
+    CHECK( locator.locate( 5.2f, 1.0f ) == -1 );
+    CHECK( locator.locate( -1.0f, 1.0f ) == -1 );
+
+    locator.clear();
+    CHECK( locator.size() == 0 );
+    CHECK( locator.locate( 1.0f, 1.0f ) == -1 );
+}
+
+TEST_CASE( ChaperoneLocatorUsesRawCoordinates )
+{
+    // Saved with the playspace moved by 10 m along x and turned by 90
+    // degrees: standing x is raw z.
+    const vr::HmdMatrix34_t standingToRaw
+        = { { { 0, 0, -1, 10 }, { 0, 1, 0, 0 }, { 1, 0, 0, 0 } } };
+    utils::ChaperoneLocator locator;
+    add( locator, 0, rectangle( 0.0f, 0.0f, 4.0f, 2.0f ), "", standingToRaw );
+    CHECK( locator.locate( 9.0f, 3.0f ) == 0 );
+    CHECK( locator.locate( 3.0f, 1.0f ) == -1 );
+}
+
+TEST_CASE( ChaperoneLocatorOnlyConsidersSpacesOfTheSetup )
+{
+    const auto quads = rectangle( 0.0f, 0.0f, 4.0f, 4.0f );
+    utils::ChaperoneLocator locator;
+    locator.setSetup( "LHB-2;LHB-1" );
+    add( locator,
+         0,
+         quads,
+         utils::ChaperoneLocator::joinSignature( { "LHB-4", "LHB-3" } ) );
+    CHECK( locator.locate( 1.0f, 1.0f ) == -1 );
+    // One shared base station is enough.
+    add( locator, 1, rectangle( 0.0f, 0.0f, 3.0f, 3.0f ), "LHB-1;LHB-9" );
+    CHECK( locator.locate( 1.0f, 1.0f ) == 1 );
+    locator.setSetup( "LHB-4" );
+    CHECK( locator.locate( 1.0f, 1.0f ) == 0 );
+    // Spaces saved without references are found everywhere.
+    add( locator, 2, rectangle( 0.5f, 0.5f, 1.5f, 1.5f ) );
+    CHECK( locator.locate( 1.0f, 1.0f ) == 2 );
+
+    CHECK( utils::ChaperoneLocator::joinSignature( { "b", "a", "c" } )
+           == "a;b;c" );
+    const auto references
+        = utils::ChaperoneLocator::splitSignature( ";c;a;;b" );
+    CHECK( references.size() == 3 );
+    CHECK( references[0] == "a" && references[2] == "c" );
+}
+
+TEST_CASE( ChaperoneLocatorHandlesHugeAndBrokenSpaces )
+{
+    utils::ChaperoneLocator locator;
+    // Beyond the range of the grid, its cell count doesn't fit into an int.
+    add( locator, 0, rectangle( -1.0e9f, -1.0e9f, 1.0e9f, 1.0e9f ) );
+    // Larger than the grid takes, but in range.
+    add( locator, 1, rectangle( 0.0f, 0.0f, 100.0f, 100.0f ) );
+    add( locator, 2, rectangle( 1.0f, 1.0f, 2.0f, 2.0f ) );
+    CHECK( locator.locate( 1.5f, 1.5f ) == 2 );
+    CHECK( locator.locate( 50.0f, 50.0f ) == 1 );
+    CHECK( locator.locate( -5.0e8f, 5.0e8f ) == 0 );
+
+    // Not finite, and too few corners.
+    auto broken = rectangle( 0.0f, 0.0f, 1.0f, 1.0f );
+    broken[2].vCorners[0].v[0] = std::nanf( "" );
+    add( locator, 3, broken );
+    broken[2].vCorners[0].v[0] = INFINITY;
+    add( locator, 4, broken );
+    broken.resize( 2 );
+    add( locator, 5, broken );
+    CHECK( locator.size() == 3 );
+}
+
+BENCHMARK( ChaperoneLocatorLocate )
+{
+    // 150 rooms of a building and 10 spaces spanning the whole floor, which
+    // are too large for the grid.
+    std::vector<std::vector<vr::HmdQuad_t>> spaces;
+    for ( int i = 0; i < 150; i++ )
+    {
+        const float x = static_cast<float>( i % 15 ) * 6.0f;
+        const float z = static_cast<float>( i / 15 ) * 6.0f;
+        spaces.push_back( rectangle( x, z, x + 5.0f, z + 5.0f ) );
+    }
+    for ( int i = 0; i < 10; i++ )
+    {
+        const float inset = static_cast<float>( i );
+        spaces.push_back(
+            rectangle( inset, inset, 90.0f - inset, 60.0f - inset ) );
+    }
+    utils::ChaperoneLocator locator;
+    tests::measure( "rebuild 160 spaces", tests::scaled( 2000 ), [&] {
+        locator.clear();
+        for ( size_t i = 0; i < spaces.size(); i++ )
+        {
+            add( locator, static_cast<int>( i ), spaces[i] );
+        }
+    } );
+
+    std::mt19937 random( 5 );
+    std::uniform_real_distribution<float> x( -5.0f, 95.0f );
+    std::uniform_real_distribution<float> z( -5.0f, 65.0f );
+    int found = 0;
+    tests::measure( "locate", tests::scaled( 2000000 ), [&] {
+        found += locator.locate( x( random ), z( random ) ) >= 0;
+    } );
+    CHECK( found > 0 );
+}
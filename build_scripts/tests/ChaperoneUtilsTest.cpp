@@ -0,0 +1,136 @@
+#include "Test.h"
+#include "StubRuntime.h"
+#include "utils/ChaperoneUtils.h"
+
+namespace
+{
+void commitLive( const std::vector<vr::HmdQuad_t>& bounds )
+{
+    auto& setup = tests::stubChaperoneSetup();
+    setup.working.bounds = bounds;
+    setup.CommitWorkingCopy( vr::EChaperoneConfigFile_Live );
+}
+
+} // namespace
+
+TEST_CASE( ChaperoneUtilsRecognizesOwnCommit )
+{
+    tests::stubChaperoneSetup().reset();
+    utils::ChaperoneUtils chaperone;
+    commitLive( tests::roomBounds( 4.0f, 3.0f ) );
+    CHECK( chaperone.loadChaperoneData() );
+    const auto generation = chaperone.generation();
+
+    const auto moved = tests::roomBounds( 4.0f, 3.5f );
+    commitLive( moved );
+    chaperone.ownCommit( moved.data(), static_cast<uint32_t>( moved.size() ) );
+    CHECK( chaperone.generation() == generation + 1 );
+    // The change event of our own commit.
+    CHECK( !chaperone.loadChaperoneData() );
+    CHECK( chaperone.generation() == generation + 1 );
+}
+
+TEST_CASE( ChaperoneUtilsSeesOutsideChangeAfterOwnCommit )
+{
+    tests::stubChaperoneSetup().reset();
+    utils::ChaperoneUtils chaperone;
+    const auto ours = tests::roomBounds( 4.0f, 3.0f );
+    commitLive( ours );
+    chaperone.ownCommit( ours.data(), static_cast<uint32_t>( ours.size() ) );
+
+    // Someone else commits right after us, before our change event is
+    // handled.
+    commitLive( tests::roomBounds( 5.0f, 5.0f ) );
+    CHECK( chaperone.loadChaperoneData() );
+    CHECK_NEAR( static_cast<double>( chaperone.boundsInfo().area ),
+                25.0,
+                1e-4 );
+    CHECK( !chaperone.loadChaperoneData() );
+}
+
+TEST_CASE( ChaperoneUtilsBoundsInfo )
+{
+    tests::stubChaperoneSetup().reset();
+    utils::ChaperoneUtils chaperone;
+    commitLive( tests::roomBounds( 4.0f, 3.0f ) );
+    CHECK( chaperone.loadChaperoneData() );
+    CHECK( chaperone.isChaperoneWellFormed() );
+    const auto& info = chaperone.boundsInfo();
+    CHECK_NEAR( static_cast<double>( info.area ), 12.0, 1e-4 );
+    CHECK_NEAR( static_cast<double>( info.centroidX ), 0.0, 1e-6 );
+    CHECK_NEAR( static_cast<double>( info.maxY ), 2.4, 1e-6 );
+    CHECK_NEAR( static_cast<double>( info.minX ), -2.0, 1e-6 );
+    CHECK_NEAR( static_cast<double>( info.maxZ ), 1.5, 1e-6 );
+
+    const vr::HmdVector3_t center = { { 0.0f, 1.0f, 0.0f } };
+    CHECK_NEAR(
+        static_cast<double>( chaperone.getDistanceToChaperone( center ) ),
+        1.5,
+        1e-6 );
+}
+
+TEST_CASE( ChaperoneUtilsPlayAreaInsidePolygon )
+{
+    // A 4 x 3 m room away from the origin.
+    std::vector<vr::HmdQuad_t> quads;
+    CHECK( utils::ChaperoneUtils::quadsFromPolygon(
+        { { { 1.0f, 2.0f } },
+          { { 5.0f, 2.0f } },
+          { { 5.0f, 5.0f } },
+          { { 1.0f, 5.0f } } },
+        2.4f,
+        0.01f,
+        quads ) );
+    vr::HmdVector2_t center;
+    vr::HmdVector2_t size;
+    CHECK( utils::ChaperoneUtils::playAreaFromPolygon( quads, center, size ) );
+    CHECK_NEAR( static_cast<double>( center.v[0] ), 3.0, 1e-4 );
+    CHECK_NEAR( static_cast<double>( center.v[1] ), 3.5, 1e-4 );
+    CHECK( size.v[0] <= 4.0f + 1e-4f && size.v[1] <= 3.0f + 1e-4f );
+    CHECK( size.v[0] * size.v[1] > 0.97f * 12.0f );
+
+    // An L shaped room, its centroid is inside the corner cut out.
+    CHECK( utils::ChaperoneUtils::quadsFromPolygon( { { { 0.0f, 0.0f } },
+                                                      { { 6.0f, 0.0f } },
+                                                      { { 6.0f, 1.0f } },
+                                                      { { 1.0f, 1.0f } },
+                                                      { { 1.0f, 6.0f } },
+                                                      { { 0.0f, 6.0f } } },
+                                                    2.4f,
+                                                    0.01f,
+                                                    quads ) );
+    CHECK( utils::ChaperoneUtils::playAreaFromPolygon( quads, center, size ) );
+    // Inside one of the arms.
+    const float minX = center.v[0] - size.v[0] / 2.0f;
+    const float maxX = center.v[0] + size.v[0] / 2.0f;
+    const float minZ = center.v[1] - size.v[1] / 2.0f;
+    const float maxZ = center.v[1] + size.v[1] / 2.0f;
+    CHECK( minX >= -1e-4f && minZ >= -1e-4f );
+    CHECK( ( maxX <= 1.0f + 1e-4f && maxZ <= 6.0f + 1e-4f )
+           || ( maxX <= 6.0f + 1e-4f && maxZ <= 1.0f + 1e-4f ) );
+    CHECK( size.v[0] * size.v[1] > 0.9f * 6.0f );
+
+    // No area.
+    quads.resize( 2 );
+    CHECK( !utils::ChaperoneUtils::playAreaFromPolygon( quads, center, size ) );
+}
+
+BENCHMARK( ChaperoneUtilsPlayAreaFromPolygon )
+{
+    // A traced room with 40 corners.
+    std::vector<vr::HmdVector2_t> corners;
+    for ( int i = 0; i < 40; i++ )
+    {
+        const float angle = static_cast<float>( i ) * 0.15708f;
+        const float radius = i % 2 == 0 ? 2.0f : 1.8f;
+        corners.push_back(
+            { { radius * std::cos( angle ), radius * std::sin( angle ) } } );
+    }
+    std::vector<vr::HmdQuad_t> quads;
+    utils::ChaperoneUtils::quadsFromPolygon( corners, 2.4f, 0.01f, quads );
+    vr::HmdVector2_t center;
+    vr::HmdVector2_t size;
+    tests::measure( "play area", tests::scaled( 20000 ), [&] {
+        utils::ChaperoneUtils::playAreaFromPolygon( quads, center, size );
+    } );
+}
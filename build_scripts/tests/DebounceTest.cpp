@@ -0,0 +1,114 @@
+#include "Test.h"
+#include "utils/Debounce.h"
+#include <vector>
+
+namespace
+{
+using Clock = utils::Debounce::Clock;
+
+constexpr auto k_delay = std::chrono::milliseconds( 250 );
+// 90 Hz frames.
+constexpr auto k_frame = std::chrono::microseconds( 11111 );
+
+struct Change
+{
+    int frame;
+    bool worn;
+};
+
+struct Mute
+{
+    int frame;
+    bool muted;
+    // From the sensor change the mute follows.
+    double latencyMilliseconds;
+};
+
+// Feeds the sensor changes in at their frames and settles every frame like
+// AudioTabController does, the mic follows every settled change.
+std::vector<Mute> replay( const std::vector<Change>& changes, int frames )
+{
+    utils::Debounce debounce;
+    bool muted = false;
+    std::vector<Mute> mutes;
+    size_t next = 0;
+    const Clock::time_point start;
+    for ( int frame = 0; frame < frames; frame++ )
+    {
+        const auto now = start + frame * k_frame;
+        while ( next < changes.size() && changes[next].frame == frame )
+        {
+            debounce.set( changes[next].worn, now );
+            next++;
+        }
+        bool worn = false;
+        if ( debounce.settle( now, k_delay, worn ) && muted == worn )
+        {
+            muted = !worn;
+            mutes.push_back(
+                { frame,
+                  muted,
+                  std::chrono::duration<double, std::milli>(
+                      now - debounce.changeTime() )
+                      .count() } );
+        }
+    }
+    return mutes;
+}
+
+} // namespace
+
+TEST_CASE( DebounceMutesAfterTheDelay )
+{
+    // Put on at the start, taken off after 10 s and put on again after 20 s.
+    const auto mutes
+        = replay( { { 0, true }, { 900, false }, { 1800, true } }, 2700 );
+    // Unmuted from the start, the first state counts as a change but the
+    // mic is unmuted already.
+    CHECK( mutes.size() == 2 );
+    CHECK( mutes[0].muted );
+    CHECK( !mutes[1].muted );
+    for ( const auto& mute : mutes )
+    {
+        // The delay and at most one frame.
+        CHECK( mute.latencyMilliseconds >= 250.0 );
+        CHECK( mute.latencyMilliseconds < 250.0 + 11.2 );
+    }
+    CHECK( mutes[0].frame == 900 + 23 );
+}
+
+TEST_CASE( DebounceIgnoresFlicker )
+{
+    // Lifting the headset for 100 ms, and a sensor flickering for a second
+    // before settling on off.
+    std::vector<Change> changes = { { 0, true }, { 90, false }, { 99, true } };
+    for ( int frame = 300; frame < 390; frame += 6 )
+    {
+        changes.push_back( { frame, false } );
+        changes.push_back( { frame + 3, true } );
+    }
+    changes.push_back( { 390, false } );
+    const auto mutes = replay( changes, 900 );
+    CHECK( mutes.size() == 1 );
+    CHECK( mutes[0].muted );
+    CHECK( mutes[0].frame == 390 + 23 );
+}
+
+TEST_CASE( DebounceFirstStateCountsAsChange )
+{
+    utils::Debounce debounce;
+    const Clock::time_point start;
+    CHECK( !debounce.isKnown() );
+    CHECK( debounce.set( false, start ) );
+    CHECK( !debounce.set( false, start + k_frame ) );
+    bool worn = true;
+    CHECK( !debounce.settle( start + k_delay / 2, k_delay, worn ) );
+    CHECK( debounce.settle( start + k_delay, k_delay, worn ) );
+    CHECK( !worn );
+    CHECK( !debounce.settle( start + k_delay * 2, k_delay, worn ) );
+
+    // After a failed read the same state counts again.
+    debounce.reset();
+    CHECK( !debounce.isKnown() );
+    CHECK( debounce.set( false, start + k_delay * 3 ) );
+}
@@ -0,0 +1,160 @@
+#include "Test.h"
+#include "utils/EventBus.h"
+#include "utils/EventLoad.h"
+#include <algorithm>
+#include <cstdio>
+
+namespace
+{
+// Default mix of the Readme, the chaperone events are added where asked for.
+constexpr auto k_mix = "mousemove=400,scroll=40,keyboard=8";
+
+// Stands in for the handlers of the OverlayController: they look at the
+// event and count it, the work the real ones do is left out.
+struct Handlers
+{
+    uint64_t mouseMoves = 0;
+    uint64_t scrolls = 0;
+    uint64_t keys = 0;
+    uint64_t keyboardDone = 0;
+    uint64_t chaperoneReloads = 0;
+    float pointerMax[2] = {};
+    float scrollSum = 0.0f;
+
+    void subscribe( utils::EventBus& bus )
+    {
+        bus.subscribe( vr::VREvent_MouseMove,
+                       [this]( const vr::VREvent_t& event ) {
+                           mouseMoves++;
+                           pointerMax[0]
+                               = std::max( pointerMax[0], event.data.mouse.x );
+                           pointerMax[1]
+                               = std::max( pointerMax[1], event.data.mouse.y );
+                       } );
+        bus.subscribe( vr::VREvent_ScrollSmooth,
+                       [this]( const vr::VREvent_t& event ) {
+                           scrolls++;
+                           scrollSum += event.data.scroll.ydelta;
+                       } );
+        bus.subscribe( vr::VREvent_KeyboardCharInput,
+                       [this]( const vr::VREvent_t& ) { keys++; } );
+        bus.subscribe( vr::VREvent_KeyboardDone,
+                       [this]( const vr::VREvent_t& event ) {
+                           if ( event.data.keyboard.uUserValue
+                                == utils::EventLoad::keyboardUserValue )
+                           {
+                               keyboardDone++;
+                           }
+                       } );
+        bus.subscribeCoalesced( { vr::VREvent_ChaperoneUniverseHasChanged,
+                                  vr::VREvent_ChaperoneDataHasChanged },
+                                [this]( const vr::VREvent_t& ) {
+                                    chaperoneReloads++;
+                                } );
+    }
+};
+
+// One tick of OverlayController::mainEventLoop() without real events.
+void tick( utils::EventBus& bus, utils::EventLoad& load )
+{
+    load.beginFrame();
+    bus.pump( [&load]( vr::VREvent_t* event ) { return load.next( event ); } );
+    bus.dispatch();
+}
+
+} // namespace
+
+TEST_CASE( EventLoadParsesTheMix )
+{
+    utils::EventLoad load;
+    CHECK( !load.active() );
+    CHECK( load.setMix( k_mix ) );
+    CHECK( load.active() );
+    CHECK( load.eventsPerFrame() == 448 );
+
+    // Broken mixes leave the previous one.
+    for ( const auto* mix : { "mousemove=-1",
+                              "mousemove=+4",
+                              "mousemove=4294967297",
+                              "mousemove=100000",
+                              "mousemove=",
+                              "mousemove=4x",
+                              "mousemove",
+                              "click=4",
+                              "scroll=2,keyboard= 3" } )
+    {
+        CHECK( !load.setMix( mix ) );
+        CHECK( load.eventsPerFrame() == 448 );
+    }
+
+    CHECK( load.setMix( "chaperone=2,mousemove=99999" ) );
+    CHECK( load.eventsPerFrame() == 100001 );
+    CHECK( load.setMix( "" ) );
+    CHECK( !load.active() );
+}
+
+TEST_CASE( EventLoadThroughTheEventBus )
+{
+    utils::EventBus bus;
+    Handlers handlers;
+    handlers.subscribe( bus );
+    utils::EventLoad load;
+    CHECK( load.setMix( k_mix ) );
+    load.setArea( 1200.0f, 800.0f );
+
+    for ( int frame = 0; frame < 10; frame++ )
+    {
+        tick( bus, load );
+    }
+    CHECK( handlers.mouseMoves == 4000 );
+    CHECK( handlers.scrolls == 400 );
+    CHECK( handlers.keys + handlers.keyboardDone == 80 );
+    CHECK( handlers.keyboardDone == 10 );
+    CHECK( handlers.chaperoneReloads == 0 );
+    CHECK( handlers.pointerMax[0] <= 1200.0f );
+    CHECK( handlers.pointerMax[1] <= 800.0f );
+    // Up and down alternate.
+    CHECK_NEAR( handlers.scrollSum, 0.0f, 1e-4f );
+    CHECK( bus.stats( vr::VREvent_MouseMove ).count == 4000 );
+
+    // The chaperone handler is coalesced, once per frame.
+    CHECK( load.setMix( "chaperone=4" ) );
+    tick( bus, load );
+    tick( bus, load );
+    CHECK( handlers.chaperoneReloads == 2 );
+    CHECK( bus.stats( vr::VREvent_ChaperoneDataHasChanged ).count == 8 );
+
+    // Nothing until the next frame begins.
+    vr::VREvent_t event;
+    CHECK( !load.next( &event ) );
+}
+
+BENCHMARK( EventLoadPump )
+{
+    utils::EventBus bus;
+    Handlers handlers;
+    handlers.subscribe( bus );
+    utils::EventLoad load;
+    load.setArea( 1200.0f, 800.0f );
+
+    CHECK( load.setMix( k_mix ) );
+    vr::VREvent_t event;
+    tests::measure( "next", tests::scaled( 10000000 ), [&] {
+        if ( !load.next( &event ) )
+        {
+            load.beginFrame();
+        }
+    } );
+
+    // A pump and dispatch of the mix, then one with ten times the events.
+    for ( const auto* mix : { k_mix, "mousemove=4000,scroll=400,keyboard=80" } )
+    {
+        CHECK( load.setMix( mix ) );
+        const double seconds = tests::measure(
+            mix, tests::scaled( 2000 ), [&] { tick( bus, load ); } );
+        std::printf( "    %.1f ns per event\n",
+                     seconds * 1e9
+                         / static_cast<double>( load.eventsPerFrame() ) );
+    }
+    CHECK( handlers.mouseMoves > 0 );
+}
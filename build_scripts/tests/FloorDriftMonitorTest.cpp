@@ -0,0 +1,179 @@
+#include "Test.h"
+#include "utils/FloorDriftMonitor.h"
+#include <cmath>
+
+namespace
+{
+constexpr vr::TrackedDeviceIndex_t k_leftController = 1;
+constexpr vr::TrackedDeviceIndex_t k_rightController = 2;
+constexpr vr::TrackedDeviceIndex_t k_tracker = 3;
+constexpr vr::TrackedDeviceIndex_t k_baseStation = 4;
+
+vr::ETrackedDeviceClass deviceClass( vr::TrackedDeviceIndex_t index )
+{
+    switch ( index )
+    {
+    case vr::k_unTrackedDeviceIndex_Hmd:
+        return vr::TrackedDeviceClass_HMD;
+    case k_leftController:
+    case k_rightController:
+        return vr::TrackedDeviceClass_Controller;
+    case k_tracker:
+        return vr::TrackedDeviceClass_GenericTracker;
+    case k_baseStation:
+        return vr::TrackedDeviceClass_TrackingReference;
+    default:
+        return vr::TrackedDeviceClass_Invalid;
+    }
+}
+
+// Recorded frames are replaced by a generator: every device lies still at its
+// height with a little tracking noise unless it is marked as moving.
+struct Replay
+{
+    vr::TrackedDevicePose_t poses[vr::k_unMaxTrackedDeviceCount] = {};
+    utils::FloorDriftMonitor monitor{ &deviceClass };
+    unsigned frame = 0;
+
+    void place( vr::TrackedDeviceIndex_t index, float height )
+    {
+        auto& pose = poses[index];
+        pose.bPoseIsValid = true;
+        pose.bDeviceIsConnected = true;
+        pose.eTrackingResult = vr::TrackingResult_Running_OK;
+        pose.mDeviceToAbsoluteTracking = {};
+        pose.mDeviceToAbsoluteTracking.m[0][0] = 1.0f;
+        pose.mDeviceToAbsoluteTracking.m[1][1] = 1.0f;
+        pose.mDeviceToAbsoluteTracking.m[2][2] = 1.0f;
+        pose.mDeviceToAbsoluteTracking.m[1][3] = height;
+        pose.vVelocity = {};
+    }
+
+    void move( vr::TrackedDeviceIndex_t index )
+    {
+        poses[index].vVelocity.v[0] = 0.5f;
+    }
+
+    // Runs the given number of frames, with sub millimeter noise on all
+    // heights.
+    void run( unsigned frames, float heightChangePerFrame = 0.0f )
+    {
+        for ( unsigned i = 0; i < frames; i++, frame++ )
+        {
+            const float noise
+                = 0.0003f * static_cast<float>( std::sin( frame * 0.7 ) );
+            for ( auto& pose : poses )
+            {
+                pose.mDeviceToAbsoluteTracking.m[1][3]
+                    += heightChangePerFrame + noise;
+            }
+            monitor.update( poses );
+            for ( auto& pose : poses )
+            {
+                pose.mDeviceToAbsoluteTracking.m[1][3] -= noise;
+            }
+        }
+    }
+};
+
+} // namespace
+
+TEST_CASE( FloorDriftNeedsBothControllers )
+{
+    Replay replay;
+    replay.place( k_leftController, 0.07f );
+    replay.place( k_rightController, 1.1f );
+    replay.run( 90 * 60 );
+
+    utils::FloorDriftMonitor::FloorSample first;
+    utils::FloorDriftMonitor::FloorSample second;
+    CHECK( !replay.monitor.floorReference( first, second ) );
+
+    replay.place( k_rightController, 0.08f );
+    replay.run( 90 * 15 );
+    CHECK( replay.monitor.floorReference( first, second ) );
+    CHECK_NEAR( first.height, 0.07, 0.001 );
+    CHECK_NEAR( second.height, 0.08, 0.001 );
+}
+
+TEST_CASE( FloorDriftWaitsForStillnessWindow )
+{
+    Replay replay;
+    replay.place( k_leftController, 0.07f );
+    replay.place( k_rightController, 0.07f );
+
+    utils::FloorDriftMonitor::FloorSample first;
+    utils::FloorDriftMonitor::FloorSample second;
+    // Put down for a few seconds is not enough.
+    replay.run( 90 * 5 );
+    CHECK( !replay.monitor.floorReference( first, second ) );
+
+    // Picking one up restarts the window.
+    replay.move( k_rightController );
+    replay.run( 1 );
+    replay.place( k_rightController, 0.07f );
+    replay.run( 90 * 8 );
+    CHECK( !replay.monitor.floorReference( first, second ) );
+
+    replay.run( 90 * 4 );
+    CHECK( replay.monitor.floorReference( first, second ) );
+}
+
+TEST_CASE( FloorDriftIgnoresHighAndMovingDevices )
+{
+    Replay replay;
+    // On a table, a tracker and a base station on the floor.
+    replay.place( k_leftController, 0.75f );
+    replay.place( k_rightController, 0.07f );
+    replay.place( k_tracker, 0.02f );
+    replay.place( k_baseStation, 0.0f );
+    replay.run( 90 * 60 );
+
+    utils::FloorDriftMonitor::FloorSample first;
+    utils::FloorDriftMonitor::FloorSample second;
+    CHECK( !replay.monitor.floorReference( first, second ) );
+
+    replay.place( k_leftController, 0.07f );
+    replay.move( k_leftController );
+    replay.run( 90 * 60 );
+    CHECK( !replay.monitor.floorReference( first, second ) );
+}
+
+TEST_CASE( FloorDriftFollowsSlowHeightDrift )
+{
+    Replay replay;
+    replay.place( k_tracker, 0.5f );
+    replay.run( 90 * 10 );
+
+    double height = 0.0;
+    double yaw = 0.0;
+    CHECK( !replay.monitor.drift( height, yaw ) );
+
+    // 2 cm over five minutes.
+    constexpr unsigned k_frames = 90 * 300;
+    replay.run( k_frames, 0.02f / k_frames );
+    CHECK( replay.monitor.drift( height, yaw ) );
+    CHECK_NEAR( height, 0.02, 0.002 );
+    CHECK_NEAR( yaw, 0.0, 1e-6 );
+
+    // A reset after moving the universe center forgets it.
+    replay.monitor.reset();
+    replay.run( 90 );
+    CHECK( !replay.monitor.drift( height, yaw ) );
+}
+
+BENCHMARK( FloorDriftMonitorFrame )
+{
+    // Two controllers and three trackers at rest, the usual full body setup.
+    Replay replay;
+    replay.place( k_leftController, 0.07f );
+    replay.place( k_rightController, 0.07f );
+    for ( vr::TrackedDeviceIndex_t i = 5; i < 8; i++ )
+    {
+        replay.place( i, 0.1f );
+    }
+    const vr::TrackedDevicePose_t* poses = replay.poses;
+    tests::measure( "update", tests::scaled( 1000000 ), [&] {
+        replay.monitor.update( poses );
+    } );
+}
@@ -0,0 +1,221 @@
+#include "Test.h"
+#include "utils/GestureRecognizer.h"
+#include <cmath>
+#include <random>
+
+namespace
+{
+using Gesture = utils::GestureRecognizer::Gesture;
+
+constexpr double k_frameRate = 90.0;
+
+// Standing still with both hands at chest height, in front of the HMD.
+utils::GestureRecognizer::Frame restingFrame( int frame )
+{
+    utils::GestureRecognizer::Frame result;
+    result.time = frame / k_frameRate;
+    result.hmdValid = true;
+    result.hmdPosition[1] = 1.7;
+    for ( unsigned hand = 0; hand < 2; hand++ )
+    {
+        result.handValid[hand] = true;
+        result.handPosition[hand][0] = hand == 0 ? -0.2 : 0.2;
+        result.handPosition[hand][1] = 1.2;
+        result.handPosition[hand][2] = -0.3;
+    }
+    return result;
+}
+
+// Raises the left hand to the side of the HMD.
+void handAtHead( utils::GestureRecognizer::Frame& frame )
+{
+    frame.handPosition[0][0] = frame.hmdPosition[0] - 0.15;
+    frame.handPosition[0][1] = frame.hmdPosition[1];
+    frame.handPosition[0][2] = frame.hmdPosition[2];
+}
+
+// Counts the gestures of a replay, replay( i ) returns frame i.
+template <typename Replay>
+unsigned countGestures( utils::GestureRecognizer& recognizer,
+                        int frames,
+                        Replay replay,
+                        Gesture* last = nullptr )
+{
+    unsigned count = 0;
+    for ( int i = 0; i < frames; i++ )
+    {
+        const Gesture gesture = recognizer.update( replay( i ) );
+        if ( gesture != Gesture::None )
+        {
+            count++;
+            if ( last )
+            {
+                *last = gesture;
+            }
+        }
+    }
+    return count;
+}
+
+} // namespace
+
+TEST_CASE( GestureRecognizerHeadDoubleTap )
+{
+    // Taps 0.25 s apart, each one frame of 1 m/s head velocity.
+    utils::GestureRecognizer recognizer;
+    Gesture gesture = Gesture::None;
+    const unsigned count = countGestures(
+        recognizer,
+        180,
+        []( int i ) {
+            auto frame = restingFrame( i );
+            handAtHead( frame );
+            if ( i == 45 || i == 45 + 22 )
+            {
+                frame.hmdVelocity[0] = 1.0;
+            }
+            return frame;
+        },
+        &gesture );
+    CHECK( count == 1 );
+    CHECK( gesture == Gesture::HeadDoubleTap );
+    CHECK_NEAR( recognizer.lastLatency(), 22.0 / k_frameRate, 1e-9 );
+}
+
+TEST_CASE( GestureRecognizerTapNeedsHandAndSecondTap )
+{
+    // The same taps with the hands down are head movement.
+    utils::GestureRecognizer recognizer;
+    CHECK( countGestures( recognizer,
+                          180,
+                          []( int i ) {
+                              auto frame = restingFrame( i );
+                              if ( i == 45 || i == 67 )
+                              {
+                                  frame.hmdVelocity[0] = 1.0;
+                              }
+                              return frame;
+                          } )
+           == 0 );
+
+    // A single tap, and two taps too far apart.
+    recognizer.reset();
+    CHECK( countGestures( recognizer,
+                          270,
+                          []( int i ) {
+                              auto frame = restingFrame( i );
+                              handAtHead( frame );
+                              if ( i == 45 || i == 180 )
+                              {
+                                  frame.hmdVelocity[0] = 1.0;
+                              }
+                              return frame;
+                          } )
+           == 0 );
+}
+
+TEST_CASE( GestureRecognizerFlick )
+{
+    // Seven frames (78 ms) of fast turning of the right hand.
+    utils::GestureRecognizer recognizer;
+    Gesture gesture = Gesture::None;
+    const unsigned count = countGestures(
+        recognizer,
+        90,
+        []( int i ) {
+            auto frame = restingFrame( i );
+            if ( i >= 30 && i < 37 )
+            {
+                frame.handAngularSpeed[1] = 20.0;
+            }
+            return frame;
+        },
+        &gesture );
+    CHECK( count == 1 );
+    CHECK( gesture == Gesture::RightFlick );
+    CHECK_NEAR( recognizer.lastLatency(), 7.0 / k_frameRate, 1e-9 );
+}
+
+TEST_CASE( GestureRecognizerLongTurnAndCooldown )
+{
+    // Half a second of fast turning is a regular movement.
+    utils::GestureRecognizer recognizer;
+    CHECK( countGestures( recognizer,
+                          90,
+                          []( int i ) {
+                              auto frame = restingFrame( i );
+                              if ( i >= 10 && i < 55 )
+                              {
+                                  frame.handAngularSpeed[0] = 20.0;
+                              }
+                              return frame;
+                          } )
+           == 0 );
+
+    // Flicks 0.3 s apart only count once, the next one after the cooldown
+    // does again.
+    recognizer.reset();
+    CHECK( countGestures( recognizer,
+                          270,
+                          []( int i ) {
+                              auto frame = restingFrame( i );
+                              const int start[] = { 10, 37, 150 };
+                              for ( int s : start )
+                              {
+                                  if ( i >= s && i < s + 5 )
+                                  {
+                                      frame.handAngularSpeed[0] = 20.0;
+                                  }
+                              }
+                              return frame;
+                          } )
+           == 2 );
+}
+
+TEST_CASE( GestureRecognizerNoFalsePositivesWhileWalking )
+{
+    // Ten minutes of walking around and looking about: the head bobs and
+    // sways, the hands swing, turn and now and then touch the HMD (adjusting
+    // it). Tracking noise on everything.
+    std::mt19937 random( 42 );
+    std::normal_distribution<double> noise( 0.0, 0.01 );
+    utils::GestureRecognizer recognizer;
+    const unsigned count = countGestures(
+        recognizer,
+        static_cast<int>( 600 * k_frameRate ),
+        [&]( int i ) {
+            auto frame = restingFrame( i );
+            const double t = frame.time;
+            frame.hmdPosition[0] = 0.5 * std::sin( t * 0.3 );
+            frame.hmdPosition[1] = 1.7 + 0.03 * std::sin( t * 11.0 );
+            frame.hmdVelocity[0]
+                = 0.15 * std::cos( t * 0.3 ) + noise( random );
+            frame.hmdVelocity[1]
+                = 0.33 * std::cos( t * 11.0 ) + noise( random );
+            frame.hmdVelocity[2] = 0.8 * std::sin( t * 0.7 ) + noise( random );
+            for ( unsigned hand = 0; hand < 2; hand++ )
+            {
+                frame.handAngularSpeed[hand]
+                    = 4.0 * std::abs( std::sin( t * 5.5 + hand ) )
+                      + std::abs( noise( random ) ) * 50.0;
+            }
+            if ( std::fmod( t, 60.0 ) < 3.0 )
+            {
+                handAtHead( frame );
+            }
+            return frame;
+        } );
+    CHECK( count == 0 );
+}
+
+BENCHMARK( GestureRecognizerFrame )
+{
+    utils::GestureRecognizer recognizer;
+    int frame = 0;
+    tests::measure( "update", tests::scaled( 5000000 ), [&] {
+        auto input = restingFrame( frame++ );
+        input.hmdVelocity[0] = 0.001 * ( frame & 15 );
+        input.handAngularSpeed[1] = ( frame & 63 ) < 4 ? 20.0 : 0.0;
+        recognizer.update( input );
+    } );
+}
@@ -0,0 +1,168 @@
+#include "Test.h"
+#include "StubOverlay.h"
+#include "utils/NotificationCompositor.h"
+
+namespace
+{
+using Compositor = utils::NotificationCompositor;
+
+unsigned visibleOverlays()
+{
+    unsigned count = 0;
+    for ( const auto& overlay : tests::stubOverlay().overlays )
+    {
+        count += overlay.visible ? 1 : 0;
+    }
+    return count;
+}
+
+} // namespace
+
+TEST_CASE( NotificationCompositorUploadsOncePerFrame )
+{
+    auto& overlay = tests::stubOverlay();
+    overlay.reset();
+    Compositor compositor( "test.indicator." );
+
+    const auto id = compositor.create( 64, 64, 0.02f );
+    CHECK( id != Compositor::invalidId );
+    for ( int i = 0; i < 5; i++ )
+    {
+        compositor.draw( id )->clear( 0xFF0000FF );
+    }
+    compositor.setVisible( id, true );
+    compositor.flush();
+    CHECK( overlay.uploads == 1 );
+    CHECK( overlay.uploadedBytes == 64 * 64 * 4 );
+    CHECK( visibleOverlays() == 1 );
+
+    // Nothing changed, nothing sent.
+    const unsigned visibilityChanges = overlay.visibilityChanges;
+    compositor.flush();
+    CHECK( overlay.uploads == 1 );
+    CHECK( overlay.visibilityChanges == visibilityChanges );
+}
+
+TEST_CASE( NotificationCompositorBoundsUploadsPerFlush )
+{
+    auto& overlay = tests::stubOverlay();
+    overlay.reset();
+    Compositor compositor( "test.indicator." );
+
+    constexpr unsigned k_count = 40;
+    for ( unsigned i = 0; i < k_count; i++ )
+    {
+        const auto id = compositor.create( 64, 40, 0.05f );
+        compositor.draw( id )->fillRect( 0, 0, 10, 10, 0xFFFFFFFF );
+        compositor.setVisible( id, true );
+    }
+    compositor.flush();
+    CHECK( overlay.uploads <= 4 );
+    // Not shown before the image is there.
+    CHECK( visibleOverlays() == overlay.uploads );
+
+    unsigned flushes = 1;
+    while ( visibleOverlays() < k_count && flushes < 100 )
+    {
+        compositor.flush();
+        flushes++;
+    }
+    CHECK( visibleOverlays() == k_count );
+    CHECK( overlay.uploads == k_count );
+    CHECK( flushes <= k_count / 4 + 1 );
+}
+
+TEST_CASE( NotificationCompositorReusesReleasedOverlays )
+{
+    auto& overlay = tests::stubOverlay();
+    overlay.reset();
+    Compositor compositor( "test.indicator." );
+
+    auto first = compositor.create( 64, 40, 0.05f );
+    compositor.setVisible( first, true );
+    compositor.flush();
+    compositor.release( first );
+    CHECK( visibleOverlays() == 0 );
+    CHECK( !compositor.isVisible( first ) );
+    CHECK( compositor.draw( first ) == nullptr );
+
+    auto second = compositor.create( 256, 40, 0.25f );
+    CHECK( overlay.creates == 1 );
+    CHECK( compositor.draw( second )->width() == 256 );
+}
+
+TEST_CASE( NotificationCompositorSkipsHiddenIndicators )
+{
+    auto& overlay = tests::stubOverlay();
+    overlay.reset();
+    Compositor compositor( "test.indicator." );
+
+    const auto id = compositor.create( 64, 64, 0.02f );
+    compositor.draw( id )->clear( 0xFFFFFFFF );
+    compositor.flush();
+    CHECK( overlay.uploads == 0 );
+
+    compositor.setVisible( id, true );
+    compositor.flush();
+    CHECK( overlay.uploads == 1 );
+    CHECK( visibleOverlays() == 1 );
+}
+
+TEST_CASE( NotificationCompositorBacksOffAfterFailedCreates )
+{
+    auto& overlay = tests::stubOverlay();
+    overlay.reset();
+    Compositor compositor( "test.indicator." );
+
+    // The battery indicators ask again every frame, the runtime only once
+    // until the retry delay passed.
+    overlay.createFails = true;
+    for ( int frame = 0; frame < 90; frame++ )
+    {
+        CHECK( compositor.create( 64, 40, 0.05f ) == Compositor::invalidId );
+    }
+    CHECK( overlay.creates == 1 );
+
+    // Indicators that exist already are reused without asking the runtime.
+    overlay.reset();
+    Compositor working( "test.indicator." );
+    const auto id = working.create( 64, 40, 0.05f );
+    CHECK( id != Compositor::invalidId );
+    working.release( id );
+    overlay.createFails = true;
+    CHECK( working.create( 64, 40, 0.05f ) == id );
+    CHECK( working.create( 64, 40, 0.05f ) == Compositor::invalidId );
+    CHECK( working.create( 64, 40, 0.05f ) == Compositor::invalidId );
+    CHECK( overlay.creates == 2 );
+}
+
+BENCHMARK( NotificationCompositorFrame )
+{
+    // 48 battery indicators that are all redrawn every frame, the worst case
+    // for a full body tracking setup.
+    auto& overlay = tests::stubOverlay();
+    overlay.reset();
+    Compositor compositor( "test.indicator." );
+    std::vector<Compositor::Id> ids;
+    for ( int i = 0; i < 48; i++ )
+    {
+        ids.push_back( compositor.create( 64, 40, 0.05f ) );
+        compositor.setVisible( ids.back(), true );
+    }
+
+    const unsigned frames = tests::scaled( 20000 );
+    unsigned frame = 0;
+    tests::measure( "draw and flush", frames, [&] {
+        for ( auto id : ids )
+        {
+            auto canvas = compositor.draw( id );
+            canvas->clear( 0x00000000 );
+            canvas->fillRect(
+                4, 4, static_cast<int>( frame % 50 ), 32, 0x00FF00FF );
+        }
+        compositor.flush();
+        frame++;
+    } );
+    std::printf( "    uploads per frame: %.2f\n",
+                 static_cast<double>( overlay.uploads ) / frames );
+}
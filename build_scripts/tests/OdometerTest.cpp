@@ -0,0 +1,135 @@
+#include "Test.h"
+#include "utils/Odometer.h"
+#include <cmath>
+#include <random>
+
+namespace
+{
+struct Result
+{
+    double distance;
+    double floorDistance;
+};
+
+// A 15 m walk along a circle with 2 cm of head bob, then 30 s of standing
+// still, with 1 mm of tracking jitter on every frame.
+Result replayWalk( double frameRate, double bob = 0.02 )
+{
+    constexpr double k_speed = 1.2;
+    constexpr double k_length = 15.0;
+    constexpr double k_radius = 2.0;
+    const double walkSeconds = k_length / k_speed;
+    std::mt19937 random( 7 );
+    std::normal_distribution<double> noise( 0.0, 0.001 );
+
+    utils::Odometer odometer;
+    const int frames = static_cast<int>( ( walkSeconds + 30.0 ) * frameRate );
+    for ( int frame = 0; frame < frames; frame++ )
+    {
+        const double t = frame / frameRate;
+        const double s = std::min( t, walkSeconds ) * k_speed;
+        const bool walking = t < walkSeconds;
+        const double angle = s / k_radius;
+        const double position[3]
+            = { k_radius * std::cos( angle ) + noise( random ),
+                1.7 + ( walking ? bob * std::sin( t * 12.0 ) : 0.0 )
+                    + noise( random ),
+                k_radius * std::sin( angle ) + noise( random ) };
+        const double speed = walking ? k_speed : 0.0;
+        const double velocity[3]
+            = { -speed * std::sin( angle ),
+                walking ? bob * 12.0 * std::cos( t * 12.0 ) : 0.0,
+                speed * std::cos( angle ) };
+        odometer.update( true, position, velocity, t );
+    }
+    return { odometer.distance(), odometer.floorDistance() };
+}
+
+} // namespace
+
+TEST_CASE( OdometerSameDistanceAtAnyRefreshRate )
+{
+    const Result at90 = replayWalk( 90.0 );
+    const Result at120 = replayWalk( 120.0 );
+    const Result at144 = replayWalk( 144.0 );
+    CHECK_NEAR( at90.floorDistance, 15.0, 0.2 );
+    CHECK_NEAR( at120.floorDistance, at90.floorDistance, 0.05 );
+    CHECK_NEAR( at144.floorDistance, at90.floorDistance, 0.05 );
+    CHECK_NEAR( at120.distance, at90.distance, 0.05 );
+    CHECK_NEAR( at144.distance, at90.distance, 0.05 );
+    // The head bob only counts in 3D.
+    CHECK( at90.distance > at90.floorDistance + 0.1 );
+    CHECK_NEAR( replayWalk( 90.0, 0.0 ).distance, at90.floorDistance, 0.05 );
+}
+
+TEST_CASE( OdometerIgnoresJitterWhileStill )
+{
+    // Ten minutes standing still with 2 mm of jitter, twice what the noise
+    // estimate starts out with. Only the first seconds may count some.
+    std::mt19937 random( 3 );
+    std::normal_distribution<double> noise( 0.0, 0.002 );
+    utils::Odometer odometer;
+    const double velocity[3] = { 0.0, 0.0, 0.0 };
+    double settled = 0.0;
+    for ( int frame = 0; frame < 90 * 600; frame++ )
+    {
+        const double position[3]
+            = { noise( random ), 1.7 + noise( random ), noise( random ) };
+        odometer.update( true, position, velocity, frame / 90.0 );
+        if ( frame == 90 * 10 )
+        {
+            settled = odometer.distance();
+        }
+    }
+    CHECK( odometer.distance() < 0.15 );
+    CHECK( odometer.distance() == settled );
+    CHECK( odometer.threshold() > 0.01 );
+}
+
+TEST_CASE( OdometerSkipsJumpsAndLostTracking )
+{
+    utils::Odometer odometer;
+    const double velocity[3] = { 0.0, 0.0, 0.0 };
+    double position[3] = { 0.0, 1.7, 0.0 };
+    int frame = 0;
+    auto walk = [&]( double meters ) {
+        // 1 m/s along x.
+        const double v[3] = { 1.0, 0.0, 0.0 };
+        const double end = position[0] + meters;
+        while ( position[0] < end )
+        {
+            position[0] += 1.0 / 90.0;
+            odometer.update( true, position, v, frame++ / 90.0 );
+        }
+    };
+    walk( 1.0 );
+    // Playspace moved by 5 m in a frame.
+    position[2] += 5.0;
+    odometer.update( true, position, velocity, frame++ / 90.0 );
+    walk( 1.0 );
+    // Tracking lost for a while, found again 3 m away.
+    for ( int i = 0; i < 90; i++ )
+    {
+        odometer.update( false, position, velocity, frame++ / 90.0 );
+    }
+    position[0] += 3.0;
+    walk( 1.0 );
+    CHECK_NEAR( odometer.floorDistance(), 3.0, 0.05 );
+    CHECK_NEAR( odometer.distance(), 3.0, 0.05 );
+
+    odometer.resetDistance();
+    CHECK( odometer.distance() == 0.0 );
+    CHECK( odometer.floorDistance() == 0.0 );
+}
+
+BENCHMARK( OdometerUpdate )
+{
+    utils::Odometer odometer;
+    const double velocity[3] = { 1.0, 0.0, 0.0 };
+    double position[3] = { 0.0, 1.7, 0.0 };
+    int frame = 0;
+    tests::measure( "update", tests::scaled( 10000000 ), [&] {
+        position[0] += 1.0 / 90.0;
+        odometer.update( true, position, velocity, frame++ / 90.0 );
+    } );
+}
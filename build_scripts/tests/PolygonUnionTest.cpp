@@ -0,0 +1,129 @@
+#include "Test.h"
+#include "utils/PolygonUnion.h"
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+using Corners = std::vector<vr::HmdVector2_t>;
+
+Corners rectangle( float minX, float minZ, float maxX, float maxZ )
+{
+    return { { { minX, minZ } },
+             { { maxX, minZ } },
+             { { maxX, maxZ } },
+             { { minX, maxZ } } };
+}
+
+double area( const Corners& corners )
+{
+    double result = 0.0;
+    for ( size_t i = 0, j = corners.size() - 1; i < corners.size(); j = i++ )
+    {
+        result += static_cast<double>( corners[j].v[0] * corners[i].v[1]
+                                       - corners[i].v[0] * corners[j].v[1] );
+    }
+    return result / 2.0;
+}
+
+// Regular polygon with the given number of corners, clockwise.
+Corners circle( float x, float z, float radius, int count )
+{
+    Corners corners;
+    for ( int i = 0; i < count; i++ )
+    {
+        const float angle = -6.2831853f * static_cast<float>( i )
+                            / static_cast<float>( count );
+        corners.push_back( { { x + radius * std::cos( angle ),
+                               z + radius * std::sin( angle ) } } );
+    }
+    return corners;
+}
+
+} // namespace
+
+TEST_CASE( PolygonUnionOverlapping )
+{
+    // Two rooms overlapping by a meter, one of them clockwise.
+    utils::PolygonUnion polygonUnion;
+    polygonUnion.add( rectangle( 0.0f, 0.0f, 4.0f, 3.0f ) );
+    auto second = rectangle( 3.0f, 1.0f, 6.0f, 4.0f );
+    std::reverse( second.begin(), second.end() );
+    polygonUnion.add( second );
+    const auto outline = polygonUnion.compute();
+    CHECK( polygonUnion.pieces() == 1 );
+    CHECK( outline.size() == 8 );
+    // Counterclockwise.
+    CHECK_NEAR( area( outline ), 12.0 + 9.0 - 2.0, 1e-3 );
+
+    // A room inside another one changes nothing.
+    polygonUnion.clear();
+    polygonUnion.add( rectangle( 0.0f, 0.0f, 4.0f, 3.0f ) );
+    polygonUnion.add( rectangle( 1.0f, 1.0f, 2.0f, 2.0f ) );
+    CHECK_NEAR( area( polygonUnion.compute() ), 12.0, 1e-3 );
+    CHECK( polygonUnion.pieces() == 1 );
+}
+
+TEST_CASE( PolygonUnionTouching )
+{
+    // Sharing part of a wall: one room.
+    utils::PolygonUnion polygonUnion;
+    polygonUnion.add( rectangle( 0.0f, 0.0f, 4.0f, 3.0f ) );
+    polygonUnion.add( rectangle( 4.0f, 1.0f, 6.0f, 2.0f ) );
+    auto outline = polygonUnion.compute();
+    CHECK( polygonUnion.pieces() == 1 );
+    CHECK( outline.size() == 8 );
+    CHECK_NEAR( area( outline ), 14.0, 1e-3 );
+
+    // The same wall: the rooms line up into one rectangle, the corners on
+    // the shared wall stay.
+    polygonUnion.clear();
+    polygonUnion.add( rectangle( 0.0f, 0.0f, 4.0f, 3.0f ) );
+    polygonUnion.add( rectangle( 4.0f, 0.0f, 6.0f, 3.0f ) );
+    outline = polygonUnion.compute();
+    CHECK( polygonUnion.pieces() == 1 );
+    CHECK_NEAR( area( outline ), 18.0, 1e-3 );
+
+    // Only a corner in common: two pieces.
+    polygonUnion.clear();
+    polygonUnion.add( rectangle( 0.0f, 0.0f, 4.0f, 3.0f ) );
+    polygonUnion.add( rectangle( 4.0f, 3.0f, 5.0f, 4.0f ) );
+    outline = polygonUnion.compute();
+    CHECK( polygonUnion.pieces() == 2 );
+    CHECK_NEAR( area( outline ), 12.0, 1e-3 );
+}
+
+TEST_CASE( PolygonUnionSeparate )
+{
+    // Two rooms a meter apart, the largest one is returned.
+    utils::PolygonUnion polygonUnion;
+    polygonUnion.add( rectangle( 0.0f, 0.0f, 2.0f, 2.0f ) );
+    polygonUnion.add( rectangle( 3.0f, 0.0f, 7.0f, 3.0f ) );
+    const auto outline = polygonUnion.compute();
+    CHECK( polygonUnion.pieces() == 2 );
+    CHECK_NEAR( area( outline ), 12.0, 1e-3 );
+
+    // Degenerate polygons are ignored, nothing added gives nothing.
+    polygonUnion.clear();
+    polygonUnion.add( { { { 0.0f, 0.0f } }, { { 1.0f, 1.0f } } } );
+    polygonUnion.add(
+        { { { 0.0f, 0.0f } }, { { 1.0f, 1.0f } }, { { 2.0f, 2.0f } } } );
+    CHECK( polygonUnion.compute().empty() );
+    CHECK( polygonUnion.pieces() == 0 );
+}
+
+BENCHMARK( PolygonUnionThousandEdges )
+{
+    // Two overlapping traced rooms with 500 corners each.
+    const auto first = circle( 0.0f, 0.0f, 2.0f, 500 );
+    const auto second = circle( 1.5f, 0.5f, 2.0f, 500 );
+    utils::PolygonUnion polygonUnion;
+    size_t corners = 0;
+    tests::measure( "union", tests::scaled( 500 ), [&] {
+        polygonUnion.clear();
+        polygonUnion.add( first );
+        polygonUnion.add( second );
+        corners += polygonUnion.compute().size();
+    } );
+    CHECK( corners > 0 );
+}
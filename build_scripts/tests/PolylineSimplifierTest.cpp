@@ -0,0 +1,174 @@
+#include "Test.h"
+#include "utils/PolylineSimplifier.h"
+#include <algorithm>
+#include <cmath>
+#include <random>
+
+namespace
+{
+using Point = utils::PolylineSimplifier::Point;
+
+// Same settings as the boundary tracing of ChaperoneTabController.
+constexpr float k_minDistance = 0.05f;
+constexpr float k_tolerance = 0.05f;
+constexpr size_t k_windowSize = 128;
+
+float segmentDistance( const Point& p, const Point& a, const Point& b )
+{
+    const float ux = b.x - a.x;
+    const float uz = b.z - a.z;
+    const float length = ux * ux + uz * uz;
+    const float t
+        = length > 0.0f
+              ? std::min(
+                  std::max( ( ( p.x - a.x ) * ux + ( p.z - a.z ) * uz )
+                                / length,
+                            0.0f ),
+                  1.0f )
+              : 0.0f;
+    return std::hypot( p.x - a.x - t * ux, p.z - a.z - t * uz );
+}
+
+// Largest distance of a point of the trace to the simplified polyline.
+float maxDeviation( const std::vector<Point>& trace,
+                    const std::vector<Point>& result )
+{
+    float deviation = 0.0f;
+    for ( const auto& p : trace )
+    {
+        float distance = INFINITY;
+        for ( size_t i = 1; i < result.size(); i++ )
+        {
+            distance = std::min(
+                distance, segmentDistance( p, result[i - 1], result[i] ) );
+        }
+        deviation = std::max( deviation, distance );
+    }
+    return deviation;
+}
+
+// Walking around a 4 x 3 m room at 1 m/s, one point per 90 Hz frame with
+// 5 mm of tracking jitter.
+std::vector<Point> walkRoom()
+{
+    const Point corners[] = { { 0.0f, 0.0f },
+                              { 4.0f, 0.0f },
+                              { 4.0f, 3.0f },
+                              { 0.0f, 3.0f },
+                              { 0.0f, 0.0f } };
+    std::mt19937 random( 11 );
+    std::normal_distribution<float> noise( 0.0f, 0.005f );
+    std::vector<Point> trace;
+    for ( size_t i = 1; i < 5; i++ )
+    {
+        const Point& a = corners[i - 1];
+        const Point& b = corners[i];
+        const float length = std::hypot( b.x - a.x, b.z - a.z );
+        const int steps = static_cast<int>( length * 90.0f );
+        for ( int step = 0; step < steps; step++ )
+        {
+            const float t
+                = static_cast<float>( step ) / static_cast<float>( steps );
+            trace.push_back( { a.x + t * ( b.x - a.x ) + noise( random ),
+                               a.z + t * ( b.z - a.z ) + noise( random ) } );
+        }
+    }
+    trace.push_back( corners[0] );
+    return trace;
+}
+
+} // namespace
+
+TEST_CASE( PolylineSimplifierKeepsTheCorners )
+{
+    const auto trace = walkRoom();
+    utils::PolylineSimplifier simplifier(
+        k_minDistance, k_tolerance, k_windowSize );
+    for ( const auto& p : trace )
+    {
+        simplifier.add( p.x, p.z );
+    }
+    const auto& result = simplifier.finish();
+    // The corners, the start twice as the room is closed, and a few more
+    // where a window ended in the middle of a wall.
+    CHECK( result.size() >= 5 );
+    CHECK( result.size() <= 12 );
+    for ( const auto corner : { Point{ 4.0f, 0.0f }, Point{ 4.0f, 3.0f } } )
+    {
+        CHECK( std::any_of( result.begin(), result.end(), [&]( Point p ) {
+            return std::hypot( p.x - corner.x, p.z - corner.z ) < 0.05f;
+        } ) );
+    }
+    // Within the tolerance of every point, twice where a straight window is
+    // shortened.
+    CHECK( maxDeviation( trace, result ) <= 2.0f * k_tolerance );
+}
+
+TEST_CASE( PolylineSimplifierBoundsMemoryOnLongTraces )
+{
+    // 1 km back and forth along a 10 m line, then a zigzag: the straight
+    // part doesn't add vertices for every window.
+    utils::PolylineSimplifier simplifier(
+        k_minDistance, k_tolerance, k_windowSize );
+    std::vector<Point> trace;
+    for ( int i = 0; i < 100 * 900; i++ )
+    {
+        const float s = static_cast<float>( i % 1800 ) / 90.0f;
+        trace.push_back( { s < 10.0f ? s : 20.0f - s, 0.0f } );
+    }
+    for ( int i = 0; i < 200; i++ )
+    {
+        trace.push_back( { static_cast<float>( i ) * 0.5f,
+                           i % 2 == 0 ? 1.0f : 2.0f } );
+    }
+    for ( const auto& p : trace )
+    {
+        simplifier.add( p.x, p.z );
+    }
+    CHECK( simplifier.vertexCount() <= 100 + 200 + 1 );
+    const auto& result = simplifier.finish();
+    CHECK( maxDeviation( trace, result ) <= 2.0f * k_tolerance );
+}
+
+TEST_CASE( PolylineSimplifierDropsShortSteps )
+{
+    utils::PolylineSimplifier simplifier( 0.1f, 0.01f, 3 );
+    // Standing still with jitter, then one step.
+    for ( int i = 0; i < 100; i++ )
+    {
+        simplifier.add( 0.001f * static_cast<float>( i % 7 ), 0.0f );
+    }
+    simplifier.add( 1.0f, 0.0f );
+    const auto& result = simplifier.finish();
+    CHECK( result.size() == 2 );
+    CHECK( result[0].x == 0.0f );
+    CHECK( result[1].x == 1.0f );
+
+    simplifier.reset();
+    CHECK( simplifier.vertexCount() == 0 );
+    CHECK( simplifier.finish().empty() );
+}
+
+BENCHMARK( PolylineSimplifierAdd )
+{
+    const auto trace = walkRoom();
+    utils::PolylineSimplifier simplifier(
+        k_minDistance, k_tolerance, k_windowSize );
+    size_t i = 0;
+    tests::measure( "add", tests::scaled( 5000000 ), [&] {
+        const auto& p = trace[i % trace.size()];
+        simplifier.add( p.x, p.z );
+        if ( ++i % trace.size() == 0 )
+        {
+            simplifier.reset();
+        }
+    } );
+    tests::measure( "trace and finish", tests::scaled( 2000 ), [&] {
+        simplifier.reset();
+        for ( const auto& p : trace )
+        {
+            simplifier.add( p.x, p.z );
+        }
+        simplifier.finish();
+    } );
+}
@@ -0,0 +1,59 @@
+#include "Test.h"
+#include "utils/ProcessMonitor.h"
+#include <atomic>
+#include <thread>
+
+TEST_CASE( ProcessMonitorCountsAllThreads )
+{
+    utils::ProcessMonitor monitor;
+    CHECK( monitor.sample() );
+    CHECK( monitor.count() == 0 );
+
+    // Every sleep is a voluntary context switch of a worker thread. The
+    // workers stay alive until the second sample, counters of exited threads
+    // are gone.
+    constexpr int k_threads = 4;
+    constexpr int k_sleeps = 100;
+    std::atomic<int> finished{ 0 };
+    std::atomic<bool> sampled{ false };
+    const auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> workers;
+    for ( int i = 0; i < k_threads; i++ )
+    {
+        workers.emplace_back( [&] {
+            for ( int j = 0; j < k_sleeps; j++ )
+            {
+                std::this_thread::sleep_for( std::chrono::microseconds( 100 ) );
+            }
+            finished++;
+            while ( !sampled )
+            {
+                std::this_thread::yield();
+            }
+        } );
+    }
+    while ( finished < k_threads )
+    {
+        std::this_thread::sleep_for( std::chrono::milliseconds( 1 ) );
+    }
+    const double seconds = std::chrono::duration<double>(
+                               std::chrono::steady_clock::now() - start )
+                               .count();
+    CHECK( monitor.sample() );
+    sampled = true;
+    for ( auto& worker : workers )
+    {
+        worker.join();
+    }
+
+    CHECK( monitor.count() == 1 );
+    const auto& sample = monitor.latest();
+    CHECK( sample.threads >= 1 + k_threads );
+    CHECK( sample.residentBytes > 0 );
+#ifndef _WIN32
+    // Only the main thread was counted before, it hardly switched at all.
+    CHECK( sample.contextSwitchesPerSecond * seconds
+           >= 0.8 * k_threads * k_sleeps );
+    CHECK( sample.runQueueWaitPercent >= 0.0 );
+#endif
+}
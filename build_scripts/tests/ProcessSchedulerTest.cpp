@@ -0,0 +1,70 @@
+#include "Test.h"
+#include "utils/ProcessScheduler.h"
+#ifndef _WIN32
+#    include <atomic>
+#    include <thread>
+#    include <sched.h>
+#    include <sys/resource.h>
+#    include <sys/syscall.h>
+#    include <unistd.h>
+#endif
+
+TEST_CASE( ProcessSchedulerParsesCoreLists )
+{
+    uint64_t mask = 1;
+    CHECK( utils::ProcessScheduler::parseCoreList( "", mask ) );
+    CHECK( mask == 0 );
+    CHECK( utils::ProcessScheduler::parseCoreList( "0", mask ) );
+    CHECK( mask == 1 );
+    CHECK( !utils::ProcessScheduler::parseCoreList( "1-0", mask ) );
+    CHECK( !utils::ProcessScheduler::parseCoreList( "x", mask ) );
+    CHECK( !utils::ProcessScheduler::parseCoreList( "64", mask ) );
+}
+
+#ifndef _WIN32
+TEST_CASE( ProcessSchedulerLowersNiceValue )
+{
+    // A helper thread that exists when background mode is switched on.
+    std::atomic<long> workerId{ 0 };
+    std::atomic<bool> done{ false };
+    std::thread thread( [&] {
+        workerId = syscall( SYS_gettid );
+        while ( !done )
+        {
+            std::this_thread::sleep_for( std::chrono::milliseconds( 1 ) );
+        }
+    } );
+    while ( workerId == 0 )
+    {
+        std::this_thread::yield();
+    }
+    const auto worker = static_cast<id_t>( workerId.load() );
+    const auto main = static_cast<id_t>( syscall( SYS_gettid ) );
+
+    utils::ProcessScheduler scheduler;
+    CHECK( scheduler.setBackground( true ) );
+    CHECK( getpriority( PRIO_PROCESS, worker ) == 10 );
+    CHECK( sched_getscheduler( static_cast<pid_t>( worker ) ) == SCHED_BATCH );
+
+    rlimit limit{};
+    getrlimit( RLIMIT_NICE, &limit );
+    const bool canRaise = geteuid() == 0 || limit.rlim_cur == RLIM_INFINITY
+                          || limit.rlim_cur >= 20;
+    CHECK( getpriority( PRIO_PROCESS, main ) == ( canRaise ? 10 : 0 ) );
+    scheduler.setLatencyCritical( true );
+    CHECK( getpriority( PRIO_PROCESS, main ) == 0 );
+    scheduler.setLatencyCritical( false );
+    CHECK( getpriority( PRIO_PROCESS, main ) == ( canRaise ? 10 : 0 ) );
+
+    // Without the rights nice 10 can't be undone, it stays in background
+    // mode.
+    CHECK( scheduler.setBackground( false ) == canRaise );
+    CHECK( scheduler.background() == !canRaise );
+    CHECK( sched_getscheduler( static_cast<pid_t>( worker ) ) == SCHED_OTHER );
+    CHECK( getpriority( PRIO_PROCESS, worker ) == ( canRaise ? 0 : 10 ) );
+    CHECK( getpriority( PRIO_PROCESS, main ) == 0 );
+
+    done = true;
+    thread.join();
+}
+#endif
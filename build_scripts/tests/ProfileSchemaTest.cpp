@@ -0,0 +1,401 @@
+#include "Test.h"
+#include "tabcontrollers/AudioTabController.h"
+#include "tabcontrollers/ChaperoneTabController.h"
+#include "tabcontrollers/PttController.h"
+#include "tabcontrollers/SteamVRTabController.h"
+#include <QFile>
+#include <QSettings>
+#include <cstdio>
+#include <string>
+#include <utility>
+
+namespace
+{
+// In the working directory, ctest runs in the build directory.
+constexpr auto k_oldPath = "profiles_old.ini";
+constexpr auto k_newPath = "profiles_new.ini";
+
+// Settings as the hand written profile code left them, before the schemas.
+// The first profile of every array has the interesting values, the second
+// one misses its keys or their flags and has to keep the struct defaults.
+constexpr auto k_oldIni = R"([audioSettings]
+pttProfiles\1\profileName=quiet
+pttProfiles\1\showNotification=false
+pttProfiles\1\leftControllerEnabled=true
+pttProfiles\1\triggerMode_1=1
+pttProfiles\1\touchpadMode_1=3
+pttProfiles\1\touchPadAreas_1=5
+pttProfiles\2\profileName=defaults
+pttProfiles\size=2
+audioProfiles\1\profileName=headset
+audioProfiles\1\playbackName=Speakers
+audioProfiles\1\micName=Headset Mic
+audioProfiles\1\micMute=true
+audioProfiles\1\micVol=0.25
+audioProfiles\1\mirrorVol=0.75
+audioProfiles\1\defaultProfile=true
+audioProfiles\2\profileName=defaults
+audioProfiles\size=2
+
+[steamVRSettings]
+steamVRProfiles\1\profileName=sharp
+steamVRProfiles\1\includesSupersampling=true
+steamVRProfiles\1\supersamplingOverride=true
+steamVRProfiles\1\supersampling=1.5
+steamVRProfiles\1\includesSupersampleFiltering=false
+steamVRProfiles\1\supersampleFiltering=false
+steamVRProfiles\1\includesMotionSmoothing=true
+steamVRProfiles\1\motionSmooth=false
+steamVRProfiles\2\profileName=defaults
+steamVRProfiles\size=2
+
+[chaperoneSettings]
+chaperoneProfiles\1\profileName=close
+chaperoneProfiles\1\includesFadeDistance=true
+chaperoneProfiles\1\fadeDistance=0.3
+chaperoneProfiles\1\includesProximityWarningSettings=true
+chaperoneProfiles\1\chaperoneSwitchToBeginnerEnabled=true
+chaperoneProfiles\1\chaperoneSwitchToBeginnerDistance=0.2
+chaperoneProfiles\1\chaperoneHapticFeedbackDistance=0.1
+chaperoneProfiles\1\chaperoneAlarmSoundDistance=0.4
+chaperoneProfiles\1\chaperoneShowDashboardDistance=0.6
+chaperoneProfiles\2\profileName=gated
+chaperoneProfiles\2\fadeDistance=0.3
+chaperoneProfiles\2\chaperoneAlarmSoundDistance=0.4
+chaperoneProfiles\size=2
+)";
+
+void writeOldIni()
+{
+    QFile::remove( k_newPath );
+    std::FILE* file = std::fopen( k_oldPath, "w" );
+    CHECK( file != nullptr );
+    std::fputs( k_oldIni, file );
+    std::fclose( file );
+}
+
+// Reads every array of a settings file, writes it to k_newPath and reads it
+// back from there.
+template <typename Schema>
+auto roundTrip( const Schema& schema, const char* group, const char* array )
+{
+    QSettings oldSettings( k_oldPath, QSettings::IniFormat );
+    const auto profiles = schema.readIniArray( oldSettings, group, array );
+    {
+        QSettings newSettings( k_newPath, QSettings::IniFormat );
+        schema.writeIniArray( newSettings, group, array, profiles );
+    }
+    QSettings newSettings( k_newPath, QSettings::IniFormat );
+    CHECK( newSettings.value( QString( group ) + "/" + array + "Version" )
+               .toUInt()
+           == schema.version );
+    return std::make_pair( profiles,
+                           schema.readIniArray( newSettings, group, array ) );
+}
+
+// A profile whose "volume" key was renamed in version 2.
+struct RenamedProfile
+{
+    std::string name;
+    float level = 1.0f;
+};
+
+void migrateRenamedProfile( QSettings& settings,
+                            RenamedProfile& profile,
+                            quint32 storedVersion )
+{
+    if ( storedVersion < 2 )
+    {
+        profile.level = settings.value( "volume", profile.level ).toFloat();
+    }
+}
+
+constexpr auto k_renamedSchema
+    = utils::profileSchema<RenamedProfile>(
+          2,
+          utils::profileField( "name", &RenamedProfile::name ),
+          utils::profileField( "level", &RenamedProfile::level ) )
+          .withMigration( &migrateRenamedProfile );
+
+// AudioTabController's reloadAudioProfiles() and saveAudioProfiles() as they
+// were before the schemas, to compare the generated code against.
+std::vector<advsettings::AudioProfile> handWrittenRead( QSettings& settings )
+{
+    std::vector<advsettings::AudioProfile> audioProfiles;
+    settings.beginGroup( "audioSettings" );
+    auto profileCount = settings.beginReadArray( "audioProfiles" );
+    for ( int i = 0; i < profileCount; i++ )
+    {
+        settings.setArrayIndex( i );
+        audioProfiles.emplace_back();
+        auto& entry = audioProfiles[static_cast<size_t>( i )];
+        entry.profileName
+            = settings.value( "profileName" ).toString().toStdString();
+        entry.playbackName
+            = settings.value( "playbackName" ).toString().toStdString();
+        entry.micName = settings.value( "micName" ).toString().toStdString();
+        entry.mirrorName
+            = settings.value( "mirrorName" ).toString().toStdString();
+        entry.micMute = settings.value( "micMute", false ).toBool();
+        entry.mirrorMute = settings.value( "mirrorMute", false ).toBool();
+        entry.mirrorVol = settings.value( "mirrorVol", 0.0 ).toFloat();
+        entry.micVol = settings.value( "micVol", 1.0 ).toFloat();
+        entry.defaultProfile
+            = settings.value( "defaultProfile", false ).toBool();
+    }
+    settings.endArray();
+    settings.endGroup();
+    return audioProfiles;
+}
+
+void handWrittenWrite( QSettings& settings,
+                       const std::vector<advsettings::AudioProfile>& profiles )
+{
+    settings.beginGroup( "audioSettings" );
+    settings.beginWriteArray( "audioProfiles" );
+    int i = 0;
+    for ( auto& p : profiles )
+    {
+        settings.setArrayIndex( i );
+        settings.setValue( "profileName",
+                           QString::fromStdString( p.profileName ) );
+        settings.setValue( "playbackName",
+                           QString::fromStdString( p.playbackName ) );
+        settings.setValue( "micName", QString::fromStdString( p.micName ) );
+        settings.setValue( "mirrorName",
+                           QString::fromStdString( p.mirrorName ) );
+        settings.setValue( "micMute", p.micMute );
+        settings.setValue( "mirrorMute", p.mirrorMute );
+        settings.setValue( "micVol", p.micVol );
+        settings.setValue( "mirrorVol", p.mirrorVol );
+        settings.setValue( "defaultProfile", p.defaultProfile );
+        i++;
+    }
+    settings.endArray();
+    settings.endGroup();
+}
+
+std::vector<advsettings::AudioProfile> syntheticAudioProfiles( size_t count )
+{
+    std::vector<advsettings::AudioProfile> profiles( count );
+    for ( size_t i = 0; i < count; i++ )
+    {
+        auto& profile = profiles[i];
+        profile.profileName = "profile " + std::to_string( i );
+        profile.playbackName = "Speakers " + std::to_string( i % 7 );
+        profile.mirrorName = i % 3 == 0 ? "Headphones" : "";
+        profile.micName = "Headset Mic " + std::to_string( i % 5 );
+        profile.mirrorVol = static_cast<float>( i % 100 ) / 100.0f;
+        profile.micVol = static_cast<float>( i % 50 ) / 50.0f;
+        profile.micMute = i % 2 == 0;
+        profile.mirrorMute = i % 4 == 0;
+        profile.defaultProfile = i == 0;
+    }
+    return profiles;
+}
+
+} // namespace
+
+TEST_CASE( ProfileSchemaReadsOldPttProfiles )
+{
+    writeOldIni();
+    const auto [read, again]
+        = roundTrip( advsettings::ptt_profile::k_schema,
+                     "audioSettings",
+                     "pttProfiles" );
+    for ( const auto* profiles : { &read, &again } )
+    {
+        CHECK( profiles->size() == 2 );
+        const auto& quiet = ( *profiles )[0];
+        CHECK( quiet.profileName == "quiet" );
+        CHECK( !quiet.showNotification );
+        CHECK( quiet.leftControllerEnabled );
+        CHECK( !quiet.rightControllerEnabled );
+        CHECK( quiet.controllerConfigs[0].triggerMode == 0 );
+        CHECK( quiet.controllerConfigs[1].triggerMode == 1 );
+        CHECK( quiet.controllerConfigs[1].touchpadMode == 3 );
+        CHECK( quiet.controllerConfigs[1].touchpadAreas == 5 );
+        // A missing key keeps the default.
+        CHECK( ( *profiles )[1].showNotification );
+    }
+    QFile::remove( k_oldPath );
+    QFile::remove( k_newPath );
+}
+
+TEST_CASE( ProfileSchemaReadsOldAudioProfiles )
+{
+    writeOldIni();
+    const auto [read, again]
+        = roundTrip( advsettings::audio_profile::k_schema,
+                     "audioSettings",
+                     "audioProfiles" );
+    for ( const auto* profiles : { &read, &again } )
+    {
+        CHECK( profiles->size() == 2 );
+        const auto& headset = ( *profiles )[0];
+        CHECK( headset.profileName == "headset" );
+        CHECK( headset.playbackName == "Speakers" );
+        CHECK( headset.micName == "Headset Mic" );
+        CHECK( headset.mirrorName.empty() );
+        CHECK( headset.micMute );
+        CHECK( !headset.mirrorMute );
+        CHECK_NEAR( headset.micVol, 0.25f, 1e-6f );
+        CHECK_NEAR( headset.mirrorVol, 0.75f, 1e-6f );
+        CHECK( headset.defaultProfile );
+        const auto& defaults = ( *profiles )[1];
+        CHECK_NEAR( defaults.micVol, 1.0f, 1e-6f );
+        CHECK_NEAR( defaults.mirrorVol, 0.0f, 1e-6f );
+        CHECK( !defaults.defaultProfile );
+    }
+    QFile::remove( k_oldPath );
+    QFile::remove( k_newPath );
+}
+
+TEST_CASE( ProfileSchemaReadsOldSteamVRProfiles )
+{
+    writeOldIni();
+    const auto [read, again]
+        = roundTrip( advsettings::steamvr_profile::k_schema,
+                     "steamVRSettings",
+                     "steamVRProfiles" );
+    for ( const auto* profiles : { &read, &again } )
+    {
+        CHECK( profiles->size() == 2 );
+        const auto& sharp = ( *profiles )[0];
+        CHECK( sharp.includesSupersampling );
+        CHECK( sharp.supersampleOverride );
+        CHECK_NEAR( sharp.supersampling, 1.5f, 1e-6f );
+        // Values behind a cleared flag aren't read.
+        CHECK( !sharp.includesSupersampleFiltering );
+        CHECK( sharp.supersampleFiltering );
+        CHECK( sharp.includesMotionSmoothing );
+        CHECK( !sharp.motionSmooth );
+        const auto& defaults = ( *profiles )[1];
+        CHECK( !defaults.includesSupersampling );
+        CHECK( !defaults.includesMotionSmoothing );
+        CHECK_NEAR( defaults.supersampling, 1.0f, 1e-6f );
+    }
+    QFile::remove( k_oldPath );
+    QFile::remove( k_newPath );
+}
+
+TEST_CASE( ProfileSchemaReadsOldChaperoneProfiles )
+{
+    writeOldIni();
+    const auto [read, again]
+        = roundTrip( advsettings::chaperone_profile::k_schema,
+                     "chaperoneSettings",
+                     "chaperoneProfiles" );
+    for ( const auto* profiles : { &read, &again } )
+    {
+        CHECK( profiles->size() == 2 );
+        const auto& close = ( *profiles )[0];
+        CHECK( close.includesFadeDistance );
+        CHECK_NEAR( close.fadeDistance, 0.3f, 1e-6f );
+        CHECK( close.includesProximityWarningSettings );
+        CHECK( close.enableChaperoneSwitchToBeginner );
+        CHECK_NEAR( close.chaperoneSwitchToBeginnerDistance, 0.2f, 1e-6f );
+        CHECK_NEAR( close.chaperoneHapticFeedbackDistance, 0.1f, 1e-6f );
+        CHECK_NEAR( close.chaperoneAlarmSoundDistance, 0.4f, 1e-6f );
+        CHECK_NEAR( close.chaperoneShowDashboardDistance, 0.6f, 1e-6f );
+        CHECK( !close.includesChaperoneGeometry );
+        // Without their flags the distances keep the defaults.
+        const auto& gated = ( *profiles )[1];
+        CHECK( !gated.includesFadeDistance );
+        CHECK_NEAR( gated.fadeDistance, 0.7f, 1e-6f );
+        CHECK_NEAR( gated.chaperoneAlarmSoundDistance, 0.5f, 1e-6f );
+    }
+    QFile::remove( k_oldPath );
+    QFile::remove( k_newPath );
+}
+
+TEST_CASE( ProfileSchemaMigratesOlderArrays )
+{
+    QFile::remove( k_oldPath );
+    {
+        // Version 1 had "volume", the hand written code had no version.
+        QSettings settings( k_oldPath, QSettings::IniFormat );
+        for ( const auto* array : { "v1", "unversioned" } )
+        {
+            settings.beginGroup( "test" );
+            if ( std::string( array ) == "v1" )
+            {
+                settings.setValue( "v1Version", 1 );
+            }
+            settings.beginWriteArray( array );
+            settings.setArrayIndex( 0 );
+            settings.setValue( "name", "old" );
+            settings.setValue( "volume", 0.5f );
+            settings.endArray();
+            settings.endGroup();
+        }
+    }
+    QSettings settings( k_oldPath, QSettings::IniFormat );
+    for ( const auto* array : { "v1", "unversioned" } )
+    {
+        const auto profiles
+            = k_renamedSchema.readIniArray( settings, "test", array );
+        CHECK( profiles.size() == 1 );
+        CHECK( profiles[0].name == "old" );
+        CHECK_NEAR( profiles[0].level, 0.5f, 1e-6f );
+    }
+
+    // Written as version 2 it isn't migrated again.
+    auto profiles = k_renamedSchema.readIniArray( settings, "test", "v1" );
+    profiles[0].level = 0.25f;
+    k_renamedSchema.writeIniArray( settings, "test", "v1", profiles );
+    settings.setValue( "test/v1/1/volume", 0.75f );
+    profiles = k_renamedSchema.readIniArray( settings, "test", "v1" );
+    CHECK( settings.value( "test/v1Version" ).toUInt() == 2 );
+    CHECK_NEAR( profiles[0].level, 0.25f, 1e-6f );
+
+    // A schema without a migration only reads the fields.
+    CHECK( advsettings::audio_profile::k_schema.migration == nullptr );
+    QFile::remove( k_oldPath );
+}
+
+BENCHMARK( ProfileSchemaAgainstHandWrittenCode )
+{
+    // Thousands of audio profiles, read back from the file like at startup.
+    const auto profiles = syntheticAudioProfiles( 5000 );
+    const auto& schema = advsettings::audio_profile::k_schema;
+    QFile::remove( k_oldPath );
+    QFile::remove( k_newPath );
+    {
+        QSettings settings( k_oldPath, QSettings::IniFormat );
+        tests::measure( "write hand written", tests::scaled( 5 ), [&] {
+            handWrittenWrite( settings, profiles );
+        } );
+    }
+    {
+        QSettings settings( k_newPath, QSettings::IniFormat );
+        tests::measure( "write generated", tests::scaled( 5 ), [&] {
+            schema.writeIniArray(
+                settings, "audioSettings", "audioProfiles", profiles );
+        } );
+    }
+
+    QSettings settings( k_newPath, QSettings::IniFormat );
+    size_t readCount = 0;
+    tests::measure( "read hand written", tests::scaled( 5 ), [&] {
+        readCount = handWrittenRead( settings ).size();
+    } );
+    CHECK( readCount == profiles.size() );
+    std::vector<advsettings::AudioProfile> read;
+    tests::measure( "read generated", tests::scaled( 5 ), [&] {
+        read = schema.readIniArray(
+            settings, "audioSettings", "audioProfiles" );
+    } );
+    CHECK( read.size() == profiles.size() );
+    // Both read the same values.
+    const auto handWritten = handWrittenRead( settings );
+    for ( size_t i = 0; i < read.size(); i++ )
+    {
+        CHECK( read[i].profileName == handWritten[i].profileName );
+        CHECK( read[i].mirrorName == handWritten[i].mirrorName );
+        CHECK( read[i].micVol == handWritten[i].micVol );
+        CHECK( read[i].micMute == handWritten[i].micMute );
+    }
+    QFile::remove( k_oldPath );
+    QFile::remove( k_newPath );
+}
@@ -0,0 +1,162 @@
+#include "Test.h"
+#include "StubSystem.h"
+#include "utils/ProximityMute.h"
+
+namespace
+{
+using Clock = utils::ProximityMute::Clock;
+
+constexpr auto k_delay = std::chrono::milliseconds( 250 );
+// 90 Hz frames.
+constexpr auto k_frame = std::chrono::microseconds( 11111 );
+
+// AudioTabController's event loop with the proximity mute on: the sensor is
+// read every tick, then the microphone follows a settled change.
+struct EventLoop
+{
+    utils::ProximityMute proximityMute;
+    bool micMuted = false;
+    int frame = 0;
+    int lastChangeFrame = -1;
+
+    Clock::time_point now() const
+    {
+        return Clock::time_point() + frame * k_frame;
+    }
+
+    void tick()
+    {
+        proximityMute.poll( now() );
+        bool mute = false;
+        if ( proximityMute.update( now(), k_delay, micMuted, mute ) )
+        {
+            micMuted = mute;
+            lastChangeFrame = frame;
+        }
+        frame++;
+    }
+
+    void run( int frames )
+    {
+        for ( int i = 0; i < frames; i++ )
+        {
+            tick();
+        }
+    }
+};
+
+vr::VREvent_t sensorEvent( bool pressed )
+{
+    vr::VREvent_t event = {};
+    event.eventType
+        = pressed ? vr::VREvent_ButtonPress : vr::VREvent_ButtonUnpress;
+    event.trackedDeviceIndex = vr::k_unTrackedDeviceIndex_Hmd;
+    event.data.controller.button = vr::k_EButton_ProximitySensor;
+    return event;
+}
+
+// Frames the delay takes, rounded up.
+constexpr int k_delayFrames = static_cast<int>(
+    ( k_delay.count() * 1000 + k_frame.count() - 1 ) / k_frame.count() );
+
+} // namespace
+
+TEST_CASE( ProximityMuteWithoutEvents )
+{
+    auto& system = tests::stubSystem();
+    system.reset();
+    system.setProximitySensor( true );
+
+    EventLoop loop;
+    loop.run( 100 );
+    CHECK( !loop.micMuted );
+    CHECK( system.controllerStateReads == 100 );
+
+    // Taken off, the event never arrives.
+    system.setProximitySensor( false );
+    const int offFrame = loop.frame;
+    loop.run( k_delayFrames + 1 );
+    CHECK( loop.micMuted );
+    CHECK( loop.lastChangeFrame == offFrame + k_delayFrames );
+
+    // Put on again, unmuted as late.
+    system.setProximitySensor( true );
+    const int onFrame = loop.frame;
+    loop.run( 100 );
+    CHECK( !loop.micMuted );
+    CHECK( loop.lastChangeFrame == onFrame + k_delayFrames );
+}
+
+TEST_CASE( ProximityMuteEventsAndPollsAgree )
+{
+    auto& system = tests::stubSystem();
+    system.reset();
+    system.setProximitySensor( true );
+
+    EventLoop loop;
+    loop.run( 10 );
+
+    // The event is handled before the tick reads the same state, the reads
+    // don't restart the delay.
+    system.setProximitySensor( false );
+    loop.proximityMute.handleEvent( sensorEvent( false ), loop.now() );
+    const int eventFrame = loop.frame;
+    loop.run( k_delayFrames );
+    CHECK( !loop.micMuted );
+    loop.run( 1 );
+    CHECK( loop.micMuted );
+    CHECK( loop.lastChangeFrame == eventFrame + k_delayFrames );
+
+    // Flicker shorter than the delay changes nothing.
+    system.setProximitySensor( true );
+    loop.run( 3 );
+    system.setProximitySensor( false );
+    loop.run( 100 );
+    CHECK( loop.micMuted );
+    CHECK( loop.lastChangeFrame == eventFrame + k_delayFrames );
+
+    // Other buttons and devices are ignored.
+    auto other = sensorEvent( true );
+    other.data.controller.button = vr::k_EButton_System;
+    loop.proximityMute.handleEvent( other, loop.now() );
+    other = sensorEvent( true );
+    other.trackedDeviceIndex = 1;
+    loop.proximityMute.handleEvent( other, loop.now() );
+    loop.run( 100 );
+    CHECK( loop.micMuted );
+}
+
+TEST_CASE( ProximityMuteForgetsUnreadableSensor )
+{
+    auto& system = tests::stubSystem();
+    system.reset();
+    system.setProximitySensor( true );
+
+    EventLoop loop;
+    loop.run( 10 );
+    CHECK( loop.proximityMute.isKnown() );
+
+    system.hmdStateValid = false;
+    loop.run( 10 );
+    CHECK( !loop.proximityMute.isKnown() );
+    CHECK( !loop.micMuted );
+
+    // Back without the headset on, the first state counts as a change.
+    system.hmdStateValid = true;
+    system.setProximitySensor( false );
+    const int backFrame = loop.frame;
+    loop.run( 100 );
+    CHECK( loop.micMuted );
+    CHECK( loop.lastChangeFrame == backFrame + k_delayFrames );
+}
+
+BENCHMARK( ProximityMuteTick )
+{
+    auto& system = tests::stubSystem();
+    system.reset();
+    system.setProximitySensor( true );
+    EventLoop loop;
+    tests::measure(
+        "poll and update", tests::scaled( 1000000 ), [&] { loop.tick(); } );
+    CHECK( !loop.micMuted );
+}
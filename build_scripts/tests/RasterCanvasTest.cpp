@@ -0,0 +1,184 @@
+#include "Test.h"
+#include "StubOverlay.h"
+#include "utils/RasterCanvas.h"
+#include <cstdio>
+
+namespace
+{
+// Same layout as the performance HUD of StatisticsTabController.
+constexpr unsigned k_hudWidth = 160;
+constexpr unsigned k_hudHeight = 100;
+constexpr unsigned k_hudHistorySize = 64;
+// What the HUD may cost per update, it is drawn on the event loop thread.
+constexpr double k_hudBudgetMilliseconds = 0.1;
+
+uint32_t pixel( const utils::RasterCanvas& canvas, unsigned x, unsigned y )
+{
+    const uint8_t* p = canvas.data() + ( y * canvas.width() + x ) * 4;
+    return static_cast<uint32_t>( p[0] ) << 24
+           | static_cast<uint32_t>( p[1] ) << 16
+           | static_cast<uint32_t>( p[2] ) << 8 | p[3];
+}
+
+unsigned countPixels( const utils::RasterCanvas& canvas, uint32_t color )
+{
+    unsigned count = 0;
+    for ( unsigned y = 0; y < canvas.height(); y++ )
+    {
+        for ( unsigned x = 0; x < canvas.width(); x++ )
+        {
+            count += pixel( canvas, x, y ) == color ? 1 : 0;
+        }
+    }
+    return count;
+}
+
+// One update of the performance HUD, see
+// StatisticsTabController::updatePerformanceHud().
+void drawHud( utils::RasterCanvas& canvas,
+              const float* history,
+              vr::VROverlayHandle_t handle )
+{
+    char line[32];
+    int y = 4;
+    canvas.clear( 0x000000C0 );
+    std::snprintf( line, sizeof( line ), "FRAME %6.2f MS", 8.25 );
+    canvas.drawText( 4, y, line, 0xFFFFFFFF );
+    y += 10;
+    std::snprintf( line, sizeof( line ), "REPROJ %5.1f%%", 2.5 );
+    canvas.drawText( 4, y, line, 0xFFFFFFFF );
+    y += 10;
+    std::snprintf( line, sizeof( line ), "DROPPED %u", 3u );
+    canvas.drawText( 4, y, line, 0xFFFFFFFF );
+    y += 10;
+    std::snprintf( line, sizeof( line ), "OVERLAY %5.2f MS", 0.42 );
+    canvas.drawText( 4, y, line, 0xFFFFFFFF );
+    y += 10;
+    std::snprintf( line, sizeof( line ), "HUD %6.3f MS", 0.012 );
+    canvas.drawText( 4, y, line, 0xFFFFFFFF );
+    canvas.drawBars( 4,
+                     56,
+                     static_cast<int>( k_hudWidth ) - 8,
+                     40,
+                     history,
+                     k_hudHistorySize,
+                     22.2f,
+                     0x40C040FF );
+    canvas.fillRect( 4, 76, static_cast<int>( k_hudWidth ) - 8, 1, 0xFFA000FF );
+    canvas.upload( handle );
+}
+
+} // namespace
+
+TEST_CASE( RasterCanvasClipsToTheCanvas )
+{
+    utils::RasterCanvas canvas( 8, 6 );
+    canvas.clear( 0x11223344 );
+    CHECK( countPixels( canvas, 0x11223344 ) == 48 );
+    CHECK( pixel( canvas, 0, 0 ) == 0x11223344 );
+
+    // Partly outside on every side.
+    canvas.fillRect( -3, -2, 5, 4, 0xFF0000FF );
+    CHECK( countPixels( canvas, 0xFF0000FF ) == 2 * 2 );
+    canvas.fillRect( 6, 4, 10, 10, 0x00FF00FF );
+    CHECK( countPixels( canvas, 0x00FF00FF ) == 2 * 2 );
+    CHECK( pixel( canvas, 7, 5 ) == 0x00FF00FF );
+    // Fully outside or empty.
+    canvas.fillRect( 8, 0, 4, 4, 0x0000FFFF );
+    canvas.fillRect( 0, -5, 4, 5, 0x0000FFFF );
+    canvas.fillRect( 2, 2, 0, 3, 0x0000FFFF );
+    CHECK( countPixels( canvas, 0x0000FFFF ) == 0 );
+
+    // A circle larger than the canvas covers all of it.
+    canvas.fillCircle( 4, 3, 20, 0xFFFFFFFF );
+    CHECK( countPixels( canvas, 0xFFFFFFFF ) == 48 );
+
+    // Shrinking keeps the allocation, drawing uses the new size.
+    canvas.resize( 4, 4 );
+    CHECK( canvas.width() == 4 && canvas.height() == 4 );
+    canvas.clear( 0 );
+    CHECK( countPixels( canvas, 0 ) == 16 );
+}
+
+TEST_CASE( RasterCanvasDrawsText )
+{
+    utils::RasterCanvas canvas( 64, 16 );
+    canvas.clear( 0 );
+    CHECK( canvas.drawText( 1, 1, "I", 0xFFFFFFFF ) == 1 + 6 );
+    // A vertical bar of 7 with serifs of one pixel on both sides.
+    CHECK( countPixels( canvas, 0xFFFFFFFF ) == 2 + 7 + 2 );
+    CHECK( pixel( canvas, 1 + 2, 1 ) == 0xFFFFFFFF );
+    CHECK( pixel( canvas, 1 + 2, 7 ) == 0xFFFFFFFF );
+    CHECK( pixel( canvas, 1 + 2, 8 ) == 0 );
+
+    // Lower case is drawn as upper case, unknown characters as '?'.
+    utils::RasterCanvas upper( 64, 16 );
+    utils::RasterCanvas lower( 64, 16 );
+    upper.clear( 0 );
+    lower.clear( 0 );
+    upper.drawText( 0, 0, "HUD?", 0xFFFFFFFF, 2 );
+    lower.drawText( 0, 0, "hud~", 0xFFFFFFFF, 2 );
+    CHECK( countPixels( upper, 0xFFFFFFFF ) > 0 );
+    CHECK( countPixels( upper, 0xFFFFFFFF )
+           == countPixels( lower, 0xFFFFFFFF ) );
+    CHECK( utils::RasterCanvas::textWidth( "HUD?", 2 ) == 4 * 6 * 2 );
+
+    // Text running off the right edge is clipped.
+    canvas.clear( 0 );
+    const int end = canvas.drawText( 60, 0, "WWW", 0xFFFFFFFF );
+    CHECK( end == 60 + 3 * 6 );
+    CHECK( countPixels( canvas, 0xFFFFFFFF ) > 0 );
+}
+
+TEST_CASE( RasterCanvasDrawsBars )
+{
+    utils::RasterCanvas canvas( 40, 10 );
+    canvas.clear( 0 );
+    // Negative and too large values are clamped.
+    const float values[] = { -1.0f, 2.5f, 5.0f, 50.0f };
+    canvas.drawBars( 0, 0, 40, 10, values, 4, 5.0f, 0xFFFFFFFF );
+    CHECK( countPixels( canvas, 0xFFFFFFFF ) == ( 0 + 5 + 10 + 10 ) * 10 );
+    // Bars grow from the bottom.
+    CHECK( pixel( canvas, 10, 9 ) == 0xFFFFFFFF );
+    CHECK( pixel( canvas, 10, 4 ) == 0 );
+
+    // Nothing for an empty range.
+    canvas.clear( 0 );
+    canvas.drawBars( 0, 0, 40, 10, values, 4, 0.0f, 0xFFFFFFFF );
+    CHECK( countPixels( canvas, 0xFFFFFFFF ) == 0 );
+}
+
+TEST_CASE( RasterCanvasUploadsTheWholeBuffer )
+{
+    auto& overlay = tests::stubOverlay();
+    overlay.reset();
+    vr::VROverlayHandle_t handle = vr::k_ulOverlayHandleInvalid;
+    overlay.CreateOverlay( "test.hud", "test.hud", &handle );
+    utils::RasterCanvas canvas( k_hudWidth, k_hudHeight );
+    float history[k_hudHistorySize] = {};
+    drawHud( canvas, history, handle );
+    CHECK( overlay.uploads == 1 );
+    CHECK( overlay.uploadedBytes == k_hudWidth * k_hudHeight * 4 );
+    overlay.DestroyOverlay( handle );
+}
+
+BENCHMARK( RasterCanvasHud )
+{
+    auto& overlay = tests::stubOverlay();
+    overlay.reset();
+    vr::VROverlayHandle_t handle = vr::k_ulOverlayHandleInvalid;
+    overlay.CreateOverlay( "test.hud", "test.hud", &handle );
+    utils::RasterCanvas canvas( k_hudWidth, k_hudHeight );
+    float history[k_hudHistorySize];
+    for ( unsigned i = 0; i < k_hudHistorySize; i++ )
+    {
+        history[i] = 6.0f + static_cast<float>( i % 13 );
+    }
+    // Upload to the stub, what the compositor does with it isn't counted.
+    const double seconds = tests::measure(
+        "compose", tests::scaled( 20000 ), [&] {
+            drawHud( canvas, history, handle );
+        } );
+    CHECK( seconds * 1e3 < k_hudBudgetMilliseconds );
+    overlay.DestroyOverlay( handle );
+}
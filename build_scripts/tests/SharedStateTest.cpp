@@ -0,0 +1,216 @@
+#include "Test.h"
+#include "utils/SharedState.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+namespace
+{
+// Every field the test looks at is derived from the index of the frame, a
+// frame mixed from two publishes has fields that don't agree. publish()
+// counts the index up, frameIndex is the one of the next frame.
+void fill( utils::SharedStateFrame& frame, uint64_t frameIndex )
+{
+    const auto value = static_cast<int32_t>( frameIndex % 1000000 );
+    frame.timeMicroseconds = value;
+    frame.universeOffset[0] = static_cast<float>( value );
+    frame.presentedFrames = static_cast<uint32_t>( value );
+    frame.poseCount = utils::k_sharedStateMaxPoses;
+    for ( auto& pose : frame.poses )
+    {
+        pose.trackingResult = value;
+    }
+}
+
+bool isConsistent( const utils::SharedStateFrame& frame )
+{
+    const auto value = static_cast<int32_t>( frame.frameIndex % 1000000 );
+    if ( frame.timeMicroseconds != value
+         || frame.universeOffset[0] != static_cast<float>( value )
+         || frame.presentedFrames != static_cast<uint32_t>( value ) )
+    {
+        return false;
+    }
+    for ( const auto& pose : frame.poses )
+    {
+        if ( pose.trackingResult != value )
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+struct Throughput
+{
+    uint64_t published = 0;
+    uint64_t reads = 0;
+    uint64_t failedReads = 0;
+    uint64_t tornReads = 0;
+    double seconds = 0.0;
+};
+
+// One writer publishing as fast as it can, the worst case for the readers,
+// or at 90 Hz, and reader threads copying whole frames meanwhile.
+Throughput run( unsigned readers,
+                std::chrono::milliseconds duration,
+                bool fullSpeed )
+{
+    utils::SharedStateWriter writer;
+    CHECK( writer.open() );
+    fill( writer.frame(), 1 );
+    writer.publish();
+
+    std::atomic<bool> stop{ false };
+    std::atomic<uint64_t> reads{ 0 };
+    std::atomic<uint64_t> failedReads{ 0 };
+    std::atomic<uint64_t> tornReads{ 0 };
+    std::vector<std::thread> threads;
+    for ( unsigned i = 0; i < readers; i++ )
+    {
+        threads.emplace_back( [&] {
+            utils::SharedStateReader reader;
+            if ( !reader.open() )
+            {
+                failedReads++;
+                return;
+            }
+            utils::SharedStateFrame frame;
+            uint64_t count = 0;
+            while ( !stop.load( std::memory_order_relaxed ) )
+            {
+                if ( !reader.read( frame ) )
+                {
+                    failedReads++;
+                }
+                else if ( !isConsistent( frame ) )
+                {
+                    tornReads++;
+                }
+                count++;
+            }
+            reads += count;
+        } );
+    }
+
+    Throughput result;
+    const auto start = std::chrono::steady_clock::now();
+    auto next = start;
+    while ( std::chrono::steady_clock::now() - start < duration )
+    {
+        fill( writer.frame(), writer.frame().frameIndex + 1 );
+        writer.publish();
+        result.published++;
+        if ( !fullSpeed )
+        {
+            next += std::chrono::microseconds( 11111 );
+            std::this_thread::sleep_until( next );
+        }
+    }
+    stop = true;
+    for ( auto& thread : threads )
+    {
+        thread.join();
+    }
+    result.seconds = std::chrono::duration<double>(
+                         std::chrono::steady_clock::now() - start )
+                         .count();
+    result.reads = reads;
+    result.failedReads = failedReads;
+    result.tornReads = tornReads;
+    writer.close();
+    return result;
+}
+
+} // namespace
+
+TEST_CASE( SharedStateRoundTrip )
+{
+    utils::SharedStateWriter writer;
+    CHECK( writer.open() );
+    utils::SharedStateReader reader;
+    CHECK( reader.open() );
+    utils::SharedStateFrame frame;
+    // Nothing published yet.
+    CHECK( !reader.read( frame ) );
+
+    writer.frame().universeOffset[1] = 1.5f;
+    writer.frame().poseCount = 2;
+    writer.frame().poses[1].poseIsValid = 1;
+    writer.publish();
+    CHECK( reader.read( frame ) );
+    CHECK( frame.frameIndex == 1 );
+    CHECK( frame.universeOffset[1] == 1.5f );
+    CHECK( frame.poses[1].poseIsValid == 1 );
+
+    // Zero copy, a publish in between is noticed.
+    auto sequence = reader.beginRead();
+    CHECK( reader.frame().frameIndex == 1 );
+    CHECK( reader.endRead( sequence ) );
+    sequence = reader.beginRead();
+    writer.publish();
+    CHECK( !reader.endRead( sequence ) );
+
+    // Readers that still have it mapped keep the last frame.
+    writer.close();
+    CHECK( reader.read( frame ) );
+    CHECK( frame.frameIndex == 2 );
+    utils::SharedStateReader late;
+    CHECK( !late.open() );
+}
+
+TEST_CASE( SharedStateReadersNeverSeeTornFrames )
+{
+    const auto result = run( 3, std::chrono::milliseconds( 300 ), true );
+    CHECK( result.published > 1000 );
+    CHECK( result.reads > 1000 );
+    CHECK( result.tornReads == 0 );
+    // Even with the writer never pausing, almost every read gets a frame.
+    CHECK( result.failedReads * 100 < result.reads );
+}
+
+BENCHMARK( SharedStateSeqlockThroughput )
+{
+    const auto duration = std::chrono::milliseconds( tests::scaled( 1000 ) );
+    for ( const bool fullSpeed : { false, true } )
+    {
+        for ( const unsigned readers : { 1u, 4u } )
+        {
+            const auto result = run( readers, duration, fullSpeed );
+            std::printf( "    writer at %s, %u readers: %.0f publishes/s, "
+                         "%.0f reads/s, %.4f %% failed, %llu torn\n",
+                         fullSpeed ? "full speed" : "90 Hz",
+                         readers,
+                         static_cast<double>( result.published )
+                             / result.seconds,
+                         static_cast<double>( result.reads ) / result.seconds,
+                         100.0 * static_cast<double>( result.failedReads )
+                             / static_cast<double>(
+                                 std::max<uint64_t>( result.reads, 1 ) ),
+                         static_cast<unsigned long long>( result.tornReads ) );
+            CHECK( result.tornReads == 0 );
+        }
+    }
+    utils::SharedStateWriter writer;
+    writer.open();
+    tests::measure( "publish", tests::scaled( 1000000 ), [&] {
+        writer.publish();
+    } );
+    utils::SharedStateReader reader;
+    reader.open();
+    utils::SharedStateFrame frame;
+    tests::measure( "read", tests::scaled( 1000000 ), [&] {
+        reader.read( frame );
+    } );
+    tests::measure( "zero copy read", tests::scaled( 10000000 ), [&] {
+        const auto sequence = reader.beginRead();
+        const float x = reader.frame().universeOffset[0];
+        if ( !reader.endRead( sequence ) || x != 0.0f )
+        {
+            frame.frameIndex = 0;
+        }
+    } );
+}
@@ -0,0 +1,138 @@
+#include "Test.h"
+#include "utils/StatisticsLog.h"
+#include <cstdio>
+#include <cstring>
+
+namespace
+{
+// In the working directory, ctest runs in the build directory.
+constexpr auto k_path = "statistics_test.bin";
+constexpr int64_t k_day = 86400;
+// 2020-01-01 00:00 UTC.
+constexpr int64_t k_start = 1577836800;
+
+utils::StatisticsLog::Record record( int64_t endTime,
+                                     int64_t sessionId,
+                                     const char* appKey )
+{
+    utils::StatisticsLog::Record result;
+    result.endTime = endTime;
+    result.sessionId = sessionId;
+    result.seconds = 60;
+    result.presentedFrames = 5400;
+    result.droppedFrames = 2;
+    result.distance = 10.0f;
+    result.rotations = 0.5f;
+    result.leftMaxSpeed = 3.0f;
+    result.rightMaxSpeed = 4.0f;
+    std::strncpy( result.appKey, appKey, sizeof( result.appKey ) - 1 );
+    return result;
+}
+
+} // namespace
+
+TEST_CASE( StatisticsLogDayTotals )
+{
+    std::remove( k_path );
+    utils::StatisticsLog log;
+    CHECK( log.open( k_path ) );
+    // Day 0: two sessions, the second one in two applications. Day 1: one
+    // minute late in the evening, which is day 2 two hours east of UTC.
+    log.append( record( k_start + 3600, k_start, "steam.app.1" ) );
+    log.append( record( k_start + 3660, k_start, "steam.app.1" ) );
+    log.append( record( k_start + 7200, k_start + 7000, "" ) );
+    log.append( record( k_start + 7260, k_start + 7000, "steam.app.1" ) );
+    log.append( record( k_start + 7320, k_start + 7000, "steam.app.2" ) );
+    log.append( record( k_start + 2 * k_day - 600, k_start + 7000, "" ) );
+    log.close();
+
+    CHECK( log.refresh( 0 ) );
+    CHECK( log.recordCount() == 6 );
+    const int64_t first = log.dayOf( k_start );
+    const auto& day = log.day( first );
+    CHECK( day.total.sessions == 2 );
+    CHECK_NEAR( day.total.seconds, 300.0, 1e-9 );
+    CHECK_NEAR( day.total.distance, 50.0, 1e-6 );
+    CHECK( day.total.presentedFrames == 5 * 5400u );
+    CHECK( day.total.maxSpeed == 4.0f );
+    CHECK( day.apps.size() == 2 );
+    CHECK( day.apps.at( "steam.app.1" ).sessions == 2 );
+    CHECK_NEAR( day.apps.at( "steam.app.1" ).seconds, 180.0, 1e-9 );
+    CHECK( day.apps.at( "steam.app.2" ).sessions == 1 );
+    CHECK( log.day( first + 1 ).total.sessions == 1 );
+    CHECK( log.day( first + 2 ).total.sessions == 0 );
+
+    // Two hours east of UTC the last minute is on the next local day.
+    CHECK( log.refresh( 2 * 3600 ) );
+    CHECK( log.day( first + 1 ).total.sessions == 0 );
+    CHECK( log.day( first + 2 ).total.sessions == 1 );
+    std::remove( k_path );
+}
+
+TEST_CASE( StatisticsLogAppendsAfterReopen )
+{
+    std::remove( k_path );
+    utils::StatisticsLog log;
+    CHECK( log.open( k_path ) );
+    log.append( record( k_start + 60, k_start, "" ) );
+    log.close();
+    CHECK( log.refresh( 0 ) );
+    const int64_t first = log.dayOf( k_start );
+    CHECK_NEAR( log.day( first ).total.seconds, 60.0, 1e-9 );
+
+    // A record cut short by a crash is overwritten by the next one.
+    std::FILE* file = std::fopen( k_path, "ab" );
+    CHECK( file != nullptr );
+    const char partial[7] = {};
+    std::fwrite( partial, sizeof( partial ), 1, file );
+    std::fclose( file );
+
+    CHECK( log.open( k_path ) );
+    log.append( record( k_start + 120, k_start, "" ) );
+    log.close();
+    // The cached day is dropped once records for it are added.
+    CHECK( log.refresh( 0 ) );
+    CHECK( log.recordCount() == 2 );
+    CHECK_NEAR( log.day( first ).total.seconds, 120.0, 1e-9 );
+    CHECK( log.day( first ).total.sessions == 1 );
+    std::remove( k_path );
+}
+
+TEST_CASE( StatisticsLogRejectsUnknownFormat )
+{
+    std::FILE* file = std::fopen( k_path, "wb" );
+    CHECK( file != nullptr );
+    std::fputs( "not a statistics log", file );
+    std::fclose( file );
+    utils::StatisticsLog log;
+    CHECK( !log.open( k_path ) );
+    std::remove( k_path );
+}
+
+BENCHMARK( StatisticsLogAppendAndDay )
+{
+    // Four weeks of two hours a day, one record per minute.
+    std::remove( k_path );
+    utils::StatisticsLog log;
+    log.open( k_path );
+    int64_t time = k_start;
+    tests::measure( "append", tests::scaled( 28 * 120 ), [&] {
+        log.append( record( time, time / k_day, "steam.app.1" ) );
+        time += time % k_day == 7200 ? k_day - 7200 : 60;
+    } );
+    log.close();
+    log.refresh( 0 );
+    const int64_t first = log.dayOf( k_start );
+    int64_t day = 0;
+    tests::measure( "uncached day", tests::scaled( 20000 ), [&] {
+        // Changing the offset drops the cache.
+        log.refresh( day & 1 );
+        log.day( first + day % 28 );
+        day++;
+    } );
+    tests::measure( "cached day", tests::scaled( 1000000 ), [&] {
+        log.day( first + day % 28 );
+        day++;
+    } );
+    std::remove( k_path );
+}
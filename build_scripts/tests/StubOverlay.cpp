@@ -0,0 +1,610 @@
+#include "StubOverlay.h"
+
+namespace tests
+{
+void StubOverlay::reset()
+{
+    overlays.clear();
+    creates = 0;
+    uploads = 0;
+    uploadedBytes = 0;
+    visibilityChanges = 0;
+    createFails = false;
+}
+
+vr::EVROverlayError StubOverlay::CreateOverlay( const char*,
+                                                const char*,
+                                                vr::VROverlayHandle_t* handle )
+{
+    creates++;
+    if ( createFails )
+    {
+        return vr::VROverlayError_KeyInUse;
+    }
+    overlays.push_back( Overlay{ true, false } );
+    *handle = overlays.size();
+    return vr::VROverlayError_None;
+}
+
+vr::EVROverlayError StubOverlay::DestroyOverlay( vr::VROverlayHandle_t handle )
+{
+    if ( handle == vr::k_ulOverlayHandleInvalid || handle > overlays.size() )
+    {
+        return vr::VROverlayError_InvalidHandle;
+    }
+    overlays[handle - 1] = Overlay{};
+    return vr::VROverlayError_None;
+}
+
+const char* StubOverlay::GetOverlayErrorNameFromEnum( vr::EVROverlayError )
+{
+    return "VROverlayError";
+}
+
+vr::EVROverlayError StubOverlay::ShowOverlay( vr::VROverlayHandle_t handle )
+{
+    if ( handle == vr::k_ulOverlayHandleInvalid || handle > overlays.size() )
+    {
+        return vr::VROverlayError_InvalidHandle;
+    }
+    overlays[handle - 1].visible = true;
+    visibilityChanges++;
+    return vr::VROverlayError_None;
+}
+
+vr::EVROverlayError StubOverlay::HideOverlay( vr::VROverlayHandle_t handle )
+{
+    if ( handle == vr::k_ulOverlayHandleInvalid || handle > overlays.size() )
+    {
+        return vr::VROverlayError_InvalidHandle;
+    }
+    overlays[handle - 1].visible = false;
+    visibilityChanges++;
+    return vr::VROverlayError_None;
+}
+
+bool StubOverlay::IsOverlayVisible( vr::VROverlayHandle_t handle )
+{
+    return handle != vr::k_ulOverlayHandleInvalid && handle <= overlays.size()
+           && overlays[handle - 1].visible;
+}
+
+vr::EVROverlayError StubOverlay::SetOverlayRaw( vr::VROverlayHandle_t,
+                                                void*,
+                                                uint32_t unWidth,
+                                                uint32_t unHeight,
+                                                uint32_t unDepth )
+{
+    uploads++;
+    uploadedBytes += static_cast<size_t>( unWidth ) * unHeight * unDepth;
+    return vr::VROverlayError_None;
+}
+
+vr::EVROverlayError StubOverlay::FindOverlay( const char*,
+                                              vr::VROverlayHandle_t* )
+{
+    return vr::VROverlayError_None;
+}
+
+vr::EVROverlayError StubOverlay::SetHighQualityOverlay( vr::VROverlayHandle_t )
+{
+    return vr::VROverlayError_None;
+}
+
+vr::VROverlayHandle_t StubOverlay::GetHighQualityOverlay()
+{
+    return vr::k_ulOverlayHandleInvalid;
+}
+
+uint32_t StubOverlay::GetOverlayKey( vr::VROverlayHandle_t,
+                                     char*,
+                                     uint32_t,
+                                     vr::EVROverlayError* )
+{
+    return 0;
+}
+
+uint32_t StubOverlay::GetOverlayName( vr::VROverlayHandle_t,
+                                      char*,
+                                      uint32_t,
+                                      vr::EVROverlayError* )
+{
+    return 0;
+}
+
+vr::EVROverlayError StubOverlay::SetOverlayName( vr::VROverlayHandle_t,
+                                                 const char* )
+{
+    return vr::VROverlayError_None;
+}
+
+vr::EVROverlayError StubOverlay::GetOverlayImageData( vr::VROverlayHandle_t,
+                                                      void*,
+                                                      uint32_t,
+                                                      uint32_t*,
+                                                      uint32_t* )
+{
+    return vr::VROverlayError_None;
+}
+
+vr::EVROverlayError StubOverlay::SetOverlayRenderingPid( vr::VROverlayHandle_t,
+                                                         uint32_t )
+{
+    return vr::VROverlayError_None;
+}
+
+uint32_t StubOverlay::GetOverlayRenderingPid( vr::VROverlayHandle_t )
+{
+    return 0;
+}
+
+vr::EVROverlayError StubOverlay::SetOverlayFlag( vr::VROverlayHandle_t,
+                                                 vr::VROverlayFlags,
+                                                 bool )
+{
+    return vr::VROverlayError_None;
+}
+
+vr::EVROverlayError StubOverlay::GetOverlayFlag( vr::VROverlayHandle_t,
+                                                 vr::VROverlayFlags,
+                                                 bool* )
+{
+    return vr::VROverlayError_None;
+}
+
+vr::EVROverlayError StubOverlay::SetOverlayColor( vr::VROverlayHandle_t,
+                                                  float,
+                                                  float,
+                                                  float )
+{
+    return vr::VROverlayError_None;
+}
+
+vr::EVROverlayError StubOverlay::GetOverlayColor( vr::VROverlayHandle_t,
+                                                  float*,
+                                                  float*,
+                                                  float* )
+{
+    return vr::VROverlayError_None;
+}
+
+vr::EVROverlayError StubOverlay::SetOverlayAlpha( vr::VROverlayHandle_t, float )
+{
+    return vr::VROverlayError_None;
+}
+
+vr::EVROverlayError StubOverlay::GetOverlayAlpha( vr::VROverlayHandle_t,
+                                                  float* )
+{
+    return vr::VROverlayError_None;
+}
+
+vr::EVROverlayError StubOverlay::SetOverlayTexelAspect( vr::VROverlayHandle_t,
+                                                        float )
+{
+    return vr::VROverlayError_None;
+}
+
+vr::EVROverlayError StubOverlay::GetOverlayTexelAspect( vr::VROverlayHandle_t,
+                                                        float* )
+{
+    return vr::VROverlayError_None;
+}
+
+vr::EVROverlayError StubOverlay::SetOverlaySortOrder( vr::VROverlayHandle_t,
+                                                      uint32_t )
+{
+    return vr::VROverlayError_None;
+}
+
+vr::EVROverlayError StubOverlay::GetOverlaySortOrder( vr::VROverlayHandle_t,
+                                                      uint32_t* )
+{
+    return vr::VROverlayError_None;
+}
+
+vr::EVROverlayError StubOverlay::SetOverlayWidthInMeters( vr::VROverlayHandle_t,
+                                                          float )
+{
+    return vr::VROverlayError_None;
+}
+
+vr::EVROverlayError StubOverlay::GetOverlayWidthInMeters( vr::VROverlayHandle_t,
+                                                          float* )
+{
+    return vr::VROverlayError_None;
+}
+
+vr::EVROverlayError StubOverlay::SetOverlayAutoCurveDistanceRangeInMeters(
+    vr::VROverlayHandle_t,
+    float,
+    float )
+{
+    return vr::VROverlayError_None;
+}
+
+vr::EVROverlayError StubOverlay::GetOverlayAutoCurveDistanceRangeInMeters(
+    vr::VROverlayHandle_t,
+    float*,
+    float* )
+{
+    return vr::VROverlayError_None;
+}
+
+vr::EVROverlayError StubOverlay::SetOverlayTextureColorSpace(
+    vr::VROverlayHandle_t,
+    vr::EColorSpace )
+{
+    return vr::VROverlayError_None;
+}
+
+vr::EVROverlayError StubOverlay::GetOverlayTextureColorSpace(
+    vr::VROverlayHandle_t,
+    vr::EColorSpace* )
+{
+    return vr::VROverlayError_None;
+}
+
+vr::EVROverlayError StubOverlay::SetOverlayTextureBounds(
+    vr::VROverlayHandle_t,
+    const vr::VRTextureBounds_t* )
+{
+    return vr::VROverlayError_None;
+}
+
+vr::EVROverlayError StubOverlay::GetOverlayTextureBounds(
+    vr::VROverlayHandle_t,
+    vr::VRTextureBounds_t* )
+{
+    return vr::VROverlayError_None;
+}
+
+uint32_t StubOverlay::GetOverlayRenderModel( vr::VROverlayHandle_t,
+                                             char*,
+                                             uint32_t,
+                                             vr::HmdColor_t*,
+                                             vr::EVROverlayError* )
+{
+    return 0;
+}
+
+vr::EVROverlayError StubOverlay::SetOverlayRenderModel( vr::VROverlayHandle_t,
+                                                        const char*,
+                                                        const vr::HmdColor_t* )
+{
+    return vr::VROverlayError_None;
+}
+
+vr::EVROverlayError StubOverlay::GetOverlayTransformType(
+    vr::VROverlayHandle_t,
+    vr::VROverlayTransformType* )
+{
+    return vr::VROverlayError_None;
+}
+
+vr::EVROverlayError StubOverlay::SetOverlayTransformAbsolute(
+    vr::VROverlayHandle_t,
+    vr::ETrackingUniverseOrigin,
+    const vr::HmdMatrix34_t* )
+{
+    return vr::VROverlayError_None;
+}
+
+vr::EVROverlayError StubOverlay::GetOverlayTransformAbsolute(
+    vr::VROverlayHandle_t,
+    vr::ETrackingUniverseOrigin*,
+    vr::HmdMatrix34_t* )
+{
+    return vr::VROverlayError_None;
+}
+
+vr::EVROverlayError StubOverlay::SetOverlayTransformTrackedDeviceRelative(
+    vr::VROverlayHandle_t,
+    vr::TrackedDeviceIndex_t,
+    const vr::HmdMatrix34_t* )
+{
+    return vr::VROverlayError_None;
+}
+
+vr::EVROverlayError StubOverlay::GetOverlayTransformTrackedDeviceRelative(
+    vr::VROverlayHandle_t,
+    vr::TrackedDeviceIndex_t*,
+    vr::HmdMatrix34_t* )
+{
+    return vr::VROverlayError_None;
+}
+
+vr::EVROverlayError StubOverlay::SetOverlayTransformTrackedDeviceComponent(
+    vr::VROverlayHandle_t,
+    vr::TrackedDeviceIndex_t,
+    const char* )
+{
+    return vr::VROverlayError_None;
+}
+
+vr::EVROverlayError StubOverlay::GetOverlayTransformTrackedDeviceComponent(
+    vr::VROverlayHandle_t,
+    vr::TrackedDeviceIndex_t*,
+    char*,
+    uint32_t )
+{
+    return vr::VROverlayError_None;
+}
+
+vr::EVROverlayError StubOverlay::GetOverlayTransformOverlayRelative(
+    vr::VROverlayHandle_t,
+    vr::VROverlayHandle_t*,
+    vr::HmdMatrix34_t* )
+{
+    return vr::VROverlayError_None;
+}
+
+vr::EVROverlayError StubOverlay::SetOverlayTransformOverlayRelative(
+    vr::VROverlayHandle_t,
+    vr::VROverlayHandle_t,
+    const vr::HmdMatrix34_t* )
+{
+    return vr::VROverlayError_None;
+}
+
+vr::EVROverlayError StubOverlay::GetTransformForOverlayCoordinates(
+    vr::VROverlayHandle_t,
+    vr::ETrackingUniverseOrigin,
+    vr::HmdVector2_t,
+    vr::HmdMatrix34_t* )
+{
+    return vr::VROverlayError_None;
+}
+
+bool StubOverlay::PollNextOverlayEvent( vr::VROverlayHandle_t,
+                                        vr::VREvent_t*,
+                                        uint32_t )
+{
+    return false;
+}
+
+vr::EVROverlayError StubOverlay::GetOverlayInputMethod(
+    vr::VROverlayHandle_t,
+    vr::VROverlayInputMethod* )
+{
+    return vr::VROverlayError_None;
+}
+
+vr::EVROverlayError StubOverlay::SetOverlayInputMethod(
+    vr::VROverlayHandle_t,
+    vr::VROverlayInputMethod )
+{
+    return vr::VROverlayError_None;
+}
+
+vr::EVROverlayError StubOverlay::GetOverlayMouseScale( vr::VROverlayHandle_t,
+                                                       vr::HmdVector2_t* )
+{
+    return vr::VROverlayError_None;
+}
+
+vr::EVROverlayError StubOverlay::SetOverlayMouseScale( vr::VROverlayHandle_t,
+                                                       const vr::HmdVector2_t* )
+{
+    return vr::VROverlayError_None;
+}
+
+bool StubOverlay::ComputeOverlayIntersection(
+    vr::VROverlayHandle_t,
+    const vr::VROverlayIntersectionParams_t*,
+    vr::VROverlayIntersectionResults_t* )
+{
+    return false;
+}
+
+bool StubOverlay::IsHoverTargetOverlay( vr::VROverlayHandle_t )
+{
+    return false;
+}
+
+vr::VROverlayHandle_t StubOverlay::GetGamepadFocusOverlay()
+{
+    return vr::k_ulOverlayHandleInvalid;
+}
+
+vr::EVROverlayError StubOverlay::SetGamepadFocusOverlay( vr::VROverlayHandle_t )
+{
+    return vr::VROverlayError_None;
+}
+
+vr::EVROverlayError StubOverlay::SetOverlayNeighbor( vr::EOverlayDirection,
+                                                     vr::VROverlayHandle_t,
+                                                     vr::VROverlayHandle_t )
+{
+    return vr::VROverlayError_None;
+}
+
+vr::EVROverlayError StubOverlay::MoveGamepadFocusToNeighbor(
+    vr::EOverlayDirection,
+    vr::VROverlayHandle_t )
+{
+    return vr::VROverlayError_None;
+}
+
+vr::EVROverlayError StubOverlay::SetOverlayDualAnalogTransform(
+    vr::VROverlayHandle_t,
+    vr::EDualAnalogWhich,
+    const vr::HmdVector2_t*,
+    float )
+{
+    return vr::VROverlayError_None;
+}
+
+vr::EVROverlayError StubOverlay::GetOverlayDualAnalogTransform(
+    vr::VROverlayHandle_t,
+    vr::EDualAnalogWhich,
+    vr::HmdVector2_t*,
+    float* )
+{
+    return vr::VROverlayError_None;
+}
+
+vr::EVROverlayError StubOverlay::SetOverlayTexture( vr::VROverlayHandle_t,
+                                                    const vr::Texture_t* )
+{
+    return vr::VROverlayError_None;
+}
+
+vr::EVROverlayError StubOverlay::ClearOverlayTexture( vr::VROverlayHandle_t )
+{
+    return vr::VROverlayError_None;
+}
+
+vr::EVROverlayError StubOverlay::SetOverlayFromFile( vr::VROverlayHandle_t,
+                                                     const char* )
+{
+    return vr::VROverlayError_None;
+}
+
+vr::EVROverlayError StubOverlay::GetOverlayTexture( vr::VROverlayHandle_t,
+                                                    void**,
+                                                    void*,
+                                                    uint32_t*,
+                                                    uint32_t*,
+                                                    uint32_t*,
+                                                    vr::ETextureType*,
+                                                    vr::EColorSpace*,
+                                                    vr::VRTextureBounds_t* )
+{
+    return vr::VROverlayError_None;
+}
+
+vr::EVROverlayError StubOverlay::ReleaseNativeOverlayHandle(
+    vr::VROverlayHandle_t,
+    void* )
+{
+    return vr::VROverlayError_None;
+}
+
+vr::EVROverlayError StubOverlay::GetOverlayTextureSize( vr::VROverlayHandle_t,
+                                                        uint32_t*,
+                                                        uint32_t* )
+{
+    return vr::VROverlayError_None;
+}
+
+vr::EVROverlayError StubOverlay::CreateDashboardOverlay(
+    const char*,
+    const char*,
+    vr::VROverlayHandle_t*,
+    vr::VROverlayHandle_t* )
+{
+    return vr::VROverlayError_None;
+}
+
+bool StubOverlay::IsDashboardVisible()
+{
+    return false;
+}
+
+bool StubOverlay::IsActiveDashboardOverlay( vr::VROverlayHandle_t )
+{
+    return false;
+}
+
+vr::EVROverlayError StubOverlay::SetDashboardOverlaySceneProcess(
+    vr::VROverlayHandle_t,
+    uint32_t )
+{
+    return vr::VROverlayError_None;
+}
+
+vr::EVROverlayError StubOverlay::GetDashboardOverlaySceneProcess(
+    vr::VROverlayHandle_t,
+    uint32_t* )
+{
+    return vr::VROverlayError_None;
+}
+
+void StubOverlay::ShowDashboard( const char* )
+{
+}
+
+vr::TrackedDeviceIndex_t StubOverlay::GetPrimaryDashboardDevice()
+{
+    return vr::k_unTrackedDeviceIndexInvalid;
+}
+
+vr::EVROverlayError StubOverlay::ShowKeyboard( vr::EGamepadTextInputMode,
+                                               vr::EGamepadTextInputLineMode,
+                                               const char*,
+                                               uint32_t,
+                                               const char*,
+                                               bool,
+                                               uint64_t )
+{
+    return vr::VROverlayError_None;
+}
+
+vr::EVROverlayError StubOverlay::ShowKeyboardForOverlay(
+    vr::VROverlayHandle_t,
+    vr::EGamepadTextInputMode,
+    vr::EGamepadTextInputLineMode,
+    const char*,
+    uint32_t,
+    const char*,
+    bool,
+    uint64_t )
+{
+    return vr::VROverlayError_None;
+}
+
+uint32_t StubOverlay::GetKeyboardText( char*, uint32_t )
+{
+    return 0;
+}
+
+void StubOverlay::HideKeyboard()
+{
+}
+
+void StubOverlay::SetKeyboardTransformAbsolute( vr::ETrackingUniverseOrigin,
+                                                const vr::HmdMatrix34_t* )
+{
+}
+
+void StubOverlay::SetKeyboardPositionForOverlay( vr::VROverlayHandle_t,
+                                                 vr::HmdRect2_t )
+{
+}
+
+vr::EVROverlayError StubOverlay::SetOverlayIntersectionMask(
+    vr::VROverlayHandle_t,
+    vr::VROverlayIntersectionMaskPrimitive_t*,
+    uint32_t,
+    uint32_t )
+{
+    return vr::VROverlayError_None;
+}
+
+vr::EVROverlayError StubOverlay::GetOverlayFlags( vr::VROverlayHandle_t,
+                                                  uint32_t* )
+{
+    return vr::VROverlayError_None;
+}
+
+vr::VRMessageOverlayResponse StubOverlay::ShowMessageOverlay( const char*,
+                                                              const char*,
+                                                              const char*,
+                                                              const char*,
+                                                              const char*,
+                                                              const char* )
+{
+    return vr::VRMessageOverlayResponse_ButtonPress_0;
+}
+
+void StubOverlay::CloseMessageOverlay()
+{
+}
+StubOverlay& stubOverlay()
+{
+    static StubOverlay overlay;
+    return overlay;
+}
+
+} // namespace tests
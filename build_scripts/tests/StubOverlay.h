@@ -0,0 +1,283 @@
+#pragma once
+
+#include <vector>
+#include <openvr.h>
+
+namespace tests
+{
+// See StubChaperoneSetup.
+#if defined( __GNUC__ )
+#    pragma GCC diagnostic push
+#    pragma GCC diagnostic ignored "-Wnon-virtual-dtor"
+#endif
+/*!
+Overlay interface that only keeps track of the overlays created through it,
+their visibility and the uploads. Everything else does nothing and reports
+success.
+*/
+class StubOverlay : public vr::IVROverlay
+{
+public:
+    struct Overlay
+    {
+        bool exists = false;
+        bool visible = false;
+    };
+
+    // Indexed by handle - 1.
+    std::vector<Overlay> overlays;
+
+    unsigned creates = 0;
+    unsigned uploads = 0;
+    size_t uploadedBytes = 0;
+    unsigned visibilityChanges = 0;
+    // CreateOverlay() fails while set.
+    bool createFails = false;
+
+    // No overlays, counters at zero, creating works.
+    void reset();
+
+    vr::EVROverlayError FindOverlay( const char*,
+                                     vr::VROverlayHandle_t* ) override;
+    vr::EVROverlayError CreateOverlay( const char*,
+                                       const char*,
+                                       vr::VROverlayHandle_t* ) override;
+    vr::EVROverlayError DestroyOverlay( vr::VROverlayHandle_t ) override;
+    vr::EVROverlayError SetHighQualityOverlay( vr::VROverlayHandle_t ) override;
+    vr::VROverlayHandle_t GetHighQualityOverlay() override;
+    uint32_t GetOverlayKey( vr::VROverlayHandle_t,
+                            char*,
+                            uint32_t,
+                            vr::EVROverlayError* ) override;
+    uint32_t GetOverlayName( vr::VROverlayHandle_t,
+                             char*,
+                             uint32_t,
+                             vr::EVROverlayError* ) override;
+    vr::EVROverlayError SetOverlayName( vr::VROverlayHandle_t,
+                                        const char* ) override;
+    vr::EVROverlayError GetOverlayImageData( vr::VROverlayHandle_t,
+                                             void*,
+                                             uint32_t,
+                                             uint32_t*,
+                                             uint32_t* ) override;
+    const char* GetOverlayErrorNameFromEnum( vr::EVROverlayError ) override;
+    vr::EVROverlayError SetOverlayRenderingPid( vr::VROverlayHandle_t,
+                                                uint32_t ) override;
+    uint32_t GetOverlayRenderingPid( vr::VROverlayHandle_t ) override;
+    vr::EVROverlayError SetOverlayFlag( vr::VROverlayHandle_t,
+                                        vr::VROverlayFlags,
+                                        bool ) override;
+    vr::EVROverlayError GetOverlayFlag( vr::VROverlayHandle_t,
+                                        vr::VROverlayFlags,
+                                        bool* ) override;
+    vr::EVROverlayError SetOverlayColor( vr::VROverlayHandle_t,
+                                         float,
+                                         float,
+                                         float ) override;
+    vr::EVROverlayError GetOverlayColor( vr::VROverlayHandle_t,
+                                         float*,
+                                         float*,
+                                         float* ) override;
+    vr::EVROverlayError SetOverlayAlpha( vr::VROverlayHandle_t,
+                                         float ) override;
+    vr::EVROverlayError GetOverlayAlpha( vr::VROverlayHandle_t,
+                                         float* ) override;
+    vr::EVROverlayError SetOverlayTexelAspect( vr::VROverlayHandle_t,
+                                               float ) override;
+    vr::EVROverlayError GetOverlayTexelAspect( vr::VROverlayHandle_t,
+                                               float* ) override;
+    vr::EVROverlayError SetOverlaySortOrder( vr::VROverlayHandle_t,
+                                             uint32_t ) override;
+    vr::EVROverlayError GetOverlaySortOrder( vr::VROverlayHandle_t,
+                                             uint32_t* ) override;
+    vr::EVROverlayError SetOverlayWidthInMeters( vr::VROverlayHandle_t,
+                                                 float ) override;
+    vr::EVROverlayError GetOverlayWidthInMeters( vr::VROverlayHandle_t,
+                                                 float* ) override;
+    vr::EVROverlayError SetOverlayAutoCurveDistanceRangeInMeters(
+        vr::VROverlayHandle_t,
+        float,
+        float ) override;
+    vr::EVROverlayError GetOverlayAutoCurveDistanceRangeInMeters(
+        vr::VROverlayHandle_t,
+        float*,
+        float* ) override;
+    vr::EVROverlayError SetOverlayTextureColorSpace( vr::VROverlayHandle_t,
+                                                     vr::EColorSpace ) override;
+    vr::EVROverlayError GetOverlayTextureColorSpace(
+        vr::VROverlayHandle_t,
+        vr::EColorSpace* ) override;
+    vr::EVROverlayError SetOverlayTextureBounds(
+        vr::VROverlayHandle_t,
+        const vr::VRTextureBounds_t* ) override;
+    vr::EVROverlayError GetOverlayTextureBounds(
+        vr::VROverlayHandle_t,
+        vr::VRTextureBounds_t* ) override;
+    uint32_t GetOverlayRenderModel( vr::VROverlayHandle_t,
+                                    char*,
+                                    uint32_t,
+                                    vr::HmdColor_t*,
+                                    vr::EVROverlayError* ) override;
+    vr::EVROverlayError SetOverlayRenderModel( vr::VROverlayHandle_t,
+                                               const char*,
+                                               const vr::HmdColor_t* ) override;
+    vr::EVROverlayError GetOverlayTransformType(
+        vr::VROverlayHandle_t,
+        vr::VROverlayTransformType* ) override;
+    vr::EVROverlayError SetOverlayTransformAbsolute(
+        vr::VROverlayHandle_t,
+        vr::ETrackingUniverseOrigin,
+        const vr::HmdMatrix34_t* ) override;
+    vr::EVROverlayError GetOverlayTransformAbsolute(
+        vr::VROverlayHandle_t,
+        vr::ETrackingUniverseOrigin*,
+        vr::HmdMatrix34_t* ) override;
+    vr::EVROverlayError SetOverlayTransformTrackedDeviceRelative(
+        vr::VROverlayHandle_t,
+        vr::TrackedDeviceIndex_t,
+        const vr::HmdMatrix34_t* ) override;
+    vr::EVROverlayError GetOverlayTransformTrackedDeviceRelative(
+        vr::VROverlayHandle_t,
+        vr::TrackedDeviceIndex_t*,
+        vr::HmdMatrix34_t* ) override;
+    vr::EVROverlayError SetOverlayTransformTrackedDeviceComponent(
+        vr::VROverlayHandle_t,
+        vr::TrackedDeviceIndex_t,
+        const char* ) override;
+    vr::EVROverlayError GetOverlayTransformTrackedDeviceComponent(
+        vr::VROverlayHandle_t,
+        vr::TrackedDeviceIndex_t*,
+        char*,
+        uint32_t ) override;
+    vr::EVROverlayError GetOverlayTransformOverlayRelative(
+        vr::VROverlayHandle_t,
+        vr::VROverlayHandle_t*,
+        vr::HmdMatrix34_t* ) override;
+    vr::EVROverlayError SetOverlayTransformOverlayRelative(
+        vr::VROverlayHandle_t,
+        vr::VROverlayHandle_t,
+        const vr::HmdMatrix34_t* ) override;
+    vr::EVROverlayError ShowOverlay( vr::VROverlayHandle_t ) override;
+    vr::EVROverlayError HideOverlay( vr::VROverlayHandle_t ) override;
+    bool IsOverlayVisible( vr::VROverlayHandle_t ) override;
+    vr::EVROverlayError GetTransformForOverlayCoordinates(
+        vr::VROverlayHandle_t,
+        vr::ETrackingUniverseOrigin,
+        vr::HmdVector2_t,
+        vr::HmdMatrix34_t* ) override;
+    bool PollNextOverlayEvent( vr::VROverlayHandle_t,
+                               vr::VREvent_t*,
+                               uint32_t ) override;
+    vr::EVROverlayError GetOverlayInputMethod(
+        vr::VROverlayHandle_t,
+        vr::VROverlayInputMethod* ) override;
+    vr::EVROverlayError SetOverlayInputMethod(
+        vr::VROverlayHandle_t,
+        vr::VROverlayInputMethod ) override;
+    vr::EVROverlayError GetOverlayMouseScale( vr::VROverlayHandle_t,
+                                              vr::HmdVector2_t* ) override;
+    vr::EVROverlayError SetOverlayMouseScale(
+        vr::VROverlayHandle_t,
+        const vr::HmdVector2_t* ) override;
+    bool ComputeOverlayIntersection(
+        vr::VROverlayHandle_t,
+        const vr::VROverlayIntersectionParams_t*,
+        vr::VROverlayIntersectionResults_t* ) override;
+    bool IsHoverTargetOverlay( vr::VROverlayHandle_t ) override;
+    vr::VROverlayHandle_t GetGamepadFocusOverlay() override;
+    vr::EVROverlayError SetGamepadFocusOverlay(
+        vr::VROverlayHandle_t ) override;
+    vr::EVROverlayError SetOverlayNeighbor( vr::EOverlayDirection,
+                                            vr::VROverlayHandle_t,
+                                            vr::VROverlayHandle_t ) override;
+    vr::EVROverlayError MoveGamepadFocusToNeighbor(
+        vr::EOverlayDirection,
+        vr::VROverlayHandle_t ) override;
+    vr::EVROverlayError SetOverlayDualAnalogTransform( vr::VROverlayHandle_t,
+                                                       vr::EDualAnalogWhich,
+                                                       const vr::HmdVector2_t*,
+                                                       float ) override;
+    vr::EVROverlayError GetOverlayDualAnalogTransform( vr::VROverlayHandle_t,
+                                                       vr::EDualAnalogWhich,
+                                                       vr::HmdVector2_t*,
+                                                       float* ) override;
+    vr::EVROverlayError SetOverlayTexture( vr::VROverlayHandle_t,
+                                           const vr::Texture_t* ) override;
+    vr::EVROverlayError ClearOverlayTexture( vr::VROverlayHandle_t ) override;
+    vr::EVROverlayError SetOverlayRaw( vr::VROverlayHandle_t,
+                                       void*,
+                                       uint32_t,
+                                       uint32_t,
+                                       uint32_t ) override;
+    vr::EVROverlayError SetOverlayFromFile( vr::VROverlayHandle_t,
+                                            const char* ) override;
+    vr::EVROverlayError GetOverlayTexture( vr::VROverlayHandle_t,
+                                           void**,
+                                           void*,
+                                           uint32_t*,
+                                           uint32_t*,
+                                           uint32_t*,
+                                           vr::ETextureType*,
+                                           vr::EColorSpace*,
+                                           vr::VRTextureBounds_t* ) override;
+    vr::EVROverlayError ReleaseNativeOverlayHandle( vr::VROverlayHandle_t,
+                                                    void* ) override;
+    vr::EVROverlayError GetOverlayTextureSize( vr::VROverlayHandle_t,
+                                               uint32_t*,
+                                               uint32_t* ) override;
+    vr::EVROverlayError CreateDashboardOverlay(
+        const char*,
+        const char*,
+        vr::VROverlayHandle_t*,
+        vr::VROverlayHandle_t* ) override;
+    bool IsDashboardVisible() override;
+    bool IsActiveDashboardOverlay( vr::VROverlayHandle_t ) override;
+    vr::EVROverlayError SetDashboardOverlaySceneProcess( vr::VROverlayHandle_t,
+                                                         uint32_t ) override;
+    vr::EVROverlayError GetDashboardOverlaySceneProcess( vr::VROverlayHandle_t,
+                                                         uint32_t* ) override;
+    void ShowDashboard( const char* ) override;
+    vr::TrackedDeviceIndex_t GetPrimaryDashboardDevice() override;
+    vr::EVROverlayError ShowKeyboard( vr::EGamepadTextInputMode,
+                                      vr::EGamepadTextInputLineMode,
+                                      const char*,
+                                      uint32_t,
+                                      const char*,
+                                      bool,
+                                      uint64_t ) override;
+    vr::EVROverlayError ShowKeyboardForOverlay( vr::VROverlayHandle_t,
+                                                vr::EGamepadTextInputMode,
+                                                vr::EGamepadTextInputLineMode,
+                                                const char*,
+                                                uint32_t,
+                                                const char*,
+                                                bool,
+                                                uint64_t ) override;
+    uint32_t GetKeyboardText( char*, uint32_t ) override;
+    void HideKeyboard() override;
+    void SetKeyboardTransformAbsolute( vr::ETrackingUniverseOrigin,
+                                       const vr::HmdMatrix34_t* ) override;
+    void SetKeyboardPositionForOverlay( vr::VROverlayHandle_t,
+                                        vr::HmdRect2_t ) override;
+    vr::EVROverlayError SetOverlayIntersectionMask(
+        vr::VROverlayHandle_t,
+        vr::VROverlayIntersectionMaskPrimitive_t*,
+        uint32_t,
+        uint32_t ) override;
+    vr::EVROverlayError GetOverlayFlags( vr::VROverlayHandle_t,
+                                         uint32_t* ) override;
+    vr::VRMessageOverlayResponse ShowMessageOverlay( const char*,
+                                                     const char*,
+                                                     const char*,
+                                                     const char*,
+                                                     const char*,
+                                                     const char* ) override;
+    void CloseMessageOverlay() override;
+};
+#if defined( __GNUC__ )
+#    pragma GCC diagnostic pop
+#endif
+
+StubOverlay& stubOverlay();
+
+} // namespace tests
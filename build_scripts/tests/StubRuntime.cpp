@@ -0,0 +1,220 @@
+#include "StubRuntime.h"
+#include "StubOverlay.h"
+#include "StubSystem.h"
+#include <cstring>
+
+namespace tests
+{
+namespace
+{
+    constexpr float k_roomHeight = 2.4f;
+
+    vr::HmdMatrix34_t identity()
+    {
+        vr::HmdMatrix34_t matrix = {};
+        matrix.m[0][0] = 1.0f;
+        matrix.m[1][1] = 1.0f;
+        matrix.m[2][2] = 1.0f;
+        return matrix;
+    }
+
+    bool copyBounds( const std::vector<vr::HmdQuad_t>& bounds,
+                     vr::HmdQuad_t* buffer,
+                     uint32_t* count )
+    {
+        const auto size = static_cast<uint32_t>( bounds.size() );
+        if ( buffer && *count >= size && size > 0 )
+        {
+            std::memcpy(
+                buffer, bounds.data(), size * sizeof( vr::HmdQuad_t ) );
+        }
+        const bool fits = !buffer || *count >= size;
+        *count = size;
+        return fits;
+    }
+} // namespace
+
+void StubChaperoneSetup::reset()
+{
+    working.standingPose = identity();
+    working.seatedPose = identity();
+    working.bounds.clear();
+    working.playAreaSize[0] = 0.0f;
+    working.playAreaSize[1] = 0.0f;
+    live = working;
+    reverts = 0;
+    commits = 0;
+    boundsReads = 0;
+    boundsWrites = 0;
+}
+
+bool StubChaperoneSetup::CommitWorkingCopy( vr::EChaperoneConfigFile )
+{
+    live = working;
+    commits++;
+    return true;
+}
+
+void StubChaperoneSetup::RevertWorkingCopy()
+{
+    working = live;
+    reverts++;
+}
+
+bool StubChaperoneSetup::GetWorkingPlayAreaSize( float* pSizeX, float* pSizeZ )
+{
+    *pSizeX = working.playAreaSize[0];
+    *pSizeZ = working.playAreaSize[1];
+    return true;
+}
+
+bool StubChaperoneSetup::GetWorkingPlayAreaRect( vr::HmdQuad_t* rect )
+{
+    const float x = working.playAreaSize[0] / 2.0f;
+    const float z = working.playAreaSize[1] / 2.0f;
+    *rect = vr::HmdQuad_t{ { { { -x, 0.0f, -z } },
+                             { { x, 0.0f, -z } },
+                             { { x, 0.0f, z } },
+                             { { -x, 0.0f, z } } } };
+    return true;
+}
+
+bool StubChaperoneSetup::GetWorkingCollisionBoundsInfo(
+    vr::HmdQuad_t* pQuadsBuffer,
+    uint32_t* punQuadsCount )
+{
+    boundsReads++;
+    return copyBounds( working.bounds, pQuadsBuffer, punQuadsCount );
+}
+
+bool StubChaperoneSetup::GetLiveCollisionBoundsInfo(
+    vr::HmdQuad_t* pQuadsBuffer,
+    uint32_t* punQuadsCount )
+{
+    boundsReads++;
+    return copyBounds( live.bounds, pQuadsBuffer, punQuadsCount );
+}
+
+bool StubChaperoneSetup::GetWorkingSeatedZeroPoseToRawTrackingPose(
+    vr::HmdMatrix34_t* pose )
+{
+    *pose = working.seatedPose;
+    return true;
+}
+
+bool StubChaperoneSetup::GetWorkingStandingZeroPoseToRawTrackingPose(
+    vr::HmdMatrix34_t* pose )
+{
+    *pose = working.standingPose;
+    return true;
+}
+
+void StubChaperoneSetup::SetWorkingPlayAreaSize( float sizeX, float sizeZ )
+{
+    working.playAreaSize[0] = sizeX;
+    working.playAreaSize[1] = sizeZ;
+}
+
+void StubChaperoneSetup::SetWorkingCollisionBoundsInfo(
+    vr::HmdQuad_t* pQuadsBuffer,
+    uint32_t unQuadsCount )
+{
+    boundsWrites++;
+    working.bounds.assign( pQuadsBuffer, pQuadsBuffer + unQuadsCount );
+}
+
+void StubChaperoneSetup::SetWorkingPerimeter( vr::HmdVector2_t*, uint32_t ) {}
+
+void StubChaperoneSetup::SetWorkingSeatedZeroPoseToRawTrackingPose(
+    const vr::HmdMatrix34_t* pose )
+{
+    working.seatedPose = *pose;
+}
+
+void StubChaperoneSetup::SetWorkingStandingZeroPoseToRawTrackingPose(
+    const vr::HmdMatrix34_t* pose )
+{
+    working.standingPose = *pose;
+}
+
+void StubChaperoneSetup::ReloadFromDisk( vr::EChaperoneConfigFile ) {}
+
+bool StubChaperoneSetup::GetLiveSeatedZeroPoseToRawTrackingPose(
+    vr::HmdMatrix34_t* pose )
+{
+    *pose = live.seatedPose;
+    return true;
+}
+
+bool StubChaperoneSetup::ExportLiveToBuffer( char*, uint32_t* pnBufferLength )
+{
+    *pnBufferLength = 0;
+    return false;
+}
+
+bool StubChaperoneSetup::ImportFromBufferToWorking( const char*, uint32_t )
+{
+    return false;
+}
+
+void StubChaperoneSetup::ShowWorkingSetPreview() {}
+
+void StubChaperoneSetup::HideWorkingSetPreview() {}
+
+StubChaperoneSetup& stubChaperoneSetup()
+{
+    static StubChaperoneSetup setup;
+    return setup;
+}
+
+std::vector<vr::HmdQuad_t> roomBounds( float sizeX, float sizeZ )
+{
+    const float x = sizeX / 2.0f;
+    const float z = sizeZ / 2.0f;
+    const vr::HmdVector2_t corners[]
+        = { { { -x, -z } }, { { x, -z } }, { { x, z } }, { { -x, z } } };
+    std::vector<vr::HmdQuad_t> quads;
+    for ( size_t i = 0; i < 4; i++ )
+    {
+        const auto& a = corners[i];
+        const auto& b = corners[( i + 1 ) % 4];
+        quads.push_back( vr::HmdQuad_t{ { { { a.v[0], 0.0f, a.v[1] } },
+                                          { { a.v[0], k_roomHeight, a.v[1] } },
+                                          { { b.v[0], k_roomHeight, b.v[1] } },
+                                          { { b.v[0], 0.0f, b.v[1] } } } } );
+    }
+    return quads;
+}
+
+} // namespace tests
+
+namespace vr
+{
+uint32_t VR_GetInitToken()
+{
+    return 1;
+}
+
+void* VR_GetGenericInterface( const char* pchInterfaceVersion,
+                              EVRInitError* peError )
+{
+    if ( std::strcmp( pchInterfaceVersion, IVRChaperoneSetup_Version ) == 0 )
+    {
+        *peError = VRInitError_None;
+        return &tests::stubChaperoneSetup();
+    }
+    if ( std::strcmp( pchInterfaceVersion, IVROverlay_Version ) == 0 )
+    {
+        *peError = VRInitError_None;
+        return &tests::stubOverlay();
+    }
+    if ( std::strcmp( pchInterfaceVersion, IVRSystem_Version ) == 0 )
+    {
+        *peError = VRInitError_None;
+        return &tests::stubSystem();
+    }
+    *peError = VRInitError_Init_InterfaceNotFound;
+    return nullptr;
+}
+
+} // namespace vr
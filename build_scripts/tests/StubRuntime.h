@@ -0,0 +1,89 @@
+#pragma once
+
+#include <vector>
+#include <openvr.h>
+
+/*!
+Stand-in for the OpenVR runtime, so the utils can be tested without SteamVR.
+
+The tests don't link openvr_api. VR_GetInitToken() and
+VR_GetGenericInterface() are defined in StubRuntime.cpp instead and hand out
+the stub interfaces below, so vr::VRChaperoneSetup() and friends reach them
+through the normal openvr.h accessors. The overlay stub is in StubOverlay.h,
+the system stub in StubSystem.h.
+*/
+namespace tests
+{
+/*!
+Keeps a working and a live copy of the universe centers and collision bounds
+like SteamVR does, and counts the calls so tests can check the IPC a change
+costs.
+*/
+// The OpenVR interfaces have no virtual destructors, the stubs are never
+// deleted through them.
+#if defined( __GNUC__ )
+#    pragma GCC diagnostic push
+#    pragma GCC diagnostic ignored "-Wnon-virtual-dtor"
+#endif
+class StubChaperoneSetup : public vr::IVRChaperoneSetup
+{
+public:
+    struct Copy
+    {
+        vr::HmdMatrix34_t standingPose;
+        vr::HmdMatrix34_t seatedPose;
+        std::vector<vr::HmdQuad_t> bounds;
+        float playAreaSize[2];
+    };
+
+    Copy working;
+    Copy live;
+
+    unsigned reverts = 0;
+    unsigned commits = 0;
+    unsigned boundsReads = 0;
+    unsigned boundsWrites = 0;
+
+    // Identity centers and no bounds in both copies, counters at zero.
+    void reset();
+
+    bool CommitWorkingCopy( vr::EChaperoneConfigFile configFile ) override;
+    void RevertWorkingCopy() override;
+    bool GetWorkingPlayAreaSize( float* pSizeX, float* pSizeZ ) override;
+    bool GetWorkingPlayAreaRect( vr::HmdQuad_t* rect ) override;
+    bool GetWorkingCollisionBoundsInfo( vr::HmdQuad_t* pQuadsBuffer,
+                                        uint32_t* punQuadsCount ) override;
+    bool GetLiveCollisionBoundsInfo( vr::HmdQuad_t* pQuadsBuffer,
+                                     uint32_t* punQuadsCount ) override;
+    bool GetWorkingSeatedZeroPoseToRawTrackingPose(
+        vr::HmdMatrix34_t* pose ) override;
+    bool GetWorkingStandingZeroPoseToRawTrackingPose(
+        vr::HmdMatrix34_t* pose ) override;
+    void SetWorkingPlayAreaSize( float sizeX, float sizeZ ) override;
+    void SetWorkingCollisionBoundsInfo( vr::HmdQuad_t* pQuadsBuffer,
+                                        uint32_t unQuadsCount ) override;
+    void SetWorkingPerimeter( vr::HmdVector2_t* pPointBuffer,
+                              uint32_t unPointCount ) override;
+    void SetWorkingSeatedZeroPoseToRawTrackingPose(
+        const vr::HmdMatrix34_t* pose ) override;
+    void SetWorkingStandingZeroPoseToRawTrackingPose(
+        const vr::HmdMatrix34_t* pose ) override;
+    void ReloadFromDisk( vr::EChaperoneConfigFile configFile ) override;
+    bool GetLiveSeatedZeroPoseToRawTrackingPose(
+        vr::HmdMatrix34_t* pose ) override;
+    bool ExportLiveToBuffer( char* pBuffer, uint32_t* pnBufferLength ) override;
+    bool ImportFromBufferToWorking( const char* pBuffer,
+                                    uint32_t nImportFlags ) override;
+    void ShowWorkingSetPreview() override;
+    void HideWorkingSetPreview() override;
+};
+#if defined( __GNUC__ )
+#    pragma GCC diagnostic pop
+#endif
+
+StubChaperoneSetup& stubChaperoneSetup();
+
+// Rectangular room of the given size around the origin, 2.4 m high.
+std::vector<vr::HmdQuad_t> roomBounds( float sizeX, float sizeZ );
+
+} // namespace tests
@@ -0,0 +1,382 @@
+#include "StubSystem.h"
+
+namespace tests
+{
+namespace
+{
+    vr::HmdMatrix34_t identity()
+    {
+        vr::HmdMatrix34_t matrix = {};
+        matrix.m[0][0] = 1.0f;
+        matrix.m[1][1] = 1.0f;
+        matrix.m[2][2] = 1.0f;
+        return matrix;
+    }
+} // namespace
+
+void StubSystem::reset()
+{
+    hmdState = vr::VRControllerState_t{};
+    hmdStateValid = true;
+    controllerStateReads = 0;
+}
+
+void StubSystem::setProximitySensor( bool pressed )
+{
+    const auto mask = vr::ButtonMaskFromId( vr::k_EButton_ProximitySensor );
+    if ( pressed )
+    {
+        hmdState.ulButtonPressed |= mask;
+    }
+    else
+    {
+        hmdState.ulButtonPressed &= ~mask;
+    }
+    hmdState.unPacketNum++;
+}
+
+bool StubSystem::GetControllerState( vr::TrackedDeviceIndex_t device,
+                                     vr::VRControllerState_t* state,
+                                     uint32_t size )
+{
+    controllerStateReads++;
+    if ( device != vr::k_unTrackedDeviceIndex_Hmd || !hmdStateValid
+         || size != sizeof( vr::VRControllerState_t ) )
+    {
+        return false;
+    }
+    *state = hmdState;
+    return true;
+}
+
+bool StubSystem::GetControllerStateWithPose( vr::ETrackingUniverseOrigin,
+                                             vr::TrackedDeviceIndex_t device,
+                                             vr::VRControllerState_t* state,
+                                             uint32_t size,
+                                             vr::TrackedDevicePose_t* pose )
+{
+    *pose = vr::TrackedDevicePose_t{};
+    return GetControllerState( device, state, size );
+}
+
+void StubSystem::GetRecommendedRenderTargetSize( uint32_t* pnWidth,
+                                                 uint32_t* pnHeight )
+{
+    *pnWidth = 0;
+    *pnHeight = 0;
+}
+
+vr::HmdMatrix44_t StubSystem::GetProjectionMatrix( vr::EVREye, float, float )
+{
+    return vr::HmdMatrix44_t{};
+}
+
+void StubSystem::GetProjectionRaw( vr::EVREye,
+                                   float* pfLeft,
+                                   float* pfRight,
+                                   float* pfTop,
+                                   float* pfBottom )
+{
+    *pfLeft = *pfRight = *pfTop = *pfBottom = 0.0f;
+}
+
+bool StubSystem::ComputeDistortion( vr::EVREye,
+                                    float,
+                                    float,
+                                    vr::DistortionCoordinates_t* )
+{
+    return false;
+}
+
+vr::HmdMatrix34_t StubSystem::GetEyeToHeadTransform( vr::EVREye )
+{
+    return identity();
+}
+
+bool StubSystem::GetTimeSinceLastVsync( float*, uint64_t* )
+{
+    return false;
+}
+
+int32_t StubSystem::GetD3D9AdapterIndex()
+{
+    return 0;
+}
+
+void StubSystem::GetDXGIOutputInfo( int32_t* pnAdapterIndex )
+{
+    *pnAdapterIndex = 0;
+}
+
+void StubSystem::GetOutputDevice( uint64_t* pnDevice,
+                                  vr::ETextureType,
+                                  VkInstance_T* )
+{
+    *pnDevice = 0;
+}
+
+bool StubSystem::IsDisplayOnDesktop()
+{
+    return false;
+}
+
+bool StubSystem::SetDisplayVisibility( bool )
+{
+    return false;
+}
+
+void StubSystem::GetDeviceToAbsoluteTrackingPose(
+    vr::ETrackingUniverseOrigin,
+    float,
+    vr::TrackedDevicePose_t* pTrackedDevicePoseArray,
+    uint32_t unTrackedDevicePoseArrayCount )
+{
+    for ( uint32_t i = 0; i < unTrackedDevicePoseArrayCount; i++ )
+    {
+        pTrackedDevicePoseArray[i] = vr::TrackedDevicePose_t{};
+    }
+}
+
+void StubSystem::ResetSeatedZeroPose()
+{
+}
+
+vr::HmdMatrix34_t StubSystem::GetSeatedZeroPoseToStandingAbsoluteTrackingPose()
+{
+    return identity();
+}
+
+vr::HmdMatrix34_t StubSystem::GetRawZeroPoseToStandingAbsoluteTrackingPose()
+{
+    return identity();
+}
+
+uint32_t StubSystem::GetSortedTrackedDeviceIndicesOfClass(
+    vr::ETrackedDeviceClass,
+    vr::TrackedDeviceIndex_t*,
+    uint32_t,
+    vr::TrackedDeviceIndex_t )
+{
+    return 0;
+}
+
+vr::EDeviceActivityLevel
+    StubSystem::GetTrackedDeviceActivityLevel( vr::TrackedDeviceIndex_t )
+{
+    return vr::k_EDeviceActivityLevel_Unknown;
+}
+
+void StubSystem::ApplyTransform( vr::TrackedDevicePose_t* pOutputPose,
+                                 const vr::TrackedDevicePose_t* pPose,
+                                 const vr::HmdMatrix34_t* )
+{
+    *pOutputPose = *pPose;
+}
+
+vr::TrackedDeviceIndex_t StubSystem::GetTrackedDeviceIndexForControllerRole(
+    vr::ETrackedControllerRole )
+{
+    return vr::k_unTrackedDeviceIndexInvalid;
+}
+
+vr::ETrackedControllerRole StubSystem::GetControllerRoleForTrackedDeviceIndex(
+    vr::TrackedDeviceIndex_t )
+{
+    return vr::TrackedControllerRole_Invalid;
+}
+
+vr::ETrackedDeviceClass
+    StubSystem::GetTrackedDeviceClass( vr::TrackedDeviceIndex_t )
+{
+    return vr::TrackedDeviceClass_Invalid;
+}
+
+bool StubSystem::IsTrackedDeviceConnected( vr::TrackedDeviceIndex_t )
+{
+    return false;
+}
+
+bool StubSystem::GetBoolTrackedDeviceProperty(
+    vr::TrackedDeviceIndex_t,
+    vr::ETrackedDeviceProperty,
+    vr::ETrackedPropertyError* pError )
+{
+    if ( pError )
+    {
+        *pError = vr::TrackedProp_InvalidDevice;
+    }
+    return false;
+}
+
+float StubSystem::GetFloatTrackedDeviceProperty(
+    vr::TrackedDeviceIndex_t,
+    vr::ETrackedDeviceProperty,
+    vr::ETrackedPropertyError* pError )
+{
+    if ( pError )
+    {
+        *pError = vr::TrackedProp_InvalidDevice;
+    }
+    return 0.0f;
+}
+
+int32_t StubSystem::GetInt32TrackedDeviceProperty(
+    vr::TrackedDeviceIndex_t,
+    vr::ETrackedDeviceProperty,
+    vr::ETrackedPropertyError* pError )
+{
+    if ( pError )
+    {
+        *pError = vr::TrackedProp_InvalidDevice;
+    }
+    return 0;
+}
+
+uint64_t StubSystem::GetUint64TrackedDeviceProperty(
+    vr::TrackedDeviceIndex_t,
+    vr::ETrackedDeviceProperty,
+    vr::ETrackedPropertyError* pError )
+{
+    if ( pError )
+    {
+        *pError = vr::TrackedProp_InvalidDevice;
+    }
+    return 0;
+}
+
+vr::HmdMatrix34_t StubSystem::GetMatrix34TrackedDeviceProperty(
+    vr::TrackedDeviceIndex_t,
+    vr::ETrackedDeviceProperty,
+    vr::ETrackedPropertyError* pError )
+{
+    if ( pError )
+    {
+        *pError = vr::TrackedProp_InvalidDevice;
+    }
+    return identity();
+}
+
+uint32_t StubSystem::GetArrayTrackedDeviceProperty(
+    vr::TrackedDeviceIndex_t,
+    vr::ETrackedDeviceProperty,
+    vr::PropertyTypeTag_t,
+    void*,
+    uint32_t,
+    vr::ETrackedPropertyError* pError )
+{
+    if ( pError )
+    {
+        *pError = vr::TrackedProp_InvalidDevice;
+    }
+    return 0;
+}
+
+uint32_t StubSystem::GetStringTrackedDeviceProperty(
+    vr::TrackedDeviceIndex_t,
+    vr::ETrackedDeviceProperty,
+    char*,
+    uint32_t,
+    vr::ETrackedPropertyError* pError )
+{
+    if ( pError )
+    {
+        *pError = vr::TrackedProp_InvalidDevice;
+    }
+    return 0;
+}
+
+const char* StubSystem::GetPropErrorNameFromEnum( vr::ETrackedPropertyError )
+{
+    return "TrackedPropertyError";
+}
+
+bool StubSystem::PollNextEvent( vr::VREvent_t*, uint32_t )
+{
+    return false;
+}
+
+bool StubSystem::PollNextEventWithPose( vr::ETrackingUniverseOrigin,
+                                        vr::VREvent_t*,
+                                        uint32_t,
+                                        vr::TrackedDevicePose_t* )
+{
+    return false;
+}
+
+const char* StubSystem::GetEventTypeNameFromEnum( vr::EVREventType )
+{
+    return "VREvent";
+}
+
+vr::HiddenAreaMesh_t StubSystem::GetHiddenAreaMesh( vr::EVREye,
+                                                    vr::EHiddenAreaMeshType )
+{
+    return vr::HiddenAreaMesh_t{ nullptr, 0 };
+}
+
+void StubSystem::TriggerHapticPulse( vr::TrackedDeviceIndex_t,
+                                     uint32_t,
+                                     unsigned short )
+{
+}
+
+const char* StubSystem::GetButtonIdNameFromEnum( vr::EVRButtonId )
+{
+    return "Button";
+}
+
+const char*
+    StubSystem::GetControllerAxisTypeNameFromEnum( vr::EVRControllerAxisType )
+{
+    return "Axis";
+}
+
+bool StubSystem::IsInputAvailable()
+{
+    return true;
+}
+
+bool StubSystem::IsSteamVRDrawingControllers()
+{
+    return false;
+}
+
+bool StubSystem::ShouldApplicationPause()
+{
+    return false;
+}
+
+bool StubSystem::ShouldApplicationReduceRenderingWork()
+{
+    return false;
+}
+
+uint32_t StubSystem::DriverDebugRequest( vr::TrackedDeviceIndex_t,
+                                         const char*,
+                                         char*,
+                                         uint32_t )
+{
+    return 0;
+}
+
+vr::EVRFirmwareError
+    StubSystem::PerformFirmwareUpdate( vr::TrackedDeviceIndex_t )
+{
+    return vr::VRFirmwareError_None;
+}
+
+void StubSystem::AcknowledgeQuit_Exiting()
+{
+}
+
+void StubSystem::AcknowledgeQuit_UserPrompt()
+{
+}
+
+StubSystem& stubSystem()
+{
+    static StubSystem system;
+    return system;
+}
+
+} // namespace tests
@@ -0,0 +1,147 @@
+#pragma once
+
+#include <openvr.h>
+
+namespace tests
+{
+// See StubChaperoneSetup.
+#if defined( __GNUC__ )
+#    pragma GCC diagnostic push
+#    pragma GCC diagnostic ignored "-Wnon-virtual-dtor"
+#endif
+/*!
+System interface that only reports the controller state of the HMD, which
+carries the proximity sensor, and counts the reads. No events are queued and
+no devices are connected. Everything else does nothing and returns zeros.
+*/
+class StubSystem : public vr::IVRSystem
+{
+public:
+    vr::VRControllerState_t hmdState = {};
+    // GetControllerState() fails for the HMD while not set.
+    bool hmdStateValid = true;
+    unsigned controllerStateReads = 0;
+
+    // Proximity sensor not pressed, the state can be read, counter at zero.
+    void reset();
+    // Presses or releases the proximity sensor without an event.
+    void setProximitySensor( bool pressed );
+
+    void GetRecommendedRenderTargetSize( uint32_t*, uint32_t* ) override;
+    vr::HmdMatrix44_t GetProjectionMatrix( vr::EVREye, float, float ) override;
+    void GetProjectionRaw(
+        vr::EVREye, float*, float*, float*, float* ) override;
+    bool ComputeDistortion( vr::EVREye,
+                            float,
+                            float,
+                            vr::DistortionCoordinates_t* ) override;
+    vr::HmdMatrix34_t GetEyeToHeadTransform( vr::EVREye ) override;
+    bool GetTimeSinceLastVsync( float*, uint64_t* ) override;
+    int32_t GetD3D9AdapterIndex() override;
+    void GetDXGIOutputInfo( int32_t* ) override;
+    void GetOutputDevice( uint64_t*,
+                          vr::ETextureType,
+                          VkInstance_T* ) override;
+    bool IsDisplayOnDesktop() override;
+    bool SetDisplayVisibility( bool ) override;
+    void GetDeviceToAbsoluteTrackingPose( vr::ETrackingUniverseOrigin,
+                                          float,
+                                          vr::TrackedDevicePose_t*,
+                                          uint32_t ) override;
+    void ResetSeatedZeroPose() override;
+    vr::HmdMatrix34_t
+        GetSeatedZeroPoseToStandingAbsoluteTrackingPose() override;
+    vr::HmdMatrix34_t GetRawZeroPoseToStandingAbsoluteTrackingPose() override;
+    uint32_t GetSortedTrackedDeviceIndicesOfClass( vr::ETrackedDeviceClass,
+                                                   vr::TrackedDeviceIndex_t*,
+                                                   uint32_t,
+                                                   vr::TrackedDeviceIndex_t )
+        override;
+    vr::EDeviceActivityLevel
+        GetTrackedDeviceActivityLevel( vr::TrackedDeviceIndex_t ) override;
+    void ApplyTransform( vr::TrackedDevicePose_t*,
+                         const vr::TrackedDevicePose_t*,
+                         const vr::HmdMatrix34_t* ) override;
+    vr::TrackedDeviceIndex_t
+        GetTrackedDeviceIndexForControllerRole( vr::ETrackedControllerRole )
+            override;
+    vr::ETrackedControllerRole
+        GetControllerRoleForTrackedDeviceIndex( vr::TrackedDeviceIndex_t )
+            override;
+    vr::ETrackedDeviceClass
+        GetTrackedDeviceClass( vr::TrackedDeviceIndex_t ) override;
+    bool IsTrackedDeviceConnected( vr::TrackedDeviceIndex_t ) override;
+    bool GetBoolTrackedDeviceProperty( vr::TrackedDeviceIndex_t,
+                                       vr::ETrackedDeviceProperty,
+                                       vr::ETrackedPropertyError* ) override;
+    float GetFloatTrackedDeviceProperty( vr::TrackedDeviceIndex_t,
+                                         vr::ETrackedDeviceProperty,
+                                         vr::ETrackedPropertyError* ) override;
+    int32_t
+        GetInt32TrackedDeviceProperty( vr::TrackedDeviceIndex_t,
+                                       vr::ETrackedDeviceProperty,
+                                       vr::ETrackedPropertyError* ) override;
+    uint64_t
+        GetUint64TrackedDeviceProperty( vr::TrackedDeviceIndex_t,
+                                        vr::ETrackedDeviceProperty,
+                                        vr::ETrackedPropertyError* ) override;
+    vr::HmdMatrix34_t
+        GetMatrix34TrackedDeviceProperty( vr::TrackedDeviceIndex_t,
+                                          vr::ETrackedDeviceProperty,
+                                          vr::ETrackedPropertyError* ) override;
+    uint32_t GetArrayTrackedDeviceProperty( vr::TrackedDeviceIndex_t,
+                                            vr::ETrackedDeviceProperty,
+                                            vr::PropertyTypeTag_t,
+                                            void*,
+                                            uint32_t,
+                                            vr::ETrackedPropertyError* )
+        override;
+    uint32_t GetStringTrackedDeviceProperty( vr::TrackedDeviceIndex_t,
+                                             vr::ETrackedDeviceProperty,
+                                             char*,
+                                             uint32_t,
+                                             vr::ETrackedPropertyError* )
+        override;
+    const char* GetPropErrorNameFromEnum( vr::ETrackedPropertyError ) override;
+    bool PollNextEvent( vr::VREvent_t*, uint32_t ) override;
+    bool PollNextEventWithPose( vr::ETrackingUniverseOrigin,
+                                vr::VREvent_t*,
+                                uint32_t,
+                                vr::TrackedDevicePose_t* ) override;
+    const char* GetEventTypeNameFromEnum( vr::EVREventType ) override;
+    vr::HiddenAreaMesh_t GetHiddenAreaMesh( vr::EVREye,
+                                            vr::EHiddenAreaMeshType ) override;
+    bool GetControllerState( vr::TrackedDeviceIndex_t,
+                             vr::VRControllerState_t*,
+                             uint32_t ) override;
+    bool GetControllerStateWithPose( vr::ETrackingUniverseOrigin,
+                                     vr::TrackedDeviceIndex_t,
+                                     vr::VRControllerState_t*,
+                                     uint32_t,
+                                     vr::TrackedDevicePose_t* ) override;
+    void TriggerHapticPulse( vr::TrackedDeviceIndex_t,
+                             uint32_t,
+                             unsigned short ) override;
+    const char* GetButtonIdNameFromEnum( vr::EVRButtonId ) override;
+    const char*
+        GetControllerAxisTypeNameFromEnum( vr::EVRControllerAxisType ) override;
+    bool IsInputAvailable() override;
+    bool IsSteamVRDrawingControllers() override;
+    bool ShouldApplicationPause() override;
+    bool ShouldApplicationReduceRenderingWork() override;
+    uint32_t DriverDebugRequest( vr::TrackedDeviceIndex_t,
+                                 const char*,
+                                 char*,
+                                 uint32_t ) override;
+    vr::EVRFirmwareError
+        PerformFirmwareUpdate( vr::TrackedDeviceIndex_t ) override;
+    void AcknowledgeQuit_Exiting() override;
+    void AcknowledgeQuit_UserPrompt() override;
+};
+#if defined( __GNUC__ )
+#    pragma GCC diagnostic pop
+#endif
+
+StubSystem& stubSystem();
+
+} // namespace tests
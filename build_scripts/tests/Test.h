@@ -0,0 +1,102 @@
+#pragma once
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+/*!
+Minimal test and benchmark registry for the classes in src/utils.
+
+    TEST_CASE( PolygonUnionOverlapping )
+    {
+        CHECK( ... );
+    }
+
+    BENCHMARK( PolygonUnionThousandEdges )
+    {
+        tests::measure( "union", iterations, [&] { ... } );
+    }
+
+utils_tests runs every test case, utils_tests --bench every benchmark.
+--quick shrinks the benchmarks to a smoke run, a name as argument selects the
+cases or benchmarks that contain it.
+*/
+namespace tests
+{
+struct Case
+{
+    const char* name;
+    void ( *function )();
+};
+
+std::vector<Case>& testCases();
+std::vector<Case>& benchmarks();
+
+struct Registrar
+{
+    Registrar( std::vector<Case>& registry,
+               const char* name,
+               void ( *function )() )
+    {
+        registry.push_back( Case{ name, function } );
+    }
+};
+
+void fail( const char* file, int line, const char* expression );
+
+// Scales the iteration counts of benchmarks, 1 normally and small with
+// --quick.
+double benchmarkScale();
+
+inline unsigned scaled( unsigned iterations )
+{
+    const auto count = static_cast<unsigned>(
+        static_cast<double>( iterations ) * benchmarkScale() );
+    return count > 0 ? count : 1;
+}
+
+// Runs function iterations times and prints the time per call.
+template <typename Function>
+double measure( const char* label, unsigned iterations, Function function )
+{
+    const auto start = std::chrono::steady_clock::now();
+    for ( unsigned i = 0; i < iterations; i++ )
+    {
+        function();
+    }
+    const double seconds = std::chrono::duration<double>(
+                               std::chrono::steady_clock::now() - start )
+                               .count();
+    const double perCall = seconds / iterations;
+    if ( perCall >= 1e-3 )
+    {
+        std::printf( "    %s: %.3f ms\n", label, perCall * 1e3 );
+    }
+    else
+    {
+        std::printf( "    %s: %.1f ns\n", label, perCall * 1e9 );
+    }
+    return perCall;
+}
+
+} // namespace tests
+
+#define TEST_CASE( name )                                                \
+    static void name();                                                  \
+    static const tests::Registrar name##Registrar(                       \
+        tests::testCases(), #name, &name );                              \
+    static void name()
+
+#define BENCHMARK( name )                                                \
+    static void name();                                                  \
+    static const tests::Registrar name##Registrar(                       \
+        tests::benchmarks(), #name, &name );                             \
+    static void name()
+
+#define CHECK( expression )                                              \
+    ( ( expression ) ? static_cast<void>( 0 )                            \
+                     : tests::fail( __FILE__, __LINE__, #expression ) )
+
+#define CHECK_NEAR( a, b, tolerance )                                    \
+    CHECK( std::abs( ( a ) - ( b ) ) <= ( tolerance ) )
@@ -0,0 +1,91 @@
+#include "Test.h"
+#include <cstring>
+#include <string>
+#include <easylogging++.h>
+
+INITIALIZE_EASYLOGGINGPP
+
+namespace tests
+{
+namespace
+{
+    int g_failures = 0;
+    double g_benchmarkScale = 1.0;
+} // namespace
+
+std::vector<Case>& testCases()
+{
+    static std::vector<Case> cases;
+    return cases;
+}
+
+std::vector<Case>& benchmarks()
+{
+    static std::vector<Case> cases;
+    return cases;
+}
+
+void fail( const char* file, int line, const char* expression )
+{
+    std::printf( "    %s:%d: CHECK( %s ) failed\n", file, line, expression );
+    g_failures++;
+}
+
+double benchmarkScale()
+{
+    return g_benchmarkScale;
+}
+
+} // namespace tests
+
+int main( int argc, char* argv[] )
+{
+    bool bench = false;
+    std::string filter;
+    for ( int i = 1; i < argc; i++ )
+    {
+        if ( std::strcmp( argv[i], "--bench" ) == 0 )
+        {
+            bench = true;
+        }
+        else if ( std::strcmp( argv[i], "--quick" ) == 0 )
+        {
+            tests::g_benchmarkScale = 0.01;
+        }
+        else
+        {
+            filter = argv[i];
+        }
+    }
+
+    // The utils log through easylogging++, keep the output to the results.
+    el::Configurations logging;
+    logging.setToDefault();
+    logging.setGlobally( el::ConfigurationType::Enabled, "false" );
+    el::Loggers::reconfigureAllLoggers( logging );
+
+    int run = 0;
+    int failed = 0;
+    for ( const auto& entry : bench ? tests::benchmarks() : tests::testCases() )
+    {
+        if ( !filter.empty()
+             && std::string( entry.name ).find( filter ) == std::string::npos )
+        {
+            continue;
+        }
+        std::printf( "%s\n", entry.name );
+        std::fflush( stdout );
+        const int failuresBefore = tests::g_failures;
+        entry.function();
+        run++;
+        if ( tests::g_failures != failuresBefore )
+        {
+            failed++;
+        }
+    }
+    std::printf( "%d of %d %s passed\n",
+                 run - failed,
+                 run,
+                 bench ? "benchmarks" : "test cases" );
+    return failed == 0 && run > 0 ? 0 : 1;
+}
@@ -0,0 +1,317 @@
+#include "Test.h"
+#include "StubRuntime.h"
+#include "utils/UniverseTransform.h"
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+// Drag session like MoveCenterTabController produces it: small offset and yaw
+// steps every frame, one revert, apply and commit each.
+struct Session
+{
+    utils::UniverseTransform transform;
+    double offset[3] = { 0.0, 0.0, 0.0 };
+    double yaw = 0.0;
+
+    void commit()
+    {
+        auto& setup = tests::stubChaperoneSetup();
+        setup.RevertWorkingCopy();
+        if ( transform.apply(
+                 vr::TrackingUniverseStanding, offset, yaw, true ) )
+        {
+            setup.CommitWorkingCopy( vr::EChaperoneConfigFile_Live );
+        }
+    }
+};
+
+// Largest difference between the live universe center and the one derived
+// directly from the state, for an identity baseline.
+double poseError( const Session& session )
+{
+    const auto& pose = tests::stubChaperoneSetup().live.standingPose;
+    const double c = std::cos( session.yaw );
+    const double s = std::sin( session.yaw );
+    const double expected[3][4] = { { c, 0.0, s, session.offset[0] },
+                                    { 0.0, 1.0, 0.0, session.offset[1] },
+                                    { -s, 0.0, c, session.offset[2] } };
+    double error = 0.0;
+    for ( int i = 0; i < 3; i++ )
+    {
+        for ( int j = 0; j < 4; j++ )
+        {
+            error = std::max(
+                error,
+                std::abs( static_cast<double>( pose.m[i][j] )
+                          - expected[i][j] ) );
+        }
+    }
+    return error;
+}
+
+// Largest difference between the live bounds and the room moved by the state.
+double boundsError( const Session& session,
+                    const std::vector<vr::HmdQuad_t>& room )
+{
+    const auto& bounds = tests::stubChaperoneSetup().live.bounds;
+    const double c = std::cos( session.yaw );
+    const double s = std::sin( session.yaw );
+    double error = 0.0;
+    for ( size_t q = 0; q < room.size(); q++ )
+    {
+        for ( int k = 0; k < 4; k++ )
+        {
+            const auto& base = room[q].vCorners[k].v;
+            const double dx
+                = static_cast<double>( base[0] ) - session.offset[0];
+            const double dz
+                = static_cast<double>( base[2] ) - session.offset[2];
+            const auto& corner = bounds[q].vCorners[k].v;
+            error = std::max(
+                { error,
+                  std::abs( static_cast<double>( corner[0] )
+                            - ( c * dx - s * dz ) ),
+                  std::abs( static_cast<double>( corner[2] )
+                            - ( s * dx + c * dz ) ) } );
+        }
+    }
+    return error;
+}
+
+// Largest difference between two zero poses.
+double poseDifference( const vr::HmdMatrix34_t& a, const vr::HmdMatrix34_t& b )
+{
+    double error = 0.0;
+    for ( int i = 0; i < 3; i++ )
+    {
+        for ( int j = 0; j < 4; j++ )
+        {
+            error = std::max( error,
+                              std::abs( static_cast<double>( a.m[i][j] )
+                                        - static_cast<double>( b.m[i][j] ) ) );
+        }
+    }
+    return error;
+}
+
+// Largest difference between the live bounds in raw tracking space and the
+// room, which starts out at an identity zero pose.
+double rawBoundsError( const std::vector<vr::HmdQuad_t>& room )
+{
+    const auto& live = tests::stubChaperoneSetup().live;
+    const auto& pose = live.standingPose.m;
+    double error = 0.0;
+    for ( size_t q = 0; q < room.size(); q++ )
+    {
+        for ( int k = 0; k < 4; k++ )
+        {
+            const auto& corner = live.bounds[q].vCorners[k].v;
+            for ( int i = 0; i < 3; i++ )
+            {
+                double raw = static_cast<double>( pose[i][3] );
+                for ( int j = 0; j < 3; j++ )
+                {
+                    raw += static_cast<double>( pose[i][j] )
+                           * static_cast<double>( corner[j] );
+                }
+                error = std::max(
+                    error,
+                    std::abs( raw
+                              - static_cast<double>(
+                                  room[q].vCorners[k].v[i] ) ) );
+            }
+        }
+    }
+    return error;
+}
+
+// Saves an anchor like MoveCenterTabController::addPlayspaceAnchor().
+vr::HmdMatrix34_t saveAnchor( Session& session )
+{
+    tests::stubChaperoneSetup().RevertWorkingCopy();
+    return session.transform.poseFor(
+        vr::TrackingUniverseStanding, session.offset, session.yaw );
+}
+
+// Jumps like MoveCenterTabController::jumpToPlayspaceAnchor().
+void jumpToAnchor( Session& session, const vr::HmdMatrix34_t& anchor )
+{
+    tests::stubChaperoneSetup().RevertWorkingCopy();
+    session.transform.stateFor(
+        vr::TrackingUniverseStanding, anchor, session.offset, session.yaw );
+    session.commit();
+}
+
+} // namespace
+
+TEST_CASE( UniverseTransformLongDragDoesNotDrift )
+{
+    auto& setup = tests::stubChaperoneSetup();
+    setup.reset();
+    const auto room = tests::roomBounds( 4.0f, 3.0f );
+    setup.live.bounds = room;
+    setup.working.bounds = room;
+
+    // An hour at 144 Hz of slow wandering drags and turns, in steps far below
+    // the float resolution of the values they add up to.
+    Session session;
+    constexpr int k_frames = 144 * 3600;
+    for ( int frame = 0; frame < k_frames; frame++ )
+    {
+        const double t = frame / 144.0;
+        session.offset[0] += 0.0007 * std::sin( t * 0.05 );
+        session.offset[2] += 0.0005 * std::cos( t * 0.031 );
+        session.yaw += 0.00011 * std::sin( t * 0.017 );
+        session.commit();
+    }
+
+    CHECK( setup.commits == static_cast<unsigned>( k_frames ) );
+    CHECK( poseError( session ) < 1e-5 );
+    CHECK( boundsError( session, room ) < 1e-4 );
+    // Walls stay on the floor and keep their height.
+    for ( const auto& quad : setup.live.bounds )
+    {
+        CHECK( quad.vCorners[0].v[1] == 0.0f );
+        CHECK( quad.vCorners[1].v[1] == room[0].vCorners[1].v[1] );
+    }
+}
+
+TEST_CASE( UniverseTransformReturnsToStart )
+{
+    auto& setup = tests::stubChaperoneSetup();
+    setup.reset();
+    const auto room = tests::roomBounds( 4.0f, 3.0f );
+    setup.live.bounds = room;
+
+    Session session;
+    for ( int frame = 0; frame < 100000; frame++ )
+    {
+        session.offset[0] += frame < 50000 ? 0.001 : -0.001;
+        session.yaw += frame < 50000 ? 0.0001 : -0.0001;
+        session.commit();
+    }
+    CHECK( std::abs( session.offset[0] ) < 1e-9 );
+    CHECK( poseError( session ) < 1e-6 );
+    CHECK( boundsError( session, room ) < 1e-6 );
+}
+
+TEST_CASE( UniverseTransformKeepsOutsideChanges )
+{
+    auto& setup = tests::stubChaperoneSetup();
+    setup.reset();
+
+    Session session;
+    session.offset[0] = 1.0;
+    session.commit();
+
+    // Floor fix in between: raises the universe center by 5 cm.
+    setup.RevertWorkingCopy();
+    setup.working.standingPose.m[1][3] += 0.05f;
+    setup.CommitWorkingCopy( vr::EChaperoneConfigFile_Live );
+
+    session.offset[0] = 2.0;
+    session.commit();
+    const auto& pose = setup.live.standingPose;
+    CHECK_NEAR( static_cast<double>( pose.m[0][3] ), 2.0, 1e-6 );
+    CHECK_NEAR( static_cast<double>( pose.m[1][3] ), 0.05, 1e-6 );
+}
+
+TEST_CASE( UniverseTransformSkipsUnchangedState )
+{
+    auto& setup = tests::stubChaperoneSetup();
+    setup.reset();
+    setup.live.bounds = tests::roomBounds( 2.0f, 2.0f );
+
+    Session session;
+    session.offset[2] = 0.5;
+    session.commit();
+    const unsigned commits = setup.commits;
+    const unsigned boundsWrites = setup.boundsWrites;
+    session.commit();
+    CHECK( setup.commits == commits );
+    CHECK( setup.boundsWrites == boundsWrites );
+}
+
+TEST_CASE( UniverseTransformAnchorSurvivesRebase )
+{
+    auto& setup = tests::stubChaperoneSetup();
+    setup.reset();
+    const auto room = tests::roomBounds( 4.0f, 3.0f );
+    setup.live.bounds = room;
+
+    Session session;
+    session.offset[0] = 1.0;
+    session.offset[2] = 0.5;
+    session.yaw = 0.3;
+    session.commit();
+    const auto anchor = saveAnchor( session );
+    CHECK( poseDifference( anchor, setup.live.standingPose ) < 1e-6 );
+
+    // "Apply Room Settings Offsets as Center", then somewhere else.
+    session.transform.rebase();
+    session.offset[0] = 0.0;
+    session.offset[2] = 0.0;
+    session.yaw = 0.0;
+    session.commit();
+    session.offset[0] = -2.0;
+    session.yaw = -1.0;
+    session.commit();
+
+    jumpToAnchor( session, anchor );
+    CHECK( poseDifference( anchor, setup.live.standingPose ) < 1e-5 );
+    // The moved playspace is where it was, measured from the new center.
+    CHECK_NEAR( session.offset[0], 0.0, 1e-5 );
+    CHECK_NEAR( session.offset[2], 0.0, 1e-5 );
+    CHECK_NEAR( session.yaw, 0.0, 1e-5 );
+    // And the bounds didn't leave the room.
+    CHECK( rawBoundsError( room ) < 1e-5 );
+}
+
+TEST_CASE( UniverseTransformAnchorSurvivesOutsideChanges )
+{
+    auto& setup = tests::stubChaperoneSetup();
+    setup.reset();
+
+    Session session;
+    session.offset[2] = -1.5;
+    session.yaw = 2.0;
+    session.commit();
+    const auto anchor = saveAnchor( session );
+
+    // Room setup moves and turns the universe center in between.
+    setup.RevertWorkingCopy();
+    setup.working.standingPose.m[0][3] += 0.7f;
+    setup.working.standingPose.m[2][3] -= 0.2f;
+    setup.working.standingPose.m[0][0] = 0.0f;
+    setup.working.standingPose.m[0][2] = 1.0f;
+    setup.working.standingPose.m[2][0] = -1.0f;
+    setup.working.standingPose.m[2][2] = 0.0f;
+    setup.CommitWorkingCopy( vr::EChaperoneConfigFile_Live );
+    session.offset[0] = 3.0;
+    session.commit();
+
+    jumpToAnchor( session, anchor );
+    CHECK( poseDifference( anchor, setup.live.standingPose ) < 1e-5 );
+}
+
+BENCHMARK( UniverseTransformDragFrame )
+{
+    // One frame of a drag with a room of 64 walls: revert, apply and commit.
+    auto& setup = tests::stubChaperoneSetup();
+    setup.reset();
+    std::vector<vr::HmdQuad_t> room;
+    for ( float size = 4.0f; size < 5.6f; size += 0.1f )
+    {
+        const auto walls = tests::roomBounds( size, 3.0f );
+        room.insert( room.end(), walls.begin(), walls.end() );
+    }
+    setup.live.bounds = room;
+
+    Session session;
+    tests::measure( "drag frame", tests::scaled( 200000 ), [&] {
+        session.offset[0] += 0.0001;
+        session.yaw += 0.00001;
+        session.commit();
+    } );
+}
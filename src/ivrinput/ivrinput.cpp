@@ -6,6 +6,17 @@
 
 namespace input
 {
+namespace
+{
+    // Frames between updates of the low rate sets. Short enough that a quick
+    // button press is still seen at 90 Hz.
+    constexpr unsigned k_lowRateInterval = 4;
+    // Low rate updates between checks whether the legacy media actions are
+    // bound, about 10 s at 90 Hz. Bindings change rarely, but the new ones
+    // are only seen after the check.
+    constexpr unsigned k_legacyBindingCheckInterval = 256;
+} // namespace
+
 /*!
 Wrapper around the IVRInput GetDigitalActionData with error handling.
 
@@ -124,12 +135,26 @@ mystically not working.
 */
 SteamIVRInput::SteamIVRInput()
     : m_manifest(), m_mainSet( input_strings::k_setMain ),
+      m_musicSet( input_strings::k_setMusic ),
       m_nextTrack( input_strings::k_actionNextTrack, ActionType::Digital ),
       m_previousTrack( input_strings::k_actionPreviousTrack,
                        ActionType::Digital ),
       m_pausePlayTrack( input_strings::k_actionPausePlayTrack,
                         ActionType::Digital ),
       m_stopTrack( input_strings::k_actionStopTrack, ActionType::Digital ),
+      m_legacyNextTrack{ Action( input_strings::k_actionLegacyNextTrack,
+                                 ActionType::Digital ),
+                         false },
+      m_legacyPreviousTrack{ Action( input_strings::k_actionLegacyPreviousTrack,
+                                     ActionType::Digital ),
+                             false },
+      m_legacyPausePlayTrack{
+          Action( input_strings::k_actionLegacyPausePlayTrack,
+                  ActionType::Digital ),
+          false },
+      m_legacyStopTrack{ Action( input_strings::k_actionLegacyStopTrack,
+                                 ActionType::Digital ),
+                         false },
       m_leftHandRoomTurn( input_strings::k_actionLeftHandRoomTurn,
                           ActionType::Digital ),
       m_rightHandRoomTurn( input_strings::k_actionRightHandRoomTurn,
@@ -150,11 +175,22 @@ SteamIVRInput::SteamIVRInput()
       m_optionalOverrideRightHandRoomDrag(
           input_strings::k_actionOptionalOverrideRightHandRoomDrag,
           ActionType::Digital ),
-      m_pushToTalk( input_strings::k_actionPushToTalk, ActionType::Digital )
+      m_pushToTalk( input_strings::k_actionPushToTalk, ActionType::Digital ),
+      m_smoothMove( input_strings::k_actionSmoothMove, ActionType::Analog ),
+      m_smoothTurn( input_strings::k_actionSmoothTurn, ActionType::Analog ),
+      m_traceBoundary( input_strings::k_actionTraceBoundary,
+                       ActionType::Digital ),
+      m_nextPlayspaceAnchor( input_strings::k_actionNextPlayspaceAnchor,
+                             ActionType::Digital )
 {
-    m_activeActionSet.ulActionSet = m_mainSet.handle();
-    m_activeActionSet.ulRestrictedToDevice = vr::k_ulInvalidInputValueHandle;
-    m_activeActionSet.nPriority = 0;
+    m_activeActionSets[0].ulActionSet = m_mainSet.handle();
+    m_activeActionSets[0].ulRestrictedToDevice
+        = vr::k_ulInvalidInputValueHandle;
+    m_activeActionSets[0].nPriority = 0;
+    m_activeActionSets[1].ulActionSet = m_musicSet.handle();
+    m_activeActionSets[1].ulRestrictedToDevice
+        = vr::k_ulInvalidInputValueHandle;
+    m_activeActionSets[1].nPriority = 0;
 }
 /*!
 Returns true if the next media track should be played.
@@ -164,7 +200,12 @@ button down will result in false until it has been released and pushed again.
 */
 bool SteamIVRInput::nextSong()
 {
-    return isDigitalActionActivatedOnce( m_nextTrack );
+    if ( !m_lowRateSetsUpdated )
+    {
+        return false;
+    }
+    const bool legacy = isLegacyActionActivatedOnce( m_legacyNextTrack );
+    return isDigitalActionActivatedOnce( m_nextTrack ) || legacy;
 }
 
 /*!
@@ -175,7 +216,12 @@ button down will result in false until it has been released and pushed again.
 */
 bool SteamIVRInput::previousSong()
 {
-    return isDigitalActionActivatedOnce( m_previousTrack );
+    if ( !m_lowRateSetsUpdated )
+    {
+        return false;
+    }
+    const bool legacy = isLegacyActionActivatedOnce( m_legacyPreviousTrack );
+    return isDigitalActionActivatedOnce( m_previousTrack ) || legacy;
 }
 
 /*!
@@ -186,7 +232,12 @@ button down will result in false until it has been released and pushed again.
 */
 bool SteamIVRInput::pausePlaySong()
 {
-    return isDigitalActionActivatedOnce( m_pausePlayTrack );
+    if ( !m_lowRateSetsUpdated )
+    {
+        return false;
+    }
+    const bool legacy = isLegacyActionActivatedOnce( m_legacyPausePlayTrack );
+    return isDigitalActionActivatedOnce( m_pausePlayTrack ) || legacy;
 }
 
 /*!
@@ -197,7 +248,61 @@ button down will result in false until it has been released and pushed again.
 */
 bool SteamIVRInput::stopSong()
 {
-    return isDigitalActionActivatedOnce( m_stopTrack );
+    if ( !m_lowRateSetsUpdated )
+    {
+        return false;
+    }
+    const bool legacy = isLegacyActionActivatedOnce( m_legacyStopTrack );
+    return isDigitalActionActivatedOnce( m_stopTrack ) || legacy;
+}
+
+/*!
+Returns true if a legacy action was pressed since it was last read. They are
+in the main set but only read on low rate frames, so bChanged would miss
+presses that began on the frames in between.
+*/
+bool SteamIVRInput::isLegacyActionActivatedOnce( LegacyAction& legacy )
+{
+    if ( !m_legacyBound )
+    {
+        legacy.pressed = false;
+        return false;
+    }
+    const bool pressed = isDigitalActionActivatedConstant( legacy.action );
+    const bool activated = pressed && !legacy.pressed;
+    legacy.pressed = pressed;
+    return activated;
+}
+
+/*!
+Checks whether any legacy media action still has a binding. Only the user's
+own bindings saved before the split have them, the default bindings don't.
+*/
+void SteamIVRInput::updateLegacyBindings()
+{
+    bool bound = false;
+    for ( auto* legacy : { &m_legacyNextTrack,
+                           &m_legacyPreviousTrack,
+                           &m_legacyPausePlayTrack,
+                           &m_legacyStopTrack } )
+    {
+        vr::VRInputValueHandle_t origins[vr::k_unMaxActionOriginCount] = {};
+        const auto error
+            = vr::VRInput()->GetActionOrigins( m_mainSet.handle(),
+                                               legacy->action.handle(),
+                                               origins,
+                                               vr::k_unMaxActionOriginCount );
+        bound = bound
+                || ( error == vr::EVRInputError::VRInputError_None
+                     && origins[0] != vr::k_ulInvalidInputValueHandle );
+    }
+    if ( bound != m_legacyBound )
+    {
+        LOG( INFO ) << "Old media bindings in the main set are "
+                    << ( bound ? "bound, move them to the media action set"
+                               : "no longer bound" );
+    }
+    m_legacyBound = bound;
 }
 
 bool SteamIVRInput::leftHandRoomTurn()
@@ -248,17 +353,86 @@ bool SteamIVRInput::pushToTalk()
     return isDigitalActionActivatedConstant( m_pushToTalk );
 }
 
+/*!
+Returns the thumbstick position bound to smooth movement. Both axes are zero if
+the action isn't bound or its device isn't active.
+*/
+void SteamIVRInput::smoothMove( float& x, float& y )
+{
+    const auto handleData = getAnalogActionData( m_smoothMove );
+    x = handleData.bActive ? handleData.x : 0.0f;
+    y = handleData.bActive ? handleData.y : 0.0f;
+}
+
+/*!
+Returns the horizontal thumbstick position bound to smooth turning, zero if the
+action isn't bound or its device isn't active.
+*/
+float SteamIVRInput::smoothTurn()
+{
+    const auto handleData = getAnalogActionData( m_smoothTurn );
+    return handleData.bActive ? handleData.x : 0.0f;
+}
+
+/*!
+Returns the controller the boundary tracing action is held on. The action can
+be bound to either hand, the device is found through the origin that
+activated it.
+*/
+vr::TrackedDeviceIndex_t SteamIVRInput::traceBoundary()
+{
+    const auto handleData = getDigitalActionData( m_traceBoundary );
+    if ( !handleData.bActive || !handleData.bState )
+    {
+        return vr::k_unTrackedDeviceIndexInvalid;
+    }
+    vr::InputOriginInfo_t originInfo = {};
+    const auto error = vr::VRInput()->GetOriginTrackedDeviceInfo(
+        handleData.activeOrigin, &originInfo, sizeof( originInfo ) );
+    if ( error != vr::EVRInputError::VRInputError_None )
+    {
+        LOG( ERROR ) << "Error getting the device of action "
+                     << m_traceBoundary.name() << ". SteamVR Error: " << error;
+        return vr::k_unTrackedDeviceIndexInvalid;
+    }
+    return originInfo.trackedDeviceIndex;
+}
+
+/*!
+Returns true if the playspace should jump to the next anchor.
+
+Will only return true the first time that the button is pressed.
+*/
+bool SteamIVRInput::nextPlayspaceAnchor()
+{
+    return isDigitalActionActivatedOnce( m_nextPlayspaceAnchor );
+}
+
 /*!
 Updates the active action set(s).
 Should be called every frame, or however often you want the input system to
-update state.
+update state. The low rate sets are only included every k_lowRateInterval
+calls, or on every call with updateLowRateSets set.
 */
-void SteamIVRInput::UpdateStates()
+void SteamIVRInput::UpdateStates( bool updateLowRateSets )
 {
-    constexpr auto numberOfSets = 1;
+    m_framesSinceLowRateUpdate++;
+    m_lowRateSetsUpdated = updateLowRateSets
+                           || m_framesSinceLowRateUpdate >= k_lowRateInterval;
+    if ( m_lowRateSetsUpdated )
+    {
+        m_framesSinceLowRateUpdate = 0;
+    }
+    const uint32_t numberOfSets = m_lowRateSetsUpdated ? 2 : 1;
 
-    const auto error = vr::VRInput()->UpdateActionState(
-        &m_activeActionSet, sizeof( m_activeActionSet ), numberOfSets );
+    const auto start = std::chrono::steady_clock::now();
+    const auto error
+        = vr::VRInput()->UpdateActionState( m_activeActionSets,
+                                            sizeof( m_activeActionSets[0] ),
+                                            numberOfSets );
+    auto& cost = m_lowRateSetsUpdated ? m_allCost : m_mainCost;
+    cost.total += std::chrono::steady_clock::now() - start;
+    cost.count++;
 
     if ( error != vr::EVRInputError::VRInputError_None )
     {
@@ -266,6 +440,31 @@ void SteamIVRInput::UpdateStates()
             << "Error during IVRInput action state update. OpenVR Error: "
             << error;
     }
+    else if ( m_lowRateSetsUpdated )
+    {
+        // The origins are known after the first update with the bindings.
+        if ( m_updatesUntilLegacyBindingCheck == 0 )
+        {
+            updateLegacyBindings();
+            m_updatesUntilLegacyBindingCheck = k_legacyBindingCheckInterval;
+        }
+        m_updatesUntilLegacyBindingCheck--;
+    }
+}
+
+void SteamIVRInput::logStatistics() const
+{
+    auto average = []( const UpdateCost& cost ) {
+        return cost.count > 0
+                   ? std::chrono::duration<double, std::micro>( cost.total )
+                             .count()
+                         / static_cast<double>( cost.count )
+                   : 0.0;
+    };
+    LOG( INFO ) << "IVRInput update: " << average( m_mainCost )
+                << " us with the main set (" << m_mainCost.count
+                << " frames), " << average( m_allCost )
+                << " us with all sets (" << m_allCost.count << " frames)";
 }
 
 } // namespace input
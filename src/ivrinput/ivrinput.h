@@ -1,5 +1,6 @@
 #pragma once
 
+#include <chrono>
 #include <openvr.h>
 #include "ivrinput_action.h"
 #include "ivrinput_manifest.h"
@@ -12,6 +13,21 @@ Responsible for controller input.
 
 UpdateStates should be called every frame.
 
+Actions are split into two action sets. The main set holds the latency
+critical actions (room drag/turn, push to talk) and is updated every frame.
+The music set holds actions that are only pressed every now and then, it is
+only updated every k_lowRateInterval frames, or every frame while
+UpdateStates is told to. While it isn't updated its actions return false.
+
+The media actions used to be in the main set. Their old paths are kept as
+legacy actions so bindings saved before the split keep working. Those paths
+name the main set, and UpdateActionState works on whole sets, so they can't
+be moved to the low rate update without breaking the bindings they are kept
+for. Instead they are only read when the music set is updated too, and not
+at all while none of them is bound, which is checked every
+k_legacyBindingCheckInterval low rate updates. Unbound they give the runtime
+nothing to evaluate in the main set update.
+
 Binary actions should only have one function,
 and they should reflect the expected behaviour. I.e. if a button being pressed
 and held should only return true the first time, that logic should be in the
@@ -35,7 +51,9 @@ class SteamIVRInput
 public:
     SteamIVRInput();
 
-    void UpdateStates();
+    void UpdateStates( bool updateLowRateSets = false );
+    // Logs the average cost of the UpdateActionState calls.
+    void logStatistics() const;
 
     bool nextSong();
     bool previousSong();
@@ -53,6 +71,16 @@ public:
 
     bool pushToTalk();
 
+    // Thumbstick position, each axis in -1 .. 1. Zero while not bound.
+    void smoothMove( float& x, float& y );
+    float smoothTurn();
+
+    // Controller the boundary tracing action is held on,
+    // k_unTrackedDeviceIndexInvalid while it isn't held.
+    vr::TrackedDeviceIndex_t traceBoundary();
+
+    bool nextPlayspaceAnchor();
+
     // Destructor. There are no terminating calls for the IVRInput API, so it
     // is left blank.
     ~SteamIVRInput() {}
@@ -71,10 +99,31 @@ public:
     SteamIVRInput& operator=( const SteamIVRInput&& ) = delete;
 
 private:
+    struct LegacyAction
+    {
+        Action action;
+        bool pressed;
+    };
+
+    bool isLegacyActionActivatedOnce( LegacyAction& legacy );
+    void updateLegacyBindings();
+
     Manifest m_manifest;
 
     ActionSet m_mainSet;
-    vr::VRActiveActionSet_t m_activeActionSet = {};
+    ActionSet m_musicSet;
+    // Main set first, UpdateStates passes either only the first or both.
+    vr::VRActiveActionSet_t m_activeActionSets[2] = {};
+    unsigned m_framesSinceLowRateUpdate = 0;
+    bool m_lowRateSetsUpdated = false;
+
+    struct UpdateCost
+    {
+        uint64_t count = 0;
+        std::chrono::steady_clock::duration total{};
+    };
+    UpdateCost m_mainCost;
+    UpdateCost m_allCost;
 
     // Music player bindings
     Action m_nextTrack;
@@ -82,6 +131,16 @@ private:
     Action m_pausePlayTrack;
     Action m_stopTrack;
 
+    // Music player bindings saved before the music set existed. Pressed
+    // state at the last read, bChanged refers to the last main set update.
+    LegacyAction m_legacyNextTrack;
+    LegacyAction m_legacyPreviousTrack;
+    LegacyAction m_legacyPausePlayTrack;
+    LegacyAction m_legacyStopTrack;
+    // Any legacy action bound, low rate updates until the next check.
+    bool m_legacyBound = false;
+    unsigned m_updatesUntilLegacyBindingCheck = 0;
+
     // Room bindings
     Action m_leftHandRoomTurn;
     Action m_rightHandRoomTurn;
@@ -94,6 +153,16 @@ private:
 
     // Push To Talk
     Action m_pushToTalk;
+
+    // Thumbstick locomotion
+    Action m_smoothMove;
+    Action m_smoothTurn;
+
+    // Chaperone boundary tracing
+    Action m_traceBoundary;
+
+    // Playspace anchors
+    Action m_nextPlayspaceAnchor;
 };
 
 /*!
@@ -103,10 +172,17 @@ should be used to refer to all action manifest strings.
 */
 namespace input_strings
 {
-    constexpr auto k_actionNextTrack = "/actions/main/in/NextTrack";
-    constexpr auto k_actionPreviousTrack = "/actions/main/in/PreviousTrack";
-    constexpr auto k_actionPausePlayTrack = "/actions/main/in/PausePlayTrack";
-    constexpr auto k_actionStopTrack = "/actions/main/in/StopTrack";
+    constexpr auto k_actionNextTrack = "/actions/music/in/NextTrack";
+    constexpr auto k_actionPreviousTrack = "/actions/music/in/PreviousTrack";
+    constexpr auto k_actionPausePlayTrack = "/actions/music/in/PausePlayTrack";
+    constexpr auto k_actionStopTrack = "/actions/music/in/StopTrack";
+
+    constexpr auto k_actionLegacyNextTrack = "/actions/main/in/NextTrack";
+    constexpr auto k_actionLegacyPreviousTrack
+        = "/actions/main/in/PreviousTrack";
+    constexpr auto k_actionLegacyPausePlayTrack
+        = "/actions/main/in/PausePlayTrack";
+    constexpr auto k_actionLegacyStopTrack = "/actions/main/in/StopTrack";
 
     constexpr auto k_actionLeftHandRoomTurn
         = "/actions/main/in/LeftHandRoomTurn";
@@ -127,7 +203,16 @@ namespace input_strings
 
     constexpr auto k_actionPushToTalk = "/actions/main/in/PushToTalk";
 
+    constexpr auto k_actionSmoothMove = "/actions/main/in/SmoothMove";
+    constexpr auto k_actionSmoothTurn = "/actions/main/in/SmoothTurn";
+
+    constexpr auto k_actionTraceBoundary = "/actions/main/in/TraceBoundary";
+
+    constexpr auto k_actionNextPlayspaceAnchor
+        = "/actions/main/in/NextPlayspaceAnchor";
+
     constexpr auto k_setMain = "/actions/main";
+    constexpr auto k_setMusic = "/actions/music";
 
 } // namespace input_strings
 
@@ -41,12 +41,29 @@ bool CheckCommandLineArgument( int argc,
     return false;
 }
 
+// Returns the argument following a specific launch argument, empty if there is
+// none.
+std::string GetCommandLineArgumentValue( int argc,
+                                         char* argv[],
+                                         const std::string parameter )
+{
+    for ( int i = 0; i + 1 < argc; i++ )
+    {
+        if ( std::string( argv[i] ) == parameter )
+        {
+            return argv[i + 1];
+        }
+    }
+    return std::string();
+}
+
 constexpr auto kDesktopMode = "-desktop";
 constexpr auto kNoSound = "-nosound";
 constexpr auto kNoManifest = "-nomanifest";
 constexpr auto kInstallManifest = "-installmanifest";
 constexpr auto kRemoveManifest = "-removemanifest";
 constexpr auto kEnableBindingsInterface = "-bindingsinterface";
+constexpr auto kEventLoad = "-eventload";
 } // namespace argument
 
 namespace manifest
@@ -360,6 +377,8 @@ int main( int argc, char* argv[] )
         argc, argv, argument::kRemoveManifest );
     const bool bindingsInterface = argument::CheckCommandLineArgument(
         argc, argv, argument::kEnableBindingsInterface );
+    const auto eventLoadMix = argument::GetCommandLineArgumentValue(
+        argc, argv, argument::kEventLoad );
 
     // If a command line arg is set, make sure the logs reflect that.
     LOG_IF( desktopMode, INFO ) << "Desktop mode enabled.";
@@ -368,6 +387,7 @@ int main( int argc, char* argv[] )
     LOG_IF( installManifest, INFO ) << "Install manifest enabled.";
     LOG_IF( removeManifest, INFO ) << "Remove manifest enabled.";
     LOG_IF( bindingsInterface, INFO ) << "Bindings interface enabled.";
+    LOG_IF( !eventLoadMix.empty(), INFO ) << "Event load: " << eventLoadMix;
 
     if ( bindingsInterface )
     {
@@ -439,6 +459,10 @@ int main( int argc, char* argv[] )
             qobject_cast<QQuickItem*>( quickObj ),
             advsettings::OverlayController::applicationDisplayName,
             advsettings::OverlayController::applicationKey );
+        if ( !eventLoadMix.empty() )
+        {
+            controller.startEventLoad( eventLoadMix );
+        }
 
         // Attempts to install the application manifest on all "regular" starts.
         if ( !desktopMode && !noManifest )
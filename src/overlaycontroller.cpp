@@ -15,8 +15,11 @@
 #include <QCursor>
 #include <QProcess>
 #include <QMessageBox>
+#include <algorithm>
 #include <iostream>
+#include <cstring>
 #include <cmath>
+#include <chrono>
 #include <openvr.h>
 #include <easylogging++.h>
 #include "utils/Matrix.h"
@@ -26,6 +29,20 @@ namespace advsettings
 {
 constexpr const char* OverlayController::applicationVersionString;
 
+namespace
+{
+    // Scale of the reduced render level.
+    constexpr double k_reducedRenderScale = 0.5;
+    // Further away the text isn't readable at full resolution anyway, in m.
+    constexpr float k_fullRenderDistance = 2.5f;
+    // Avoids reallocating the render target when the pointer only briefly
+    // leaves the overlay.
+    constexpr std::chrono::seconds k_reducedRenderLevelDelay{ 2 };
+    // RGBA8 color and 24 bit depth with 8 bit stencil.
+    constexpr int k_renderTargetBytesPerPixel = 8;
+    constexpr std::chrono::seconds k_eventLoadReportInterval{ 10 };
+} // namespace
+
 QSettings* OverlayController::_appSettings = nullptr;
 
 OverlayController::OverlayController( bool desktopMode,
@@ -118,6 +135,12 @@ OverlayController::OverlayController( bool desktopMode,
             nullptr, "OpenVR Advanced Settings Overlay", "Is OpenVR running?" );
         throw std::runtime_error( std::string( "No Overlay interface" ) );
     }
+    // Before the controllers, so the chaperone data is reloaded before they
+    // see chaperone events.
+    subscribeEvents();
+    // Later reloads only happen on chaperone change events.
+    m_chaperoneUtils.loadChaperoneData();
+
     // Init controllers
     m_steamVRTabController.initStage1();
     m_chaperoneTabController.initStage1();
@@ -282,6 +305,8 @@ void OverlayController::Shutdown()
         m_pRenderTimer->stop();
         m_pRenderTimer.reset();
     }
+    m_statisticsTabController.destroyPerformanceHud();
+    m_pRenderTimerQuery.reset();
     m_pWindow.reset();
     m_pRenderControl.reset();
     m_pFbo.reset();
@@ -359,6 +384,15 @@ void OverlayController::SetWidget( QQuickItem* quickItem,
         m_pWindow.reset( new QQuickWindow( m_pRenderControl.get() ) );
         m_pWindow->setRenderTarget( m_pFbo.get() );
         quickItem->setParentItem( m_pWindow->contentItem() );
+        // The item is scaled down with the render target.
+        quickItem->setTransformOrigin( QQuickItem::TopLeft );
+        m_pOverlayItem = quickItem;
+        m_overlaySize = QSize( static_cast<int>( quickItem->width() ),
+                               static_cast<int>( quickItem->height() ) );
+        m_renderLevelStats[static_cast<size_t>( RenderLevel::Full )].width
+            = m_overlaySize.width();
+        m_renderLevelStats[static_cast<size_t>( RenderLevel::Full )].height
+            = m_overlaySize.height();
         m_pWindow->setGeometry( 0,
                                 0,
                                 static_cast<int>( quickItem->width() ),
@@ -371,6 +405,14 @@ void OverlayController::SetWidget( QQuickItem* quickItem,
         vr::VROverlay()->SetOverlayMouseScale( m_ulOverlayHandle,
                                                &vecWindowSize );
 
+        m_pRenderTimerQuery.reset( new QOpenGLTimerQuery() );
+        if ( !m_pRenderTimerQuery->create() )
+        {
+            LOG( INFO ) << "Timer queries not supported, GPU render time is "
+                           "not measured";
+            m_pRenderTimerQuery.reset();
+        }
+
         connect( m_pRenderControl.get(),
                  SIGNAL( renderRequested() ),
                  this,
@@ -415,15 +457,28 @@ void OverlayController::renderOverlay()
 {
     if ( !m_desktopMode )
     {
-        // skip rendering if the overlay isn't visible
+        // skip rendering if the overlay isn't visible, unless the dashboard
+        // was just opened and it is about to be. The thumbnail shows a fixed
+        // image and doesn't need the texture.
         if ( !vr::VROverlay()
-             || ( !vr::VROverlay()->IsOverlayVisible( m_ulOverlayHandle )
-                  && !vr::VROverlay()->IsOverlayVisible(
-                         m_ulOverlayThumbnailHandle ) ) )
+             || ( !m_preRenderPending
+                  && !vr::VROverlay()->IsOverlayVisible( m_ulOverlayHandle ) ) )
             return;
+        auto& stats
+            = m_renderLevelStats[static_cast<size_t>( m_renderLevel )];
+        const bool timed = startRenderTimerQuery();
+        const auto start = std::chrono::steady_clock::now();
         m_pRenderControl->polishItems();
         m_pRenderControl->sync();
         m_pRenderControl->render();
+        if ( timed )
+        {
+            m_pRenderTimerQuery->end();
+        }
+        stats.renders++;
+        stats.cpuMilliseconds += std::chrono::duration<double, std::milli>(
+                                     std::chrono::steady_clock::now() - start )
+                                     .count();
 
         GLuint unTexture = m_pFbo->texture();
         if ( unTexture != 0 )
@@ -444,9 +499,44 @@ void OverlayController::renderOverlay()
         }
         m_pOpenGLContext->functions()->glFlush(); // We need to flush otherwise
                                                   // the texture may be empty.*/
+
+        if ( m_preRenderPending )
+        {
+            // The compositor shows the texture from its next frame on.
+            m_preRenderPending = false;
+            const double latency
+                = std::chrono::duration<double, std::milli>(
+                      std::chrono::steady_clock::now()
+                      - m_dashboardActivatedAt )
+                      .count();
+            m_dashboardActivations++;
+            m_activationLatencyMilliseconds += latency;
+            m_maxActivationLatencyMilliseconds
+                = std::max( m_maxActivationLatencyMilliseconds, latency );
+            LOG( DEBUG ) << "Dashboard activation to first current frame: "
+                         << latency << " ms";
+        }
     }
 }
 
+void OverlayController::refreshDashboard( float eventAgeSeconds )
+{
+    m_dashboardActivatedAt
+        = std::chrono::steady_clock::now()
+          - std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+              std::chrono::duration<float>( eventAgeSeconds ) );
+    // Instead of spreading the updates over the next seconds every tab reads
+    // its values in the coming tick, the page is rendered after that.
+    m_audioTabController.refreshSettings();
+    m_chaperoneTabController.refreshSettings();
+    m_moveCenterTabController.refreshSettings();
+    m_reviveTabController.refreshSettings();
+    m_settingsTabController.refreshSettings();
+    m_steamVRTabController.refreshSettings();
+    m_utilitiesTabController.refreshSettings();
+    m_preRenderPending = true;
+}
+
 bool OverlayController::pollNextEvent( vr::VROverlayHandle_t ulOverlayHandle,
                                        vr::VREvent_t* pEvent )
 {
@@ -461,6 +551,147 @@ bool OverlayController::pollNextEvent( vr::VROverlayHandle_t ulOverlayHandle,
     }
 }
 
+void OverlayController::updateRenderLevel(
+    const vr::TrackedDevicePose_t& hmdPose )
+{
+    // Nothing is rendered while the overlay is hidden, the level it had is
+    // kept so opening the dashboard doesn't reallocate the render target.
+    if ( m_desktopMode || !m_pFbo
+         || !vr::VROverlay()->IsOverlayVisible( m_ulOverlayHandle ) )
+    {
+        return;
+    }
+    bool full = vr::VROverlay()->IsHoverTargetOverlay( m_ulOverlayHandle );
+    const vr::HmdVector2_t center
+        = { static_cast<float>( m_pFbo->width() ) / 2.0f,
+            static_cast<float>( m_pFbo->height() ) / 2.0f };
+    vr::HmdMatrix34_t overlayTransform;
+    if ( !full && hmdPose.bPoseIsValid
+         && vr::VROverlay()->GetTransformForOverlayCoordinates(
+                m_ulOverlayHandle,
+                vr::TrackingUniverseStanding,
+                center,
+                &overlayTransform )
+                == vr::VROverlayError_None )
+    {
+        const auto& hmd = hmdPose.mDeviceToAbsoluteTracking.m;
+        const auto& overlay = overlayTransform.m;
+        const float dx = overlay[0][3] - hmd[0][3];
+        const float dy = overlay[1][3] - hmd[1][3];
+        const float dz = overlay[2][3] - hmd[2][3];
+        full = std::sqrt( dx * dx + dy * dy + dz * dz )
+               <= k_fullRenderDistance;
+    }
+
+    if ( full )
+    {
+        m_reducedRenderLevelWanted = false;
+        if ( m_renderLevel != RenderLevel::Full )
+        {
+            setRenderLevel( RenderLevel::Full );
+        }
+        return;
+    }
+    const auto now = std::chrono::steady_clock::now();
+    if ( !m_reducedRenderLevelWanted )
+    {
+        m_reducedRenderLevelWanted = true;
+        m_reducedRenderLevelSince = now;
+    }
+    else if ( m_renderLevel != RenderLevel::Reduced
+              && now - m_reducedRenderLevelSince >= k_reducedRenderLevelDelay )
+    {
+        setRenderLevel( RenderLevel::Reduced );
+    }
+}
+
+void OverlayController::setRenderLevel( RenderLevel level )
+{
+    const double scale
+        = level == RenderLevel::Full ? 1.0 : k_reducedRenderScale;
+    const int width = static_cast<int>( m_overlaySize.width() * scale );
+    const int height = static_cast<int>( m_overlaySize.height() * scale );
+
+    m_pOpenGLContext->makeCurrent( m_pOffscreenSurface.get() );
+    // The window must not render to a deleted target.
+    std::unique_ptr<QOpenGLFramebufferObject> fbo(
+        new QOpenGLFramebufferObject( width, height, m_pFbo->format() ) );
+    m_pWindow->setRenderTarget( fbo.get() );
+    m_pFbo = std::move( fbo );
+    // Mouse positions are in render target pixels, the item transform maps
+    // them back.
+    m_pWindow->setGeometry( 0, 0, width, height );
+    m_pOverlayItem->setScale( scale );
+    vr::HmdVector2_t vecWindowSize
+        = { static_cast<float>( width ), static_cast<float>( height ) };
+    vr::VROverlay()->SetOverlayMouseScale( m_ulOverlayHandle, &vecWindowSize );
+
+    m_renderLevel = level;
+    auto& stats = m_renderLevelStats[static_cast<size_t>( level )];
+    stats.width = width;
+    stats.height = height;
+    LOG( DEBUG ) << "Rendering the overlay at " << width << "x" << height;
+    m_pWindow->update();
+}
+
+bool OverlayController::startRenderTimerQuery()
+{
+    if ( !m_pRenderTimerQuery )
+    {
+        return false;
+    }
+    if ( m_renderTimerQueryPending )
+    {
+        // Results arrive a few frames late, renders in between aren't timed.
+        if ( !m_pRenderTimerQuery->isResultAvailable() )
+        {
+            return false;
+        }
+        auto& stats = m_renderLevelStats[static_cast<size_t>(
+            m_renderTimerQueryLevel )];
+        stats.gpuSamples++;
+        stats.gpuMilliseconds
+            += static_cast<double>( m_pRenderTimerQuery->waitForResult() )
+               / 1000000.0;
+    }
+    m_pRenderTimerQuery->begin();
+    m_renderTimerQueryPending = true;
+    m_renderTimerQueryLevel = m_renderLevel;
+    return true;
+}
+
+void OverlayController::logRenderStatistics() const
+{
+    const char* names[] = { "Reduced", "Full" };
+    for ( size_t i = 0; i < 2; i++ )
+    {
+        const auto& stats = m_renderLevelStats[i];
+        if ( stats.renders == 0 )
+        {
+            continue;
+        }
+        LOG( INFO ) << names[i] << " render level " << stats.width << "x"
+                    << stats.height << " ("
+                    << static_cast<double>( stats.width * stats.height
+                                            * k_renderTargetBytesPerPixel )
+                           / ( 1024.0 * 1024.0 )
+                    << " MB): " << stats.renders << " renders, "
+                    << stats.cpuMilliseconds / stats.renders << " ms CPU, "
+                    << ( stats.gpuSamples > 0
+                             ? stats.gpuMilliseconds / stats.gpuSamples
+                             : 0.0 )
+                    << " ms GPU per render";
+    }
+    if ( m_dashboardActivations > 0 )
+    {
+        LOG( INFO ) << "Dashboard activation to first current frame: "
+                    << m_activationLatencyMilliseconds / m_dashboardActivations
+                    << " ms average, " << m_maxActivationLatencyMilliseconds
+                    << " ms max over " << m_dashboardActivations
+                    << " activations";
+    }
+}
+
 QPoint OverlayController::getMousePositionForEvent( vr::VREvent_Mouse_t mouse )
 {
     float y = mouse.y;
@@ -513,6 +744,18 @@ void OverlayController::processRoomBindings()
         m_actions.optionalOverrideLeftHandRoomTurn() );
     m_moveCenterTabController.optionalOverrideRightHandRoomTurn(
         m_actions.optionalOverrideRightHandRoomTurn() );
+
+    // analog actions, integrated in the next eventLoopTick:
+    float smoothMoveX = 0.0f;
+    float smoothMoveY = 0.0f;
+    m_actions.smoothMove( smoothMoveX, smoothMoveY );
+    m_moveCenterTabController.smoothMove( smoothMoveX, smoothMoveY );
+    m_moveCenterTabController.smoothTurn( m_actions.smoothTurn() );
+
+    if ( m_actions.nextPlayspaceAnchor() )
+    {
+        m_moveCenterTabController.nextPlayspaceAnchor();
+    }
 }
 
 void OverlayController::processPushToTalkBindings()
@@ -523,7 +766,8 @@ void OverlayController::processPushToTalkBindings()
         return;
     }
 
-    const auto pushToTalkButtonActivated = m_actions.pushToTalk();
+    const auto pushToTalkButtonActivated
+        = m_actions.pushToTalk() || m_gesturePttLatched;
     const auto pushToTalkCurrentlyActive = m_audioTabController.pttActive();
     if ( pushToTalkButtonActivated && !pushToTalkCurrentlyActive )
     {
@@ -535,6 +779,117 @@ void OverlayController::processPushToTalkBindings()
     }
 }
 
+void OverlayController::publishSharedState(
+    const vr::TrackedDevicePose_t* devicePoses )
+{
+    static_assert( utils::k_sharedStateMaxPoses
+                       == vr::k_unMaxTrackedDeviceCount,
+                   "All poses have to fit" );
+    auto& frame = m_sharedState.frame();
+    frame.timeMicroseconds
+        = std::chrono::duration_cast<std::chrono::microseconds>(
+              std::chrono::system_clock::now().time_since_epoch() )
+              .count();
+
+    frame.trackingUniverse = m_moveCenterTabController.trackingUniverse();
+    frame.universeRotation
+        = static_cast<float>( m_moveCenterTabController.rotation() ) / 100.0f;
+    frame.universeOffset[0] = m_moveCenterTabController.offsetX();
+    frame.universeOffset[1] = m_moveCenterTabController.offsetY();
+    frame.universeOffset[2] = m_moveCenterTabController.offsetZ();
+
+    frame.presentedFrames = m_statisticsTabController.presentedFrames();
+    frame.droppedFrames = m_statisticsTabController.droppedFrames();
+    frame.reprojectedFrames = m_statisticsTabController.reprojectedFrames();
+    frame.timedOutFrames = m_statisticsTabController.timedOut();
+    frame.reprojectedRatio = m_statisticsTabController.totalReprojectedRatio();
+
+    frame.poseCount = vr::k_unMaxTrackedDeviceCount;
+    for ( uint32_t i = 0; i < vr::k_unMaxTrackedDeviceCount; i++ )
+    {
+        const auto& pose = devicePoses[i];
+        auto& shared = frame.poses[i];
+        std::memcpy( shared.deviceToAbsoluteTracking,
+                     pose.mDeviceToAbsoluteTracking.m,
+                     sizeof( shared.deviceToAbsoluteTracking ) );
+        std::memcpy( shared.velocity,
+                     pose.vVelocity.v,
+                     sizeof( shared.velocity ) );
+        std::memcpy( shared.angularVelocity,
+                     pose.vAngularVelocity.v,
+                     sizeof( shared.angularVelocity ) );
+        shared.trackingResult = pose.eTrackingResult;
+        shared.poseIsValid = pose.bPoseIsValid;
+        shared.deviceIsConnected = pose.bDeviceIsConnected;
+    }
+    m_sharedState.publish();
+}
+
+bool OverlayController::startEventLoad( const std::string& mix )
+{
+    if ( !m_eventLoad.setMix( mix ) )
+    {
+        return false;
+    }
+    m_eventLoad.setArea( static_cast<float>( m_overlaySize.width() ),
+                         static_cast<float>( m_overlaySize.height() ) );
+    m_eventLoadReportTime = std::chrono::steady_clock::now();
+    LOG( INFO ) << "Event load started with " << m_eventLoad.eventsPerFrame()
+                << " events per frame";
+    return true;
+}
+
+/*!
+Collects the time of the tick that just ended. Every k_eventLoadReportInterval
+the throughput and tick times are logged together with the cost per event
+type, so runs with different event handling can be compared from the log.
+*/
+void OverlayController::recordEventLoadTick()
+{
+    m_eventLoad.recordTick( m_eventLoopMilliseconds,
+                            m_eventDispatchMilliseconds );
+    const auto now = std::chrono::steady_clock::now();
+    if ( now - m_eventLoadReportTime >= k_eventLoadReportInterval )
+    {
+        m_eventLoad.logStatistics(
+            std::chrono::duration<double>( now - m_eventLoadReportTime )
+                .count() );
+        m_eventBus.logStatistics();
+        m_eventLoadReportTime = now;
+    }
+}
+
+void OverlayController::processGesture(
+    utils::GestureRecognizer::Gesture gesture )
+{
+    LOG( INFO ) << "Recognized " << utils::GestureRecognizer::name( gesture )
+                << " after " << m_gestureRecognizer.lastLatency() * 1000.0
+                << " ms";
+    const auto action
+        = gesture == utils::GestureRecognizer::Gesture::HeadDoubleTap
+              ? m_settingsTabController.headTapAction()
+              : m_settingsTabController.flickAction();
+    switch ( action )
+    {
+    case GestureAction::TogglePtt:
+        m_gesturePttLatched = !m_gesturePttLatched;
+        break;
+    case GestureAction::FixFloor:
+        m_fixFloorTabController.fixFloorClicked();
+        break;
+    case GestureAction::ResetRoom:
+        m_moveCenterTabController.reset();
+        break;
+    case GestureAction::None:
+        break;
+    }
+}
+
+void OverlayController::processBoundaryTracingBindings()
+{
+    m_chaperoneTabController.traceBoundary( m_actions.traceBoundary() );
+}
+
 /*!
 Checks if an action has been activated and dispatches the related action if it
 has been.
@@ -546,6 +901,8 @@ void OverlayController::processInputBindings()
     processRoomBindings();
 
     processPushToTalkBindings();
+
+    processBoundaryTracingBindings();
 }
 
 // vsync implementation:
@@ -561,30 +918,26 @@ void OverlayController::OnTimeoutPumpEvents()
         // If the frame has advanced since last check, it's time for our main
         // event loop. (this function should trigger about every 11ms assuming
         // 90fps compositor)
+        auto start = std::chrono::steady_clock::now();
         mainEventLoop();
+        m_eventLoopMilliseconds
+            = std::chrono::duration<double, std::milli>(
+                  std::chrono::steady_clock::now() - start )
+                  .count();
+        if ( m_eventLoad.active() )
+        {
+            recordEventLoadTick();
+        }
 
         // wait for the next frame after executing our main event loop once.
         m_lastFrame = m_currentFrame;
     }
 }
 
-void OverlayController::mainEventLoop()
+void OverlayController::subscribeEvents()
 {
-    if ( !vr::VRSystem() )
-        return;
-
-    m_actions.UpdateStates();
-
-    processInputBindings();
-
-    vr::VREvent_t vrEvent;
-    bool chaperoneDataAlreadyUpdated = false;
-    while ( pollNextEvent( m_ulOverlayHandle, &vrEvent ) )
-    {
-        switch ( vrEvent.eventType )
-        {
-        case vr::VREvent_MouseMove:
-        {
+    m_eventBus.subscribe(
+        vr::VREvent_MouseMove, [this]( const vr::VREvent_t& vrEvent ) {
             QPoint ptNewMouse = getMousePositionForEvent( vrEvent.data.mouse );
             if ( ptNewMouse != m_ptLastMouse )
             {
@@ -598,11 +951,10 @@ void OverlayController::mainEventLoop()
                 QCoreApplication::sendEvent( m_pWindow.get(), &mouseEvent );
                 OnRenderRequest();
             }
-        }
-        break;
+        } );
 
-        case vr::VREvent_MouseButtonDown:
-        {
+    m_eventBus.subscribe(
+        vr::VREvent_MouseButtonDown, [this]( const vr::VREvent_t& vrEvent ) {
             QPoint ptNewMouse = getMousePositionForEvent( vrEvent.data.mouse );
             Qt::MouseButton button
                 = vrEvent.data.mouse.button == vr::VRMouseButton_Right
@@ -616,11 +968,10 @@ void OverlayController::mainEventLoop()
                                     m_lastMouseButtons,
                                     nullptr );
             QCoreApplication::sendEvent( m_pWindow.get(), &mouseEvent );
-        }
-        break;
+        } );
 
-        case vr::VREvent_MouseButtonUp:
-        {
+    m_eventBus.subscribe(
+        vr::VREvent_MouseButtonUp, [this]( const vr::VREvent_t& vrEvent ) {
             QPoint ptNewMouse = getMousePositionForEvent( vrEvent.data.mouse );
             Qt::MouseButton button
                 = vrEvent.data.mouse.button == vr::VRMouseButton_Right
@@ -634,11 +985,10 @@ void OverlayController::mainEventLoop()
                                     m_lastMouseButtons,
                                     nullptr );
             QCoreApplication::sendEvent( m_pWindow.get(), &mouseEvent );
-        }
-        break;
+        } );
 
-        case vr::VREvent_ScrollSmooth:
-        {
+    m_eventBus.subscribe(
+        vr::VREvent_ScrollSmooth, [this]( const vr::VREvent_t& vrEvent ) {
             // Wheel speed is defined as 1/8 of a degree
             QWheelEvent wheelEvent(
                 m_ptLastMouse,
@@ -653,77 +1003,111 @@ void OverlayController::mainEventLoop()
                 m_lastMouseButtons,
                 nullptr );
             QCoreApplication::sendEvent( m_pWindow.get(), &wheelEvent );
-        }
-        break;
-
-        case vr::VREvent_OverlayShown:
-        {
-            m_pWindow->update();
-        }
-        break;
-
-        case vr::VREvent_Quit:
-        {
-            LOG( INFO ) << "Received quit request.";
-            vr::VRSystem()->AcknowledgeQuit_Exiting(); // Let us buy some
-                                                       // time just in case
-            m_moveCenterTabController.reset();
-            m_chaperoneTabController.shutdown();
-            Shutdown();
-            QApplication::exit();
-            return;
-        }
-        break;
-
-        case vr::VREvent_DashboardActivated:
-        {
-            LOG( DEBUG ) << "Dashboard activated";
-            m_dashboardVisible = true;
-        }
-        break;
-
-        case vr::VREvent_DashboardDeactivated:
-        {
-            LOG( DEBUG ) << "Dashboard deactivated";
-            m_dashboardVisible = false;
-        }
-        break;
+        } );
 
-        case vr::VREvent_KeyboardDone:
-        {
+    // Also sent for the thumbnail. The render level is updated later in
+    // this frame, once the poses are fetched.
+    m_eventBus.subscribe( vr::VREvent_OverlayShown,
+                          [this]( const vr::VREvent_t& ) {
+                              m_renderLevelUpdateCounter
+                                  = k_renderLevelUpdateCounter;
+                              m_pWindow->update();
+                          } );
+
+    m_eventBus.subscribe( vr::VREvent_Quit, [this]( const vr::VREvent_t& ) {
+        LOG( INFO ) << "Received quit request.";
+        vr::VRSystem()->AcknowledgeQuit_Exiting(); // Let us buy some
+                                                   // time just in case
+        m_eventBus.logStatistics();
+        m_actions.logStatistics();
+        logRenderStatistics();
+        m_moveCenterTabController.reset();
+        m_chaperoneTabController.shutdown();
+        Shutdown();
+        QApplication::exit();
+        m_eventBus.stop();
+    } );
+
+    m_eventBus.subscribe( vr::VREvent_DashboardActivated,
+                          [this]( const vr::VREvent_t& vrEvent ) {
+                              LOG( DEBUG ) << "Dashboard activated";
+                              m_dashboardVisible = true;
+                              refreshDashboard( vrEvent.eventAgeSeconds );
+                          } );
+
+    m_eventBus.subscribe( vr::VREvent_DashboardDeactivated,
+                          [this]( const vr::VREvent_t& ) {
+                              LOG( DEBUG ) << "Dashboard deactivated";
+                              m_dashboardVisible = false;
+                          } );
+
+    m_eventBus.subscribe(
+        vr::VREvent_KeyboardDone, [this]( const vr::VREvent_t& vrEvent ) {
             char keyboardBuffer[1024];
             vr::VROverlay()->GetKeyboardText( keyboardBuffer, 1024 );
             emit keyBoardInputSignal( QString( keyboardBuffer ),
                                       static_cast<unsigned long>(
                                           vrEvent.data.keyboard.uUserValue ) );
-        }
-        break;
+        } );
 
-        // Multiple ChaperoneUniverseHasChanged are often emitted at the
-        // same time (some with a little bit of delay) There is no sure way
-        // to recognize redundant events, we can only exclude redundant
-        // events during the same call of OnTimeoutPumpEvents() INFO Removed
-        // logging on play space mover for possible crashing issues.
-        case vr::VREvent_ChaperoneUniverseHasChanged:
-        case vr::VREvent_ChaperoneDataHasChanged:
-        {
-            if ( !chaperoneDataAlreadyUpdated )
+    // Multiple ChaperoneUniverseHasChanged are often emitted at the same time
+    // (some with a little bit of delay) There is no sure way to recognize
+    // redundant events, we can only exclude redundant events during the same
+    // call of OnTimeoutPumpEvents().
+    m_eventBus.subscribeCoalesced(
+        { vr::VREvent_ChaperoneUniverseHasChanged,
+          vr::VREvent_ChaperoneDataHasChanged },
+        [this]( const vr::VREvent_t& ) {
+            m_chaperoneUtils.loadChaperoneData();
+        } );
+}
+
+void OverlayController::mainEventLoop()
+{
+    if ( !vr::VRSystem() )
+        return;
+
+    // Media keys are mostly used from the dashboard, react to them on every
+    // frame there.
+    m_actions.UpdateStates( isDashboardVisible() );
+
+    processInputBindings();
+
+    m_eventBus.pump( [this]( vr::VREvent_t* event ) {
+        return pollNextEvent( m_ulOverlayHandle, event );
+    } );
+    if ( m_ulOverlayThumbnailHandle != vr::k_ulOverlayHandleInvalid )
+    {
+        // Only the shown event of the thumbnail is of interest.
+        m_eventBus.pump( [this]( vr::VREvent_t* event ) {
+            while ( vr::VROverlay()->PollNextOverlayEvent(
+                m_ulOverlayThumbnailHandle, event, sizeof( vr::VREvent_t ) ) )
             {
-                // LOG(INFO) << "Re-loading chaperone data ...";
-                m_chaperoneUtils.loadChaperoneData();
-                // LOG(INFO) << "Found " << m_chaperoneUtils.quadsCount() <<
-                // " chaperone quads."; if
-                // (m_chaperoneUtils.isChaperoneWellFormed()) { LOG(INFO) <<
-                // "Chaperone data seems to be well-formed.";
-                //} else {
-                // LOG(INFO) << "Chaperone data is NOT well-formed.";
-                //}
-                chaperoneDataAlreadyUpdated = true;
+                if ( event->eventType == vr::VREvent_OverlayShown )
+                {
+                    return true;
+                }
             }
-        }
-        break;
-        }
+            return false;
+        } );
     }
+    if ( m_eventLoad.active() )
+    {
+        m_eventLoad.beginFrame();
+        m_eventBus.pump( [this]( vr::VREvent_t* event ) {
+            return m_eventLoad.next( event );
+        } );
+    }
+    const auto dispatchStart = std::chrono::steady_clock::now();
+    if ( !m_eventBus.dispatch() )
+    {
+        // Quit
+        return;
+    }
+    m_eventDispatchMilliseconds
+        = std::chrono::duration<double, std::milli>(
+              std::chrono::steady_clock::now() - dispatchStart )
+              .count();
 
     vr::TrackedDevicePose_t devicePoses[vr::k_unMaxTrackedDeviceCount];
     vr::VRSystem()->GetDeviceToAbsoluteTrackingPose(
@@ -766,8 +1150,26 @@ void OverlayController::mainEventLoop()
         hmdSpeed
             = std::sqrt( vel[0] * vel[0] + vel[1] * vel[1] + vel[2] * vel[2] );
     }
+    if ( m_settingsTabController.gesturesEnabled() )
+    {
+        const auto gesture = m_gestureRecognizer.update(
+            devicePoses,
+            leftId,
+            rightId,
+            std::chrono::duration<double>(
+                std::chrono::steady_clock::now().time_since_epoch() )
+                .count() );
+        if ( gesture != utils::GestureRecognizer::Gesture::None )
+        {
+            processGesture( gesture );
+        }
+    }
+
     m_moveCenterTabController.eventLoopTick(
         vr::VRCompositor()->GetTrackingSpace(), devicePoses );
+    // Only changes the priority when a drag or turn starts or ends.
+    m_processScheduler.setLatencyCritical(
+        m_moveCenterTabController.isDragOrTurnActive() );
     m_utilitiesTabController.eventLoopTick();
     m_fixFloorTabController.eventLoopTick( devicePoses );
     m_statisticsTabController.eventLoopTick(
@@ -776,24 +1178,31 @@ void OverlayController::mainEventLoop()
     m_chaperoneTabController.eventLoopTick(
         devicePoses, leftSpeed, rightSpeed, hmdSpeed );
     m_settingsTabController.eventLoopTick();
-    m_reviveTabController.eventLoopTick();
+    m_reviveTabController.eventLoopTick( devicePoses );
     m_audioTabController.eventLoopTick();
+    if ( m_sharedState.isOpen() )
+    {
+        publishSharedState( devicePoses );
+    }
+    if ( m_preRenderPending )
+    {
+        // The refreshed values are in the QML items by now.
+        renderOverlay();
+        m_preRenderPending = false;
+    }
 
-    if ( m_ulOverlayThumbnailHandle != vr::k_ulOverlayHandleInvalid )
+    if ( m_renderLevelUpdateCounter >= k_renderLevelUpdateCounter )
     {
-        while ( vr::VROverlay()->PollNextOverlayEvent(
-            m_ulOverlayThumbnailHandle, &vrEvent, sizeof( vrEvent ) ) )
-        {
-            switch ( vrEvent.eventType )
-            {
-            case vr::VREvent_OverlayShown:
-            {
-                m_pWindow->update();
-            }
-            break;
-            }
-        }
+        updateRenderLevel( devicePoses[vr::k_unTrackedDeviceIndex_Hmd] );
+        m_renderLevelUpdateCounter = 0;
     }
+    else
+    {
+        m_renderLevelUpdateCounter++;
+    }
+
+    // All notification changes of this frame in one go.
+    m_notificationCompositor.flush();
 }
 
 void OverlayController::AddOffsetToUniverseCenter(
@@ -17,16 +17,24 @@
 #include <QtWidgets/QGraphicsScene>
 #include <QOffscreenSurface>
 #include <QOpenGLFramebufferObject>
+#include <QOpenGLTimerQuery>
 #include <QQuickWindow>
 #include <QQuickItem>
 #include <QQuickRenderControl>
 #include <QSoundEffect>
+#include <chrono>
 #include <memory>
 #include <easylogging++.h>
 
 #include "overlaycontroller/openvr_init.h"
 
 #include "utils/ChaperoneUtils.h"
+#include "utils/EventBus.h"
+#include "utils/EventLoad.h"
+#include "utils/GestureRecognizer.h"
+#include "utils/NotificationCompositor.h"
+#include "utils/ProcessScheduler.h"
+#include "utils/SharedState.h"
 
 #include "tabcontrollers/SteamVRTabController.h"
 #include "tabcontrollers/ChaperoneTabController.h"
@@ -51,7 +59,11 @@ namespace advsettings
 // Avoid setting values to the same numbers.
 constexpr int k_audioSettingsUpdateCounter = 89;
 constexpr int k_chaperoneSettingsUpdateCounter = 101;
+constexpr int k_fixFloorDriftMonitorUpdateCounter = 181;
 constexpr int k_moveCenterSettingsUpdateCounter = 149;
+constexpr int k_performanceHudUpdateCounter = 23;
+constexpr int k_processMonitorUpdateCounter = 83;
+constexpr int k_renderLevelUpdateCounter = 11;
 constexpr int k_reviveSettingsUpdateCounter = 139;
 constexpr int k_settingsTabSettingsUpdateCounter = 157;
 constexpr int k_steamVrSettingsUpdateCounter = 97;
@@ -84,6 +96,42 @@ private:
     std::unique_ptr<QTimer> m_pRenderTimer;
     bool m_dashboardVisible = false;
 
+    // The dashboard is rendered at a reduced resolution while it is neither
+    // pointed at nor close enough to read the details.
+    enum class RenderLevel
+    {
+        Reduced,
+        Full,
+    };
+    struct RenderLevelStats
+    {
+        int width = 0;
+        int height = 0;
+        unsigned renders = 0;
+        double cpuMilliseconds = 0.0;
+        unsigned gpuSamples = 0;
+        double gpuMilliseconds = 0.0;
+    };
+    QQuickItem* m_pOverlayItem = nullptr;
+    QSize m_overlaySize;
+    RenderLevel m_renderLevel = RenderLevel::Full;
+    bool m_reducedRenderLevelWanted = false;
+    std::chrono::steady_clock::time_point m_reducedRenderLevelSince;
+    int m_renderLevelUpdateCounter = 0;
+    RenderLevelStats m_renderLevelStats[2];
+    // Only available with GL_ARB_timer_query.
+    std::unique_ptr<QOpenGLTimerQuery> m_pRenderTimerQuery;
+    bool m_renderTimerQueryPending = false;
+    RenderLevel m_renderTimerQueryLevel = RenderLevel::Full;
+
+    // When the dashboard is opened all tabs are refreshed at once and the
+    // current page is rendered right away, visible or not.
+    bool m_preRenderPending = false;
+    std::chrono::steady_clock::time_point m_dashboardActivatedAt;
+    unsigned m_dashboardActivations = 0;
+    double m_activationLatencyMilliseconds = 0.0;
+    double m_maxActivationLatencyMilliseconds = 0.0;
+
     QPoint m_ptLastMouse;
     Qt::MouseButtons m_lastMouseButtons = nullptr;
 
@@ -93,6 +141,15 @@ private:
     QUrl m_runtimePathUrl;
 
     utils::ChaperoneUtils m_chaperoneUtils;
+    utils::EventBus m_eventBus;
+    utils::NotificationCompositor m_notificationCompositor{
+        std::string( applicationKey ) + ".notification."
+    };
+    utils::ProcessScheduler m_processScheduler;
+    utils::GestureRecognizer m_gestureRecognizer;
+    utils::SharedStateWriter m_sharedState;
+    // Push to talk switched on by a gesture, held like the button.
+    bool m_gesturePttLatched = false;
 
     QSoundEffect m_activationSoundEffect;
     QSoundEffect m_focusChangedSoundEffect;
@@ -100,6 +157,13 @@ private:
 
     uint64_t m_currentFrame = 0;
     uint64_t m_lastFrame = 0;
+    // Wall time of the last mainEventLoop() call.
+    double m_eventLoopMilliseconds = 0.0;
+
+    // Synthetic events on top of the real ones, see startEventLoad().
+    utils::EventLoad m_eventLoad;
+    double m_eventDispatchMilliseconds = 0.0;
+    std::chrono::steady_clock::time_point m_eventLoadReportTime;
 
     // OpenVR_Init must be declared before any other class that uses OpenVR
     // function calls since objects are initialized in order of declaration in
@@ -122,10 +186,20 @@ public: // I know it's an ugly hack to make them public to enable external
 
 private:
     QPoint getMousePositionForEvent( vr::VREvent_Mouse_t mouse );
+    void subscribeEvents();
     void processInputBindings();
     void processMediaKeyBindings();
     void processRoomBindings();
     void processPushToTalkBindings();
+    void processBoundaryTracingBindings();
+    void processGesture( utils::GestureRecognizer::Gesture gesture );
+    void publishSharedState( const vr::TrackedDevicePose_t* devicePoses );
+    void recordEventLoadTick();
+    void updateRenderLevel( const vr::TrackedDevicePose_t& hmdPose );
+    void setRenderLevel( RenderLevel level );
+    bool startRenderTimerQuery();
+    void logRenderStatistics() const;
+    void refreshDashboard( float eventAgeSeconds );
 
 public:
     OverlayController( bool desktopMode, bool noSound, QQmlEngine& qmlEngine );
@@ -141,6 +215,9 @@ public:
     void SetWidget( QQuickItem* quickItem,
                     const std::string& name,
                     const std::string& key = "" );
+    // Adds the synthetic events of the mix (see utils::EventLoad) to every
+    // tick, for benchmarking the event handling. Call after SetWidget().
+    bool startEventLoad( const std::string& mix );
 
     void AddOffsetToUniverseCenter( vr::ETrackingUniverseOrigin universe,
                                     unsigned axisId,
@@ -172,6 +249,36 @@ public:
         return m_chaperoneUtils;
     }
 
+    utils::EventBus& eventBus() noexcept
+    {
+        return m_eventBus;
+    }
+
+    utils::NotificationCompositor& notifications() noexcept
+    {
+        return m_notificationCompositor;
+    }
+
+    utils::ProcessScheduler& processScheduler() noexcept
+    {
+        return m_processScheduler;
+    }
+
+    utils::GestureRecognizer& gestureRecognizer() noexcept
+    {
+        return m_gestureRecognizer;
+    }
+
+    utils::SharedStateWriter& sharedState() noexcept
+    {
+        return m_sharedState;
+    }
+
+    double eventLoopMilliseconds() const noexcept
+    {
+        return m_eventLoopMilliseconds;
+    }
+
     Q_INVOKABLE QString getVersionString();
     Q_INVOKABLE QUrl getVRRuntimePathUrl();
 
@@ -157,6 +157,80 @@ MyStackViewPage {
         }
     }
 
+    MyDialogOkCancelPopup {
+        id: chaperoneMergeProfilesDialog
+        property var selectedProfiles: ({})
+        dialogTitle: "Merge Profiles"
+        dialogWidth: 800
+        dialogHeight: 780
+        dialogContentItem: ColumnLayout {
+            RowLayout {
+                Layout.topMargin: 16
+                Layout.leftMargin: 16
+                Layout.rightMargin: 16
+                MyText {
+                    text: "Name: "
+                }
+                MyTextField {
+                    id: chaperoneMergeProfilesName
+                    keyBoardUID: 391
+                    color: "#cccccc"
+                    text: ""
+                    Layout.fillWidth: true
+                    font.pointSize: 20
+                    function onInputEvent(input) {
+                        chaperoneMergeProfilesName.text = input
+                    }
+                }
+            }
+            MyText {
+                Layout.topMargin: 24
+                text: "Profiles to merge:"
+            }
+            Repeater {
+                id: chaperoneMergeProfilesRepeater
+                model: []
+                MyToggleButton {
+                    Layout.leftMargin: 32
+                    text: modelData.name
+                    onCheckedChanged: {
+                        chaperoneMergeProfilesDialog.selectedProfiles[modelData.index] = this.checked
+                    }
+                }
+            }
+        }
+        onClosed: {
+            if (okClicked) {
+                var indices = []
+                for (var i in selectedProfiles) {
+                    if (selectedProfiles[i]) {
+                        indices.push(parseInt(i))
+                    }
+                }
+                if (chaperoneMergeProfilesName.text == "") {
+                    chaperoneMessageDialog.showMessage("Merge Profiles", "ERROR: Empty profile name.")
+                } else if (indices.length < 2) {
+                    chaperoneMessageDialog.showMessage("Merge Profiles", "ERROR: Select at least two profiles.")
+                } else if (!ChaperoneTabController.mergeChaperoneProfiles(chaperoneMergeProfilesName.text, indices)) {
+                    chaperoneMessageDialog.showMessage("Merge Profiles", "ERROR: The profiles could not be merged. Their bounds have to overlap or share a wall.")
+                }
+            }
+        }
+        function openPopup() {
+            chaperoneMergeProfilesName.text = ""
+            selectedProfiles = {}
+            var profiles = []
+            var count = ChaperoneTabController.getChaperoneProfileCount()
+            for (var i = 0; i < count; i++) {
+                if (ChaperoneTabController.getChaperoneProfileHasGeometry(i)) {
+                    profiles.push({ index: i, name: ChaperoneTabController.getChaperoneProfileName(i) })
+                }
+            }
+            chaperoneMergeProfilesRepeater.model = profiles
+            open()
+        }
+    }
+
 
     content: ColumnLayout {
         spacing: 18
@@ -204,6 +278,13 @@ MyStackViewPage {
             }
             RowLayout {
                 spacing: 18
+                MyToggleButton {
+                    id: chaperoneProfileAutoSelectToggle
+                    text: "Switch Profile by Location"
+                    onCheckedChanged: {
+                        ChaperoneTabController.setChaperoneProfileAutoSelectEnabled(this.checked, false)
+                    }
+                }
                 Item {
                     Layout.fillWidth: true
                 }
@@ -219,6 +300,13 @@ MyStackViewPage {
                         }
                     }
                 }
+                MyPushButton {
+                    Layout.preferredWidth: 200
+                    text: "Merge Profiles"
+                    onClicked: {
+                        chaperoneMergeProfilesDialog.openPopup()
+                    }
+                }
                 MyPushButton {
                     Layout.preferredWidth: 200
                     text: "New Profile"
@@ -464,12 +552,35 @@ MyStackViewPage {
             }
         }
 
-        MyPushButton {
-            id: chaperoneFlipOrientationButton
-            text: "Flip Orientation"
-            Layout.preferredWidth: 250
-            onClicked: {
-                ChaperoneTabController.flipOrientation()
+        RowLayout {
+            spacing: 18
+
+            MyPushButton {
+                id: chaperoneFlipOrientationButton
+                text: "Flip Orientation"
+                Layout.preferredWidth: 250
+                onClicked: {
+                    ChaperoneTabController.flipOrientation()
+                }
+            }
+
+            MyPushButton {
+                id: chaperoneTraceBoundaryButton
+                text: "Trace Boundary"
+                Layout.preferredWidth: 250
+                onClicked: {
+                    if (ChaperoneTabController.boundaryTracingActive) {
+                        ChaperoneTabController.cancelBoundaryTracing()
+                    } else {
+                        ChaperoneTabController.startBoundaryTracing()
+                    }
+                }
+            }
+
+            MyText {
+                id: chaperoneTraceBoundaryText
+                visible: false
+                text: "Hold the \"Trace Chaperone Boundary\" binding and walk along the walls. The playspace center moves to the middle of the largest play area inside."
             }
         }
 
@@ -514,6 +625,7 @@ MyStackViewPage {
             chaperoneCenterMarkerToggle.checked = ChaperoneTabController.centerMarker
             chaperonePlaySpaceToggle.checked = ChaperoneTabController.playSpaceMarker
             chaperoneForceBoundsToggle.checked = ChaperoneTabController.forceBounds
+            chaperoneProfileAutoSelectToggle.checked = ChaperoneTabController.chaperoneProfileAutoSelectEnabled
             reloadChaperoneProfiles()
         }
 
@@ -548,6 +660,14 @@ MyStackViewPage {
             onForceBoundsChanged: {
                 chaperoneForceBoundsToggle.checked = ChaperoneTabController.forceBounds
             }
+            onChaperoneProfileAutoSelectEnabledChanged: {
+                chaperoneProfileAutoSelectToggle.checked = ChaperoneTabController.chaperoneProfileAutoSelectEnabled
+            }
+            onBoundaryTracingActiveChanged: {
+                var active = ChaperoneTabController.boundaryTracingActive
+                chaperoneTraceBoundaryButton.text = active ? "Cancel Tracing" : "Trace Boundary"
+                chaperoneTraceBoundaryText.visible = active
+            }
             onChaperoneProfilesUpdated: {
                 reloadChaperoneProfiles()
             }
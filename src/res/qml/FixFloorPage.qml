@@ -74,6 +74,27 @@ MyStackViewPage {
             }
         }
 
+        RowLayout {
+            Layout.fillWidth: true
+
+            MyToggleButton {
+                id: driftMonitorToggle
+                text: "Monitor Floor Drift"
+                onCheckedChanged: {
+                    FixFloorTabController.driftMonitor = this.checked
+                }
+            }
+
+            MyToggleButton {
+                id: driftAutoCorrectToggle
+                text: "Auto-Correct"
+                enabled: driftMonitorToggle.checked
+                onCheckedChanged: {
+                    FixFloorTabController.driftAutoCorrect = this.checked
+                }
+            }
+        }
+
         MyPushButton {
             id: zeroRoomButton
             Layout.fillWidth: true
@@ -92,6 +113,8 @@ MyStackViewPage {
             statusMessageText.text = ""
             undoFixButton.enabled = FixFloorTabController.canUndo
             fixButton.enabled = true
+            driftMonitorToggle.checked = FixFloorTabController.driftMonitor
+            driftAutoCorrectToggle.checked = FixFloorTabController.driftAutoCorrect
         }
 
         Timer {
@@ -123,6 +146,12 @@ MyStackViewPage {
             onCanUndoChanged: {
                 undoFixButton.enabled = FixFloorTabController.canUndo
             }
+            onDriftMonitorChanged: {
+                driftMonitorToggle.checked = FixFloorTabController.driftMonitor
+            }
+            onDriftAutoCorrectChanged: {
+                driftAutoCorrectToggle.checked = FixFloorTabController.driftAutoCorrect
+            }
         }
 
     }
@@ -8,6 +8,51 @@ import "common"
 MyStackViewPage {
     headerText: "Room Settings"
 
+    MyDialogOkCancelPopup {
+        id: playspaceDeleteAnchorDialog
+        property int anchorIndex: -1
+        dialogTitle: "Delete Anchor"
+        dialogText: "Do you really want to delete this anchor?"
+        onClosed: {
+            if (okClicked) {
+                MoveCenterTabController.deletePlayspaceAnchor(anchorIndex)
+            }
+        }
+    }
+
+    MyDialogOkCancelPopup {
+        id: playspaceNewAnchorDialog
+        dialogTitle: "Save Anchor"
+        dialogContentItem: RowLayout {
+            Layout.topMargin: 16
+            Layout.leftMargin: 16
+            Layout.rightMargin: 16
+            MyText {
+                text: "Name: "
+            }
+            MyTextField {
+                id: playspaceNewAnchorName
+                keyBoardUID: 109
+                color: "#cccccc"
+                text: ""
+                Layout.fillWidth: true
+                font.pointSize: 20
+                function onInputEvent(input) {
+                    playspaceNewAnchorName.text = input
+                }
+            }
+        }
+        onClosed: {
+            if (okClicked && playspaceNewAnchorName.text != "") {
+                MoveCenterTabController.addPlayspaceAnchor(playspaceNewAnchorName.text)
+            }
+        }
+        function openPopup() {
+            playspaceNewAnchorName.text = ""
+            open()
+        }
+    }
+
     content: ColumnLayout {
         spacing: 18
 
@@ -367,6 +412,171 @@ MyStackViewPage {
             }
         }
 
+        GroupBox {
+            Layout.fillWidth: true
+
+            label: MyText {
+                leftPadding: 10
+                text: "Thumbstick Locomotion"
+                bottomPadding: -10
+            }
+            background: Rectangle {
+                color: "transparent"
+                border.color: "#ffffff"
+                radius: 8
+            }
+            ColumnLayout {
+                MyToggleButton {
+                    id: smoothLocomotionToggle
+                    text: "Enable Thumbstick Locomotion"
+                    onCheckedChanged: {
+                        MoveCenterTabController.smoothLocomotionEnabled = this.checked
+                    }
+                }
+                RowLayout {
+                    Layout.fillWidth: true
+
+                    MyText {
+                        text: "Move Speed (m/s):"
+                    }
+
+                    MyTextField {
+                        id: smoothMoveSpeedText
+                        text: MoveCenterTabController.smoothMoveSpeed.toFixed(1)
+                        keyBoardUID: 105
+                        Layout.preferredWidth: 100
+                        Layout.leftMargin: 10
+                        Layout.rightMargin: 20
+                        horizontalAlignment: Text.AlignHCenter
+                        function onInputEvent(input) {
+                            var val = parseFloat(input)
+                            if (!isNaN(val)) {
+                                MoveCenterTabController.smoothMoveSpeed = val
+                            }
+                            text = MoveCenterTabController.smoothMoveSpeed.toFixed(1)
+                        }
+                    }
+
+                    MyText {
+                        text: "Turn Speed (°/s):"
+                    }
+
+                    MyTextField {
+                        id: smoothTurnSpeedText
+                        text: MoveCenterTabController.smoothTurnSpeed.toFixed(0)
+                        keyBoardUID: 106
+                        Layout.preferredWidth: 100
+                        Layout.leftMargin: 10
+                        Layout.rightMargin: 20
+                        horizontalAlignment: Text.AlignHCenter
+                        function onInputEvent(input) {
+                            var val = parseFloat(input)
+                            if (!isNaN(val)) {
+                                MoveCenterTabController.smoothTurnSpeed = val
+                            }
+                            text = MoveCenterTabController.smoothTurnSpeed.toFixed(0)
+                        }
+                    }
+                }
+                RowLayout {
+                    Layout.fillWidth: true
+
+                    MyText {
+                        text: "Deadzone:"
+                    }
+
+                    MyTextField {
+                        id: smoothDeadzoneText
+                        text: MoveCenterTabController.smoothDeadzone.toFixed(2)
+                        keyBoardUID: 107
+                        Layout.preferredWidth: 100
+                        Layout.leftMargin: 10
+                        Layout.rightMargin: 20
+                        horizontalAlignment: Text.AlignHCenter
+                        function onInputEvent(input) {
+                            var val = parseFloat(input)
+                            if (!isNaN(val)) {
+                                MoveCenterTabController.smoothDeadzone = val
+                            }
+                            text = MoveCenterTabController.smoothDeadzone.toFixed(2)
+                        }
+                    }
+
+                    MyText {
+                        text: "Response Curve:"
+                    }
+
+                    MyTextField {
+                        id: smoothResponseCurveText
+                        text: MoveCenterTabController.smoothResponseCurve.toFixed(1)
+                        keyBoardUID: 108
+                        Layout.preferredWidth: 100
+                        Layout.leftMargin: 10
+                        Layout.rightMargin: 20
+                        horizontalAlignment: Text.AlignHCenter
+                        function onInputEvent(input) {
+                            var val = parseFloat(input)
+                            if (!isNaN(val)) {
+                                MoveCenterTabController.smoothResponseCurve = val
+                            }
+                            text = MoveCenterTabController.smoothResponseCurve.toFixed(1)
+                        }
+                    }
+                }
+            }
+        }
+
+        RowLayout {
+            spacing: 18
+
+            MyText {
+                text: "Anchor:"
+            }
+
+            MyComboBox {
+                id: playspaceAnchorComboBox
+                Layout.fillWidth: true
+                model: [""]
+                onCurrentIndexChanged: {
+                    playspaceJumpAnchorButton.enabled = currentIndex > 0
+                    playspaceDeleteAnchorButton.enabled = currentIndex > 0
+                }
+            }
+
+            MyPushButton {
+                id: playspaceJumpAnchorButton
+                enabled: false
+                Layout.preferredWidth: 150
+                text: "Jump"
+                onClicked: {
+                    if (playspaceAnchorComboBox.currentIndex > 0) {
+                        MoveCenterTabController.jumpToPlayspaceAnchor(playspaceAnchorComboBox.currentIndex - 1)
+                    }
+                }
+            }
+
+            MyPushButton {
+                Layout.preferredWidth: 150
+                text: "Save"
+                onClicked: {
+                    playspaceNewAnchorDialog.openPopup()
+                }
+            }
+
+            MyPushButton {
+                id: playspaceDeleteAnchorButton
+                enabled: false
+                Layout.preferredWidth: 150
+                text: "Delete"
+                onClicked: {
+                    if (playspaceAnchorComboBox.currentIndex > 0) {
+                        playspaceDeleteAnchorDialog.anchorIndex = playspaceAnchorComboBox.currentIndex - 1
+                        playspaceDeleteAnchorDialog.open()
+                    }
+                }
+            }
+        }
+
         ColumnLayout {
             RowLayout {
                 Layout.fillWidth: true
@@ -404,9 +614,11 @@ MyStackViewPage {
             roomRotationSlider.value = MoveCenterTabController.rotation
             moveShortcutRight.checked = MoveCenterTabController.moveShortcutRight
             moveShortcutLeft.checked = MoveCenterTabController.moveShortcutLeft
+            smoothLocomotionToggle.checked = MoveCenterTabController.smoothLocomotionEnabled
 			lockXToggle.checked = MoveCenterTabController.lockXToggle
 			lockYToggle.checked = MoveCenterTabController.lockYToggle
 			lockZToggle.checked = MoveCenterTabController.lockZToggle
+            reloadPlayspaceAnchors()
 			
             if (MoveCenterTabController.trackingUniverse === 0) {
                 roomModeText.text = "Sitting"
@@ -454,6 +666,21 @@ MyStackViewPage {
             }
             onMoveShortcutLeftChanged: {
                 moveShortcutLeft.checked = MoveCenterTabController.moveShortcutLeft
+            }
+            onSmoothLocomotionEnabledChanged: {
+                smoothLocomotionToggle.checked = MoveCenterTabController.smoothLocomotionEnabled
+            }
+            onSmoothMoveSpeedChanged: {
+                smoothMoveSpeedText.text = MoveCenterTabController.smoothMoveSpeed.toFixed(1)
+            }
+            onSmoothTurnSpeedChanged: {
+                smoothTurnSpeedText.text = MoveCenterTabController.smoothTurnSpeed.toFixed(0)
+            }
+            onSmoothDeadzoneChanged: {
+                smoothDeadzoneText.text = MoveCenterTabController.smoothDeadzone.toFixed(2)
+            }
+            onSmoothResponseCurveChanged: {
+                smoothResponseCurveText.text = MoveCenterTabController.smoothResponseCurve.toFixed(1)
             }
 			onLockXToggleChanged: {
 				lockXToggle.checked = MoveCenterTabController.lockXToggle
@@ -464,6 +691,9 @@ MyStackViewPage {
 			onLockZToggleChanged: {
 				lockZToggle.checked = MoveCenterTabController.lockZToggle
 			}
+            onPlayspaceAnchorsUpdated: {
+                reloadPlayspaceAnchors()
+            }
             onTrackingUniverseChanged: {
                 if (MoveCenterTabController.trackingUniverse === 0) {
                     roomModeText.text = "Sitting"
@@ -485,4 +715,13 @@ MyStackViewPage {
 
     }
 
+    function reloadPlayspaceAnchors() {
+        var anchors = [""]
+        var anchorCount = MoveCenterTabController.getPlayspaceAnchorCount()
+        for (var i = 0; i < anchorCount; i++) {
+            anchors.push(MoveCenterTabController.getPlayspaceAnchorName(i))
+        }
+        playspaceAnchorComboBox.currentIndex = 0
+        playspaceAnchorComboBox.model = anchors
+    }
 }
@@ -702,7 +702,7 @@ MyStackViewPage {
             id: revivePersonalInfoDialog
             property double playerHeight: 0.0
             property double eyeHeight: 0.0
-            dialogWidth: 600
+            dialogWidth: 720
             dialogHeight: 480
             dialogTitle: "Personal Information"
             dialogContentItem: GridLayout {
@@ -847,20 +847,35 @@ MyStackViewPage {
                     }
                 }
 
-                Item {
-                    Layout.fillWidth: true
+                MyToggleButton {
+                    id: reviveHeightCalibrationToggle
+                    text: "Track Standing Height"
+                    onCheckedChanged: {
+                        ReviveTabController.setHeightCalibrationEnabled(checked, false)
+                    }
                 }
 
                 RowLayout {
                     Item {
                         Layout.fillWidth: true
                     }
+                    MyText {
+                        id: reviveCalibratedEyeHeightText
+                        Layout.preferredWidth: 120
+                        horizontalAlignment: Text.AlignHCenter
+                        text: "-"
+                    }
                     MyPushButton {
                         id: reviveCalibrateHeightButton
                         Layout.preferredWidth: 230
                         text: "Calibrate Height"
                         onClicked: {
-                            var hmdHeight = ReviveTabController.getCurrentHMDHeight()
+                            // The standing height tracked over the session
+                            // if there is one, the current height otherwise.
+                            var hmdHeight = ReviveTabController.calibratedEyeHeight
+                            if (hmdHeight <= 0.0) {
+                                hmdHeight = ReviveTabController.getCurrentHMDHeight()
+                            }
                             revivePersonalInfoDialog.eyeHeight = hmdHeight.toFixed(2)
                             pridEyeHeighInputField.text = revivePersonalInfoDialog.eyeHeight
                             revivePersonalInfoDialog.playerHeight = (hmdHeight + 0.103).toFixed(2)
@@ -881,8 +896,14 @@ MyStackViewPage {
                 pridPlayerHeighInputField.text = playerHeight.toFixed(2)
                 eyeHeight = ReviveTabController.piEyeHeight
                 pridEyeHeighInputField.text = eyeHeight.toFixed(2)
+                reviveHeightCalibrationToggle.checked = ReviveTabController.heightCalibrationEnabled
+                updateCalibratedEyeHeight()
                 open()
             }
+            function updateCalibratedEyeHeight() {
+                var height = ReviveTabController.calibratedEyeHeight
+                reviveCalibratedEyeHeightText.text = height > 0.0 ? height.toFixed(2) + " m" : "-"
+            }
             onClosed: {
                 if (okClicked) {
                     ReviveTabController.setPiUsername(rpidUsername.text, false)
@@ -1081,6 +1102,12 @@ MyStackViewPage {
             onControllerProfilesUpdated: {
                 reloadControllerProfiles()
             }
+            onHeightCalibrationEnabledChanged : {
+                reviveHeightCalibrationToggle.checked = ReviveTabController.heightCalibrationEnabled
+            }
+            onCalibratedEyeHeightChanged : {
+                revivePersonalInfoDialog.updateCalibratedEyeHeight()
+            }
         }
     }
 
@@ -26,6 +26,120 @@ MyStackViewPage {
             }
         }
 
+        MyToggleButton {
+            id: backgroundModeToggle
+            text: "Background Mode (lower CPU priority while not dragging)"
+            onCheckedChanged: {
+                SettingsTabController.setBackgroundMode(checked, true)
+            }
+        }
+
+        MyToggleButton {
+            id: sharedStateToggle
+            text: "Share Playspace, Poses and Statistics With Other Tools"
+            onCheckedChanged: {
+                SettingsTabController.setSharedStateEnabled(checked, true)
+            }
+        }
+
+        RowLayout {
+            MyText {
+                text: "CPU Cores:"
+            }
+
+            MyTextField {
+                id: cpuAffinityText
+                text: ""
+                keyBoardUID: 1001
+                Layout.preferredWidth: 200
+                Layout.leftMargin: 10
+                horizontalAlignment: Text.AlignHCenter
+                function onInputEvent(input) {
+                    SettingsTabController.setCpuAffinity(input, true)
+                    text = SettingsTabController.cpuAffinity
+                }
+            }
+
+            MyText {
+                text: "e.g. \"2,3\" or \"4-7\" of 0-" + (SettingsTabController.cpuCoreCount - 1) + ", empty for all"
+                Layout.leftMargin: 10
+            }
+        }
+
+        RowLayout {
+            MyText {
+                text: "Head Double Tap:"
+                Layout.preferredWidth: 260
+            }
+
+            MyComboBox {
+                id: headTapGestureComboBox
+                Layout.preferredWidth: 250
+                model: ["Nothing", "Toggle Push To Talk", "Fix Floor", "Reset Playspace"]
+                onCurrentIndexChanged: {
+                    SettingsTabController.setHeadTapGestureAction(currentIndex, false)
+                }
+            }
+
+            MyText {
+                text: "Tap Strength (m/s²):"
+                Layout.leftMargin: 25
+            }
+
+            MyTextField {
+                id: gestureTapAccelerationText
+                text: ""
+                keyBoardUID: 1002
+                Layout.preferredWidth: 100
+                Layout.leftMargin: 10
+                horizontalAlignment: Text.AlignHCenter
+                function onInputEvent(input) {
+                    var val = parseFloat(input)
+                    if (!isNaN(val) && val > 0) {
+                        SettingsTabController.gestureTapAcceleration = val
+                    }
+                    text = SettingsTabController.gestureTapAcceleration.toFixed(0)
+                }
+            }
+        }
+
+        RowLayout {
+            MyText {
+                text: "Controller Flick:"
+                Layout.preferredWidth: 260
+            }
+
+            MyComboBox {
+                id: flickGestureComboBox
+                Layout.preferredWidth: 250
+                model: ["Nothing", "Toggle Push To Talk", "Fix Floor", "Reset Playspace"]
+                onCurrentIndexChanged: {
+                    SettingsTabController.setFlickGestureAction(currentIndex, false)
+                }
+            }
+
+            MyText {
+                text: "Flick Speed (rad/s):"
+                Layout.leftMargin: 25
+            }
+
+            MyTextField {
+                id: gestureFlickSpeedText
+                text: ""
+                keyBoardUID: 1003
+                Layout.preferredWidth: 100
+                Layout.leftMargin: 10
+                horizontalAlignment: Text.AlignHCenter
+                function onInputEvent(input) {
+                    var val = parseFloat(input)
+                    if (!isNaN(val) && val > 0) {
+                        SettingsTabController.gestureFlickSpeed = val
+                    }
+                    text = SettingsTabController.gestureFlickSpeed.toFixed(0)
+                }
+            }
+        }
+
         Item {
             Layout.fillHeight: true
         }
@@ -33,6 +147,13 @@ MyStackViewPage {
         Component.onCompleted: {
             settingsAutoStartToggle.checked = SettingsTabController.autoStartEnabled
             forceReviveToggle.checked = SettingsTabController.forceRevivePage
+            backgroundModeToggle.checked = SettingsTabController.backgroundMode
+            sharedStateToggle.checked = SettingsTabController.sharedStateEnabled
+            cpuAffinityText.text = SettingsTabController.cpuAffinity
+            headTapGestureComboBox.currentIndex = SettingsTabController.headTapGestureAction
+            flickGestureComboBox.currentIndex = SettingsTabController.flickGestureAction
+            gestureTapAccelerationText.text = SettingsTabController.gestureTapAcceleration.toFixed(0)
+            gestureFlickSpeedText.text = SettingsTabController.gestureFlickSpeed.toFixed(0)
         }
 
         Connections {
@@ -43,6 +164,21 @@ MyStackViewPage {
             onForceRevivePageChanged: {
                 forceReviveToggle.checked = SettingsTabController.forceRevivePage
             }
+            onBackgroundModeChanged: {
+                backgroundModeToggle.checked = SettingsTabController.backgroundMode
+            }
+            onSharedStateEnabledChanged: {
+                sharedStateToggle.checked = SettingsTabController.sharedStateEnabled
+            }
+            onCpuAffinityChanged: {
+                cpuAffinityText.text = SettingsTabController.cpuAffinity
+            }
+            onHeadTapGestureActionChanged: {
+                headTapGestureComboBox.currentIndex = SettingsTabController.headTapGestureAction
+            }
+            onFlickGestureActionChanged: {
+                flickGestureComboBox.currentIndex = SettingsTabController.flickGestureAction
+            }
         }
     }
 }
@@ -190,12 +190,179 @@ MyStackViewPage {
                 }
             }
         }
+
+        MyToggleButton {
+            id: performanceHudToggle
+            text: "Show Performance HUD"
+            Layout.topMargin: 32
+            onCheckedChanged: {
+                StatisticsTabController.performanceHud = this.checked
+            }
+        }
+
+        MyText {
+            text: "Overlay Resource Usage:"
+            Layout.topMargin: 16
+        }
+
+        RowLayout {
+            spacing: 18
+
+            GridLayout {
+                columns: 2
+                columnSpacing: 18
+
+                MyText {
+                    text: "CPU:"
+                }
+                MyText {
+                    id: statsOverlayCpuText
+                    text: "0.0%"
+                    horizontalAlignment: Text.AlignRight
+                    Layout.preferredWidth: 160
+                }
+
+                MyText {
+                    text: "Memory:"
+                }
+                MyText {
+                    id: statsOverlayMemoryText
+                    text: "0.0 MB"
+                    horizontalAlignment: Text.AlignRight
+                    Layout.preferredWidth: 160
+                }
+
+                MyText {
+                    text: "Threads:"
+                }
+                MyText {
+                    id: statsOverlayThreadsText
+                    text: "0"
+                    horizontalAlignment: Text.AlignRight
+                    Layout.preferredWidth: 160
+                }
+
+                MyText {
+                    text: "Context Switches:"
+                }
+                MyText {
+                    id: statsOverlayContextSwitchesText
+                    text: "0/s"
+                    horizontalAlignment: Text.AlignRight
+                    Layout.preferredWidth: 160
+                }
+
+                MyText {
+                    text: "Run Queue Wait:"
+                }
+                MyText {
+                    id: statsOverlayRunQueueWaitText
+                    text: "0.0%"
+                    horizontalAlignment: Text.AlignRight
+                    Layout.preferredWidth: 160
+                }
+
+                MyText {
+                    text: "Priority Changes:"
+                }
+                MyText {
+                    id: statsOverlayPriorityChangesText
+                    text: "0"
+                    horizontalAlignment: Text.AlignRight
+                    Layout.preferredWidth: 160
+                }
+            }
+
+            // CPU usage over the last minute, one bar per second
+            Rectangle {
+                color: "#1b2939"
+                Layout.fillWidth: true
+                Layout.preferredHeight: 120
+                Row {
+                    anchors.bottom: parent.bottom
+                    anchors.left: parent.left
+                    anchors.right: parent.right
+                    Repeater {
+                        id: statsOverlayCpuHistory
+                        model: []
+                        Rectangle {
+                            width: parent.width / 60
+                            height: Math.min(modelData / Math.max(StatisticsTabController.overlayCpuBudget * 2.0, 1.0), 1.0) * 120
+                            anchors.bottom: parent.bottom
+                            color: modelData > StatisticsTabController.overlayCpuBudget && StatisticsTabController.overlayCpuBudget > 0 ? "#e03131" : "#40c040"
+                        }
+                    }
+                }
+            }
+        }
+
+        RowLayout {
+            MyText {
+                text: "CPU Budget (%):"
+            }
+
+            MyTextField {
+                id: overlayCpuBudgetText
+                text: "0.0"
+                keyBoardUID: 901
+                Layout.preferredWidth: 100
+                Layout.leftMargin: 10
+                horizontalAlignment: Text.AlignHCenter
+                function onInputEvent(input) {
+                    var val = parseFloat(input)
+                    if (!isNaN(val) && val >= 0.0) {
+                        StatisticsTabController.overlayCpuBudget = val
+                    }
+                    text = StatisticsTabController.overlayCpuBudget.toFixed(1)
+                }
+            }
+
+            MyText {
+                id: overlayCpuBudgetWarning
+                text: "The overlay exceeds its CPU budget!"
+                color: "#e03131"
+                visible: false
+                Layout.leftMargin: 18
+            }
+        }
+        MyText {
+            text: "History:"
+            Layout.topMargin: 16
+        }
+
+        // Totals of the last week from the statistics log, newest first
+        GridLayout {
+            columns: 5
+            columnSpacing: 18
+
+            Repeater {
+                id: statsHistory
+                model: []
+                delegate: MyText {
+                    text: modelData
+                }
+            }
+        }
         Item {
             Layout.fillHeight: true
         }
 
+        function updateHistory() {
+            var cells = ["Date", "Minutes", "Distance", "Sessions", "Most Played"]
+            var days = StatisticsTabController.statisticsHistory(7)
+            for (var i = 0; i < days.length; i++) {
+                var day = days[i]
+                cells.push(day.date)
+                cells.push(day.minutes.toFixed(0))
+                cells.push(day.distance.toFixed(1) + " m")
+                cells.push(day.sessions)
+                cells.push(day.topApp === "" ? "-" : day.topApp)
+            }
+            statsHistory.model = cells
+        }
+
         function updateStatistics() {
-            statsHmdMovedText.text = StatisticsTabController.hmdDistanceMoved.toFixed(1) + " m"
+            statsHmdMovedText.text = StatisticsTabController.hmdDistanceMoved.toFixed(1) + " m (" + StatisticsTabController.hmdDistanceMoved3D.toFixed(1) + " m in 3D)"
             var rotations = StatisticsTabController.hmdRotations
             if (rotations > 0) {
                 statsHmdRotationText.text = rotations.toFixed(2) + " CCW"
@@ -209,6 +376,15 @@ MyStackViewPage {
             statsReprojectionFramesText.text = StatisticsTabController.reprojectedFrames
             statsTimedOutText.text = StatisticsTabController.timedOut
             statstotalRatioText.text = (StatisticsTabController.totalReprojectedRatio*100.0).toFixed(1) + "%"
+            statsOverlayCpuText.text = StatisticsTabController.overlayCpuUsage.toFixed(1) + "%"
+            statsOverlayMemoryText.text = StatisticsTabController.overlayMemoryUsage.toFixed(1) + " MB"
+            statsOverlayThreadsText.text = StatisticsTabController.overlayThreadCount
+            var contextSwitches = StatisticsTabController.overlayContextSwitches
+            statsOverlayContextSwitchesText.text = contextSwitches < 0 ? "n/a" : contextSwitches.toFixed(0) + "/s"
+            var runQueueWait = StatisticsTabController.overlayRunQueueWait
+            statsOverlayRunQueueWaitText.text = runQueueWait < 0 ? "n/a" : runQueueWait.toFixed(1) + "%"
+            statsOverlayPriorityChangesText.text = StatisticsTabController.overlayPriorityChanges
+            statsOverlayCpuHistory.model = StatisticsTabController.overlayCpuHistory()
         }
 
         Timer {
@@ -220,8 +396,28 @@ MyStackViewPage {
             }
         }
 
+        Component.onCompleted: {
+            performanceHudToggle.checked = StatisticsTabController.performanceHud
+            overlayCpuBudgetText.text = StatisticsTabController.overlayCpuBudget.toFixed(1)
+            overlayCpuBudgetWarning.visible = StatisticsTabController.overlayCpuBudgetExceeded
+        }
+
+        Connections {
+            target: StatisticsTabController
+            onPerformanceHudChanged: {
+                performanceHudToggle.checked = StatisticsTabController.performanceHud
+            }
+            onOverlayCpuBudgetChanged: {
+                overlayCpuBudgetText.text = StatisticsTabController.overlayCpuBudget.toFixed(1)
+            }
+            onOverlayCpuBudgetExceededChanged: {
+                overlayCpuBudgetWarning.visible = StatisticsTabController.overlayCpuBudgetExceeded
+            }
+        }
+
         onVisibleChanged: {
             if (visible) {
+                updateHistory()
                 updateStatistics()
                 statisticsUpdateTimer.start()
             } else {
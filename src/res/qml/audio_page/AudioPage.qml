@@ -27,6 +27,34 @@ MyStackViewPage {
             spacing: 18
             ProximityToggle {
             }
+            RowLayout {
+                MyText {
+                    text: "Proximity Sensor Delay (ms):"
+                }
+
+                MyTextField {
+                    id: micProximityDebounceText
+                    text: AudioTabController.micProximityDebounce
+                    keyBoardUID: 501
+                    Layout.preferredWidth: 100
+                    Layout.leftMargin: 10
+                    horizontalAlignment: Text.AlignHCenter
+                    function onInputEvent(input) {
+                        var val = parseInt(input)
+                        if (!isNaN(val) && val >= 0) {
+                            AudioTabController.micProximityDebounce = val
+                        }
+                        text = AudioTabController.micProximityDebounce
+                    }
+                }
+
+                Connections {
+                    target: AudioTabController
+                    onMicProximityDebounceChanged: {
+                        micProximityDebounceText.text = AudioTabController.micProximityDebounce
+                    }
+                }
+            }
             PttButtons {
             }
             ProfileButtons {
@@ -1,6 +1,7 @@
 #include "AudioTabController.h"
 #include <QQuickWindow>
 #include <QApplication>
+#include <algorithm>
 #include "../overlaycontroller.h"
 #ifdef _WIN32
 #    include "audiomanager/AudioManagerWindows.h"
@@ -11,6 +12,25 @@
 // application namespace
 namespace advsettings
 {
+namespace
+{
+    void drawPttNotification( utils::RasterCanvas& canvas )
+    {
+        // Microphone on a round badge.
+        constexpr uint32_t background = 0x2B8A3ED0;
+        constexpr uint32_t foreground = 0xFFFFFFFF;
+        canvas.clear( 0x00000000 );
+        canvas.fillCircle( 32, 32, 31, background );
+        canvas.fillCircle( 32, 16, 7, foreground );
+        canvas.fillRect( 25, 16, 15, 12, foreground );
+        canvas.fillCircle( 32, 28, 7, foreground );
+        canvas.fillRect( 31, 35, 3, 5, foreground );
+        canvas.fillRect( 25, 40, 15, 2, foreground );
+        const int textX = 32 - utils::RasterCanvas::textWidth( "PTT" ) / 2;
+        canvas.drawText( textX, 46, "PTT", foreground );
+    }
+} // namespace
+
 void AudioTabController::initStage1()
 {
     vr::EVRSettingsError vrSettingsError;
@@ -63,48 +83,48 @@ void AudioTabController::initStage2( OverlayController* var_parent,
     this->parent = var_parent;
     this->widget = var_widget;
 
-    std::string notifKey
-        = std::string( OverlayController::applicationKey ) + ".pptnotification";
-
-    vr::VROverlayError overlayError = vr::VROverlay()->CreateOverlay(
-        notifKey.c_str(), notifKey.c_str(), &m_ulNotificationOverlayHandle );
-    if ( overlayError == vr::VROverlayError_None )
+    auto& notifications = parent->notifications();
+    m_pttNotification = notifications.create( 64, 64, 0.02f );
+    if ( auto canvas = notifications.draw( m_pttNotification ) )
     {
-        QString notifIconPath = QStandardPaths::locate(
-            QStandardPaths::AppDataLocation,
-            QStringLiteral(
-                "/res/img/audio/microphone/ptt_notification.png" ) );
-        if ( QFile::exists( notifIconPath ) )
-        {
-            vr::VROverlay()->SetOverlayFromFile(
-                m_ulNotificationOverlayHandle,
-                notifIconPath.toStdString().c_str() );
-            vr::VROverlay()->SetOverlayWidthInMeters(
-                m_ulNotificationOverlayHandle, 0.02f );
-            vr::HmdMatrix34_t notificationTransform
-                = { { { 1.0f, 0.0f, 0.0f, 0.12f },
-                      { 0.0f, 1.0f, 0.0f, 0.08f },
-                      { 0.0f, 0.0f, 1.0f, -0.3f } } };
-            vr::VROverlay()->SetOverlayTransformTrackedDeviceRelative(
-                m_ulNotificationOverlayHandle,
-                vr::k_unTrackedDeviceIndex_Hmd,
-                &notificationTransform );
-        }
-        else
-        {
-            LOG( ERROR ) << "Could not find notification icon \""
-                         << notifIconPath << "\"";
-        }
+        drawPttNotification( *canvas );
+        vr::HmdMatrix34_t notificationTransform
+            = { { { 1.0f, 0.0f, 0.0f, 0.12f },
+                  { 0.0f, 1.0f, 0.0f, 0.08f },
+                  { 0.0f, 0.0f, 1.0f, -0.3f } } };
+        notifications.attachToDevice( m_pttNotification,
+                                      vr::k_unTrackedDeviceIndex_Hmd,
+                                      notificationTransform );
     }
-    else
+    // The sensor is reported like a button of the HMD.
+    auto& eventBus = parent->eventBus();
+    for ( const auto eventType :
+          { vr::VREvent_ButtonPress, vr::VREvent_ButtonUnpress } )
     {
-        LOG( ERROR ) << "Could not create ptt notification overlay: "
-                     << vr::VROverlay()->GetOverlayErrorNameFromEnum(
-                            overlayError );
+        eventBus.subscribe( eventType, [this]( const vr::VREvent_t& event ) {
+            if ( m_micProximitySensorCanMute )
+            {
+                m_proximityMute.handleEvent( event,
+                                             std::chrono::steady_clock::now() );
+            }
+        } );
+    }
+    if ( m_micProximitySensorCanMute )
+    {
+        readProximitySensor();
     }
     emit defaultProfileDisplay();
 }
 
+void AudioTabController::setNotificationVisible( bool visible )
+{
+    // Not created before initStage2().
+    if ( m_pttNotification != utils::NotificationCompositor::invalidId )
+    {
+        parent->notifications().setVisible( m_pttNotification, visible );
+    }
+}
+
 void AudioTabController::reloadAudioSettings()
 {
     std::lock_guard<std::recursive_mutex> lock( eventLoopMutex );
@@ -112,6 +132,8 @@ void AudioTabController::reloadAudioSettings()
     settings->beginGroup( getSettingsName() );
     setMicProximitySensorCanMute(
         settings->value( "micProximitySensorCanMute", false ).toBool(), false );
+    setMicProximityDebounce(
+        settings->value( "micProximityDebounce", 250 ).toInt(), false );
     setMicReversePtt( settings->value( "micReversePtt", false ).toBool(),
                       false );
     settings->endGroup();
@@ -123,6 +145,7 @@ void AudioTabController::saveAudioSettings()
     settings->beginGroup( getSettingsName() );
     settings->setValue( "micProximitySensorCanMute",
                         micProximitySensorCanMute() );
+    settings->setValue( "micProximityDebounce", micProximityDebounce() );
     settings->setValue( "micReversePtt", micReversePtt() );
     settings->endGroup();
     settings->sync();
@@ -153,6 +176,11 @@ bool AudioTabController::micProximitySensorCanMute() const
     return m_micProximitySensorCanMute;
 }
 
+int AudioTabController::micProximityDebounce() const
+{
+    return m_micProximityDebounce;
+}
+
 bool AudioTabController::micReversePtt() const
 {
     return m_micReversePtt;
@@ -163,6 +191,44 @@ bool AudioTabController::audioProfileDefault() const
     return m_isDefaultAudioProfile;
 }
 
+void AudioTabController::readProximitySensor()
+{
+    // Only logged when a known state gets lost, not on every tick.
+    const bool known = m_proximityMute.isKnown();
+    if ( !m_proximityMute.poll( std::chrono::steady_clock::now() ) && known
+         && !parent->isDashboardVisible() )
+    {
+        LOG( ERROR ) << "Could not read proximity sensor!";
+    }
+}
+
+void AudioTabController::updateProximityMute()
+{
+    bool mute = false;
+    if ( m_proximityMute.update(
+             std::chrono::steady_clock::now(),
+             std::chrono::milliseconds( m_micProximityDebounce ),
+             m_micMuted,
+             mute ) )
+    {
+        // Still a synchronous call on the event loop thread, see the header.
+        setMicMuted( mute );
+        LOG( INFO ) << "Headset " << ( mute ? "taken off" : "put on" )
+                    << ", microphone " << ( mute ? "muted" : "unmuted" )
+                    << " after "
+                    << std::chrono::duration<double, std::milli>(
+                           std::chrono::steady_clock::now()
+                           - m_proximityMute.changeTime() )
+                           .count()
+                    << " ms";
+    }
+}
+
+void AudioTabController::refreshSettings() noexcept
+{
+    settingsUpdateCounter = k_audioSettingsUpdateCounter;
+}
+
 void AudioTabController::eventLoopTick()
 {
     if ( !eventLoopMutex.try_lock() )
@@ -170,41 +236,15 @@ void AudioTabController::eventLoopTick()
         return;
     }
 
+    if ( m_micProximitySensorCanMute )
+    {
+        // Every tick, the sensor's events aren't always delivered.
+        readProximitySensor();
+        updateProximityMute();
+    }
+
     if ( settingsUpdateCounter >= k_audioSettingsUpdateCounter )
     {
-        if ( m_micProximitySensorCanMute )
-        {
-            vr::VRControllerState_t controllerState;
-            if ( vr::VRSystem()->GetControllerState(
-                     vr::k_unTrackedDeviceIndex_Hmd,
-                     &controllerState,
-                     sizeof( vr::VRControllerState_t ) ) )
-            {
-                if ( ( controllerState.ulButtonPressed
-                       & vr::ButtonMaskFromId( vr::k_EButton_ProximitySensor ) )
-                     == 0 )
-                {
-                    if ( !m_micMuted )
-                    {
-                        setMicMuted( true );
-                    }
-                }
-                else
-                {
-                    if ( m_micMuted )
-                    {
-                        setMicMuted( false );
-                    }
-                }
-            }
-            else
-            {
-                if ( !parent->isDashboardVisible() )
-                {
-                    LOG( ERROR ) << "Could not read proximity sensor!";
-                }
-            }
-        }
         vr::EVRSettingsError vrSettingsError;
         char mirrorDeviceId[1024];
         vr::VRSettings()->GetString(
@@ -367,6 +407,13 @@ void AudioTabController::setMicProximitySensorCanMute( bool value, bool notify )
     if ( value != m_micProximitySensorCanMute )
     {
         m_micProximitySensorCanMute = value;
+        m_proximityMute.reset();
+        // The settings are loaded before initStage2(), which reads the
+        // sensor then.
+        if ( value && parent )
+        {
+            readProximitySensor();
+        }
         saveAudioSettings();
         if ( notify )
         {
@@ -375,6 +422,21 @@ void AudioTabController::setMicProximitySensorCanMute( bool value, bool notify )
     }
 }
 
+void AudioTabController::setMicProximityDebounce( int value, bool notify )
+{
+    std::lock_guard<std::recursive_mutex> lock( eventLoopMutex );
+    value = std::max( value, 0 );
+    if ( value != m_micProximityDebounce )
+    {
+        m_micProximityDebounce = value;
+        saveAudioSettings();
+        if ( notify )
+        {
+            emit micProximityDebounceChanged( value );
+        }
+    }
+}
+
 void AudioTabController::setMicReversePtt( bool value, bool notify )
 {
     std::lock_guard<std::recursive_mutex> lock( eventLoopMutex );
@@ -742,31 +804,8 @@ Profile Name
 */
 void AudioTabController::reloadAudioProfiles()
 {
-    audioProfiles.clear();
-    auto settings = OverlayController::appSettings();
-    settings->beginGroup( getSettingsName() );
-    auto profileCount = settings->beginReadArray( "audioProfiles" );
-    for ( int i = 0; i < profileCount; i++ )
-    {
-        settings->setArrayIndex( i );
-        audioProfiles.emplace_back();
-        auto& entry = audioProfiles[static_cast<size_t>( i )];
-        entry.profileName
-            = settings->value( "profileName" ).toString().toStdString();
-        entry.playbackName
-            = settings->value( "playbackName" ).toString().toStdString();
-        entry.micName = settings->value( "micName" ).toString().toStdString();
-        entry.mirrorName
-            = settings->value( "mirrorName" ).toString().toStdString();
-        entry.micMute = settings->value( "micMute", false ).toBool();
-        entry.mirrorMute = settings->value( "mirrorMute", false ).toBool();
-        entry.mirrorVol = settings->value( "mirrorVol", 0.0 ).toFloat();
-        entry.micVol = settings->value( "micVol", 1.0 ).toFloat();
-        entry.defaultProfile
-            = settings->value( "defaultProfile", false ).toBool();
-    }
-    settings->endArray();
-    settings->endGroup();
+    audioProfiles = audio_profile::k_schema.readIniArray(
+        *OverlayController::appSettings(), getSettingsName(), "audioProfiles" );
 }
 
 /*
@@ -784,29 +823,10 @@ Description: saves a copy of the audio profiles from working to Settings file.
 */
 void AudioTabController::saveAudioProfiles()
 {
-    auto settings = OverlayController::appSettings();
-    settings->beginGroup( getSettingsName() );
-    settings->beginWriteArray( "audioProfiles" );
-    int i = 0;
-    for ( auto& p : audioProfiles )
-    {
-        settings->setArrayIndex( i );
-        settings->setValue( "profileName",
-                            QString::fromStdString( p.profileName ) );
-        settings->setValue( "playbackName",
-                            QString::fromStdString( p.playbackName ) );
-        settings->setValue( "micName", QString::fromStdString( p.micName ) );
-        settings->setValue( "mirrorName",
-                            QString::fromStdString( p.mirrorName ) );
-        settings->setValue( "micMute", p.micMute );
-        settings->setValue( "mirrorMute", p.mirrorMute );
-        settings->setValue( "micVol", p.micVol );
-        settings->setValue( "mirrorVol", p.mirrorVol );
-        settings->setValue( "defaultProfile", p.defaultProfile );
-        i++;
-    }
-    settings->endArray();
-    settings->endGroup();
+    audio_profile::k_schema.writeIniArray( *OverlayController::appSettings(),
+                                           getSettingsName(),
+                                           "audioProfiles",
+                                           audioProfiles );
 }
 
 /*
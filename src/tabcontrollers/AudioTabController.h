@@ -3,6 +3,10 @@
 
 #include "AudioManager.h"
 #include "PttController.h"
+#include "../utils/NotificationCompositor.h"
+#include "../utils/ProfileSchema.h"
+#include "../utils/ProximityMute.h"
+#include <chrono>
 #include <memory>
 
 class QQuickWindow;
@@ -19,12 +23,30 @@ struct AudioProfile
     std::string mirrorName;
     std::string micName;
     float mirrorVol = 0.0;
-    float micVol = 0.0;
+    float micVol = 1.0;
     bool micMute = false;
     bool mirrorMute = false;
     bool defaultProfile = false;
 };
 
+// How AudioProfile is stored in the settings, see utils::ProfileSchema.
+namespace audio_profile
+{
+    using Profile = AudioProfile;
+
+    inline constexpr auto k_schema = utils::profileSchema<Profile>(
+        1,
+        utils::profileField( "profileName", &Profile::profileName ),
+        utils::profileField( "playbackName", &Profile::playbackName ),
+        utils::profileField( "micName", &Profile::micName ),
+        utils::profileField( "mirrorName", &Profile::mirrorName ),
+        utils::profileField( "micMute", &Profile::micMute ),
+        utils::profileField( "mirrorMute", &Profile::mirrorMute ),
+        utils::profileField( "micVol", &Profile::micVol ),
+        utils::profileField( "mirrorVol", &Profile::mirrorVol ),
+        utils::profileField( "defaultProfile", &Profile::defaultProfile ) );
+} // namespace audio_profile
+
 class AudioTabController : public PttController
 {
     Q_OBJECT
@@ -45,17 +67,19 @@ class AudioTabController : public PttController
     Q_PROPERTY( bool micProximitySensorCanMute READ micProximitySensorCanMute
                     WRITE setMicProximitySensorCanMute NOTIFY
                         micProximitySensorCanMuteChanged )
+    Q_PROPERTY( int micProximityDebounce READ micProximityDebounce WRITE
+                    setMicProximityDebounce NOTIFY micProximityDebounceChanged )
     Q_PROPERTY( bool micReversePtt READ micReversePtt WRITE setMicReversePtt
                     NOTIFY micReversePttChanged )
     Q_PROPERTY( bool audioProfileDefault READ audioProfileDefault WRITE
                     setAudioProfileDefault NOTIFY audioProfileDefaultChanged )
 
 private:
-    OverlayController* parent;
+    OverlayController* parent = nullptr;
     QQuickWindow* widget;
 
-    vr::VROverlayHandle_t m_ulNotificationOverlayHandle
-        = vr::k_ulOverlayHandleInvalid;
+    utils::NotificationCompositor::Id m_pttNotification
+        = utils::NotificationCompositor::invalidId;
 
     int m_playbackDeviceIndex = -1;
 
@@ -67,6 +91,8 @@ private:
     float m_micVolume = 1.0;
     bool m_micMuted = false;
     bool m_micProximitySensorCanMute = false;
+    // Milliseconds the proximity sensor has to keep a new state.
+    int m_micProximityDebounce = 250;
     bool m_micReversePtt = false;
     bool m_isDefaultAudioProfile = false;
 
@@ -74,6 +100,17 @@ private:
 
     unsigned settingsUpdateCounter = 0;
 
+    // Proximity sensor state, read every tick and from the sensor's button
+    // events, see utils::ProximityMute. The mute itself is still a
+    // synchronous audio manager call on the event loop thread, once per
+    // change: the Windows endpoint is replaced on device changes and every
+    // other audio call would need a lock to hand it to another thread.
+    utils::ProximityMute m_proximityMute;
+
+    void readProximitySensor();
+    // Applies a sensor change once it has held for the debounce delay.
+    void updateProximityMute();
+
     std::unique_ptr<AudioManager> audioManager;
     std::vector<std::pair<std::string, std::string>> m_recordingDevices;
     std::vector<std::pair<std::string, std::string>> m_playbackDevices;
@@ -88,10 +125,7 @@ private:
     void onPttEnabled() override;
     void onPttDisabled() override;
 
-    virtual vr::VROverlayHandle_t getNotificationOverlayHandle() override
-    {
-        return m_ulNotificationOverlayHandle;
-    }
+    void setNotificationVisible( bool visible ) override;
 
     void findPlaybackDeviceIndex( std::string id, bool notify = true );
     void findMirrorDeviceIndex( std::string id, bool notify = true );
@@ -113,6 +147,8 @@ public:
     void saveAudioSettings();
 
     void eventLoopTick();
+    // The values shown on the page are read again with the next tick.
+    void refreshSettings() noexcept;
 
     bool pttChangeValid() override;
 
@@ -126,6 +162,7 @@ public:
     float micVolume() const;
     bool micMuted() const;
     bool micProximitySensorCanMute() const;
+    int micProximityDebounce() const;
     bool micReversePtt() const;
     bool audioProfileDefault() const;
 
@@ -155,6 +192,7 @@ public slots:
     void setMicVolume( float value, bool notify = true );
     void setMicMuted( bool value, bool notify = true );
     void setMicProximitySensorCanMute( bool value, bool notify = true );
+    void setMicProximityDebounce( int value, bool notify = true );
     void setMicReversePtt( bool value, bool notify = true );
 
     void setPlaybackDeviceIndex( int value, bool notify = true );
@@ -178,6 +216,7 @@ signals:
     void micVolumeChanged( float value );
     void micMutedChanged( bool value );
     void micProximitySensorCanMuteChanged( bool value );
+    void micProximityDebounceChanged( int value );
     void micReversePttChanged( bool value );
 
     void playbackDeviceListChanged();
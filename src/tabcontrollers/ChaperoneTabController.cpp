@@ -1,15 +1,26 @@
 #include "ChaperoneTabController.h"
 #include <QQuickWindow>
 #include "../overlaycontroller.h"
+#include <algorithm>
 #include <cmath>
 
 // application namespace
 namespace advsettings
 {
-void ChaperoneTabController::initStage1()
+namespace
 {
-    m_height = getBoundsMaxY();
+    // Time the HMD has to be in another space before its profile is applied.
+    constexpr std::chrono::seconds k_profileAutoSelectDelay{ 2 };
+
+    // Corners of traced or merged bounds closer than this to their
+    // neighbours are dropped, in m.
+    constexpr float k_boundsTolerance = 0.1f;
+    // Height of traced walls when there are no bounds to take it from.
+    constexpr float k_defaultBoundsHeight = 2.0f;
+} // namespace
 
+void ChaperoneTabController::initStage1()
+{
     auto settings = OverlayController::appSettings();
     settings->beginGroup( "chaperoneSettings" );
     m_enableChaperoneSwitchToBeginner
@@ -38,6 +49,9 @@ void ChaperoneTabController::initStage1()
     m_chaperoneVelocityModifier
         = settings->value( "chaperoneVelocityModifier", 0.3f ).toFloat();
     m_chaperoneVelocityModifierCurrent = 1.0f;
+    m_enableChaperoneProfileAutoSelect
+        = settings->value( "chaperoneProfileAutoSelectEnabled", false )
+              .toBool();
     settings->endGroup();
 
     reloadChaperoneProfiles();
@@ -49,6 +63,23 @@ void ChaperoneTabController::initStage2( OverlayController* var_parent,
 {
     this->parent = var_parent;
     this->widget = var_widget;
+
+    // The bounds are only read back when they changed, the height follows
+    // right after the reload subscribed by the OverlayController.
+    updateHeight( getBoundsMaxY() );
+    updateStandingToRaw();
+    updateTrackingSignature();
+    parent->eventBus().subscribeCoalesced(
+        { vr::VREvent_ChaperoneUniverseHasChanged,
+          vr::VREvent_ChaperoneDataHasChanged },
+        [this]( const vr::VREvent_t& ) {
+            updateHeight( getBoundsMaxY() );
+            updateStandingToRaw();
+        } );
+    parent->eventBus().subscribeCoalesced(
+        { vr::VREvent_TrackedDeviceActivated,
+          vr::VREvent_TrackedDeviceDeactivated },
+        [this]( const vr::VREvent_t& ) { updateTrackingSignature(); } );
 }
 
 ChaperoneTabController::~ChaperoneTabController()
@@ -62,295 +93,166 @@ ChaperoneTabController::~ChaperoneTabController()
 
 void ChaperoneTabController::reloadChaperoneProfiles()
 {
-    chaperoneProfiles.clear();
-    auto settings = OverlayController::appSettings();
-    settings->beginGroup( "chaperoneSettings" );
-    auto profileCount = settings->beginReadArray( "chaperoneProfiles" );
-    for ( int i = 0; i < profileCount; i++ )
+    chaperoneProfiles = chaperone_profile::k_schema.readIniArray(
+        *OverlayController::appSettings(),
+        "chaperoneSettings",
+        "chaperoneProfiles" );
+    // Only stored for older versions, the quads are authoritative.
+    for ( auto& profile : chaperoneProfiles )
     {
-        settings->setArrayIndex( i );
-        chaperoneProfiles.emplace_back();
-        auto& entry = chaperoneProfiles[static_cast<size_t>( i )];
-        entry.profileName
-            = settings->value( "profileName" ).toString().toStdString();
-        entry.includesChaperoneGeometry
-            = settings->value( "includesChaperoneGeometry", false ).toBool();
-        if ( entry.includesChaperoneGeometry )
-        {
-            entry.chaperoneGeometryQuadCount
-                = settings->value( "chaperoneGeometryQuadCount", 0 ).toUInt();
-            entry.chaperoneGeometryQuads.reset(
-                new vr::HmdQuad_t[entry.chaperoneGeometryQuadCount] );
-            unsigned qi = 0;
-            for ( auto q :
-                  settings->value( "chaperoneGeometryQuads" ).toList() )
-            {
-                unsigned ci = 0;
-                for ( auto c : q.toList() )
-                {
-                    unsigned cci = 0;
-                    for ( auto cc : c.toList() )
-                    {
-                        entry.chaperoneGeometryQuads.get()[qi]
-                            .vCorners[ci]
-                            .v[cci]
-                            = cc.toFloat();
-                        cci++;
-                    }
-                    ci++;
-                }
-                qi++;
-            }
-            unsigned i1 = 0;
-            for ( auto l1 : settings->value( "standingCenter" ).toList() )
-            {
-                unsigned i2 = 0;
-                for ( auto l2 : l1.toList() )
-                {
-                    entry.standingCenter.m[i1][i2] = l2.toFloat();
-                    i2++;
-                }
-                i1++;
-            }
-            entry.playSpaceAreaX
-                = settings->value( "playSpaceAreaX", 0.0f ).toFloat();
-            entry.playSpaceAreaZ
-                = settings->value( "playSpaceAreaZ", 0.0f ).toFloat();
-        }
-        entry.includesVisibility
-            = settings->value( "includesVisibility", false ).toBool();
-        if ( entry.includesVisibility )
-        {
-            entry.visibility = settings->value( "visibility", 0.6 ).toFloat();
-        }
-        entry.includesFadeDistance
-            = settings->value( "includesFadeDistance", false ).toBool();
-        if ( entry.includesFadeDistance )
-        {
-            entry.fadeDistance
-                = settings->value( "fadeDistance", 0.7 ).toFloat();
-        }
-        entry.includesCenterMarker
-            = settings->value( "includesCenterMarker", false ).toBool();
-        if ( entry.includesCenterMarker )
-        {
-            entry.centerMarker
-                = settings->value( "centerMarker", false ).toBool();
-        }
-        entry.includesPlaySpaceMarker
-            = settings->value( "includesPlaySpaceMarker", false ).toBool();
-        if ( entry.includesPlaySpaceMarker )
-        {
-            entry.playSpaceMarker
-                = settings->value( "playSpaceMarker", false ).toBool();
-        }
-        entry.includesFloorBoundsMarker
-            = settings->value( "includesFloorBoundsMarker", false ).toBool();
-        if ( entry.includesFloorBoundsMarker )
-        {
-            entry.floorBoundsMarker
-                = settings->value( "floorBoundsMarker", false ).toBool();
-        }
-        entry.includesBoundsColor
-            = settings->value( "includesBoundsColor", false ).toBool();
-        if ( entry.includesBoundsColor )
-        {
-            auto color = settings->value( "boundsColor" ).toList();
-            entry.boundsColor[0] = color[0].toInt();
-            entry.boundsColor[1] = color[1].toInt();
-            entry.boundsColor[2] = color[2].toInt();
-        }
-        entry.includesChaperoneStyle
-            = settings->value( "includesChaperoneStyle", false ).toBool();
-        if ( entry.includesChaperoneStyle )
-        {
-            entry.chaperoneStyle
-                = settings->value( "chaperoneStyle", 0 ).toInt();
-        }
-        entry.includesForceBounds
-            = settings->value( "includesForceBounds", false ).toBool();
-        if ( entry.includesForceBounds )
-        {
-            entry.forceBounds
-                = settings->value( "forceBounds", false ).toBool();
-        }
-        entry.includesProximityWarningSettings
-            = settings->value( "includesProximityWarningSettings", false )
-                  .toBool();
-        if ( entry.includesProximityWarningSettings )
-        {
-            entry.enableChaperoneSwitchToBeginner
-                = settings->value( "chaperoneSwitchToBeginnerEnabled", false )
-                      .toBool();
-            entry.chaperoneSwitchToBeginnerDistance
-                = settings->value( "chaperoneSwitchToBeginnerDistance", 0.5f )
-                      .toFloat();
-            entry.enableChaperoneHapticFeedback
-                = settings->value( "chaperoneHapticFeedbackEnabled", false )
-                      .toBool();
-            entry.chaperoneHapticFeedbackDistance
-                = settings->value( "chaperoneHapticFeedbackDistance", 0.5f )
-                      .toFloat();
-            entry.enableChaperoneAlarmSound
-                = settings->value( "chaperoneAlarmSoundEnabled", false )
-                      .toBool();
-            entry.chaperoneAlarmSoundLooping
-                = settings->value( "chaperoneAlarmSoundLooping", true )
-                      .toBool();
-            entry.chaperoneAlarmSoundAdjustVolume
-                = settings->value( "chaperoneAlarmSoundAdjustVolume", false )
-                      .toBool();
-            entry.chaperoneAlarmSoundDistance
-                = settings->value( "chaperoneAlarmSoundDistance", 0.5f )
-                      .toFloat();
-            entry.enableChaperoneShowDashboard
-                = settings->value( "chaperoneShowDashboardEnabled", false )
-                      .toBool();
-            entry.chaperoneShowDashboardDistance
-                = settings->value( "chaperoneShowDashboardDistance", 0.5f )
-                      .toFloat();
-            entry.enableChaperoneVelocityModifier
-                = settings->value( "chaperoneVelocityModifierEnabled", false )
-                      .toBool();
-            entry.chaperoneVelocityModifier
-                = settings->value( "chaperoneVelocityModifier", 0.3f )
-                      .toFloat();
-        }
-    }
-    settings->endArray();
-    settings->endGroup();
+        profile.chaperoneGeometryQuadCount
+            = static_cast<unsigned>( profile.chaperoneGeometryQuads.size() );
+    }
+    m_profileLocatorDirty = true;
+    m_autoSelectedProfile = -1;
+    m_autoSelectedProfileKnown = false;
 }
 
 void ChaperoneTabController::saveChaperoneProfiles()
 {
-    auto settings = OverlayController::appSettings();
-    settings->beginGroup( "chaperoneSettings" );
-    settings->beginWriteArray( "chaperoneProfiles" );
-    unsigned i = 0;
-    for ( auto& p : chaperoneProfiles )
+    chaperone_profile::k_schema.writeIniArray(
+        *OverlayController::appSettings(),
+        "chaperoneSettings",
+        "chaperoneProfiles",
+        chaperoneProfiles );
+    m_profileLocatorDirty = true;
+}
+
+void ChaperoneTabController::syncVRSettings()
+{
+    if ( !m_applyingProfile )
     {
-        settings->setArrayIndex( static_cast<int>( i ) );
-        settings->setValue( "profileName",
-                            QString::fromStdString( p.profileName ) );
-        settings->setValue( "includesChaperoneGeometry",
-                            p.includesChaperoneGeometry );
-        if ( p.includesChaperoneGeometry )
-        {
-            settings->setValue( "chaperoneGeometryQuadCount",
-                                p.chaperoneGeometryQuadCount );
-            QVariantList quadList;
-            for ( unsigned qi = 0; qi < p.chaperoneGeometryQuadCount; qi++ )
-            {
-                QVariantList cornerList;
-                for ( unsigned ci = 0; ci < 4; ci++ )
-                {
-                    QVariantList coordVector;
-                    for ( unsigned cci = 0; cci < 3; cci++ )
-                    {
-                        coordVector.push_back(
-                            p.chaperoneGeometryQuads.get()[qi]
-                                .vCorners[ci]
-                                .v[cci] );
-                    }
-                    cornerList.push_back( coordVector );
-                }
-                quadList.push_back( cornerList );
-            }
-            settings->setValue( "chaperoneGeometryQuads", quadList );
-            QVariantList l1;
-            for ( unsigned i1 = 0; i1 < 3; i1++ )
-            {
-                QVariantList l2;
-                for ( unsigned i2 = 0; i2 < 4; i2++ )
-                {
-                    l2.push_back( p.standingCenter.m[i1][i2] );
-                }
-                l1.push_back( l2 );
-            }
-            settings->setValue( "standingCenter", l1 );
-            settings->setValue( "playSpaceAreaX", p.playSpaceAreaX );
-            settings->setValue( "playSpaceAreaZ", p.playSpaceAreaZ );
-        }
-        settings->setValue( "includesVisibility", p.includesVisibility );
-        if ( p.includesVisibility )
-        {
-            settings->setValue( "visibility", p.visibility );
-        }
-        settings->setValue( "includesFadeDistance", p.includesFadeDistance );
-        if ( p.includesFadeDistance )
-        {
-            settings->setValue( "fadeDistance", p.fadeDistance );
-        }
-        settings->setValue( "includesCenterMarker", p.includesCenterMarker );
-        if ( p.includesCenterMarker )
-        {
-            settings->setValue( "centerMarker", p.centerMarker );
-        }
-        settings->setValue( "includesPlaySpaceMarker",
-                            p.includesPlaySpaceMarker );
-        if ( p.includesPlaySpaceMarker )
-        {
-            settings->setValue( "playSpaceMarker", p.playSpaceMarker );
-        }
-        settings->setValue( "includesFloorBoundsMarker",
-                            p.includesFloorBoundsMarker );
-        if ( p.includesFloorBoundsMarker )
-        {
-            settings->setValue( "floorBoundsMarker", p.floorBoundsMarker );
-        }
-        settings->setValue( "includesBoundsColor", p.includesBoundsColor );
-        if ( p.includesBoundsColor )
+        vr::VRSettings()->Sync();
+    }
+}
+
+void ChaperoneTabController::syncAppSettings()
+{
+    if ( !m_applyingProfile )
+    {
+        OverlayController::appSettings()->sync();
+    }
+}
+
+void ChaperoneTabController::updateTrackingSignature()
+{
+    std::vector<std::string> references;
+    char serial[256];
+    for ( vr::TrackedDeviceIndex_t i = 0; i < vr::k_unMaxTrackedDeviceCount;
+          i++ )
+    {
+        if ( vr::VRSystem()->GetTrackedDeviceClass( i )
+             != vr::TrackedDeviceClass_TrackingReference )
         {
-            QVariantList color;
-            color.push_back( p.boundsColor[0] );
-            color.push_back( p.boundsColor[1] );
-            color.push_back( p.boundsColor[2] );
-            settings->setValue( "boundsColor", color );
+            continue;
         }
-        settings->setValue( "includesChaperoneStyle",
-                            p.includesChaperoneStyle );
-        if ( p.includesChaperoneStyle )
+        vr::ETrackedPropertyError error;
+        vr::VRSystem()->GetStringTrackedDeviceProperty(
+            i, vr::Prop_SerialNumber_String, serial, sizeof( serial ), &error );
+        if ( error == vr::TrackedProp_Success && serial[0] != '\0' )
         {
-            settings->setValue( "chaperoneStyle", p.chaperoneStyle );
+            references.emplace_back( serial );
         }
-        settings->setValue( "includesForceBounds", p.includesForceBounds );
-        if ( p.includesForceBounds )
+    }
+    auto signature
+        = utils::ChaperoneLocator::joinSignature( std::move( references ) );
+    if ( signature != m_trackingSignature )
+    {
+        m_trackingSignature = std::move( signature );
+        m_profileLocator.setSetup( m_trackingSignature );
+        LOG( INFO ) << "Tracking references: \"" << m_trackingSignature
+                    << "\"";
+    }
+}
+
+void ChaperoneTabController::updateStandingToRaw()
+{
+    // From the live pose, the working copy may hold changes other tools
+    // haven't committed yet.
+    const auto rawToStanding
+        = vr::VRSystem()->GetRawZeroPoseToStandingAbsoluteTrackingPose();
+    // Rigid, the inverse rotation is the transposed one.
+    const auto& m = rawToStanding.m;
+    for ( int i = 0; i < 3; i++ )
+    {
+        for ( int j = 0; j < 3; j++ )
         {
-            settings->setValue( "forceBounds", p.forceBounds );
+            m_standingToRaw.m[i][j] = m[j][i];
         }
-        settings->setValue( "includesProximityWarningSettings",
-                            p.includesProximityWarningSettings );
-        if ( p.includesProximityWarningSettings )
+        m_standingToRaw.m[i][3] = -( m[0][i] * m[0][3] + m[1][i] * m[1][3]
+                                     + m[2][i] * m[2][3] );
+    }
+    m_standingToRawValid = true;
+}
+
+void ChaperoneTabController::updateProfileAutoSelect(
+    const vr::TrackedDevicePose_t& poseHmd )
+{
+    if ( m_profileLocatorDirty )
+    {
+        m_profileLocator.clear();
+        m_profileLocator.setSetup( m_trackingSignature );
+        for ( size_t i = 0; i < chaperoneProfiles.size(); i++ )
         {
-            settings->setValue( "chaperoneSwitchToBeginnerEnabled",
-                                p.enableChaperoneSwitchToBeginner );
-            settings->setValue( "chaperoneSwitchToBeginnerDistance",
-                                p.chaperoneSwitchToBeginnerDistance );
-            settings->setValue( "chaperoneHapticFeedbackEnabled",
-                                p.enableChaperoneHapticFeedback );
-            settings->setValue( "chaperoneHapticFeedbackDistance",
-                                p.chaperoneHapticFeedbackDistance );
-            settings->setValue( "chaperoneAlarmSoundEnabled",
-                                p.enableChaperoneAlarmSound );
-            settings->setValue( "chaperoneAlarmSoundLooping",
-                                p.chaperoneAlarmSoundLooping );
-            settings->setValue( "chaperoneAlarmSoundAdjustVolume",
-                                p.chaperoneAlarmSoundAdjustVolume );
-            settings->setValue( "chaperoneAlarmSoundDistance",
-                                p.chaperoneAlarmSoundDistance );
-            settings->setValue( "chaperoneShowDashboardEnabled",
-                                p.enableChaperoneShowDashboard );
-            settings->setValue( "chaperoneShowDashboardDistance",
-                                p.chaperoneShowDashboardDistance );
-            settings->setValue( "chaperoneVelocityModifierEnabled",
-                                p.enableChaperoneVelocityModifier );
-            settings->setValue( "chaperoneVelocityModifier",
-                                p.chaperoneVelocityModifier );
+            const auto& profile = chaperoneProfiles[i];
+            if ( profile.includesChaperoneGeometry )
+            {
+                m_profileLocator.add(
+                    static_cast<int>( i ),
+                    profile.trackingSignature,
+                    profile.chaperoneGeometryQuads.data(),
+                    static_cast<uint32_t>(
+                        profile.chaperoneGeometryQuads.size() ),
+                    profile.standingCenter );
+            }
         }
-        i++;
+        m_profileLocatorDirty = false;
+    }
+    if ( !m_standingToRawValid || m_profileLocator.size() == 0
+         || !poseHmd.bPoseIsValid
+         || poseHmd.eTrackingResult != vr::TrackingResult_Running_OK )
+    {
+        m_autoSelectCandidate = -1;
+        return;
+    }
+
+    const auto& m = m_standingToRaw.m;
+    const auto& p = poseHmd.mDeviceToAbsoluteTracking.m;
+    const float rawX = m[0][0] * p[0][3] + m[0][1] * p[1][3]
+                       + m[0][2] * p[2][3] + m[0][3];
+    const float rawZ = m[2][0] * p[0][3] + m[2][1] * p[1][3]
+                       + m[2][2] * p[2][3] + m[2][3];
+    const int found = m_profileLocator.locate( rawX, rawZ );
+    if ( !m_autoSelectedProfileKnown )
+    {
+        // The profile of the space the HMD starts in is applied already, or
+        // the user chose other settings for it.
+        m_autoSelectedProfile = found;
+        m_autoSelectedProfileKnown = true;
+        m_autoSelectCandidate = -1;
+        return;
+    }
+    if ( found < 0 || found == m_autoSelectedProfile )
+    {
+        m_autoSelectCandidate = -1;
+        return;
+    }
+    const auto now = std::chrono::steady_clock::now();
+    if ( found != m_autoSelectCandidate )
+    {
+        m_autoSelectCandidate = found;
+        m_autoSelectCandidateSince = now;
+        return;
+    }
+    if ( now - m_autoSelectCandidateSince >= k_profileAutoSelectDelay )
+    {
+        LOG( INFO ) << "Entered the space of chaperone profile \""
+                    << chaperoneProfiles[static_cast<size_t>( found )]
+                           .profileName
+                    << "\", applying it";
+        applyChaperoneProfile( static_cast<unsigned>( found ) );
+        m_autoSelectCandidate = -1;
     }
-    settings->endArray();
-    settings->endGroup();
 }
 
 void ChaperoneTabController::handleChaperoneWarnings( float distance )
@@ -538,7 +440,7 @@ void ChaperoneTabController::handleChaperoneWarnings( float distance )
                                    * m_chaperoneVelocityModifierCurrent;
         if ( distance <= activationDistance && !m_chaperoneShowDashboardActive )
         {
-            if ( !vr::VROverlay()->IsDashboardVisible() )
+            if ( !parent->isDashboardVisible() )
             {
                 vr::VROverlay()->ShowDashboard(
                     OverlayController::applicationKey );
@@ -553,6 +455,11 @@ void ChaperoneTabController::handleChaperoneWarnings( float distance )
     }
 }
 
+void ChaperoneTabController::refreshSettings() noexcept
+{
+    settingsUpdateCounter = k_chaperoneSettingsUpdateCounter;
+}
+
 void ChaperoneTabController::eventLoopTick(
     vr::TrackedDevicePose_t* devicePoses,
     float leftSpeed,
@@ -648,6 +555,14 @@ void ChaperoneTabController::eventLoopTick(
             handleChaperoneWarnings( minDistance );
         }
     }
+    if ( devicePoses && m_boundaryTracing != BoundaryTracing::Off )
+    {
+        updateBoundaryTracing( devicePoses );
+    }
+    if ( devicePoses && m_enableChaperoneProfileAutoSelect )
+    {
+        updateProfileAutoSelect( devicePoses[vr::k_unTrackedDeviceIndex_Hmd] );
+    }
 
     if ( settingsUpdateCounter >= k_chaperoneSettingsUpdateCounter )
     {
@@ -713,7 +628,6 @@ void ChaperoneTabController::eventLoopTick(
                            vrSettingsError );
             }
             setPlaySpaceMarker( ps );
-            updateHeight( getBoundsMaxY() );
         }
         settingsUpdateCounter = 0;
     }
@@ -737,7 +651,7 @@ void ChaperoneTabController::setBoundsVisibility( float value, bool notify )
             vr::k_pch_CollisionBounds_Section,
             vr::k_pch_CollisionBounds_ColorGammaA_Int32,
             static_cast<int32_t>( 255 * m_visibility ) );
-        vr::VRSettings()->Sync();
+        syncVRSettings();
         if ( notify )
         {
             emit boundsVisibilityChanged( m_visibility );
@@ -759,7 +673,7 @@ void ChaperoneTabController::setFadeDistance( float value, bool notify )
             vr::k_pch_CollisionBounds_Section,
             vr::k_pch_CollisionBounds_FadeDistance_Float,
             m_fadeDistance );
-        vr::VRSettings()->Sync();
+        syncVRSettings();
         if ( notify )
         {
             emit fadeDistanceChanged( m_fadeDistance );
@@ -778,27 +692,26 @@ void ChaperoneTabController::setHeight( float value, bool notify )
     {
         m_height = value;
         vr::VRChaperoneSetup()->RevertWorkingCopy();
-        unsigned collisionBoundsCount = 0;
-        vr::VRChaperoneSetup()->GetWorkingCollisionBoundsInfo(
-            nullptr, &collisionBoundsCount );
-        if ( collisionBoundsCount > 0 )
-        {
-            vr::HmdQuad_t* collisionBounds
-                = new vr::HmdQuad_t[collisionBoundsCount];
-            vr::VRChaperoneSetup()->GetWorkingCollisionBoundsInfo(
-                collisionBounds, &collisionBoundsCount );
-            for ( unsigned b = 0; b < collisionBoundsCount; b++ )
+        // The working copy equals the live bounds after the revert, which
+        // are already cached.
+        auto& chaperone = parent->chaperoneUtils();
+        std::lock_guard<std::recursive_mutex> lock( chaperone.mutex() );
+        chaperone.copyQuads( m_heightQuads );
+        if ( !m_heightQuads.empty() )
+        {
+            for ( auto& quad : m_heightQuads )
             {
-                collisionBounds[b].vCorners[0].v[1] = 0.0;
-                collisionBounds[b].vCorners[1].v[1] = value;
-                collisionBounds[b].vCorners[2].v[1] = value;
-                collisionBounds[b].vCorners[3].v[1] = 0.0;
+                quad.vCorners[0].v[1] = 0.0;
+                quad.vCorners[1].v[1] = value;
+                quad.vCorners[2].v[1] = value;
+                quad.vCorners[3].v[1] = 0.0;
             }
+            const auto count = static_cast<uint32_t>( m_heightQuads.size() );
             vr::VRChaperoneSetup()->SetWorkingCollisionBoundsInfo(
-                collisionBounds, collisionBoundsCount );
+                m_heightQuads.data(), count );
             vr::VRChaperoneSetup()->CommitWorkingCopy(
                 vr::EChaperoneConfigFile_Live );
-            delete[] collisionBounds;
+            chaperone.ownCommit( m_heightQuads.data(), count );
         }
         if ( notify )
         {
@@ -833,7 +746,7 @@ void ChaperoneTabController::setCenterMarker( bool value, bool notify )
             vr::k_pch_CollisionBounds_Section,
             vr::k_pch_CollisionBounds_CenterMarkerOn_Bool,
             m_centerMarker );
-        vr::VRSettings()->Sync();
+        syncVRSettings();
         if ( notify )
         {
             emit centerMarkerChanged( m_centerMarker );
@@ -854,7 +767,7 @@ void ChaperoneTabController::setPlaySpaceMarker( bool value, bool notify )
         vr::VRSettings()->SetBool( vr::k_pch_CollisionBounds_Section,
                                    vr::k_pch_CollisionBounds_PlaySpaceOn_Bool,
                                    m_playSpaceMarker );
-        vr::VRSettings()->Sync();
+        syncVRSettings();
         if ( notify )
         {
             emit playSpaceMarkerChanged( m_playSpaceMarker );
@@ -927,6 +840,144 @@ float ChaperoneTabController::chaperoneVelocityModifier() const
     return m_chaperoneVelocityModifier;
 }
 
+bool ChaperoneTabController::isChaperoneProfileAutoSelectEnabled() const
+{
+    return m_enableChaperoneProfileAutoSelect;
+}
+
+bool ChaperoneTabController::isBoundaryTracingActive() const
+{
+    return m_boundaryTracing != BoundaryTracing::Off;
+}
+
+void ChaperoneTabController::traceBoundary( vr::TrackedDeviceIndex_t device )
+{
+    m_boundaryTracingDevice = device;
+}
+
+void ChaperoneTabController::setBoundaryTracing( BoundaryTracing state )
+{
+    const bool wasActive = isBoundaryTracingActive();
+    m_boundaryTracing = state;
+    if ( isBoundaryTracingActive() != wasActive )
+    {
+        emit boundaryTracingActiveChanged( isBoundaryTracingActive() );
+    }
+}
+
+void ChaperoneTabController::startBoundaryTracing()
+{
+    setBoundaryTracing( BoundaryTracing::Armed );
+}
+
+void ChaperoneTabController::cancelBoundaryTracing()
+{
+    setBoundaryTracing( BoundaryTracing::Off );
+}
+
+void ChaperoneTabController::updateBoundaryTracing(
+    const vr::TrackedDevicePose_t* devicePoses )
+{
+    const auto device = m_boundaryTracingDevice;
+    const bool held = device < vr::k_unMaxTrackedDeviceCount;
+    switch ( m_boundaryTracing )
+    {
+    case BoundaryTracing::Armed:
+        if ( !held )
+        {
+            setBoundaryTracing( BoundaryTracing::Ready );
+        }
+        return;
+    case BoundaryTracing::Ready:
+        if ( !held )
+        {
+            return;
+        }
+        m_boundarySimplifier.reset();
+        setBoundaryTracing( BoundaryTracing::Tracing );
+        LOG( INFO ) << "Started tracing the chaperone boundary";
+        break;
+    case BoundaryTracing::Tracing:
+        if ( !held )
+        {
+            commitTracedBoundary();
+            setBoundaryTracing( BoundaryTracing::Off );
+            return;
+        }
+        break;
+    case BoundaryTracing::Off:
+        return;
+    }
+
+    const auto& pose = devicePoses[device];
+    if ( pose.bPoseIsValid
+         && pose.eTrackingResult == vr::TrackingResult_Running_OK )
+    {
+        m_boundarySimplifier.add( pose.mDeviceToAbsoluteTracking.m[0][3],
+                                  pose.mDeviceToAbsoluteTracking.m[2][3] );
+    }
+}
+
+void ChaperoneTabController::commitTracedBoundary()
+{
+    const auto& trace = m_boundarySimplifier.finish();
+    std::vector<vr::HmdVector2_t> corners;
+    corners.reserve( trace.size() );
+    for ( const auto& point : trace )
+    {
+        corners.push_back( { { point.x, point.z } } );
+    }
+    const float height = std::isnan( m_height ) || m_height <= 0.0f
+                             ? k_defaultBoundsHeight
+                             : m_height;
+    std::vector<vr::HmdQuad_t> quads;
+    if ( !utils::ChaperoneUtils::quadsFromPolygon(
+             std::move( corners ), height, k_boundsTolerance, quads ) )
+    {
+        LOG( WARNING ) << "Traced chaperone boundary has less than three "
+                          "corners, it is not applied";
+        return;
+    }
+
+    // The play area is always centered on the standing origin. The origin
+    // moves to the center of the largest play area inside the boundary, the
+    // walls are moved the other way so they stay where they were traced.
+    vr::HmdVector2_t center = { { 0.0f, 0.0f } };
+    vr::HmdVector2_t playArea = { { 0.0f, 0.0f } };
+    const bool hasPlayArea = utils::ChaperoneUtils::playAreaFromPolygon(
+        quads, center, playArea );
+    if ( hasPlayArea )
+    {
+        for ( auto& quad : quads )
+        {
+            for ( auto& corner : quad.vCorners )
+            {
+                corner.v[0] -= center.v[0];
+                corner.v[2] -= center.v[1];
+            }
+        }
+    }
+
+    // Everything goes into the working copy first and is committed at once.
+    const auto count = static_cast<uint32_t>( quads.size() );
+    vr::VRChaperoneSetup()->RevertWorkingCopy();
+    vr::VRChaperoneSetup()->SetWorkingCollisionBoundsInfo( quads.data(),
+                                                           count );
+    if ( hasPlayArea )
+    {
+        float offset[3] = { center.v[0], 0.0f, center.v[1] };
+        parent->AddOffsetToUniverseCenter(
+            vr::TrackingUniverseStanding, offset, false, false );
+        vr::VRChaperoneSetup()->SetWorkingPlayAreaSize( playArea.v[0],
+                                                        playArea.v[1] );
+    }
+    vr::VRChaperoneSetup()->CommitWorkingCopy( vr::EChaperoneConfigFile_Live );
+    parent->chaperoneUtils().ownCommit( quads.data(), count );
+    LOG( INFO ) << "Applied traced chaperone boundary with " << count
+                << " walls from " << trace.size() << " corners, play area "
+                << playArea.v[0] << " x " << playArea.v[1] << " m";
+}
+
 Q_INVOKABLE unsigned ChaperoneTabController::getChaperoneProfileCount()
 {
     return static_cast<unsigned int>( chaperoneProfiles.size() );
@@ -945,6 +996,150 @@ Q_INVOKABLE QString
     }
 }
 
+Q_INVOKABLE bool
+    ChaperoneTabController::getChaperoneProfileHasGeometry( unsigned index )
+{
+    return index < chaperoneProfiles.size()
+           && chaperoneProfiles[index].includesChaperoneGeometry
+           && chaperoneProfiles[index].chaperoneGeometryQuadCount >= 3;
+}
+
+Q_INVOKABLE bool
+    ChaperoneTabController::mergeChaperoneProfiles( QString name,
+                                                    QVariantList indices )
+{
+    // The bounds are united in raw tracking space, their standing zero poses
+    // may differ. Profiles saved with other tracking references don't share
+    // that space and are left out.
+    utils::PolygonUnion polygonUnion;
+    const ChaperoneProfile* first = nullptr;
+    std::vector<std::string> references;
+    float height = 0.0f;
+    int merged = 0;
+    for ( const auto& value : indices )
+    {
+        const auto index = value.toUInt();
+        if ( !getChaperoneProfileHasGeometry( index ) )
+        {
+            continue;
+        }
+        const auto& profile = chaperoneProfiles[index];
+        const auto profileReferences
+            = utils::ChaperoneLocator::splitSignature(
+                profile.trackingSignature );
+        if ( first && !references.empty() && !profileReferences.empty()
+             && std::find_first_of( references.begin(),
+                                    references.end(),
+                                    profileReferences.begin(),
+                                    profileReferences.end() )
+                    == references.end() )
+        {
+            LOG( WARNING ) << "Chaperone profile \"" << profile.profileName
+                           << "\" was saved with other tracking references, "
+                              "it is not merged";
+            continue;
+        }
+        if ( !first )
+        {
+            first = &profile;
+        }
+        references.insert( references.end(),
+                           profileReferences.begin(),
+                           profileReferences.end() );
+
+        const auto& m = profile.standingCenter.m;
+        std::vector<vr::HmdVector2_t> corners;
+        corners.reserve( profile.chaperoneGeometryQuads.size() );
+        for ( const auto& quad : profile.chaperoneGeometryQuads )
+        {
+            const auto& c = quad.vCorners[0].v;
+            corners.push_back(
+                { { m[0][0] * c[0] + m[0][1] * c[1] + m[0][2] * c[2]
+                        + m[0][3],
+                    m[2][0] * c[0] + m[2][1] * c[1] + m[2][2] * c[2]
+                        + m[2][3] } } );
+            height = std::max( height, quad.vCorners[1].v[1] );
+        }
+        polygonUnion.add( corners );
+        merged++;
+    }
+    if ( merged < 2 )
+    {
+        LOG( WARNING ) << "Less than two chaperone profiles with geometry to "
+                          "merge";
+        return false;
+    }
+
+    // Bounds are one closed loop of walls everywhere they are used (distance
+    // warnings, profile auto-select), spaces that don't overlap or share a
+    // wall can't be merged.
+    const auto outline = polygonUnion.compute();
+    if ( polygonUnion.pieces() > 1 )
+    {
+        LOG( WARNING ) << "Merged chaperone bounds fall apart into "
+                       << polygonUnion.pieces()
+                       << " pieces, the profiles are not merged";
+        return false;
+    }
+    // Back into the standing space of the first profile. Standing zero poses
+    // are upright, so only the rotation about y has to be undone.
+    const auto& m = first->standingCenter.m;
+    std::vector<vr::HmdVector2_t> corners;
+    corners.reserve( outline.size() );
+    for ( const auto& point : outline )
+    {
+        const float x = point.v[0] - m[0][3];
+        const float z = point.v[1] - m[2][3];
+        corners.push_back( { { m[0][0] * x + m[2][0] * z,
+                               m[0][2] * x + m[2][2] * z } } );
+    }
+    std::vector<vr::HmdQuad_t> quads;
+    if ( !utils::ChaperoneUtils::quadsFromPolygon(
+             std::move( corners ),
+             height > 0.0f ? height : k_defaultBoundsHeight,
+             k_boundsTolerance,
+             quads ) )
+    {
+        LOG( WARNING ) << "Merged chaperone bounds have less than three "
+                          "corners";
+        return false;
+    }
+
+    // Everything but the geometry is taken from the first profile, its play
+    // area still lies within the merged bounds.
+    ChaperoneProfile profile = *first;
+    profile.profileName = name.toStdString();
+    profile.chaperoneGeometryQuadCount = static_cast<unsigned>( quads.size() );
+    profile.chaperoneGeometryQuads = std::move( quads );
+    std::sort( references.begin(), references.end() );
+    references.erase( std::unique( references.begin(), references.end() ),
+                      references.end() );
+    profile.trackingSignature
+        = utils::ChaperoneLocator::joinSignature( std::move( references ) );
+    LOG( INFO ) << "Merged " << merged << " chaperone profiles into \""
+                << profile.profileName << "\" with "
+                << profile.chaperoneGeometryQuadCount << " walls";
+
+    auto existing = std::find_if(
+        chaperoneProfiles.begin(),
+        chaperoneProfiles.end(),
+        [&]( const ChaperoneProfile& p ) {
+            return p.profileName == profile.profileName;
+        } );
+    if ( existing != chaperoneProfiles.end() )
+    {
+        *existing = std::move( profile );
+    }
+    else
+    {
+        chaperoneProfiles.push_back( std::move( profile ) );
+    }
+    saveChaperoneProfiles();
+    OverlayController::appSettings()->sync();
+    emit chaperoneProfilesUpdated();
+    return true;
+}
+
 void ChaperoneTabController::setForceBounds( bool value, bool notify )
 {
     if ( m_forceBounds != value )
@@ -990,7 +1185,7 @@ void ChaperoneTabController::setChaperoneSwitchToBeginnerEnabled( bool value,
         settings->setValue( "chaperoneSwitchToBeginnerEnabled",
                             m_enableChaperoneSwitchToBeginner );
         settings->endGroup();
-        settings->sync();
+        syncAppSettings();
         if ( notify )
         {
             emit chaperoneSwitchToBeginnerEnabledChanged(
@@ -1010,7 +1205,7 @@ void ChaperoneTabController::setChaperoneSwitchToBeginnerDistance( float value,
         settings->setValue( "chaperoneSwitchToBeginnerDistance",
                             m_chaperoneSwitchToBeginnerDistance );
         settings->endGroup();
-        settings->sync();
+        syncAppSettings();
         if ( notify )
         {
             emit chaperoneSwitchToBeginnerDistanceChanged(
@@ -1035,7 +1230,7 @@ void ChaperoneTabController::setChaperoneHapticFeedbackEnabled( bool value,
         settings->setValue( "chaperoneHapticFeedbackEnabled",
                             m_enableChaperoneHapticFeedback );
         settings->endGroup();
-        settings->sync();
+        syncAppSettings();
         if ( notify )
         {
             emit chaperoneHapticFeedbackEnabledChanged(
@@ -1055,7 +1250,7 @@ void ChaperoneTabController::setChaperoneHapticFeedbackDistance( float value,
         settings->setValue( "chaperoneHapticFeedbackDistance",
                             m_chaperoneHapticFeedbackDistance );
         settings->endGroup();
-        settings->sync();
+        syncAppSettings();
         if ( notify )
         {
             emit chaperoneHapticFeedbackDistanceChanged(
@@ -1080,7 +1275,7 @@ void ChaperoneTabController::setChaperoneAlarmSoundEnabled( bool value,
         settings->setValue( "chaperoneAlarmSoundEnabled",
                             m_enableChaperoneAlarmSound );
         settings->endGroup();
-        settings->sync();
+        syncAppSettings();
         if ( notify )
         {
             emit chaperoneAlarmSoundEnabledChanged(
@@ -1111,7 +1306,7 @@ void ChaperoneTabController::setChaperoneAlarmSoundLooping( bool value,
         settings->setValue( "chaperoneAlarmSoundLooping",
                             m_chaperoneAlarmSoundLooping );
         settings->endGroup();
-        settings->sync();
+        syncAppSettings();
         if ( notify )
         {
             emit chaperoneAlarmSoundLoopingChanged(
@@ -1131,7 +1326,7 @@ void ChaperoneTabController::setChaperoneAlarmSoundAdjustVolume( bool value,
         settings->setValue( "chaperoneAlarmSoundAdjustVolume",
                             m_chaperoneAlarmSoundAdjustVolume );
         settings->endGroup();
-        settings->sync();
+        syncAppSettings();
         if ( notify )
         {
             emit chaperoneAlarmSoundAdjustVolumeChanged(
@@ -1151,7 +1346,7 @@ void ChaperoneTabController::setChaperoneAlarmSoundDistance( float value,
         settings->setValue( "chaperoneAlarmSoundDistance",
                             m_chaperoneAlarmSoundDistance );
         settings->endGroup();
-        settings->sync();
+        syncAppSettings();
         if ( notify )
         {
             emit chaperoneAlarmSoundDistanceChanged(
@@ -1172,7 +1367,7 @@ void ChaperoneTabController::setChaperoneShowDashboardEnabled( bool value,
         settings->setValue( "chaperoneShowDashboardEnabled",
                             m_enableChaperoneShowDashboard );
         settings->endGroup();
-        settings->sync();
+        syncAppSettings();
         if ( notify )
         {
             emit chaperoneShowDashboardEnabledChanged(
@@ -1192,7 +1387,7 @@ void ChaperoneTabController::setChaperoneShowDashboardDistance( float value,
         settings->setValue( "chaperoneShowDashboardDistance",
                             m_chaperoneShowDashboardDistance );
         settings->endGroup();
-        settings->sync();
+        syncAppSettings();
         if ( notify )
         {
             emit chaperoneShowDashboardDistanceChanged(
@@ -1212,7 +1407,7 @@ void ChaperoneTabController::setChaperoneVelocityModifierEnabled( bool value,
         settings->setValue( "chaperoneVelocityModifierEnabled",
                             m_enableChaperoneVelocityModifier );
         settings->endGroup();
-        settings->sync();
+        syncAppSettings();
         if ( notify )
         {
             emit chaperoneVelocityModifierEnabledChanged(
@@ -1232,7 +1427,7 @@ void ChaperoneTabController::setChaperoneVelocityModifier( float value,
         settings->setValue( "chaperoneVelocityModifier",
                             m_chaperoneVelocityModifier );
         settings->endGroup();
-        settings->sync();
+        syncAppSettings();
         if ( notify )
         {
             emit chaperoneVelocityModifierChanged(
@@ -1241,6 +1436,28 @@ void ChaperoneTabController::setChaperoneVelocityModifier( float value,
     }
 }
 
+void ChaperoneTabController::setChaperoneProfileAutoSelectEnabled( bool value,
+                                                                   bool notify )
+{
+    if ( m_enableChaperoneProfileAutoSelect != value )
+    {
+        m_enableChaperoneProfileAutoSelect = value;
+        m_autoSelectCandidate = -1;
+        m_autoSelectedProfileKnown = false;
+        auto settings = OverlayController::appSettings();
+        settings->beginGroup( "chaperoneSettings" );
+        settings->setValue( "chaperoneProfileAutoSelectEnabled",
+                            m_enableChaperoneProfileAutoSelect );
+        settings->endGroup();
+        syncAppSettings();
+        if ( notify )
+        {
+            emit chaperoneProfileAutoSelectEnabledChanged(
+                m_enableChaperoneProfileAutoSelect );
+        }
+    }
+}
+
 void ChaperoneTabController::flipOrientation()
 {
     parent->m_moveCenterTabController.reset();
@@ -1292,13 +1509,14 @@ void ChaperoneTabController::addChaperoneProfile(
         vr::VRChaperoneSetup()->GetLiveCollisionBoundsInfo( nullptr,
                                                             &quadCount );
         profile->chaperoneGeometryQuadCount = quadCount;
-        profile->chaperoneGeometryQuads.reset( new vr::HmdQuad_t[quadCount] );
+        profile->chaperoneGeometryQuads.resize( quadCount );
         vr::VRChaperoneSetup()->GetLiveCollisionBoundsInfo(
-            profile->chaperoneGeometryQuads.get(), &quadCount );
+            profile->chaperoneGeometryQuads.data(), &quadCount );
         vr::VRChaperoneSetup()->GetWorkingStandingZeroPoseToRawTrackingPose(
             &profile->standingCenter );
         vr::VRChaperoneSetup()->GetWorkingPlayAreaSize(
             &profile->playSpaceAreaX, &profile->playSpaceAreaZ );
+        profile->trackingSignature = m_trackingSignature;
     }
     profile->includesVisibility = includeVisbility;
     if ( includeVisbility )
@@ -1431,11 +1649,12 @@ void ChaperoneTabController::applyChaperoneProfile( unsigned index )
     if ( index < chaperoneProfiles.size() )
     {
         auto& profile = chaperoneProfiles[index];
+        m_applyingProfile = true;
         if ( profile.includesChaperoneGeometry )
         {
             vr::VRChaperoneSetup()->RevertWorkingCopy();
             vr::VRChaperoneSetup()->SetWorkingCollisionBoundsInfo(
-                profile.chaperoneGeometryQuads.get(),
+                profile.chaperoneGeometryQuads.data(),
                 profile.chaperoneGeometryQuadCount );
             vr::VRChaperoneSetup()->SetWorkingStandingZeroPoseToRawTrackingPose(
                 &profile.standingCenter );
@@ -1443,7 +1662,11 @@ void ChaperoneTabController::applyChaperoneProfile( unsigned index )
                 profile.playSpaceAreaX, profile.playSpaceAreaZ );
             vr::VRChaperoneSetup()->CommitWorkingCopy(
                 vr::EChaperoneConfigFile_Live );
+            m_standingToRaw = profile.standingCenter;
+            m_standingToRawValid = true;
         }
+        m_autoSelectedProfile = static_cast<int>( index );
+        m_autoSelectedProfileKnown = true;
         if ( profile.includesVisibility )
         {
             setBoundsVisibility( profile.visibility );
@@ -1516,8 +1739,9 @@ void ChaperoneTabController::applyChaperoneProfile( unsigned index )
             setChaperoneVelocityModifierEnabled(
                 profile.enableChaperoneVelocityModifier );
         }
+        m_applyingProfile = false;
         vr::VRSettings()->Sync( true );
-        updateHeight( getBoundsMaxY() );
+        OverlayController::appSettings()->sync();
     }
 }
 
@@ -1527,6 +1751,8 @@ void ChaperoneTabController::deleteChaperoneProfile( unsigned index )
     {
         auto pos = chaperoneProfiles.begin() + index;
         chaperoneProfiles.erase( pos );
+        m_autoSelectedProfile = -1;
+        m_autoSelectedProfileKnown = false;
         saveChaperoneProfiles();
         OverlayController::appSettings()->sync();
         emit chaperoneProfilesUpdated();
@@ -1535,37 +1761,7 @@ void ChaperoneTabController::deleteChaperoneProfile( unsigned index )
 
 float ChaperoneTabController::getBoundsMaxY()
 {
-    unsigned collisionBoundsCount = 0;
-    float result = FP_NAN;
-    vr::VRChaperoneSetup()->GetLiveCollisionBoundsInfo( nullptr,
-                                                        &collisionBoundsCount );
-    if ( collisionBoundsCount > 0 )
-    {
-        vr::HmdQuad_t* collisionBounds
-            = new vr::HmdQuad_t[collisionBoundsCount];
-        vr::VRChaperoneSetup()->GetLiveCollisionBoundsInfo(
-            collisionBounds, &collisionBoundsCount );
-        for ( unsigned b = 0; b < collisionBoundsCount; b++ )
-        {
-            int ci;
-            if ( collisionBounds[b].vCorners[1].v[1]
-                 >= collisionBounds[b].vCorners[2].v[1] )
-            {
-                ci = 1;
-            }
-            else
-            {
-                ci = 2;
-            }
-            if ( std::isnan( result )
-                 || result < collisionBounds[b].vCorners[ci].v[1] )
-            {
-                result = collisionBounds[b].vCorners[ci].v[1];
-            }
-        }
-        delete[] collisionBounds;
-    }
-    return result;
+    return parent->chaperoneUtils().boundsInfo().maxY;
 }
 
 void ChaperoneTabController::reset()
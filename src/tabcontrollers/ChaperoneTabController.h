@@ -2,10 +2,16 @@
 #pragma once
 
 #include <QObject>
+#include <QVariantList>
 #include <memory>
 #include <chrono>
 #include <thread>
+#include <vector>
 #include <openvr.h>
+#include "../utils/ChaperoneLocator.h"
+#include "../utils/PolygonUnion.h"
+#include "../utils/PolylineSimplifier.h"
+#include "../utils/ProfileSchema.h"
 
 class QQuickWindow;
 // application namespace
@@ -20,10 +26,13 @@ struct ChaperoneProfile
 
     bool includesChaperoneGeometry = false;
     unsigned chaperoneGeometryQuadCount = 0;
-    std::unique_ptr<vr::HmdQuad_t> chaperoneGeometryQuads = nullptr;
-    vr::HmdMatrix34_t standingCenter;
+    std::vector<vr::HmdQuad_t> chaperoneGeometryQuads;
+    vr::HmdMatrix34_t standingCenter = {};
     float playSpaceAreaX = 0.0f;
     float playSpaceAreaZ = 0.0f;
+    // Serial numbers of the tracking references the geometry was saved with,
+    // see utils::ChaperoneLocator.
+    std::string trackingSignature;
 
     bool includesVisibility = false;
     float visibility = 0.6f;
@@ -51,19 +60,126 @@ struct ChaperoneProfile
 
     bool includesProximityWarningSettings = false;
     bool enableChaperoneSwitchToBeginner = false;
-    float chaperoneSwitchToBeginnerDistance = 0.0f;
+    float chaperoneSwitchToBeginnerDistance = 0.5f;
     bool enableChaperoneHapticFeedback = false;
-    float chaperoneHapticFeedbackDistance = 0.0f;
+    float chaperoneHapticFeedbackDistance = 0.5f;
     bool enableChaperoneAlarmSound = false;
     bool chaperoneAlarmSoundLooping = true;
     bool chaperoneAlarmSoundAdjustVolume = false;
-    float chaperoneAlarmSoundDistance = 0.0f;
+    float chaperoneAlarmSoundDistance = 0.5f;
     bool enableChaperoneShowDashboard = false;
-    float chaperoneShowDashboardDistance = 0.0f;
+    float chaperoneShowDashboardDistance = 0.5f;
     bool enableChaperoneVelocityModifier = false;
-    float chaperoneVelocityModifier = 0.0f;
+    float chaperoneVelocityModifier = 0.3f;
 };
 
+// How ChaperoneProfile is stored in the settings, see utils::ProfileSchema.
+namespace chaperone_profile
+{
+    using Profile = ChaperoneProfile;
+
+    inline constexpr auto k_schema = utils::profileSchema<Profile>(
+        1,
+        utils::profileField( "profileName", &Profile::profileName ),
+        utils::profileField( "includesChaperoneGeometry",
+                             &Profile::includesChaperoneGeometry ),
+        utils::profileField( "chaperoneGeometryQuadCount",
+                             &Profile::chaperoneGeometryQuadCount,
+                             &Profile::includesChaperoneGeometry ),
+        utils::profileField( "chaperoneGeometryQuads",
+                             &Profile::chaperoneGeometryQuads,
+                             &Profile::includesChaperoneGeometry ),
+        utils::profileField( "standingCenter",
+                             &Profile::standingCenter,
+                             &Profile::includesChaperoneGeometry ),
+        utils::profileField( "playSpaceAreaX",
+                             &Profile::playSpaceAreaX,
+                             &Profile::includesChaperoneGeometry ),
+        utils::profileField( "playSpaceAreaZ",
+                             &Profile::playSpaceAreaZ,
+                             &Profile::includesChaperoneGeometry ),
+        utils::profileField( "includesVisibility",
+                             &Profile::includesVisibility ),
+        utils::profileField(
+            "visibility", &Profile::visibility, &Profile::includesVisibility ),
+        utils::profileField( "includesFadeDistance",
+                             &Profile::includesFadeDistance ),
+        utils::profileField( "fadeDistance",
+                             &Profile::fadeDistance,
+                             &Profile::includesFadeDistance ),
+        utils::profileField( "includesCenterMarker",
+                             &Profile::includesCenterMarker ),
+        utils::profileField( "centerMarker",
+                             &Profile::centerMarker,
+                             &Profile::includesCenterMarker ),
+        utils::profileField( "includesPlaySpaceMarker",
+                             &Profile::includesPlaySpaceMarker ),
+        utils::profileField( "playSpaceMarker",
+                             &Profile::playSpaceMarker,
+                             &Profile::includesPlaySpaceMarker ),
+        utils::profileField( "includesFloorBoundsMarker",
+                             &Profile::includesFloorBoundsMarker ),
+        utils::profileField( "floorBoundsMarker",
+                             &Profile::floorBoundsMarker,
+                             &Profile::includesFloorBoundsMarker ),
+        utils::profileField( "includesBoundsColor",
+                             &Profile::includesBoundsColor ),
+        utils::profileField( "boundsColor",
+                             &Profile::boundsColor,
+                             &Profile::includesBoundsColor ),
+        utils::profileField( "includesChaperoneStyle",
+                             &Profile::includesChaperoneStyle ),
+        utils::profileField( "chaperoneStyle",
+                             &Profile::chaperoneStyle,
+                             &Profile::includesChaperoneStyle ),
+        utils::profileField( "includesForceBounds",
+                             &Profile::includesForceBounds ),
+        utils::profileField( "forceBounds",
+                             &Profile::forceBounds,
+                             &Profile::includesForceBounds ),
+        utils::profileField( "includesProximityWarningSettings",
+                             &Profile::includesProximityWarningSettings ),
+        utils::profileField( "chaperoneSwitchToBeginnerEnabled",
+                             &Profile::enableChaperoneSwitchToBeginner,
+                             &Profile::includesProximityWarningSettings ),
+        utils::profileField( "chaperoneSwitchToBeginnerDistance",
+                             &Profile::chaperoneSwitchToBeginnerDistance,
+                             &Profile::includesProximityWarningSettings ),
+        utils::profileField( "chaperoneHapticFeedbackEnabled",
+                             &Profile::enableChaperoneHapticFeedback,
+                             &Profile::includesProximityWarningSettings ),
+        utils::profileField( "chaperoneHapticFeedbackDistance",
+                             &Profile::chaperoneHapticFeedbackDistance,
+                             &Profile::includesProximityWarningSettings ),
+        utils::profileField( "chaperoneAlarmSoundEnabled",
+                             &Profile::enableChaperoneAlarmSound,
+                             &Profile::includesProximityWarningSettings ),
+        utils::profileField( "chaperoneAlarmSoundLooping",
+                             &Profile::chaperoneAlarmSoundLooping,
+                             &Profile::includesProximityWarningSettings ),
+        utils::profileField( "chaperoneAlarmSoundAdjustVolume",
+                             &Profile::chaperoneAlarmSoundAdjustVolume,
+                             &Profile::includesProximityWarningSettings ),
+        utils::profileField( "chaperoneAlarmSoundDistance",
+                             &Profile::chaperoneAlarmSoundDistance,
+                             &Profile::includesProximityWarningSettings ),
+        utils::profileField( "chaperoneShowDashboardEnabled",
+                             &Profile::enableChaperoneShowDashboard,
+                             &Profile::includesProximityWarningSettings ),
+        utils::profileField( "chaperoneShowDashboardDistance",
+                             &Profile::chaperoneShowDashboardDistance,
+                             &Profile::includesProximityWarningSettings ),
+        utils::profileField( "chaperoneVelocityModifierEnabled",
+                             &Profile::enableChaperoneVelocityModifier,
+                             &Profile::includesProximityWarningSettings ),
+        utils::profileField( "chaperoneVelocityModifier",
+                             &Profile::chaperoneVelocityModifier,
+                             &Profile::includesProximityWarningSettings ),
+        utils::profileField( "trackingSignature",
+                             &Profile::trackingSignature,
+                             &Profile::includesChaperoneGeometry ) );
+} // namespace chaperone_profile
+
 class ChaperoneTabController : public QObject
 {
     Q_OBJECT
@@ -131,6 +247,14 @@ class ChaperoneTabController : public QObject
                     WRITE setChaperoneVelocityModifier NOTIFY
                         chaperoneVelocityModifierChanged )
 
+    Q_PROPERTY( bool chaperoneProfileAutoSelectEnabled READ
+                    isChaperoneProfileAutoSelectEnabled WRITE
+                        setChaperoneProfileAutoSelectEnabled NOTIFY
+                            chaperoneProfileAutoSelectEnabledChanged )
+
+    Q_PROPERTY( bool boundaryTracingActive READ isBoundaryTracingActive NOTIFY
+                    boundaryTracingActiveChanged )
+
 private:
     OverlayController* parent;
     QQuickWindow* widget;
@@ -139,6 +263,8 @@ private:
     float m_fadeDistance = 0.7f;
     float m_fadeDistanceModified = 0.7f;
     float m_height = 2.0f;
+    // Reused by setHeight(), the slider calls it on every step.
+    std::vector<vr::HmdQuad_t> m_heightQuads;
     bool m_centerMarker = false;
     bool m_playSpaceMarker = false;
     bool m_forceBounds = false;
@@ -171,6 +297,49 @@ private:
 
     std::vector<ChaperoneProfile> chaperoneProfiles;
 
+    // Set while a profile is applied, the settings are synced once at the end.
+    bool m_applyingProfile = false;
+
+    bool m_enableChaperoneProfileAutoSelect = false;
+    utils::ChaperoneLocator m_profileLocator;
+    bool m_profileLocatorDirty = true;
+    std::string m_trackingSignature;
+    // Live standing zero pose, to get the raw position of the HMD.
+    vr::HmdMatrix34_t m_standingToRaw = {};
+    bool m_standingToRawValid = false;
+    // Profile of the space the HMD was last found in. Not known at startup
+    // and when the profiles change, the space the HMD is found in first is
+    // taken as selected without applying its profile again.
+    int m_autoSelectedProfile = -1;
+    bool m_autoSelectedProfileKnown = false;
+    int m_autoSelectCandidate = -1;
+    std::chrono::steady_clock::time_point m_autoSelectCandidateSince;
+
+    enum class BoundaryTracing
+    {
+        Off,
+        // Waits for the action to be released, it may be bound to the
+        // button that clicked "Trace Boundary".
+        Armed,
+        Ready,
+        Tracing,
+    };
+    BoundaryTracing m_boundaryTracing = BoundaryTracing::Off;
+    vr::TrackedDeviceIndex_t m_boundaryTracingDevice
+        = vr::k_unTrackedDeviceIndexInvalid;
+    // Ignores steps below 5 cm, keeps the trace within 5 cm of the path.
+    utils::PolylineSimplifier m_boundarySimplifier{ 0.05f, 0.05f, 128 };
+
+    void setBoundaryTracing( BoundaryTracing state );
+    void updateBoundaryTracing( const vr::TrackedDevicePose_t* devicePoses );
+    void commitTracedBoundary();
+
+    void syncVRSettings();
+    void syncAppSettings();
+    void updateTrackingSignature();
+    void updateStandingToRaw();
+    void updateProfileAutoSelect( const vr::TrackedDevicePose_t& poseHmd );
+
 public:
     ~ChaperoneTabController();
 
@@ -181,6 +350,8 @@ public:
                         float leftSpeed,
                         float rightSpeed,
                         float hmdSpeed );
+    // The values shown on the page are read again with the next tick.
+    void refreshSettings() noexcept;
     void handleChaperoneWarnings( float distance );
 
     float boundsVisibility() const;
@@ -207,11 +378,20 @@ public:
     bool isChaperoneVelocityModifierEnabled() const;
     float chaperoneVelocityModifier() const;
 
+    bool isChaperoneProfileAutoSelectEnabled() const;
+
+    bool isBoundaryTracingActive() const;
+    // Controller the trace action is held on, invalid while it isn't held.
+    void traceBoundary( vr::TrackedDeviceIndex_t device );
+
     void reloadChaperoneProfiles();
     void saveChaperoneProfiles();
 
     Q_INVOKABLE unsigned getChaperoneProfileCount();
     Q_INVOKABLE QString getChaperoneProfileName( unsigned index );
+    Q_INVOKABLE bool getChaperoneProfileHasGeometry( unsigned index );
+    Q_INVOKABLE bool mergeChaperoneProfiles( QString name,
+                                             QVariantList indices );
 
     float getBoundsMaxY();
 
@@ -242,6 +422,12 @@ public slots:
     void setChaperoneVelocityModifierEnabled( bool value, bool notify = true );
     void setChaperoneVelocityModifier( float value, bool notify = true );
 
+    void setChaperoneProfileAutoSelectEnabled( bool value,
+                                               bool notify = true );
+
+    void startBoundaryTracing();
+    void cancelBoundaryTracing();
+
     void flipOrientation();
     void reloadFromDisk();
 
@@ -288,6 +474,10 @@ signals:
     void chaperoneVelocityModifierEnabledChanged( bool value );
     void chaperoneVelocityModifierChanged( float value );
 
+    void chaperoneProfileAutoSelectEnabledChanged( bool value );
+
+    void boundaryTracingActiveChanged( bool value );
+
     void chaperoneProfilesUpdated();
 };
 
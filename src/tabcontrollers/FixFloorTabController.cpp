@@ -5,18 +5,60 @@
 // application namespace
 namespace advsettings
 {
-void FixFloorTabController::initStage1() {}
+// Floor corrections from the drift monitor. Bigger differences are more likely
+// a controller lying on something else than the floor.
+constexpr double k_minDriftCorrection = 0.01;
+constexpr double k_maxDriftCorrection = 0.10;
+// Both floor reference controllers have to agree on the floor this closely.
+constexpr double k_maxFloorDisagreement = 0.005;
+// Yaw drift is only reported, rotating needs a pivot point we don't know.
+constexpr double k_minYawDriftReport = M_PI / 180.0;
+
+void FixFloorTabController::initStage1()
+{
+    auto settings = OverlayController::appSettings();
+    settings->beginGroup( "fixFloorSettings" );
+    auto value = settings->value( "driftMonitor", m_driftMonitor );
+    if ( value.isValid() && !value.isNull() )
+    {
+        m_driftMonitor = value.toBool();
+    }
+    value = settings->value( "driftAutoCorrect", m_driftAutoCorrect );
+    if ( value.isValid() && !value.isNull() )
+    {
+        m_driftAutoCorrect = value.toBool();
+    }
+    settings->endGroup();
+}
 
 void FixFloorTabController::initStage2( OverlayController* var_parent,
                                         QQuickWindow* var_widget )
 {
     this->parent = var_parent;
     this->widget = var_widget;
+
+    parent->eventBus().subscribe(
+        vr::VREvent_ChaperoneUniverseHasChanged,
+        [this]( const vr::VREvent_t& ) { universeCenterChanged(); } );
 }
 
 void FixFloorTabController::eventLoopTick(
     vr::TrackedDevicePose_t* devicePoses )
 {
+    if ( m_driftMonitor && state == 0 )
+    {
+        m_floorDriftMonitor.update( devicePoses );
+        if ( driftMonitorUpdateCounter >= k_fixFloorDriftMonitorUpdateCounter )
+        {
+            checkFloorDrift();
+            driftMonitorUpdateCounter = 0;
+        }
+        else
+        {
+            driftMonitorUpdateCounter++;
+        }
+    }
+
     if ( state > 0 )
     {
         if ( measurementCount == 0 )
@@ -166,12 +208,103 @@ void FixFloorTabController::eventLoopTick(
                 emit statusMessageSignal();
                 emit measureEndSignal();
                 setCanUndo( true );
+                m_floorDriftMonitor.reset();
                 state = 0;
             }
         }
     }
 }
 
+void FixFloorTabController::checkFloorDrift()
+{
+    // Same correction as in the measurement above.
+    auto floorError = [this]( const utils::FloorDriftMonitor::FloorSample& s ) {
+        return s.height
+               - static_cast<double>( std::abs( s.roll ) <= M_PI_2
+                                          ? controllerUpOffsetCorrection
+                                          : controllerDownOffsetCorrection );
+    };
+    utils::FloorDriftMonitor::FloorSample first;
+    utils::FloorDriftMonitor::FloorSample second;
+    if ( m_floorDriftMonitor.floorReference( first, second ) )
+    {
+        const double firstError = floorError( first );
+        const double secondError = floorError( second );
+        const double error = ( firstError + secondError ) / 2.0;
+        if ( std::abs( firstError - secondError ) <= k_maxFloorDisagreement
+             && std::abs( error ) >= k_minDriftCorrection
+             && std::abs( error ) <= k_maxDriftCorrection )
+        {
+            applyFloorDriftCorrection( error, "floor offset" );
+            return;
+        }
+    }
+
+    double height = 0.0;
+    double yaw = 0.0;
+    if ( m_floorDriftMonitor.drift( height, yaw ) )
+    {
+        if ( std::abs( height ) >= k_minDriftCorrection
+             && std::abs( height ) <= k_maxDriftCorrection )
+        {
+            applyFloorDriftCorrection( height, "height drift" );
+            return;
+        }
+        if ( std::abs( yaw ) >= k_minYawDriftReport && !m_yawDriftReported )
+        {
+            LOG( INFO ) << "Drift monitor: yaw drift of "
+                        << yaw * 180.0 / M_PI << " degrees detected.";
+            statusMessage = QString( "Playspace rotated by %1° since devices "
+                                     "were put down." )
+                                .arg( yaw * 180.0 / M_PI, 0, 'f', 1 );
+            statusMessageTimeout = 5.0;
+            emit statusMessageSignal();
+            m_yawDriftReported = true;
+        }
+    }
+}
+
+void FixFloorTabController::applyFloorDriftCorrection( double offsetY,
+                                                       const char* source )
+{
+    if ( m_driftAutoCorrect )
+    {
+        float offset[3] = { 0.0f, static_cast<float>( offsetY ), 0.0f };
+        parent->AddOffsetToUniverseCenter(
+            vr::TrackingUniverseStanding, offset, true );
+        LOG( INFO ) << "Drift monitor: corrected " << source << " of "
+                    << offsetY;
+        floorOffsetX = 0.0f;
+        floorOffsetY = offset[1];
+        floorOffsetZ = 0.0f;
+        setCanUndo( true );
+        statusMessage = "Floor drift corrected.";
+        statusMessageTimeout = 2.0;
+        emit statusMessageSignal();
+        universeCenterChanged();
+    }
+    else if ( std::abs( offsetY - m_lastSuggestedCorrection ) >= 0.005 )
+    {
+        // Only suggest again when the estimate has changed noticeably.
+        LOG( INFO ) << "Drift monitor: detected " << source << " of "
+                    << offsetY;
+        statusMessage = QString( "Floor seems to be off by %1 cm. Use \"Fix "
+                                 "Floor\" to correct it." )
+                            .arg( offsetY * 100.0, 0, 'f', 1 );
+        statusMessageTimeout = 5.0;
+        emit statusMessageSignal();
+        m_lastSuggestedCorrection = offsetY;
+    }
+}
+
+void FixFloorTabController::universeCenterChanged()
+{
+    // Everything measured so far is relative to the old universe center.
+    m_floorDriftMonitor.reset();
+    m_lastSuggestedCorrection = 0.0;
+    m_yawDriftReported = false;
+}
+
 QString FixFloorTabController::currentStatusMessage()
 {
     return statusMessage;
@@ -199,6 +332,51 @@ void FixFloorTabController::setCanUndo( bool value, bool notify )
     }
 }
 
+bool FixFloorTabController::driftMonitor() const
+{
+    return m_driftMonitor;
+}
+
+void FixFloorTabController::setDriftMonitor( bool value, bool notify )
+{
+    if ( m_driftMonitor != value )
+    {
+        m_driftMonitor = value;
+        universeCenterChanged();
+        auto settings = OverlayController::appSettings();
+        settings->beginGroup( "fixFloorSettings" );
+        settings->setValue( "driftMonitor", m_driftMonitor );
+        settings->endGroup();
+        settings->sync();
+        if ( notify )
+        {
+            emit driftMonitorChanged( m_driftMonitor );
+        }
+    }
+}
+
+bool FixFloorTabController::driftAutoCorrect() const
+{
+    return m_driftAutoCorrect;
+}
+
+void FixFloorTabController::setDriftAutoCorrect( bool value, bool notify )
+{
+    if ( m_driftAutoCorrect != value )
+    {
+        m_driftAutoCorrect = value;
+        auto settings = OverlayController::appSettings();
+        settings->beginGroup( "fixFloorSettings" );
+        settings->setValue( "driftAutoCorrect", m_driftAutoCorrect );
+        settings->endGroup();
+        settings->sync();
+        if ( notify )
+        {
+            emit driftAutoCorrectChanged( m_driftAutoCorrect );
+        }
+    }
+}
+
 void FixFloorTabController::fixFloorClicked()
 {
     statusMessage = "Fixing ...";
@@ -234,6 +412,7 @@ void FixFloorTabController::undoFixFloorClicked()
     statusMessageTimeout = 1.0;
     emit statusMessageSignal();
     setCanUndo( false );
+    universeCenterChanged();
 }
 
 } // namespace advsettings
@@ -3,6 +3,7 @@
 
 #include <QObject>
 #include <openvr.h>
+#include "../utils/FloorDriftMonitor.h"
 
 class QQuickWindow;
 // application namespace
@@ -16,6 +17,10 @@ class FixFloorTabController : public QObject
     Q_OBJECT
     Q_PROPERTY(
         bool canUndo READ canUndo WRITE setCanUndo NOTIFY canUndoChanged )
+    Q_PROPERTY( bool driftMonitor READ driftMonitor WRITE setDriftMonitor
+                    NOTIFY driftMonitorChanged )
+    Q_PROPERTY( bool driftAutoCorrect READ driftAutoCorrect WRITE
+                    setDriftAutoCorrect NOTIFY driftAutoCorrectChanged )
 
 private:
     OverlayController* parent;
@@ -42,6 +47,17 @@ private:
     float statusMessageTimeout = 0.0f;
     bool m_canUndo = false;
 
+    // Background floor/drift monitor
+    bool m_driftMonitor = false;
+    bool m_driftAutoCorrect = false;
+    utils::FloorDriftMonitor m_floorDriftMonitor;
+    double m_lastSuggestedCorrection = 0.0;
+    bool m_yawDriftReported = false;
+    unsigned driftMonitorUpdateCounter = 0;
+
+    void checkFloorDrift();
+    void applyFloorDriftCorrection( double offsetY, const char* source );
+
 public:
     void initStage1();
     void initStage2( OverlayController* parent, QQuickWindow* widget );
@@ -52,6 +68,10 @@ public:
     Q_INVOKABLE float currentStatusMessageTimeout();
 
     bool canUndo() const;
+    bool driftMonitor() const;
+    bool driftAutoCorrect() const;
+
+    void universeCenterChanged();
 
 public slots:
     void fixFloorClicked();
@@ -59,12 +79,16 @@ public slots:
     void undoFixFloorClicked();
 
     void setCanUndo( bool value, bool notify = true );
+    void setDriftMonitor( bool value, bool notify = true );
+    void setDriftAutoCorrect( bool value, bool notify = true );
 
 signals:
     void statusMessageSignal();
     void measureStartSignal();
     void measureEndSignal();
     void canUndoChanged( bool value );
+    void driftMonitorChanged( bool value );
+    void driftAutoCorrectChanged( bool value );
 };
 
 } // namespace advsettings
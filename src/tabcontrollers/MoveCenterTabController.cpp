@@ -2,6 +2,9 @@
 #include <QQuickWindow>
 #include "../overlaycontroller.h"
 #include "../utils/Matrix.h"
+#include "../utils/ProfileSchema.h"
+#include <algorithm>
+#include <cmath>
 
 void rotateCoordinates( double coordinates[3], double angle )
 {
@@ -24,6 +27,42 @@ using std::chrono::duration_cast;
 using std::chrono::milliseconds;
 typedef std::chrono::system_clock clock;
 
+namespace
+{
+    // Longer frames (e.g. after a stall) are integrated as this, so the
+    // playspace doesn't jump.
+    constexpr double k_maxSmoothStepSeconds = 0.1;
+    constexpr double k_maxSmoothDeadzone = 0.9;
+    constexpr double k_minSmoothResponseCurve = 0.1;
+
+    using Anchor = PlayspaceAnchor;
+
+    constexpr auto k_playspaceAnchorSchema = utils::profileSchema<Anchor>(
+        1,
+        utils::profileField( "anchorName", &Anchor::anchorName ),
+        utils::profileField( "trackingUniverse", &Anchor::trackingUniverse ),
+        utils::profileField( "offset", &Anchor::offset ),
+        utils::profileField( "rotation", &Anchor::rotation ),
+        utils::profileField( "hasZeroPose", &Anchor::hasZeroPose ),
+        utils::profileField(
+            "zeroPose", &Anchor::zeroPose, &Anchor::hasZeroPose ) );
+
+    /*!
+    Maps a stick deflection (0 .. 1) to a speed factor: zero inside the
+    deadzone, then rescaled to 0 .. 1 and raised to the curve exponent.
+    */
+    double shapeDeflection( double deflection, double deadzone, double curve )
+    {
+        if ( deflection <= deadzone )
+        {
+            return 0.0;
+        }
+        const double scaled
+            = std::min( ( deflection - deadzone ) / ( 1.0 - deadzone ), 1.0 );
+        return std::pow( scaled, curve );
+    }
+} // namespace
+
 void MoveCenterTabController::initStage1()
 {
     setTrackingUniverse( vr::VRCompositor()->GetTrackingSpace() );
@@ -66,8 +105,37 @@ void MoveCenterTabController::initStage1()
     {
         m_lockZToggle = value.toBool();
     }
+    value = settings->value( "smoothLocomotionEnabled",
+                             m_smoothLocomotionEnabled );
+    if ( value.isValid() && !value.isNull() )
+    {
+        m_smoothLocomotionEnabled = value.toBool();
+    }
+    value = settings->value( "smoothMoveSpeed", m_smoothMoveSpeed );
+    if ( value.isValid() && !value.isNull() )
+    {
+        m_smoothMoveSpeed = value.toFloat();
+    }
+    value = settings->value( "smoothTurnSpeed", m_smoothTurnSpeed );
+    if ( value.isValid() && !value.isNull() )
+    {
+        m_smoothTurnSpeed = value.toFloat();
+    }
+    value = settings->value( "smoothDeadzone", m_smoothDeadzone );
+    if ( value.isValid() && !value.isNull() )
+    {
+        m_smoothDeadzone = value.toFloat();
+    }
+    value = settings->value( "smoothResponseCurve", m_smoothResponseCurve );
+    if ( value.isValid() && !value.isNull() )
+    {
+        m_smoothResponseCurve = value.toFloat();
+    }
     settings->endGroup();
+    m_playspaceAnchors = k_playspaceAnchorSchema.readIniArray(
+        *settings, "playspaceSettings", "playspaceAnchors" );
     lastMoveButtonClick[0] = lastMoveButtonClick[1] = clock::now();
+    m_lastTickTime = std::chrono::steady_clock::now();
 }
 
 void MoveCenterTabController::initStage2( OverlayController* var_parent,
@@ -97,46 +165,61 @@ void MoveCenterTabController::setTrackingUniverse( int value, bool notify )
 
 float MoveCenterTabController::offsetX() const
 {
-    return m_offsetX;
+    return static_cast<float>( m_offsetX );
 }
 
 void MoveCenterTabController::setOffsetX( float value, bool notify )
 {
-    if ( m_offsetX != value )
+    if ( offsetX() != value && !m_lockXToggle )
     {
-        modOffsetX( value - m_offsetX, notify );
+        m_offsetX = static_cast<double>( value );
+        applyUniverseTransform();
+        if ( notify )
+        {
+            emit offsetXChanged( offsetX() );
+        }
     }
 }
 
 float MoveCenterTabController::offsetY() const
 {
-    return m_offsetY;
+    return static_cast<float>( m_offsetY );
 }
 
 void MoveCenterTabController::setOffsetY( float value, bool notify )
 {
-    if ( m_offsetY != value )
+    if ( offsetY() != value && !m_lockYToggle )
     {
-        modOffsetY( value - m_offsetY, notify );
+        m_offsetY = static_cast<double>( value );
+        applyUniverseTransform();
+        if ( notify )
+        {
+            emit offsetYChanged( offsetY() );
+        }
     }
 }
 
 float MoveCenterTabController::offsetZ() const
 {
-    return m_offsetZ;
+    return static_cast<float>( m_offsetZ );
 }
 
 void MoveCenterTabController::setOffsetZ( float value, bool notify )
 {
-    if ( m_offsetZ != value )
+    if ( offsetZ() != value && !m_lockZToggle )
     {
-        modOffsetZ( value - m_offsetZ, notify );
+        m_offsetZ = static_cast<double>( value );
+        applyUniverseTransform();
+        if ( notify )
+        {
+            emit offsetZChanged( offsetZ() );
+        }
     }
 }
 
 int MoveCenterTabController::rotation() const
 {
-    return m_rotation;
+    return static_cast<int>( std::round( m_rotation ) );
 }
 
 int MoveCenterTabController::tempRotation() const
@@ -146,15 +229,16 @@ int MoveCenterTabController::tempRotation() const
 
 void MoveCenterTabController::setRotation( int value, bool notify )
 {
-    if ( m_rotation != value )
+    if ( rotation() != value )
     {
-        double angle = ( value - m_rotation ) * k_centidegreesToRadians;
-
-        // Revert now because we don't commit in RotateUniverseCenter and
-        // AddOffsetToUniverseCenter. We do this so rotation and offset can
-        // happen in one go, avoiding positional judder.
-        vr::VRChaperoneSetup()->RevertWorkingCopy();
+        applyRotation( static_cast<double>( value ), notify );
+    }
+}
 
+void MoveCenterTabController::applyRotation( double value, bool notify )
+{
+    if ( m_rotation != value )
+    {
         // Get hmd pose matrix.
         vr::TrackedDevicePose_t
             devicePosesForRot[vr::k_unMaxTrackedDeviceCount];
@@ -163,83 +247,49 @@ void MoveCenterTabController::setRotation( int value, bool notify )
             0.0f,
             devicePosesForRot,
             vr::k_unMaxTrackedDeviceCount );
-        vr::HmdMatrix34_t oldHmdPos
-            = devicePosesForRot[0].mDeviceToAbsoluteTracking;
-
-        // Set up xyz coordinate values from pose matrix.
-        double oldHmdXyz[3] = { static_cast<double>( oldHmdPos.m[0][3] ),
-                                static_cast<double>( oldHmdPos.m[1][3] ),
-                                static_cast<double>( oldHmdPos.m[2][3] ) };
-        double newHmdXyz[3] = { static_cast<double>( oldHmdPos.m[0][3] ),
-                                static_cast<double>( oldHmdPos.m[1][3] ),
-                                static_cast<double>( oldHmdPos.m[2][3] ) };
-
-        // Convert oldHmdXyz into un-rotated coordinates.
-        double oldAngle = -m_rotation * k_centidegreesToRadians;
-        rotateCoordinates( oldHmdXyz, oldAngle );
-
-        // Set newHmdXyz to have additional rotation from incoming angle change.
-        rotateCoordinates( newHmdXyz, oldAngle - angle );
-
-        // find difference in x,z offset due to incoming angle change
-        // (coordinates are in un-rotated axis).
-        double hmdRotDiff[3]
-            = { oldHmdXyz[0] - newHmdXyz[0], 0, oldHmdXyz[2] - newHmdXyz[2] };
-
-        // Rotate the tracking univese center without committing.
-        parent->RotateUniverseCenter(
-            vr::TrackingUniverseOrigin( m_trackingUniverse ),
-            static_cast<float>( angle ),
-            m_adjustChaperone,
-            false );
-
-        m_rotation = value;
-        if ( notify )
-        {
-            emit rotationChanged( m_rotation );
-        }
+        rotateAroundHmd( value,
+                         devicePosesForRot[0].mDeviceToAbsoluteTracking );
+        applyUniverseTransform();
 
-        // Get rotated offset to apply to universe center.
-        // We use rotated coordinates here because we have already applied
-        // RotateUniverseCenter. This will be the final offset ready to apply,
-        // so it must match the current universe axis rotation.
-        double finalAngle = m_rotation * k_centidegreesToRadians;
-        double finalHmdRotDiff[3] = { hmdRotDiff[0], 0, hmdRotDiff[2] };
-        rotateCoordinates( finalHmdRotDiff, finalAngle );
-
-        // We're done with calculations now so we can down-cast the double
-        // values to float for compatilibilty with openvr format
-        float finalHmdRotDiffFloat[3]
-            = { static_cast<float>( finalHmdRotDiff[0] ),
-                static_cast<float>( finalHmdRotDiff[1] ),
-                static_cast<float>( finalHmdRotDiff[2] ) };
-
-        // Apply the offset (in rotated coordinates) without commit.
-        // We still can't commit yet because it would call
-        // vr::VRChaperoneSetup()->RevertWorkingCopy() and we'd lose our
-        // uncommitted RotateUniverseCenter.
-        parent->AddOffsetToUniverseCenter(
-            vr::TrackingUniverseOrigin( m_trackingUniverse ),
-            finalHmdRotDiffFloat,
-            m_adjustChaperone,
-            false );
-
-        // Commit here because we didn't in RotateUniverseCenter and
-        // AddOffsetToUniverseCenter to combine into one go.
-        vr::VRChaperoneSetup()->CommitWorkingCopy(
-            vr::EChaperoneConfigFile_Live );
-
-        // Update UI offsets.
-        m_offsetX += static_cast<float>( hmdRotDiff[0] );
-        m_offsetZ += static_cast<float>( hmdRotDiff[2] );
         if ( notify )
         {
-            emit offsetXChanged( m_offsetX );
-            emit offsetZChanged( m_offsetZ );
+            emit rotationChanged( rotation() );
+            emit offsetXChanged( offsetX() );
+            emit offsetZChanged( offsetZ() );
         }
     }
 }
 
+void MoveCenterTabController::rotateAroundHmd(
+    double value,
+    const vr::HmdMatrix34_t& hmdPos )
+{
+    double angle = ( value - m_rotation ) * k_centidegreesToRadians;
+
+    // Set up xyz coordinate values from pose matrix.
+    double oldHmdXyz[3] = { static_cast<double>( hmdPos.m[0][3] ),
+                            static_cast<double>( hmdPos.m[1][3] ),
+                            static_cast<double>( hmdPos.m[2][3] ) };
+    double newHmdXyz[3] = { static_cast<double>( hmdPos.m[0][3] ),
+                            static_cast<double>( hmdPos.m[1][3] ),
+                            static_cast<double>( hmdPos.m[2][3] ) };
+
+    // Convert oldHmdXyz into un-rotated coordinates.
+    double oldAngle = -m_rotation * k_centidegreesToRadians;
+    rotateCoordinates( oldHmdXyz, oldAngle );
+
+    // Set newHmdXyz to have additional rotation from incoming angle change.
+    rotateCoordinates( newHmdXyz, oldAngle - angle );
+
+    // Rotate around the hmd instead of the universe center: the
+    // difference in x,z offset due to the incoming angle change goes into
+    // the offset (coordinates are in un-rotated axis), and rotation and
+    // offset are written in one go to avoid positional judder.
+    m_offsetX += oldHmdXyz[0] - newHmdXyz[0];
+    m_offsetZ += oldHmdXyz[2] - newHmdXyz[2];
+    m_rotation = value;
+}
+
 void MoveCenterTabController::setTempRotation( int value, bool notify )
 {
     m_tempRotation = value;
@@ -259,24 +309,7 @@ void MoveCenterTabController::setAdjustChaperone( bool value, bool notify )
     if ( m_adjustChaperone != value )
     {
         m_adjustChaperone = value;
-        if ( m_trackingUniverse == vr::TrackingUniverseStanding )
-        {
-            double angle = m_rotation * k_centidegreesToRadians;
-            double offsetdir = m_adjustChaperone ? -1.0 : 1.0;
-            double offset[3] = { offsetdir * static_cast<double>( m_offsetX ),
-                                 offsetdir * static_cast<double>( m_offsetY ),
-                                 offsetdir * static_cast<double>( m_offsetZ ) };
-            rotateCoordinates( offset, angle );
-
-            // We're done with calculations so down-cast to float for
-            // compatibility with openvr format
-
-            float offsetFloat[3] = { static_cast<float>( offset[0] ),
-                                     static_cast<float>( offset[1] ),
-                                     static_cast<float>( offset[2] ) };
-
-            parent->AddOffsetToCollisionBounds( offsetFloat );
-        }
+        applyUniverseTransform();
         auto settings = OverlayController::appSettings();
         settings->beginGroup( "playspaceSettings" );
         settings->setValue( "adjustChaperone", m_adjustChaperone );
@@ -308,6 +341,104 @@ void MoveCenterTabController::setRotateHand( bool value, bool notify )
     }
 }
 
+bool MoveCenterTabController::smoothLocomotionEnabled() const
+{
+    return m_smoothLocomotionEnabled;
+}
+
+void MoveCenterTabController::setSmoothLocomotionEnabled( bool value,
+                                                          bool notify )
+{
+    m_smoothLocomotionEnabled = value;
+    auto settings = OverlayController::appSettings();
+    settings->beginGroup( "playspaceSettings" );
+    settings->setValue( "smoothLocomotionEnabled", m_smoothLocomotionEnabled );
+    settings->endGroup();
+    settings->sync();
+    if ( notify )
+    {
+        emit smoothLocomotionEnabledChanged( m_smoothLocomotionEnabled );
+    }
+}
+
+float MoveCenterTabController::smoothMoveSpeed() const
+{
+    return m_smoothMoveSpeed;
+}
+
+void MoveCenterTabController::setSmoothMoveSpeed( float value, bool notify )
+{
+    m_smoothMoveSpeed = value;
+    auto settings = OverlayController::appSettings();
+    settings->beginGroup( "playspaceSettings" );
+    settings->setValue( "smoothMoveSpeed", m_smoothMoveSpeed );
+    settings->endGroup();
+    settings->sync();
+    if ( notify )
+    {
+        emit smoothMoveSpeedChanged( m_smoothMoveSpeed );
+    }
+}
+
+float MoveCenterTabController::smoothTurnSpeed() const
+{
+    return m_smoothTurnSpeed;
+}
+
+void MoveCenterTabController::setSmoothTurnSpeed( float value, bool notify )
+{
+    m_smoothTurnSpeed = value;
+    auto settings = OverlayController::appSettings();
+    settings->beginGroup( "playspaceSettings" );
+    settings->setValue( "smoothTurnSpeed", m_smoothTurnSpeed );
+    settings->endGroup();
+    settings->sync();
+    if ( notify )
+    {
+        emit smoothTurnSpeedChanged( m_smoothTurnSpeed );
+    }
+}
+
+float MoveCenterTabController::smoothDeadzone() const
+{
+    return m_smoothDeadzone;
+}
+
+void MoveCenterTabController::setSmoothDeadzone( float value, bool notify )
+{
+    m_smoothDeadzone = std::max(
+        0.0f, std::min( value, static_cast<float>( k_maxSmoothDeadzone ) ) );
+    auto settings = OverlayController::appSettings();
+    settings->beginGroup( "playspaceSettings" );
+    settings->setValue( "smoothDeadzone", m_smoothDeadzone );
+    settings->endGroup();
+    settings->sync();
+    if ( notify )
+    {
+        emit smoothDeadzoneChanged( m_smoothDeadzone );
+    }
+}
+
+float MoveCenterTabController::smoothResponseCurve() const
+{
+    return m_smoothResponseCurve;
+}
+
+void MoveCenterTabController::setSmoothResponseCurve( float value, bool notify )
+{
+    m_smoothResponseCurve
+        = std::max( value, static_cast<float>( k_minSmoothResponseCurve ) );
+    auto settings = OverlayController::appSettings();
+    settings->beginGroup( "playspaceSettings" );
+    settings->setValue( "smoothResponseCurve", m_smoothResponseCurve );
+    settings->endGroup();
+    settings->sync();
+    if ( notify )
+    {
+        emit smoothResponseCurveChanged( m_smoothResponseCurve );
+    }
+}
+
 bool MoveCenterTabController::moveShortcutRight() const
 {
     return m_settingsRightHandDragEnabled;
@@ -405,23 +536,13 @@ void MoveCenterTabController::setLockZ( bool value, bool notify )
 
 void MoveCenterTabController::modOffsetX( float value, bool notify )
 {
-    // TODO ? possible issue with locking position this way
     if ( !m_lockXToggle )
     {
-        double angle = m_rotation * k_centidegreesToRadians;
-        double offset[3] = { static_cast<double>( value ), 0, 0 };
-        rotateCoordinates( offset, angle );
-        float offsetFloat[3] = { static_cast<float>( offset[0] ),
-                                 static_cast<float>( offset[1] ),
-                                 static_cast<float>( offset[2] ) };
-        parent->AddOffsetToUniverseCenter(
-            vr::TrackingUniverseOrigin( m_trackingUniverse ),
-            offsetFloat,
-            m_adjustChaperone );
-        m_offsetX += value;
+        m_offsetX += static_cast<double>( value );
+        applyUniverseTransform();
         if ( notify )
         {
-            emit offsetXChanged( m_offsetX );
+            emit offsetXChanged( offsetX() );
         }
     }
 }
@@ -430,15 +551,11 @@ void MoveCenterTabController::modOffsetY( float value, bool notify )
 {
     if ( !m_lockYToggle )
     {
-        parent->AddOffsetToUniverseCenter(
-            vr::TrackingUniverseOrigin( m_trackingUniverse ),
-            1,
-            value,
-            m_adjustChaperone );
-        m_offsetY += value;
+        m_offsetY += static_cast<double>( value );
+        applyUniverseTransform();
         if ( notify )
         {
-            emit offsetYChanged( m_offsetY );
+            emit offsetYChanged( offsetY() );
         }
     }
 }
@@ -447,59 +564,213 @@ void MoveCenterTabController::modOffsetZ( float value, bool notify )
 {
     if ( !m_lockZToggle )
     {
-        double angle = m_rotation * k_centidegreesToRadians;
-        double offset[3] = { 0, 0, static_cast<double>( value ) };
-        rotateCoordinates( offset, angle );
-        float offsetFloat[3] = { static_cast<float>( offset[0] ),
-                                 static_cast<float>( offset[1] ),
-                                 static_cast<float>( offset[2] ) };
-        parent->AddOffsetToUniverseCenter(
-            vr::TrackingUniverseOrigin( m_trackingUniverse ),
-            offsetFloat,
-            m_adjustChaperone );
-        m_offsetZ += value;
+        m_offsetZ += static_cast<double>( value );
+        applyUniverseTransform();
         if ( notify )
         {
-            emit offsetZChanged( m_offsetZ );
+            emit offsetZChanged( offsetZ() );
         }
     }
 }
 
 void MoveCenterTabController::reset()
 {
+    m_offsetX = 0.0;
+    m_offsetY = 0.0;
+    m_offsetZ = 0.0;
+    m_rotation = 0.0;
+    applyUniverseTransform();
+    emit offsetXChanged( offsetX() );
+    emit offsetYChanged( offsetY() );
+    emit offsetZChanged( offsetZ() );
+    emit rotationChanged( rotation() );
+}
+
+void MoveCenterTabController::zeroOffsets()
+{
+    m_offsetX = 0.0;
+    m_offsetY = 0.0;
+    m_offsetZ = 0.0;
+    m_rotation = 0.0;
+    m_universeTransform.rebase();
+    emit offsetXChanged( offsetX() );
+    emit offsetYChanged( offsetY() );
+    emit offsetZChanged( offsetZ() );
+    emit rotationChanged( rotation() );
+}
+
+void MoveCenterTabController::applyUniverseTransform()
+{
+    // Revert first so we always build on top of the last committed state
+    // instead of leftovers in the working copy. During a drag the working copy
+    // is what we committed the frame before, so that is only needed once.
+    if ( !m_workingCopyRevertedForDrag )
+    {
+        vr::VRChaperoneSetup()->RevertWorkingCopy();
+    }
+    m_workingCopyRevertedForDrag = isDragOrTurnActive();
+    double offset[3] = { m_offsetX, m_offsetY, m_offsetZ };
+    if ( m_universeTransform.apply(
+             vr::ETrackingUniverseOrigin( m_trackingUniverse ),
+             offset,
+             m_rotation * k_centidegreesToRadians,
+             m_adjustChaperone ) )
+    {
+        vr::VRChaperoneSetup()->CommitWorkingCopy(
+            vr::EChaperoneConfigFile_Live );
+        // So the change event this causes isn't taken as new bounds.
+        if ( auto bounds = m_universeTransform.writtenBounds() )
+        {
+            parent->chaperoneUtils().ownCommit(
+                bounds->data(), static_cast<uint32_t>( bounds->size() ) );
+        }
+    }
+}
+
+void MoveCenterTabController::savePlayspaceAnchors()
+{
+    k_playspaceAnchorSchema.writeIniArray( *OverlayController::appSettings(),
+                                           "playspaceSettings",
+                                           "playspaceAnchors",
+                                           m_playspaceAnchors );
+    OverlayController::appSettings()->sync();
+}
+
+unsigned MoveCenterTabController::getPlayspaceAnchorCount() const
+{
+    return static_cast<unsigned>( m_playspaceAnchors.size() );
+}
+
+QString MoveCenterTabController::getPlayspaceAnchorName( unsigned index ) const
+{
+    if ( index >= m_playspaceAnchors.size() )
+    {
+        return QString();
+    }
+    return QString::fromStdString( m_playspaceAnchors[index].anchorName );
+}
+
+/*!
+Saves the current playspace move under the given name, an anchor with the same
+name is replaced. Next to the offsets the anchor keeps the zero pose in raw
+tracking space, so zeroOffsets(), room setup or a chaperone profile moving the
+offsets' baseline don't move the anchor. The bounds aren't stored, with
+adjustChaperone they are rebuilt from the baseline like for any other move and
+stay where they are in the room.
+*/
+void MoveCenterTabController::addPlayspaceAnchor( QString name )
+{
+    const auto anchorName = name.toStdString();
+    auto anchor = std::find_if( m_playspaceAnchors.begin(),
+                                m_playspaceAnchors.end(),
+                                [&anchorName]( const PlayspaceAnchor& a ) {
+                                    return a.anchorName == anchorName;
+                                } );
+    if ( anchor == m_playspaceAnchors.end() )
+    {
+        anchor = m_playspaceAnchors.emplace( m_playspaceAnchors.end() );
+    }
+    anchor->anchorName = anchorName;
+    anchor->trackingUniverse = m_trackingUniverse;
+    anchor->offset[0] = static_cast<float>( m_offsetX );
+    anchor->offset[1] = static_cast<float>( m_offsetY );
+    anchor->offset[2] = static_cast<float>( m_offsetZ );
+    anchor->rotation = static_cast<float>( m_rotation );
+    const double offset[3] = { m_offsetX, m_offsetY, m_offsetZ };
     vr::VRChaperoneSetup()->RevertWorkingCopy();
-    parent->RotateUniverseCenter(
-        vr::TrackingUniverseOrigin( m_trackingUniverse ),
-        static_cast<float>( -m_rotation * k_centidegreesToRadians ),
-        m_adjustChaperone,
-        false );
-    float offset[3] = { -m_offsetX, -m_offsetY, -m_offsetZ };
-    parent->AddOffsetToUniverseCenter(
-        vr::TrackingUniverseOrigin( m_trackingUniverse ),
+    anchor->zeroPose = m_universeTransform.poseFor(
+        vr::ETrackingUniverseOrigin( m_trackingUniverse ),
         offset,
-        m_adjustChaperone,
-        false );
-    vr::VRChaperoneSetup()->CommitWorkingCopy( vr::EChaperoneConfigFile_Live );
-    m_offsetX = 0.0f;
-    m_offsetY = 0.0f;
-    m_offsetZ = 0.0f;
-    m_rotation = 0;
-    emit offsetXChanged( m_offsetX );
-    emit offsetYChanged( m_offsetY );
-    emit offsetZChanged( m_offsetZ );
-    emit rotationChanged( m_rotation );
+        m_rotation * k_centidegreesToRadians );
+    anchor->hasZeroPose = true;
+    savePlayspaceAnchors();
+    emit playspaceAnchorsUpdated();
 }
 
-void MoveCenterTabController::zeroOffsets()
+void MoveCenterTabController::deletePlayspaceAnchor( unsigned index )
 {
-    m_offsetX = 0.0f;
-    m_offsetY = 0.0f;
-    m_offsetZ = 0.0f;
-    m_rotation = 0;
-    emit offsetXChanged( m_offsetX );
-    emit offsetYChanged( m_offsetY );
-    emit offsetZChanged( m_offsetZ );
-    emit rotationChanged( m_rotation );
+    if ( index < m_playspaceAnchors.size() )
+    {
+        m_playspaceAnchors.erase( m_playspaceAnchors.begin() + index );
+        savePlayspaceAnchors();
+        emit playspaceAnchorsUpdated();
+    }
+}
+
+/*!
+Moves the playspace to a saved anchor. Offsets and rotation are set as a whole
+and go out in one revert, transform and commit of the working copy, bounds
+included, so the compositor never sees a half applied jump.
+
+The offsets are rebuilt from the anchor's zero pose against the current
+baseline. Only the height is taken from the anchor's offsets: a floor fix after
+saving moves the baseline to the corrected floor, which the stored pose would
+undo.
+
+Ignored while a drag or turn is held: those work from the controller position
+of the last frame, which would still be in the old playspace.
+*/
+void MoveCenterTabController::jumpToPlayspaceAnchor( unsigned index )
+{
+    if ( index >= m_playspaceAnchors.size() )
+    {
+        return;
+    }
+    const auto& anchor = m_playspaceAnchors[index];
+    if ( anchor.trackingUniverse != m_trackingUniverse )
+    {
+        LOG( WARNING ) << "Playspace anchor \"" << anchor.anchorName
+                       << "\" was saved in another tracking universe";
+        return;
+    }
+    if ( isDragOrTurnActive() )
+    {
+        return;
+    }
+    m_offsetX = static_cast<double>( anchor.offset[0] );
+    m_offsetY = static_cast<double>( anchor.offset[1] );
+    m_offsetZ = static_cast<double>( anchor.offset[2] );
+    m_rotation = static_cast<double>( anchor.rotation );
+    if ( anchor.hasZeroPose )
+    {
+        double offset[3];
+        double yaw = 0.0;
+        vr::VRChaperoneSetup()->RevertWorkingCopy();
+        m_universeTransform.stateFor(
+            vr::ETrackingUniverseOrigin( m_trackingUniverse ),
+            anchor.zeroPose,
+            offset,
+            yaw );
+        m_offsetX = offset[0];
+        m_offsetZ = offset[2];
+        m_rotation = yaw / k_centidegreesToRadians;
+    }
+    m_universeTransformPending = false;
+    applyUniverseTransform();
+    m_nextPlayspaceAnchor = index + 1;
+    emit offsetXChanged( offsetX() );
+    emit offsetYChanged( offsetY() );
+    emit offsetZChanged( offsetZ() );
+    emit rotationChanged( rotation() );
+}
+
+/*!
+Jumps to the anchor after the one jumped to last, skipping anchors of the
+other tracking universe.
+*/
+void MoveCenterTabController::nextPlayspaceAnchor()
+{
+    const auto count = m_playspaceAnchors.size();
+    for ( size_t i = 0; i < count; i++ )
+    {
+        const auto index
+            = static_cast<unsigned>( ( m_nextPlayspaceAnchor + i ) % count );
+        if ( m_playspaceAnchors[index].trackingUniverse == m_trackingUniverse )
+        {
+            jumpToPlayspaceAnchor( index );
+            return;
+        }
+    }
 }
 
 double MoveCenterTabController::getHmdYawTotal()
@@ -860,6 +1131,22 @@ void MoveCenterTabController::optionalOverrideRightHandRoomTurn(
 
 // END of turn bindings.
 
+void MoveCenterTabController::smoothMove( float x, float y )
+{
+    m_smoothMoveInput[0] = x;
+    m_smoothMoveInput[1] = y;
+}
+
+void MoveCenterTabController::smoothTurn( float x )
+{
+    m_smoothTurnInput = x;
+}
+
+void MoveCenterTabController::refreshSettings() noexcept
+{
+    settingsUpdateCounter = k_moveCenterSettingsUpdateCounter;
+}
+
 void MoveCenterTabController::eventLoopTick(
     vr::ETrackingUniverseOrigin universe,
     vr::TrackedDevicePose_t* devicePoses )
@@ -949,9 +1236,9 @@ void MoveCenterTabController::eventLoopTick(
     {
         if ( m_lastMoveHand != vr::TrackedControllerRole_Invalid )
         {
-            emit offsetXChanged( m_offsetX );
-            emit offsetYChanged( m_offsetY );
-            emit offsetZChanged( m_offsetZ );
+            emit offsetXChanged( offsetX() );
+            emit offsetYChanged( offsetY() );
+            emit offsetZChanged( offsetZ() );
         }
         m_lastMoveHand = m_activeDragHand;
     }
@@ -974,69 +1261,36 @@ void MoveCenterTabController::eventLoopTick(
                         movePose->mDeviceToAbsoluteTracking.m[2][3] ) };
 
             rotateCoordinates( relativeControllerPosition, -angle );
-            float absoluteControllerPosition[] = {
-                static_cast<float>( relativeControllerPosition[0] ) + m_offsetX,
-                static_cast<float>( relativeControllerPosition[1] ) + m_offsetY,
-                static_cast<float>( relativeControllerPosition[2] ) + m_offsetZ,
+            double absoluteControllerPosition[] = {
+                relativeControllerPosition[0] + m_offsetX,
+                relativeControllerPosition[1] + m_offsetY,
+                relativeControllerPosition[2] + m_offsetZ,
             };
 
             if ( m_lastMoveHand == m_activeDragHand )
             {
+                // offset is un-rotated coordinates
                 double diff[3] = {
-                    static_cast<double>( absoluteControllerPosition[0]
-                                         - m_lastControllerPosition[0] ),
-                    static_cast<double>( absoluteControllerPosition[1]
-                                         - m_lastControllerPosition[1] ),
-                    static_cast<double>( absoluteControllerPosition[2]
-                                         - m_lastControllerPosition[2] ),
+                    absoluteControllerPosition[0] - m_lastControllerPosition[0],
+                    absoluteControllerPosition[1] - m_lastControllerPosition[1],
+                    absoluteControllerPosition[2] - m_lastControllerPosition[2],
                 };
 
-                // offset is un-rotated coordinates
-
-                // prevents UI from updating if axis movement is locked
+                // If locked removes movement
                 if ( !m_lockXToggle )
                 {
-                    m_offsetX += static_cast<float>( diff[0] );
+                    m_offsetX += diff[0];
                 }
                 if ( !m_lockYToggle )
                 {
-                    m_offsetY += static_cast<float>( diff[1] );
+                    m_offsetY += diff[1];
                 }
                 if ( !m_lockZToggle )
                 {
-                    m_offsetZ += static_cast<float>( diff[2] );
+                    m_offsetZ += diff[2];
                 }
 
-                rotateCoordinates( diff, angle );
-
-                // Done calculating rotation so we down-cast double to float for
-                // openvr format
-                float diffFloat[3] = { static_cast<float>( diff[0] ),
-                                       static_cast<float>( diff[1] ),
-                                       static_cast<float>( diff[2] ) };
-                // If locked removes movement
-                if ( m_lockXToggle )
-                {
-                    diffFloat[0] = 0;
-                }
-                if ( m_lockYToggle )
-                {
-                    diffFloat[1] = 0;
-                }
-                if ( m_lockZToggle )
-                {
-                    diffFloat[2] = 0;
-                }
-
-                // Check if diffFloat is anything before comitting.
-                if ( diffFloat[0] != 0 || diffFloat[1] != 0
-                     || diffFloat[2] != 0 )
-                {
-                    parent->AddOffsetToUniverseCenter(
-                        vr::TrackingUniverseOrigin( m_trackingUniverse ),
-                        diffFloat,
-                        m_adjustChaperone );
-                }
+                m_universeTransformPending = true;
             }
             m_lastControllerPosition[0] = absoluteControllerPosition[0];
             m_lastControllerPosition[1] = absoluteControllerPosition[1];
@@ -1119,26 +1373,148 @@ void MoveCenterTabController::eventLoopTick(
                                       + handDiffQuaternion.x
                                             * handDiffQuaternion.x ) );
 
-                    int newRotationAngleDeg = static_cast<int>(
-                        round( handYawDiff * k_radiansToCentidegrees )
-                        + m_rotation );
+                    // Not rounded to whole centidegrees, small turns per
+                    // frame would otherwise add up to a noticeable drift.
+                    double newRotationAngleDeg
+                        = handYawDiff * k_radiansToCentidegrees + m_rotation;
 
                     // Keep angle within -18000 ~ 18000 centidegrees
-                    if ( newRotationAngleDeg > 18000 )
+                    if ( newRotationAngleDeg > 18000.0 )
                     {
-                        newRotationAngleDeg -= 36000;
+                        newRotationAngleDeg -= 36000.0;
                     }
-                    else if ( newRotationAngleDeg < -18000 )
+                    else if ( newRotationAngleDeg < -18000.0 )
                     {
-                        newRotationAngleDeg += 36000;
+                        newRotationAngleDeg += 36000.0;
                     }
 
-                    setRotation( newRotationAngleDeg );
+                    rotateAroundHmd( newRotationAngleDeg,
+                                     devicePoses[0].mDeviceToAbsoluteTracking );
+                    m_universeTransformPending = true;
+                    emit rotationChanged( rotation() );
+                    emit offsetXChanged( offsetX() );
+                    emit offsetZChanged( offsetZ() );
                 }
             }
             m_lastHandQuaternion = m_handQuaternion;
             m_lastRotateHand = m_activeTurnHand;
         }
     } // END of hand rotation
+
+    updateSmoothLocomotion( devicePoses[0] );
+
+    // Only writes and commits if the transform actually changed.
+    if ( m_universeTransformPending )
+    {
+        m_universeTransformPending = false;
+        applyUniverseTransform();
+    }
+    else if ( !isDragOrTurnActive() )
+    {
+        m_workingCopyRevertedForDrag = false;
+    }
+}
+
+void MoveCenterTabController::updateSmoothLocomotion(
+    const vr::TrackedDevicePose_t& hmdPose )
+{
+    // A movement that was going on when it got switched off still ends
+    // below.
+    if ( !m_smoothLocomotionEnabled && !m_smoothLocomotionActive )
+    {
+        return;
+    }
+    // Integrated over the real frame time, so speeds don't depend on the
+    // refresh rate. The step is limited, the first one after enabling
+    // starts at an old tick time.
+    const auto now = std::chrono::steady_clock::now();
+    const double seconds = std::min(
+        std::chrono::duration<double>( now - m_lastTickTime ).count(),
+        k_maxSmoothStepSeconds );
+    m_lastTickTime = now;
+
+    const double deadzone = static_cast<double>( m_smoothDeadzone );
+    const double curve = static_cast<double>( m_smoothResponseCurve );
+    const double moveX = static_cast<double>( m_smoothMoveInput[0] );
+    const double moveY = static_cast<double>( m_smoothMoveInput[1] );
+    // Radial deadzone for movement, the direction is kept as is.
+    const double moveDeflection = std::sqrt( moveX * moveX + moveY * moveY );
+    const double moveFactor
+        = shapeDeflection( moveDeflection, deadzone, curve );
+    const double turnInput = static_cast<double>( m_smoothTurnInput );
+    const double turnFactor = std::copysign(
+        shapeDeflection( std::abs( turnInput ), deadzone, curve ), turnInput );
+
+    const bool hmdValid
+        = hmdPose.bPoseIsValid
+          && hmdPose.eTrackingResult == vr::TrackingResult_Running_OK;
+    const bool active = m_smoothLocomotionEnabled && hmdValid
+                        && ( moveFactor > 0.0 || turnFactor != 0.0 );
+    if ( !active )
+    {
+        if ( m_smoothLocomotionActive )
+        {
+            emit offsetXChanged( offsetX() );
+            emit offsetZChanged( offsetZ() );
+            emit rotationChanged( rotation() );
+        }
+        m_smoothLocomotionActive = false;
+        return;
+    }
+    m_smoothLocomotionActive = true;
+    const auto& hmdMatrix = hmdPose.mDeviceToAbsoluteTracking;
+
+    if ( turnFactor != 0.0 )
+    {
+        // Turning the universe to the left turns the player to the right.
+        double newRotation
+            = m_rotation
+              + turnFactor * static_cast<double>( m_smoothTurnSpeed ) * 100.0
+                    * seconds;
+        if ( newRotation > 18000.0 )
+        {
+            newRotation -= 36000.0;
+        }
+        else if ( newRotation < -18000.0 )
+        {
+            newRotation += 36000.0;
+        }
+        rotateAroundHmd( newRotation, hmdMatrix );
+    }
+
+    if ( moveFactor > 0.0 )
+    {
+        // Head relative directions on the floor plane, -z is forward.
+        double forward[3] = { -static_cast<double>( hmdMatrix.m[0][2] ),
+                              0.0,
+                              -static_cast<double>( hmdMatrix.m[2][2] ) };
+        const double length
+            = std::sqrt( forward[0] * forward[0] + forward[2] * forward[2] );
+        if ( length > 1e-6 )
+        {
+            forward[0] /= length;
+            forward[2] /= length;
+            // Stick position rotated into the head direction, right is
+            // forward turned by 90 degrees clockwise.
+            const double scale
+                = moveFactor / moveDeflection
+                  * static_cast<double>( m_smoothMoveSpeed ) * seconds;
+            double step[3]
+                = { ( forward[0] * moveY - forward[2] * moveX ) * scale,
+                    0.0,
+                    ( forward[2] * moveY + forward[0] * moveX ) * scale };
+            rotateCoordinates( step, -m_rotation * k_centidegreesToRadians );
+            // Moving the player forward moves the universe backward.
+            if ( !m_lockXToggle )
+            {
+                m_offsetX -= step[0];
+            }
+            if ( !m_lockZToggle )
+            {
+                m_offsetZ -= step[2];
+            }
+        }
+    }
+    m_universeTransformPending = true;
 }
 } // namespace advsettings
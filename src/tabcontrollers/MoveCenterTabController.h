@@ -4,7 +4,10 @@
 #include <QObject>
 #include <openvr.h>
 #include <chrono>
+#include <string>
+#include <vector>
 #include <qmath.h>
+#include "../utils/UniverseTransform.h"
 
 class QQuickWindow;
 // application namespace
@@ -18,6 +21,20 @@ constexpr double k_quaternionUnderIsInvalidValueThreshold = -900.0;
 
 class OverlayController;
 
+// A saved playspace move the playspace can jump back to.
+struct PlayspaceAnchor
+{
+    std::string anchorName;
+    int trackingUniverse = static_cast<int>( vr::TrackingUniverseStanding );
+    // Offsets in m before rotation, rotation in centidegrees.
+    float offset[3] = { 0.0f, 0.0f, 0.0f };
+    float rotation = 0.0f;
+    // Zero pose in raw tracking space, which a rebase doesn't move. Anchors
+    // saved before it was added only have the offsets.
+    bool hasZeroPose = false;
+    vr::HmdMatrix34_t zeroPose = {};
+};
+
 class MoveCenterTabController : public QObject
 {
     Q_OBJECT
@@ -47,23 +64,38 @@ class MoveCenterTabController : public QObject
                     requireLockZChanged )
     Q_PROPERTY( bool rotateHand READ rotateHand WRITE setRotateHand NOTIFY
                     rotateHandChanged )
+    Q_PROPERTY( bool smoothLocomotionEnabled READ smoothLocomotionEnabled WRITE
+                    setSmoothLocomotionEnabled NOTIFY
+                        smoothLocomotionEnabledChanged )
+    Q_PROPERTY( float smoothMoveSpeed READ smoothMoveSpeed WRITE
+                    setSmoothMoveSpeed NOTIFY smoothMoveSpeedChanged )
+    Q_PROPERTY( float smoothTurnSpeed READ smoothTurnSpeed WRITE
+                    setSmoothTurnSpeed NOTIFY smoothTurnSpeedChanged )
+    Q_PROPERTY( float smoothDeadzone READ smoothDeadzone WRITE
+                    setSmoothDeadzone NOTIFY smoothDeadzoneChanged )
+    Q_PROPERTY( float smoothResponseCurve READ smoothResponseCurve WRITE
+                    setSmoothResponseCurve NOTIFY smoothResponseCurveChanged )
 
 private:
     OverlayController* parent;
     QQuickWindow* widget;
 
     int m_trackingUniverse = static_cast<int>( vr::TrackingUniverseStanding );
-    float m_offsetX = 0.0f;
-    float m_offsetY = 0.0f;
-    float m_offsetZ = 0.0f;
-    int m_rotation = 0;
+    // Canonical playspace move state. Offsets are in un-rotated coordinates,
+    // rotation is in centidegrees but not rounded so small per-frame turns
+    // don't get lost.
+    double m_offsetX = 0.0;
+    double m_offsetY = 0.0;
+    double m_offsetZ = 0.0;
+    double m_rotation = 0.0;
+    utils::UniverseTransform m_universeTransform;
     int m_tempRotation = 0;
     bool m_adjustChaperone = true;
     bool m_settingsHandTurningEnabled = false;
     bool m_moveShortcutRightPressed = false;
     bool m_moveShortcutLeftPressed = false;
     vr::TrackedDeviceIndex_t m_activeMoveController;
-    float m_lastControllerPosition[3];
+    double m_lastControllerPosition[3];
     bool m_settingsRightHandDragEnabled = false;
     bool m_settingsLeftHandDragEnabled = false;
     bool m_lockXToggle = false;
@@ -95,7 +127,33 @@ private:
     bool m_rightHandTurnPressed = false;
     bool m_overrideLeftHandTurnPressed = false;
     bool m_overrideRightHandTurnPressed = false;
+    // Thumbstick locomotion. Speeds in m/s and degrees/s, the response curve
+    // is the exponent applied to the stick deflection past the deadzone.
+    // Off by default, the default bindings put it on the thumbsticks.
+    bool m_smoothLocomotionEnabled = false;
+    float m_smoothMoveSpeed = 2.0f;
+    float m_smoothTurnSpeed = 90.0f;
+    float m_smoothDeadzone = 0.15f;
+    float m_smoothResponseCurve = 2.0f;
+    float m_smoothMoveInput[2] = { 0.0f, 0.0f };
+    float m_smoothTurnInput = 0.0f;
+    bool m_smoothLocomotionActive = false;
+    std::chrono::steady_clock::time_point m_lastTickTime;
+    // Drag, turn and thumbstick changes of a frame are committed together.
+    bool m_universeTransformPending = false;
+    // The working copy is reverted once when a drag or turn starts, our own
+    // commits keep it current for the rest of it.
+    bool m_workingCopyRevertedForDrag = false;
     unsigned settingsUpdateCounter = 0;
+    // Indexed by the page and the next anchor action.
+    std::vector<PlayspaceAnchor> m_playspaceAnchors;
+    unsigned m_nextPlayspaceAnchor = 0;
+
+    void applyUniverseTransform();
+    void savePlayspaceAnchors();
+    void applyRotation( double value, bool notify );
+    void rotateAroundHmd( double value, const vr::HmdMatrix34_t& hmdPos );
+    void updateSmoothLocomotion( const vr::TrackedDevicePose_t& hmdPose );
 
 public:
     void initStage1();
@@ -103,6 +161,8 @@ public:
 
     void eventLoopTick( vr::ETrackingUniverseOrigin universe,
                         vr::TrackedDevicePose_t* devicePoses );
+    // The values shown on the page are read again with the next tick.
+    void refreshSettings() noexcept;
 
     float offsetX() const;
     float offsetY() const;
@@ -119,6 +179,19 @@ public:
     double getHmdYawTotal();
     void resetHmdYawTotal();
 
+    bool smoothLocomotionEnabled() const;
+    float smoothMoveSpeed() const;
+    float smoothTurnSpeed() const;
+    float smoothDeadzone() const;
+    float smoothResponseCurve() const;
+
+    bool isDragOrTurnActive() const noexcept
+    {
+        return m_activeDragHand != vr::TrackedControllerRole_Invalid
+               || m_activeTurnHand != vr::TrackedControllerRole_Invalid
+               || m_smoothLocomotionActive;
+    }
+
     // actions:
     void leftHandRoomDrag( bool leftHandDragActive );
     void rightHandRoomDrag( bool rightHandDragActive );
@@ -128,6 +201,12 @@ public:
     void rightHandRoomTurn( bool rightHandTurnActive );
     void optionalOverrideLeftHandRoomTurn( bool overrideLeftHandTurnActive );
     void optionalOverrideRightHandRoomTurn( bool overrideRightHandTurnActive );
+    void smoothMove( float x, float y );
+    void smoothTurn( float x );
+    void nextPlayspaceAnchor();
+
+    Q_INVOKABLE unsigned getPlayspaceAnchorCount() const;
+    Q_INVOKABLE QString getPlayspaceAnchorName( unsigned index ) const;
 
 public slots:
     int trackingUniverse() const;
@@ -145,6 +224,12 @@ public slots:
 
     void setRotateHand( bool value, bool notify = true );
 
+    void setSmoothLocomotionEnabled( bool value, bool notify = true );
+    void setSmoothMoveSpeed( float value, bool notify = true );
+    void setSmoothTurnSpeed( float value, bool notify = true );
+    void setSmoothDeadzone( float value, bool notify = true );
+    void setSmoothResponseCurve( float value, bool notify = true );
+
     void setMoveShortcutRight( bool value, bool notify = true );
     void setMoveShortcutLeft( bool value, bool notify = true );
 
@@ -159,6 +244,10 @@ public slots:
     void reset();
     void zeroOffsets();
 
+    void addPlayspaceAnchor( QString name );
+    void jumpToPlayspaceAnchor( unsigned index );
+    void deletePlayspaceAnchor( unsigned index );
+
 signals:
     void trackingUniverseChanged( int value );
     void offsetXChanged( float value );
@@ -168,11 +257,17 @@ signals:
     void tempRotationChanged( int value );
     void adjustChaperoneChanged( bool value );
     void rotateHandChanged( bool value );
+    void smoothLocomotionEnabledChanged( bool value );
+    void smoothMoveSpeedChanged( float value );
+    void smoothTurnSpeedChanged( float value );
+    void smoothDeadzoneChanged( float value );
+    void smoothResponseCurveChanged( float value );
     void moveShortcutRightChanged( bool value );
     void moveShortcutLeftChanged( bool value );
     void requireLockXChanged( bool value );
     void requireLockYChanged( bool value );
     void requireLockZChanged( bool value );
+    void playspaceAnchorsUpdated();
 };
 
 } // namespace advsettings
@@ -57,93 +57,29 @@ void PttController::setPttControllerConfig( unsigned controller,
 
 void PttController::reloadPttProfiles()
 {
-    pttProfiles.clear();
-    auto settings = OverlayController::appSettings();
-    settings->beginGroup( getSettingsName() );
-    auto profileCount = settings->beginReadArray( "pttProfiles" );
-    for ( int i = 0; i < profileCount; i++ )
+    pttProfiles = ptt_profile::k_schema.readIniArray(
+        *OverlayController::appSettings(), getSettingsName(), "pttProfiles" );
+    // The mask isn't stored.
+    for ( auto& profile : pttProfiles )
     {
-        settings->setArrayIndex( i );
-        pttProfiles.emplace_back();
-        auto& entry = pttProfiles[static_cast<size_t>( i )];
-        entry.profileName
-            = settings->value( "profileName" ).toString().toStdString();
-        entry.showNotification
-            = settings->value( "showNotification", true ).toBool();
-        entry.leftControllerEnabled
-            = settings->value( "leftControllerEnabled", false ).toBool();
-        entry.rightControllerEnabled
-            = settings->value( "rightControllerEnabled", false ).toBool();
-        entry.controllerConfigs[0].digitalButtons
-            = settings->value( "digitalButtons_0" ).toList();
-        uint64_t buttonMask = 0;
-        for ( auto b : entry.controllerConfigs[0].digitalButtons )
+        for ( auto& config : profile.controllerConfigs )
         {
-            buttonMask |= vr::ButtonMaskFromId(
-                static_cast<vr::EVRButtonId>( b.toInt() ) );
-        }
-        entry.controllerConfigs[0].digitalButtonMask = buttonMask;
-        entry.controllerConfigs[0].triggerMode
-            = settings->value( "triggerMode_0", 0 ).toUInt();
-        entry.controllerConfigs[0].touchpadMode
-            = settings->value( "touchpadMode_0", 0 ).toUInt();
-        entry.controllerConfigs[0].touchpadAreas
-            = settings->value( "touchPadAreas_0", 0 ).toUInt();
-        entry.controllerConfigs[1].digitalButtons
-            = settings->value( "digitalButtons_1" ).toList();
-        buttonMask = 0;
-        for ( auto b : entry.controllerConfigs[1].digitalButtons )
-        {
-            buttonMask |= vr::ButtonMaskFromId(
-                static_cast<vr::EVRButtonId>( b.toInt() ) );
+            config.digitalButtonMask = 0;
+            for ( const auto& b : config.digitalButtons )
+            {
+                config.digitalButtonMask |= vr::ButtonMaskFromId(
+                    static_cast<vr::EVRButtonId>( b.toInt() ) );
+            }
         }
-        entry.controllerConfigs[1].digitalButtonMask = buttonMask;
-        entry.controllerConfigs[1].triggerMode
-            = settings->value( "triggerMode_1", 0 ).toUInt();
-        entry.controllerConfigs[1].touchpadMode
-            = settings->value( "touchpadMode_1", 0 ).toUInt();
-        entry.controllerConfigs[1].touchpadAreas
-            = settings->value( "touchPadAreas_1", 0 ).toUInt();
-    }
-    settings->endArray();
-    settings->endGroup();
+    }
 }
 
 void PttController::savePttProfiles()
 {
-    auto settings = OverlayController::appSettings();
-    settings->beginGroup( getSettingsName() );
-    settings->beginWriteArray( "pttProfiles" );
-    unsigned i = 0;
-    for ( auto& p : pttProfiles )
-    {
-        settings->setArrayIndex( static_cast<int>( i ) );
-        settings->setValue( "profileName",
-                            QString::fromStdString( p.profileName ) );
-        settings->setValue( "showNotification", p.showNotification );
-        settings->setValue( "leftControllerEnabled", p.leftControllerEnabled );
-        settings->setValue( "rightControllerEnabled",
-                            p.rightControllerEnabled );
-        settings->setValue( "digitalButtons_0",
-                            p.controllerConfigs[0].digitalButtons );
-        settings->setValue( "triggerMode_0",
-                            p.controllerConfigs[0].triggerMode );
-        settings->setValue( "touchpadMode_0",
-                            p.controllerConfigs[0].touchpadMode );
-        settings->setValue( "touchPadAreas_0",
-                            p.controllerConfigs[0].touchpadAreas );
-        settings->setValue( "digitalButtons_1",
-                            p.controllerConfigs[1].digitalButtons );
-        settings->setValue( "triggerMode_1",
-                            p.controllerConfigs[1].triggerMode );
-        settings->setValue( "touchpadMode_1",
-                            p.controllerConfigs[1].touchpadMode );
-        settings->setValue( "touchPadAreas_1",
-                            p.controllerConfigs[1].touchpadAreas );
-        i++;
-    }
-    settings->endArray();
-    settings->endGroup();
+    ptt_profile::k_schema.writeIniArray( *OverlayController::appSettings(),
+                                         getSettingsName(),
+                                         "pttProfiles",
+                                         pttProfiles );
 }
 
 void PttController::reloadPttConfig()
@@ -235,10 +171,9 @@ void PttController::startPtt()
 {
     m_pttActive = true;
     onPttStart();
-    if ( m_pttShowNotification
-         && getNotificationOverlayHandle() != vr::k_ulOverlayHandleInvalid )
+    if ( m_pttShowNotification )
     {
-        vr::VROverlay()->ShowOverlay( getNotificationOverlayHandle() );
+        setNotificationVisible( true );
     }
     emit pttActiveChanged( m_pttActive );
 }
@@ -247,10 +182,9 @@ void PttController::stopPtt()
 {
     m_pttActive = false;
     onPttStop();
-    if ( m_pttShowNotification
-         && getNotificationOverlayHandle() != vr::k_ulOverlayHandleInvalid )
+    if ( m_pttShowNotification )
     {
-        vr::VROverlay()->HideOverlay( getNotificationOverlayHandle() );
+        setNotificationVisible( false );
     }
     emit pttActiveChanged( m_pttActive );
 }
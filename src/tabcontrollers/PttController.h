@@ -7,6 +7,7 @@
 #include <string>
 #include <mutex>
 #include <openvr.h>
+#include "../utils/ProfileSchema.h"
 
 class QQuickWindow;
 // application namespace
@@ -37,12 +38,67 @@ struct PttProfile
 {
     std::string profileName;
 
-    bool showNotification = false;
+    bool showNotification = true;
     bool leftControllerEnabled = false;
     bool rightControllerEnabled = false;
     PttControllerConfig controllerConfigs[2];
 };
 
+// How PttProfile is stored in the settings, see utils::ProfileSchema.
+namespace ptt_profile
+{
+    using Profile = PttProfile;
+
+    inline constexpr auto k_schema = utils::profileSchema<Profile>(
+        1,
+        utils::profileField( "profileName", &Profile::profileName ),
+        utils::profileField( "showNotification", &Profile::showNotification ),
+        utils::profileField( "leftControllerEnabled",
+                             &Profile::leftControllerEnabled ),
+        utils::profileField( "rightControllerEnabled",
+                             &Profile::rightControllerEnabled ),
+        utils::profileField<Profile>(
+            "digitalButtons_0",
+            []( auto& p ) -> auto& {
+                return p.controllerConfigs[0].digitalButtons;
+            } ),
+        utils::profileField<Profile>(
+            "triggerMode_0",
+            []( auto& p ) -> auto& {
+                return p.controllerConfigs[0].triggerMode;
+            } ),
+        utils::profileField<Profile>(
+            "touchpadMode_0",
+            []( auto& p ) -> auto& {
+                return p.controllerConfigs[0].touchpadMode;
+            } ),
+        utils::profileField<Profile>(
+            "touchPadAreas_0",
+            []( auto& p ) -> auto& {
+                return p.controllerConfigs[0].touchpadAreas;
+            } ),
+        utils::profileField<Profile>(
+            "digitalButtons_1",
+            []( auto& p ) -> auto& {
+                return p.controllerConfigs[1].digitalButtons;
+            } ),
+        utils::profileField<Profile>(
+            "triggerMode_1",
+            []( auto& p ) -> auto& {
+                return p.controllerConfigs[1].triggerMode;
+            } ),
+        utils::profileField<Profile>(
+            "touchpadMode_1",
+            []( auto& p ) -> auto& {
+                return p.controllerConfigs[1].touchpadMode;
+            } ),
+        utils::profileField<Profile>(
+            "touchPadAreas_1",
+            []( auto& p ) -> auto& {
+                return p.controllerConfigs[1].touchpadAreas;
+            } ) );
+} // namespace ptt_profile
+
 class PttController : public QObject
 {
     Q_OBJECT
@@ -76,10 +132,7 @@ protected:
     virtual void onPttEnabled() {}
     virtual void onPttDisabled() {}
 
-    virtual vr::VROverlayHandle_t getNotificationOverlayHandle()
-    {
-        return vr::k_ulOverlayHandleInvalid;
-    }
+    virtual void setNotificationVisible( bool ) {}
     std::recursive_mutex eventLoopMutex;
 
 public:
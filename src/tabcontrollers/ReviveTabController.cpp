@@ -1,6 +1,8 @@
 #include "ReviveTabController.h"
 #include <QQuickWindow>
 #include "../overlaycontroller.h"
+#include "../utils/ProfileSchema.h"
+#include <cmath>
 
 // application namespace
 namespace advsettings
@@ -25,8 +27,45 @@ constexpr auto key_piUser = "User";
 constexpr auto key_piName = "Name";
 constexpr auto key_piGender = "Gender";
 
+namespace
+{
+    using Profile = ReviveControllerProfile;
+
+    constexpr auto k_controllerProfileSchema = utils::profileSchema<Profile>(
+        1,
+        utils::profileField( "profileName", &Profile::profileName ),
+        utils::profileField( "gripButtonMode", &Profile::gripButtonMode ),
+        utils::profileField( "triggerAsGrip", &Profile::triggerAsGrip ),
+        utils::profileField( "thumbDeadzone", &Profile::thumbDeadzone ),
+        utils::profileField( "thumbRange", &Profile::thumbRange ),
+        utils::profileField( "touchPitch", &Profile::touchPitch ),
+        utils::profileField( "touchYaw", &Profile::touchYaw ),
+        utils::profileField( "touchRoll", &Profile::touchRoll ),
+        utils::profileField( "touchX", &Profile::touchX ),
+        utils::profileField( "touchY", &Profile::touchY ),
+        utils::profileField( "touchZ", &Profile::touchZ ) );
+
+    // HMD heights are sampled every this many frames, neighbouring frames
+    // hardly differ.
+    constexpr unsigned k_hmdHeightSampleInterval = 9;
+    // Only taken while the head is still and upright: below this speed in m/s
+    // and with the HMD y axis at most ~25 degrees off vertical.
+    constexpr float k_maxHmdHeightSampleSpeed = 0.25f;
+    constexpr float k_minHmdUpright = 0.9f;
+    // About 30 s of standing still.
+    constexpr uint64_t k_minHmdHeightSamples = 300;
+    // Smaller changes of the estimate aren't shown.
+    constexpr float k_calibratedEyeHeightStep = 0.005f;
+} // namespace
+
 void ReviveTabController::initStage1( bool forceRevivePage )
 {
+    auto settings = OverlayController::appSettings();
+    settings->beginGroup( "reviveSettings" );
+    m_heightCalibrationEnabled
+        = settings->value( "heightCalibrationEnabled", false ).toBool();
+    settings->endGroup();
+
     m_isOverlayInstalled
         = vr::VRApplications()->IsApplicationInstalled( appkey_overlay );
     if ( m_isOverlayInstalled || forceRevivePage )
@@ -304,13 +343,24 @@ void ReviveTabController::initStage2( OverlayController* var_parent,
     this->widget = var_widget;
 }
 
-void ReviveTabController::eventLoopTick()
+void ReviveTabController::refreshSettings() noexcept
+{
+    settingsUpdateCounter = k_reviveSettingsUpdateCounter;
+}
+
+void ReviveTabController::eventLoopTick(
+    vr::TrackedDevicePose_t* devicePoses )
 {
     if ( m_isOverlayInstalled
          || parent->m_settingsTabController.forceRevivePage() )
     {
+        if ( m_heightCalibrationEnabled )
+        {
+            sampleHmdHeight( devicePoses[vr::k_unTrackedDeviceIndex_Hmd] );
+        }
         if ( settingsUpdateCounter >= k_reviveSettingsUpdateCounter )
         {
+            updateCalibratedEyeHeight();
             if ( parent->isDashboardVisible() )
             {
                 vr::EVRSettingsError vrSettingsError;
@@ -574,6 +624,16 @@ int ReviveTabController::piGender() const
     return m_piGender;
 }
 
+bool ReviveTabController::isHeightCalibrationEnabled() const
+{
+    return m_heightCalibrationEnabled;
+}
+
+float ReviveTabController::calibratedEyeHeight() const
+{
+    return m_calibratedEyeHeight;
+}
+
 void ReviveTabController::setGripButtonMode( int value, bool notify )
 {
     if ( m_gripButtonMode != value )
@@ -1173,6 +1233,75 @@ void ReviveTabController::reset()
     settingsUpdateCounter = 999; // Easiest way to get default values
 }
 
+void ReviveTabController::setHeightCalibrationEnabled( bool value,
+                                                       bool notify )
+{
+    if ( m_heightCalibrationEnabled != value )
+    {
+        m_heightCalibrationEnabled = value;
+        auto settings = OverlayController::appSettings();
+        settings->beginGroup( "reviveSettings" );
+        settings->setValue( "heightCalibrationEnabled",
+                            m_heightCalibrationEnabled );
+        settings->endGroup();
+        settings->sync();
+        if ( notify )
+        {
+            emit heightCalibrationEnabledChanged( m_heightCalibrationEnabled );
+        }
+    }
+}
+
+void ReviveTabController::resetHeightCalibration()
+{
+    m_hmdHeights.reset();
+    m_hmdHeightSampleCounter = 0;
+    m_calibratedEyeHeight = 0.0f;
+    emit calibratedEyeHeightChanged( m_calibratedEyeHeight );
+}
+
+void ReviveTabController::sampleHmdHeight( const vr::TrackedDevicePose_t& pose )
+{
+    if ( ++m_hmdHeightSampleCounter < k_hmdHeightSampleInterval )
+    {
+        return;
+    }
+    m_hmdHeightSampleCounter = 0;
+    if ( !pose.bPoseIsValid
+         || pose.eTrackingResult != vr::TrackingResult_Running_OK )
+    {
+        return;
+    }
+    const auto& velocity = pose.vVelocity.v;
+    const float speedSquared = velocity[0] * velocity[0]
+                               + velocity[1] * velocity[1]
+                               + velocity[2] * velocity[2];
+    if ( speedSquared > k_maxHmdHeightSampleSpeed * k_maxHmdHeightSampleSpeed
+         || pose.mDeviceToAbsoluteTracking.m[1][1] < k_minHmdUpright )
+    {
+        return;
+    }
+    // Crouching or sitting only lowers heights, while the user stands for
+    // more than a fifth of the time the upper quantile is a standing one.
+    m_hmdHeights.add(
+        static_cast<double>( pose.mDeviceToAbsoluteTracking.m[1][3] ) );
+}
+
+void ReviveTabController::updateCalibratedEyeHeight()
+{
+    if ( m_hmdHeights.count() < k_minHmdHeightSamples )
+    {
+        return;
+    }
+    const auto height = static_cast<float>( m_hmdHeights.value() );
+    if ( std::abs( height - m_calibratedEyeHeight )
+         >= k_calibratedEyeHeightStep )
+    {
+        m_calibratedEyeHeight = height;
+        emit calibratedEyeHeightChanged( m_calibratedEyeHeight );
+    }
+}
+
 float ReviveTabController::getCurrentHMDHeight()
 {
     float hmdHeight = 0.0f;
@@ -1199,58 +1328,18 @@ float ReviveTabController::getCurrentHMDHeight()
 
 void ReviveTabController::reloadControllerProfiles()
 {
-    controllerProfiles.clear();
-    auto settings = OverlayController::appSettings();
-    settings->beginGroup( "reviveSettings" );
-    auto profileCount = settings->beginReadArray( "controllerProfiles" );
-    for ( int i = 0; i < profileCount; i++ )
-    {
-        settings->setArrayIndex( i );
-        controllerProfiles.emplace_back();
-        auto& entry = controllerProfiles[static_cast<size_t>( i )];
-        entry.profileName
-            = settings->value( "profileName" ).toString().toStdString();
-        entry.gripButtonMode = settings->value( "gripButtonMode", 0 ).toInt();
-        entry.triggerAsGrip = settings->value( "triggerAsGrip", 0 ).toBool();
-        entry.thumbDeadzone
-            = settings->value( "thumbDeadzone", 0.3f ).toFloat();
-        entry.thumbRange = settings->value( "thumbRange", 2.0f ).toFloat();
-        entry.touchPitch = settings->value( "touchPitch", -28.0f ).toFloat();
-        entry.touchYaw = settings->value( "touchYaw", 0.0f ).toFloat();
-        entry.touchRoll = settings->value( "touchRoll", -14.0f ).toFloat();
-        entry.touchX = settings->value( "touchX", 0.016f ).toFloat();
-        entry.touchY = settings->value( "touchY", 0.0f ).toFloat();
-        entry.touchZ = settings->value( "touchZ", 0.016f ).toFloat();
-    }
-    settings->endArray();
-    settings->endGroup();
+    controllerProfiles = k_controllerProfileSchema.readIniArray(
+        *OverlayController::appSettings(),
+        "reviveSettings",
+        "controllerProfiles" );
 }
 
 void ReviveTabController::saveControllerProfiles()
 {
-    auto settings = OverlayController::appSettings();
-    settings->beginGroup( "reviveSettings" );
-    settings->beginWriteArray( "controllerProfiles" );
-    unsigned i = 0;
-    for ( auto& p : controllerProfiles )
-    {
-        settings->setArrayIndex( static_cast<int>( i ) );
-        settings->setValue( "profileName",
-                            QString::fromStdString( p.profileName ) );
-        settings->setValue( "gripButtonMode", p.gripButtonMode );
-        settings->setValue( "triggerAsGrip", p.triggerAsGrip );
-        settings->setValue( "thumbDeadzone", p.thumbDeadzone );
-        settings->setValue( "thumbRange", p.thumbRange );
-        settings->setValue( "touchPitch", p.touchPitch );
-        settings->setValue( "touchYaw", p.touchYaw );
-        settings->setValue( "touchRoll", p.touchRoll );
-        settings->setValue( "touchX", p.touchX );
-        settings->setValue( "touchY", p.touchY );
-        settings->setValue( "touchZ", p.touchZ );
-        i++;
-    }
-    settings->endArray();
-    settings->endGroup();
+    k_controllerProfileSchema.writeIniArray( *OverlayController::appSettings(),
+                                             "reviveSettings",
+                                             "controllerProfiles",
+                                             controllerProfiles );
 }
 
 Q_INVOKABLE unsigned ReviveTabController::getControllerProfileCount()
@@ -2,6 +2,8 @@
 #pragma once
 
 #include <QObject>
+#include <openvr.h>
+#include "../utils/StreamingQuantile.h"
 
 class QQuickWindow;
 // application namespace
@@ -13,16 +15,16 @@ class OverlayController;
 struct ReviveControllerProfile
 {
     std::string profileName;
-    int gripButtonMode;
-    bool triggerAsGrip;
-    float thumbDeadzone;
-    float thumbRange;
-    float touchPitch;
-    float touchYaw;
-    float touchRoll;
-    float touchX;
-    float touchY;
-    float touchZ;
+    int gripButtonMode = 0;
+    bool triggerAsGrip = false;
+    float thumbDeadzone = 0.3f;
+    float thumbRange = 2.0f;
+    float touchPitch = -28.0f;
+    float touchYaw = 0.0f;
+    float touchRoll = -14.0f;
+    float touchX = 0.016f;
+    float touchY = 0.0f;
+    float touchZ = 0.016f;
 };
 
 class ReviveTabController : public QObject
@@ -67,6 +69,11 @@ class ReviveTabController : public QObject
         QString piName READ piName WRITE setPiName NOTIFY piNameChanged )
     Q_PROPERTY(
         int piGender READ piGender WRITE setPiGender NOTIFY piGenderChanged )
+    Q_PROPERTY( bool heightCalibrationEnabled READ isHeightCalibrationEnabled
+                    WRITE setHeightCalibrationEnabled NOTIFY
+                        heightCalibrationEnabledChanged )
+    Q_PROPERTY( float calibratedEyeHeight READ calibratedEyeHeight NOTIFY
+                    calibratedEyeHeightChanged )
 
 private:
     OverlayController* parent;
@@ -92,15 +99,27 @@ private:
     QString m_piName = "";
     int m_piGender = 0; // 0 .. Unknown, 1 .. Male, 2 .. Female
 
+    // Standing eye height estimated from the HMD heights of the session.
+    bool m_heightCalibrationEnabled = false;
+    utils::StreamingQuantile m_hmdHeights{ 0.8 };
+    unsigned m_hmdHeightSampleCounter = 0;
+    // 0 until there are enough samples.
+    float m_calibratedEyeHeight = 0.0f;
+
     unsigned settingsUpdateCounter = 0;
 
+    void sampleHmdHeight( const vr::TrackedDevicePose_t& pose );
+    void updateCalibratedEyeHeight();
+
     std::vector<ReviveControllerProfile> controllerProfiles;
 
 public:
     void initStage1( bool forceRevivePage );
     void initStage2( OverlayController* parent, QQuickWindow* widget );
 
-    void eventLoopTick();
+    void eventLoopTick( vr::TrackedDevicePose_t* devicePoses );
+    // The values shown on the page are read again with the next tick.
+    void refreshSettings() noexcept;
 
     bool isOverlayInstalled() const;
 
@@ -126,6 +145,8 @@ public:
     const QString& piUsername() const;
     const QString& piName() const;
     int piGender() const; // 0 .. Unknown, 1 .. Male, 2 .. Female
+    bool isHeightCalibrationEnabled() const;
+    float calibratedEyeHeight() const;
 
     Q_INVOKABLE float getCurrentHMDHeight();
 
@@ -161,6 +182,8 @@ public slots:
     void setPiGender( int value,
                       bool notify
                       = true ); // 0 .. Unknown, 1 .. Male, 2 .. Female
+    void setHeightCalibrationEnabled( bool value, bool notify = true );
+    void resetHeightCalibration();
 
     void addControllerProfile( QString name );
     void applyControllerProfile( unsigned index );
@@ -193,6 +216,8 @@ signals:
     void piUsernameChanged( const QString& value );
     void piNameChanged( const QString& value );
     void piGenderChanged( int value );
+    void heightCalibrationEnabledChanged( bool value );
+    void calibratedEyeHeightChanged( float value );
 
     void controllerProfilesUpdated();
 };
@@ -12,11 +12,52 @@ void SettingsTabController::initStage1()
     auto settings = OverlayController::appSettings();
     settings->beginGroup( "applicationSettings" );
     auto value = settings->value( "forceRevivePage", m_forceRevivePage );
+    auto backgroundModeValue
+        = settings->value( "backgroundMode", m_backgroundMode );
+    auto sharedStateValue
+        = settings->value( "sharedStateEnabled", m_sharedStateEnabled );
+    auto cpuAffinityValue = settings->value( "cpuAffinity", m_cpuAffinity );
+    auto headTapValue
+        = settings->value( "headTapGestureAction", m_headTapGestureAction );
+    auto flickValue
+        = settings->value( "flickGestureAction", m_flickGestureAction );
+    auto tapAccelerationValue = settings->value( "gestureTapAcceleration",
+                                                 m_gestureTapAcceleration );
+    auto flickSpeedValue
+        = settings->value( "gestureFlickSpeed", m_gestureFlickSpeed );
     settings->endGroup();
     if ( value.isValid() && !value.isNull() )
     {
         m_forceRevivePage = value.toBool();
     }
+    if ( backgroundModeValue.isValid() && !backgroundModeValue.isNull() )
+    {
+        m_backgroundMode = backgroundModeValue.toBool();
+    }
+    if ( sharedStateValue.isValid() && !sharedStateValue.isNull() )
+    {
+        m_sharedStateEnabled = sharedStateValue.toBool();
+    }
+    if ( cpuAffinityValue.isValid() && !cpuAffinityValue.isNull() )
+    {
+        m_cpuAffinity = cpuAffinityValue.toString();
+    }
+    if ( headTapValue.isValid() && !headTapValue.isNull() )
+    {
+        m_headTapGestureAction = headTapValue.toInt();
+    }
+    if ( flickValue.isValid() && !flickValue.isNull() )
+    {
+        m_flickGestureAction = flickValue.toInt();
+    }
+    if ( tapAccelerationValue.isValid() && !tapAccelerationValue.isNull() )
+    {
+        m_gestureTapAcceleration = tapAccelerationValue.toFloat();
+    }
+    if ( flickSpeedValue.isValid() && !flickSpeedValue.isNull() )
+    {
+        m_gestureFlickSpeed = flickSpeedValue.toFloat();
+    }
 }
 
 void SettingsTabController::initStage2( OverlayController* var_parent,
@@ -24,6 +65,30 @@ void SettingsTabController::initStage2( OverlayController* var_parent,
 {
     this->parent = var_parent;
     this->widget = var_widget;
+
+    parent->processScheduler().setBackground( m_backgroundMode );
+    if ( m_sharedStateEnabled && !parent->sharedState().open() )
+    {
+        LOG( ERROR ) << "Could not create the shared memory segment";
+        m_sharedStateEnabled = false;
+    }
+    uint64_t mask = 0;
+    if ( utils::ProcessScheduler::parseCoreList( m_cpuAffinity.toStdString(),
+                                                 mask ) )
+    {
+        parent->processScheduler().setAffinity( mask );
+    }
+    else
+    {
+        LOG( ERROR ) << "Ignoring invalid cpu affinity \"" << m_cpuAffinity
+                     << "\"";
+    }
+    applyGestureThresholds();
+}
+
+void SettingsTabController::refreshSettings() noexcept
+{
+    settingsUpdateCounter = k_settingsTabSettingsUpdateCounter;
 }
 
 void SettingsTabController::eventLoopTick()
@@ -90,4 +155,209 @@ void SettingsTabController::setForceRevivePage( bool value, bool notify )
     }
 }
 
+bool SettingsTabController::backgroundMode() const
+{
+    return m_backgroundMode;
+}
+
+void SettingsTabController::setBackgroundMode( bool value, bool notify )
+{
+    if ( m_backgroundMode != value )
+    {
+        if ( !parent->processScheduler().setBackground( value ) )
+        {
+            // Puts the toggle back, leaving background mode can be refused
+            // on Linux.
+            if ( notify )
+            {
+                emit backgroundModeChanged( m_backgroundMode );
+            }
+            return;
+        }
+        m_backgroundMode = value;
+        auto settings = OverlayController::appSettings();
+        settings->beginGroup( "applicationSettings" );
+        settings->setValue( "backgroundMode", m_backgroundMode );
+        settings->endGroup();
+        settings->sync();
+        if ( notify )
+        {
+            emit backgroundModeChanged( m_backgroundMode );
+        }
+    }
+}
+
+bool SettingsTabController::isSharedStateEnabled() const
+{
+    return m_sharedStateEnabled;
+}
+
+void SettingsTabController::setSharedStateEnabled( bool value, bool notify )
+{
+    if ( m_sharedStateEnabled != value )
+    {
+        if ( !value )
+        {
+            parent->sharedState().close();
+        }
+        else if ( !parent->sharedState().open() )
+        {
+            LOG( ERROR ) << "Could not create the shared memory segment";
+            return;
+        }
+        m_sharedStateEnabled = value;
+        auto settings = OverlayController::appSettings();
+        settings->beginGroup( "applicationSettings" );
+        settings->setValue( "sharedStateEnabled", m_sharedStateEnabled );
+        settings->endGroup();
+        settings->sync();
+        if ( notify )
+        {
+            emit sharedStateEnabledChanged( m_sharedStateEnabled );
+        }
+    }
+}
+
+QString SettingsTabController::cpuAffinity() const
+{
+    return m_cpuAffinity;
+}
+
+int SettingsTabController::cpuCoreCount() const
+{
+    return static_cast<int>( utils::ProcessScheduler::coreCount() );
+}
+
+void SettingsTabController::setCpuAffinity( QString value, bool notify )
+{
+    value = value.trimmed();
+    if ( m_cpuAffinity != value )
+    {
+        uint64_t mask = 0;
+        if ( !utils::ProcessScheduler::parseCoreList( value.toStdString(),
+                                                      mask )
+             || !parent->processScheduler().setAffinity( mask ) )
+        {
+            LOG( ERROR ) << "Invalid cpu affinity \"" << value << "\"";
+            // Resets the text field.
+            if ( notify )
+            {
+                emit cpuAffinityChanged( m_cpuAffinity );
+            }
+            return;
+        }
+        m_cpuAffinity = value;
+        auto settings = OverlayController::appSettings();
+        settings->beginGroup( "applicationSettings" );
+        settings->setValue( "cpuAffinity", m_cpuAffinity );
+        settings->endGroup();
+        settings->sync();
+        if ( notify )
+        {
+            emit cpuAffinityChanged( m_cpuAffinity );
+        }
+    }
+}
+
+int SettingsTabController::headTapGestureAction() const
+{
+    return m_headTapGestureAction;
+}
+
+void SettingsTabController::setHeadTapGestureAction( int value, bool notify )
+{
+    if ( m_headTapGestureAction != value )
+    {
+        m_headTapGestureAction = value;
+        auto settings = OverlayController::appSettings();
+        settings->beginGroup( "applicationSettings" );
+        settings->setValue( "headTapGestureAction", m_headTapGestureAction );
+        settings->endGroup();
+        settings->sync();
+        if ( notify )
+        {
+            emit headTapGestureActionChanged( m_headTapGestureAction );
+        }
+    }
+}
+
+int SettingsTabController::flickGestureAction() const
+{
+    return m_flickGestureAction;
+}
+
+void SettingsTabController::setFlickGestureAction( int value, bool notify )
+{
+    if ( m_flickGestureAction != value )
+    {
+        m_flickGestureAction = value;
+        auto settings = OverlayController::appSettings();
+        settings->beginGroup( "applicationSettings" );
+        settings->setValue( "flickGestureAction", m_flickGestureAction );
+        settings->endGroup();
+        settings->sync();
+        if ( notify )
+        {
+            emit flickGestureActionChanged( m_flickGestureAction );
+        }
+    }
+}
+
+float SettingsTabController::gestureTapAcceleration() const
+{
+    return m_gestureTapAcceleration;
+}
+
+void SettingsTabController::setGestureTapAcceleration( float value,
+                                                       bool notify )
+{
+    if ( m_gestureTapAcceleration != value )
+    {
+        m_gestureTapAcceleration = value;
+        applyGestureThresholds();
+        auto settings = OverlayController::appSettings();
+        settings->beginGroup( "applicationSettings" );
+        settings->setValue( "gestureTapAcceleration",
+                            m_gestureTapAcceleration );
+        settings->endGroup();
+        settings->sync();
+        if ( notify )
+        {
+            emit gestureTapAccelerationChanged( m_gestureTapAcceleration );
+        }
+    }
+}
+
+float SettingsTabController::gestureFlickSpeed() const
+{
+    return m_gestureFlickSpeed;
+}
+
+void SettingsTabController::setGestureFlickSpeed( float value, bool notify )
+{
+    if ( m_gestureFlickSpeed != value )
+    {
+        m_gestureFlickSpeed = value;
+        applyGestureThresholds();
+        auto settings = OverlayController::appSettings();
+        settings->beginGroup( "applicationSettings" );
+        settings->setValue( "gestureFlickSpeed", m_gestureFlickSpeed );
+        settings->endGroup();
+        settings->sync();
+        if ( notify )
+        {
+            emit gestureFlickSpeedChanged( m_gestureFlickSpeed );
+        }
+    }
+}
+
+void SettingsTabController::applyGestureThresholds()
+{
+    auto thresholds = parent->gestureRecognizer().thresholds();
+    thresholds.tapAcceleration
+        = static_cast<double>( m_gestureTapAcceleration );
+    thresholds.flickAngularSpeed = static_cast<double>( m_gestureFlickSpeed );
+    parent->gestureRecognizer().setThresholds( thresholds );
+}
+
 } // namespace advsettings
@@ -10,6 +10,15 @@ namespace advsettings
 // forward declaration
 class OverlayController;
 
+// What a recognized gesture does, stored as int in the settings.
+enum class GestureAction
+{
+    None = 0,
+    TogglePtt = 1,
+    FixFloor = 2,
+    ResetRoom = 3,
+};
+
 class SettingsTabController : public QObject
 {
     Q_OBJECT
@@ -17,6 +26,23 @@ class SettingsTabController : public QObject
                     setAutoStartEnabled NOTIFY autoStartEnabledChanged )
     Q_PROPERTY( bool forceRevivePage READ forceRevivePage WRITE
                     setForceRevivePage NOTIFY forceRevivePageChanged )
+    Q_PROPERTY( bool backgroundMode READ backgroundMode WRITE
+                    setBackgroundMode NOTIFY backgroundModeChanged )
+    Q_PROPERTY( bool sharedStateEnabled READ isSharedStateEnabled WRITE
+                    setSharedStateEnabled NOTIFY sharedStateEnabledChanged )
+    Q_PROPERTY( QString cpuAffinity READ cpuAffinity WRITE setCpuAffinity
+                    NOTIFY cpuAffinityChanged )
+    Q_PROPERTY( int cpuCoreCount READ cpuCoreCount CONSTANT )
+    Q_PROPERTY( int headTapGestureAction READ headTapGestureAction WRITE
+                    setHeadTapGestureAction NOTIFY
+                        headTapGestureActionChanged )
+    Q_PROPERTY( int flickGestureAction READ flickGestureAction WRITE
+                    setFlickGestureAction NOTIFY flickGestureActionChanged )
+    Q_PROPERTY( float gestureTapAcceleration READ gestureTapAcceleration WRITE
+                    setGestureTapAcceleration NOTIFY
+                        gestureTapAccelerationChanged )
+    Q_PROPERTY( float gestureFlickSpeed READ gestureFlickSpeed WRITE
+                    setGestureFlickSpeed NOTIFY gestureFlickSpeedChanged )
 
 private:
     OverlayController* parent;
@@ -26,23 +52,72 @@ private:
 
     bool m_autoStartEnabled = false;
     bool m_forceRevivePage = false;
+    bool m_backgroundMode = false;
+    bool m_sharedStateEnabled = false;
+    // Empty for all cores.
+    QString m_cpuAffinity;
+    int m_headTapGestureAction = 0;
+    int m_flickGestureAction = 0;
+    // In m/s^2 and rad/s.
+    float m_gestureTapAcceleration = 30.0f;
+    float m_gestureFlickSpeed = 15.0f;
+
+    void applyGestureThresholds();
 
 public:
     void initStage1();
     void initStage2( OverlayController* parent, QQuickWindow* widget );
 
     void eventLoopTick();
+    // The values shown on the page are read again with the next tick.
+    void refreshSettings() noexcept;
 
     bool autoStartEnabled() const;
     bool forceRevivePage() const;
+    bool backgroundMode() const;
+    bool isSharedStateEnabled() const;
+    QString cpuAffinity() const;
+    int cpuCoreCount() const;
+    int headTapGestureAction() const;
+    int flickGestureAction() const;
+    float gestureTapAcceleration() const;
+    float gestureFlickSpeed() const;
+
+    GestureAction headTapAction() const noexcept
+    {
+        return static_cast<GestureAction>( m_headTapGestureAction );
+    }
+    GestureAction flickAction() const noexcept
+    {
+        return static_cast<GestureAction>( m_flickGestureAction );
+    }
+    // The recognizer only needs to run if a gesture does something.
+    bool gesturesEnabled() const noexcept
+    {
+        return m_headTapGestureAction != 0 || m_flickGestureAction != 0;
+    }
 
 public slots:
     void setAutoStartEnabled( bool value, bool notify = true );
     void setForceRevivePage( bool value, bool notify = true );
+    void setBackgroundMode( bool value, bool notify = true );
+    void setSharedStateEnabled( bool value, bool notify = true );
+    void setCpuAffinity( QString value, bool notify = true );
+    void setHeadTapGestureAction( int value, bool notify = true );
+    void setFlickGestureAction( int value, bool notify = true );
+    void setGestureTapAcceleration( float value, bool notify = true );
+    void setGestureFlickSpeed( float value, bool notify = true );
 
 signals:
     void autoStartEnabledChanged( bool value );
     void forceRevivePageChanged( bool value );
+    void backgroundModeChanged( bool value );
+    void sharedStateEnabledChanged( bool value );
+    void cpuAffinityChanged( QString value );
+    void headTapGestureActionChanged( int value );
+    void flickGestureActionChanged( int value );
+    void gestureTapAccelerationChanged( float value );
+    void gestureFlickSpeedChanged( float value );
 };
 
 } // namespace advsettings
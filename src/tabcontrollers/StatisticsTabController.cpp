@@ -1,17 +1,284 @@
 #include "StatisticsTabController.h"
 #include <QQuickWindow>
+#include <QDateTime>
+#include <QDir>
+#include <QStandardPaths>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
 #include "../overlaycontroller.h"
 
 // application namespace
 namespace advsettings
 {
-void StatisticsTabController::initStage1() {}
+// Performance HUD layout, colors are 0xRRGGBBAA.
+constexpr unsigned k_hudWidth = 160;
+constexpr unsigned k_hudHeight = 100;
+constexpr int k_hudLineHeight = 10;
+constexpr int k_hudGraphTop = 56;
+constexpr uint32_t k_hudBackgroundColor = 0x000000C0;
+constexpr uint32_t k_hudTextColor = 0xFFFFFFFF;
+constexpr uint32_t k_hudGraphColor = 0x40C040FF;
+constexpr uint32_t k_hudBudgetColor = 0xFFA000FF;
+// Samples the average CPU usage is taken over before it is compared to the
+// budget, so a single busy second doesn't raise a warning.
+constexpr unsigned k_cpuBudgetSamples = 5;
+// Play time covered by one record of the statistics log.
+constexpr std::chrono::seconds k_statisticsLogInterval{ 60 };
+
+void StatisticsTabController::initStage1()
+{
+    auto settings = OverlayController::appSettings();
+    settings->beginGroup( "statisticsSettings" );
+    auto value = settings->value( "performanceHud", m_performanceHud );
+    if ( value.isValid() && !value.isNull() )
+    {
+        m_performanceHud = value.toBool();
+    }
+    value = settings->value( "overlayCpuBudget", m_overlayCpuBudget );
+    if ( value.isValid() && !value.isNull() )
+    {
+        m_overlayCpuBudget = value.toFloat();
+    }
+    settings->endGroup();
+    m_processMonitor.sample();
+
+    const QDir dataDir( QStandardPaths::writableLocation(
+                            QStandardPaths::AppDataLocation )
+                        + "/matzman666/OpenVRAdvancedSettings" );
+    dataDir.mkpath( "." );
+    m_statisticsLog.open(
+        QDir::toNativeSeparators( dataDir.absoluteFilePath( "statistics.bin" ) )
+            .toStdString() );
+    m_sessionId = static_cast<int64_t>( std::time( nullptr ) );
+    m_logIntervalStart = std::chrono::steady_clock::now();
+}
+
+StatisticsTabController::~StatisticsTabController()
+{
+    writeStatisticsRecord();
+    m_statisticsLog.close();
+}
+
+void StatisticsTabController::writeStatisticsRecord()
+{
+    const auto now = std::chrono::steady_clock::now();
+    const auto seconds
+        = std::chrono::duration_cast<std::chrono::seconds>(
+              now - m_logIntervalStart )
+              .count();
+    if ( seconds <= 0 )
+    {
+        return;
+    }
+    utils::StatisticsLog::Record record;
+    record.endTime = static_cast<int64_t>( std::time( nullptr ) );
+    record.sessionId = m_sessionId;
+    record.seconds = static_cast<uint32_t>( seconds );
+    record.presentedFrames
+        = m_cumStats.m_nNumFramePresents - m_logPresentedBase;
+    record.droppedFrames = m_cumStats.m_nNumDroppedFrames - m_logDroppedBase;
+    record.reprojectedFrames
+        = m_cumStats.m_nNumReprojectedFrames - m_logReprojectedBase;
+    record.distance = static_cast<float>( m_hmdOdometer.floorDistance()
+                                          - m_logDistanceBase );
+    record.rotations = m_hmdRotation - m_logRotationBase;
+    record.leftMaxSpeed = m_logLeftMaxSpeed;
+    record.rightMaxSpeed = m_logRightMaxSpeed;
+    std::strncpy(
+        record.appKey, m_logAppKey.c_str(), sizeof( record.appKey ) - 1 );
+    m_statisticsLog.append( record );
+
+    m_logIntervalStart = now;
+    m_logDistanceBase = m_hmdOdometer.floorDistance();
+    m_logRotationBase = m_hmdRotation;
+    m_logLeftMaxSpeed = 0.0f;
+    m_logRightMaxSpeed = 0.0f;
+    m_logPresentedBase = m_cumStats.m_nNumFramePresents;
+    m_logDroppedBase = m_cumStats.m_nNumDroppedFrames;
+    m_logReprojectedBase = m_cumStats.m_nNumReprojectedFrames;
+}
 
 void StatisticsTabController::initStage2( OverlayController* var_parent,
                                           QQuickWindow* var_widget )
 {
     this->parent = var_parent;
     this->widget = var_widget;
+    if ( m_performanceHud )
+    {
+        createPerformanceHud();
+    }
+}
+
+void StatisticsTabController::createPerformanceHud()
+{
+    if ( m_hudOverlayHandle != vr::k_ulOverlayHandleInvalid )
+    {
+        vr::VROverlay()->ShowOverlay( m_hudOverlayHandle );
+        return;
+    }
+    std::string hudKey = std::string( OverlayController::applicationKey )
+                         + ".performancehud";
+    vr::VROverlayError overlayError = vr::VROverlay()->CreateOverlay(
+        hudKey.c_str(), hudKey.c_str(), &m_hudOverlayHandle );
+    if ( overlayError != vr::VROverlayError_None )
+    {
+        LOG( ERROR ) << "Could not create performance hud overlay: "
+                     << vr::VROverlay()->GetOverlayErrorNameFromEnum(
+                            overlayError );
+        m_hudOverlayHandle = vr::k_ulOverlayHandleInvalid;
+        return;
+    }
+    m_hudCanvas.resize( k_hudWidth, k_hudHeight );
+    vr::VROverlay()->SetOverlayWidthInMeters( m_hudOverlayHandle, 0.12f );
+    vr::HmdMatrix34_t hudTransform = { { { 1.0f, 0.0f, 0.0f, -0.15f },
+                                         { 0.0f, 1.0f, 0.0f, -0.1f },
+                                         { 0.0f, 0.0f, 1.0f, -0.4f } } };
+    vr::VROverlay()->SetOverlayTransformTrackedDeviceRelative(
+        m_hudOverlayHandle, vr::k_unTrackedDeviceIndex_Hmd, &hudTransform );
+    m_hudPresentedFrames = m_cumStats.m_nNumFramePresents;
+    m_hudReprojectedFrames = m_cumStats.m_nNumReprojectedFrames;
+    m_hudDroppedFrames = m_cumStats.m_nNumDroppedFrames;
+    updatePerformanceHud();
+    vr::VROverlay()->ShowOverlay( m_hudOverlayHandle );
+}
+
+void StatisticsTabController::destroyPerformanceHud()
+{
+    if ( m_hudOverlayHandle != vr::k_ulOverlayHandleInvalid
+         && vr::VROverlay() )
+    {
+        vr::VROverlay()->DestroyOverlay( m_hudOverlayHandle );
+    }
+    m_hudOverlayHandle = vr::k_ulOverlayHandleInvalid;
+}
+
+void StatisticsTabController::updatePerformanceHud()
+{
+    auto start = std::chrono::steady_clock::now();
+
+    // The worst frame since the last update goes into the graph.
+    vr::Compositor_FrameTiming timings[k_performanceHudUpdateCounter + 1];
+    timings[0].m_nSize = sizeof( vr::Compositor_FrameTiming );
+    auto timingCount = vr::VRCompositor()->GetFrameTimings(
+        timings, k_performanceHudUpdateCounter + 1 );
+    float frameTime = 0.0f;
+    for ( unsigned i = 0; i < timingCount; i++ )
+    {
+        frameTime = std::max( frameTime, timings[i].m_flTotalRenderGpuMs );
+    }
+    m_hudFrameTimes[m_hudHistoryIndex] = frameTime;
+    m_hudHistoryIndex = ( m_hudHistoryIndex + 1 ) % k_hudHistorySize;
+
+    // Rates since the last update.
+    unsigned presented = m_cumStats.m_nNumFramePresents - m_hudPresentedFrames;
+    unsigned reprojected
+        = m_cumStats.m_nNumReprojectedFrames - m_hudReprojectedFrames;
+    unsigned dropped = m_cumStats.m_nNumDroppedFrames - m_hudDroppedFrames;
+    m_hudPresentedFrames = m_cumStats.m_nNumFramePresents;
+    m_hudReprojectedFrames = m_cumStats.m_nNumReprojectedFrames;
+    m_hudDroppedFrames = m_cumStats.m_nNumDroppedFrames;
+    double reprojectedRatio
+        = presented > 0 ? static_cast<double>( reprojected )
+                              / static_cast<double>( presented )
+                        : 0.0;
+
+    char line[32];
+    int y = 4;
+    m_hudCanvas.clear( k_hudBackgroundColor );
+    std::snprintf( line,
+                   sizeof( line ),
+                   "FRAME %6.2f MS",
+                   static_cast<double>( frameTime ) );
+    m_hudCanvas.drawText( 4, y, line, k_hudTextColor );
+    y += k_hudLineHeight;
+    std::snprintf(
+        line, sizeof( line ), "REPROJ %5.1f%%", reprojectedRatio * 100.0 );
+    m_hudCanvas.drawText( 4, y, line, k_hudTextColor );
+    y += k_hudLineHeight;
+    std::snprintf( line, sizeof( line ), "DROPPED %u", dropped );
+    m_hudCanvas.drawText( 4, y, line, k_hudTextColor );
+    y += k_hudLineHeight;
+    std::snprintf( line,
+                   sizeof( line ),
+                   "OVERLAY %5.2f MS",
+                   m_hudEventLoopMilliseconds );
+    m_hudCanvas.drawText( 4, y, line, k_hudTextColor );
+    y += k_hudLineHeight;
+    std::snprintf(
+        line, sizeof( line ), "HUD %6.3f MS", m_hudDrawMilliseconds );
+    m_hudCanvas.drawText( 4, y, line, k_hudTextColor );
+
+    // Graph from oldest to newest, scaled so twice the frame budget fits.
+    float history[k_hudHistorySize];
+    float maxFrameTime = 0.0f;
+    for ( unsigned i = 0; i < k_hudHistorySize; i++ )
+    {
+        history[i]
+            = m_hudFrameTimes[( m_hudHistoryIndex + i ) % k_hudHistorySize];
+        maxFrameTime = std::max( maxFrameTime, history[i] );
+    }
+    float frameBudget = vr::VRSystem()->GetFloatTrackedDeviceProperty(
+        vr::k_unTrackedDeviceIndex_Hmd, vr::Prop_DisplayFrequency_Float );
+    frameBudget = frameBudget > 0.0f ? 1000.0f / frameBudget : 11.1f;
+    float graphMax = std::max( 2.0f * frameBudget, maxFrameTime );
+    const int graphHeight = static_cast<int>( k_hudHeight ) - k_hudGraphTop - 4;
+    m_hudCanvas.drawBars( 4,
+                          k_hudGraphTop,
+                          static_cast<int>( k_hudWidth ) - 8,
+                          graphHeight,
+                          history,
+                          k_hudHistorySize,
+                          graphMax,
+                          k_hudGraphColor );
+    m_hudCanvas.fillRect(
+        4,
+        k_hudGraphTop + graphHeight
+            - static_cast<int>( static_cast<float>( graphHeight )
+                                * frameBudget / graphMax ),
+        static_cast<int>( k_hudWidth ) - 8,
+        1,
+        k_hudBudgetColor );
+
+    m_hudCanvas.upload( m_hudOverlayHandle );
+
+    m_hudDrawMilliseconds = std::chrono::duration<double, std::milli>(
+                                std::chrono::steady_clock::now() - start )
+                                .count();
+}
+
+void StatisticsTabController::updateProcessMonitor()
+{
+    if ( !m_processMonitor.sample() || m_processMonitor.count() == 0 )
+    {
+        return;
+    }
+    const unsigned count
+        = std::min( m_processMonitor.count(), k_cpuBudgetSamples );
+    double cpuPercent = 0.0;
+    for ( unsigned i = m_processMonitor.count() - count;
+          i < m_processMonitor.count();
+          i++ )
+    {
+        cpuPercent += m_processMonitor.at( i ).cpuPercent;
+    }
+    cpuPercent /= count;
+
+    // A budget of 0 disables the warning.
+    bool exceeded = m_overlayCpuBudget > 0.0f && count == k_cpuBudgetSamples
+                    && cpuPercent > static_cast<double>( m_overlayCpuBudget );
+    if ( exceeded != m_overlayCpuBudgetExceeded )
+    {
+        if ( exceeded )
+        {
+            LOG( WARNING ) << "Overlay uses " << cpuPercent
+                           << "% CPU, budget is " << m_overlayCpuBudget << "%";
+        }
+        m_overlayCpuBudgetExceeded = exceeded;
+        emit overlayCpuBudgetExceededChanged( m_overlayCpuBudgetExceeded );
+    }
 }
 
 void StatisticsTabController::eventLoopTick(
@@ -24,49 +291,66 @@ void StatisticsTabController::eventLoopTick(
         &pStats, sizeof( vr::Compositor_CumulativeStats ) );
     if ( pStats.m_nPid != m_cumStats.m_nPid )
     {
+        // The interval so far belongs to the previous application.
+        writeStatisticsRecord();
+        char appKey[vr::k_unMaxApplicationKeyLength] = {};
+        if ( pStats.m_nPid != 0 )
+        {
+            vr::VRApplications()->GetApplicationKeyByProcessId(
+                pStats.m_nPid, appKey, sizeof( appKey ) );
+        }
+        m_logAppKey = appKey;
+        m_logPresentedBase = 0;
+        m_logDroppedBase = 0;
+        m_logReprojectedBase = 0;
         m_cumStats = pStats;
         m_droppedFramesOffset = 0;
         m_reprojectedFramesOffset = 0;
         m_timedOutOffset = 0;
         m_totalRatioPresentedOffset = 0;
         m_totalRatioReprojectedOffset = 0;
+        m_hudPresentedFrames = 0;
+        m_hudReprojectedFrames = 0;
+        m_hudDroppedFrames = 0;
     }
     m_cumStats = pStats;
 
-    auto& m = devicePoses->mDeviceToAbsoluteTracking.m;
-
-    // Hmd Distance //
-    if ( lastPosTimer == 0 )
+    if ( m_performanceHud
+         && m_hudOverlayHandle != vr::k_ulOverlayHandleInvalid )
     {
-        if ( devicePoses[0].bPoseIsValid
-             && devicePoses[0].eTrackingResult
-                    == vr::TrackingResult_Running_OK )
+        // Smoothed, a single slow frame would make the value unreadable.
+        m_hudEventLoopMilliseconds
+            += 0.05
+               * ( parent->eventLoopMilliseconds()
+                   - m_hudEventLoopMilliseconds );
+        if ( hudUpdateCounter >= k_performanceHudUpdateCounter )
         {
-            if ( !lastHmdPosValid )
-            {
-                lastHmdPosValid = true;
-            }
-            else
-            {
-                float delta = static_cast<float>( std::sqrt(
-                    std::pow( m[0][3] - lastHmdPos[0],
-                              2 ) /*+ std::pow(m[1][3] - lastHmdPos[1], 2)*/
-                    + std::pow( m[2][3] - lastHmdPos[2], 2 ) ) );
-                if ( delta >= 0.01f )
-                {
-                    m_hmdDistanceMoved += static_cast<double>( delta );
-                }
-            }
-            lastHmdPos[0] = m[0][3];
-            lastHmdPos[1] = m[1][3];
-            lastHmdPos[2] = m[2][3];
+            updatePerformanceHud();
+            hudUpdateCounter = 0;
         }
         else
         {
-            lastHmdPosValid = false;
+            hudUpdateCounter++;
         }
     }
 
+    if ( processMonitorUpdateCounter >= k_processMonitorUpdateCounter )
+    {
+        updateProcessMonitor();
+        processMonitorUpdateCounter = 0;
+    }
+    else
+    {
+        processMonitorUpdateCounter++;
+    }
+
+    // Hmd Distance //
+    m_hmdOdometer.update(
+        devicePoses[vr::k_unTrackedDeviceIndex_Hmd],
+        std::chrono::duration<double>(
+            std::chrono::steady_clock::now().time_since_epoch() )
+            .count() );
+
     // Controller speeds //
     if ( leftSpeed > m_leftControllerMaxSpeed )
     {
@@ -77,23 +361,28 @@ void StatisticsTabController::eventLoopTick(
         m_rightControllerMaxSpeed = rightSpeed;
     }
 
+    m_logLeftMaxSpeed = std::max( m_logLeftMaxSpeed, leftSpeed );
+    m_logRightMaxSpeed = std::max( m_logRightMaxSpeed, rightSpeed );
+
     // HMD Rotation //
     double roomHmdYawTotal = parent->m_moveCenterTabController.getHmdYawTotal();
     m_hmdRotation = static_cast<float>( roomHmdYawTotal / ( 2.0 * M_PI ) );
 
-    if ( lastPosTimer <= 0 )
+    if ( std::chrono::steady_clock::now() - m_logIntervalStart
+         >= k_statisticsLogInterval )
     {
-        lastPosTimer = 10;
-    }
-    else
-    {
-        lastPosTimer--;
+        writeStatisticsRecord();
     }
 }
 
 float StatisticsTabController::hmdDistanceMoved() const
 {
-    return static_cast<float>( m_hmdDistanceMoved );
+    return static_cast<float>( m_hmdOdometer.floorDistance() );
+}
+
+float StatisticsTabController::hmdDistanceMoved3D() const
+{
+    return static_cast<float>( m_hmdOdometer.distance() );
 }
 
 float StatisticsTabController::hmdRotations() const
@@ -149,17 +438,15 @@ float StatisticsTabController::totalReprojectedRatio() const
 
 void StatisticsTabController::statsDistanceResetClicked()
 {
-    lastHmdPosValid = false;
-    if ( m_hmdDistanceMoved != 0.0 )
-    {
-        m_hmdDistanceMoved = 0.0;
-    }
+    m_logDistanceBase -= m_hmdOdometer.floorDistance();
+    m_hmdOdometer.resetDistance();
 }
 
 void StatisticsTabController::statsRotationResetClicked()
 {
     // rotationResetFlag = true;
     parent->m_moveCenterTabController.resetHmdYawTotal();
+    m_logRotationBase -= m_hmdRotation;
 }
 
 void StatisticsTabController::statsLeftControllerSpeedResetClicked()
@@ -204,4 +491,148 @@ void StatisticsTabController::totalRatioResetClicked()
     m_totalRatioReprojectedOffset = m_cumStats.m_nNumReprojectedFrames;
 }
 
+bool StatisticsTabController::performanceHud() const
+{
+    return m_performanceHud;
+}
+
+float StatisticsTabController::overlayCpuUsage() const
+{
+    return static_cast<float>( m_processMonitor.latest().cpuPercent );
+}
+
+float StatisticsTabController::overlayMemoryUsage() const
+{
+    return static_cast<float>( m_processMonitor.latest().residentBytes )
+           / ( 1024.0f * 1024.0f );
+}
+
+int StatisticsTabController::overlayThreadCount() const
+{
+    return static_cast<int>( m_processMonitor.latest().threads );
+}
+
+float StatisticsTabController::overlayContextSwitches() const
+{
+    return static_cast<float>(
+        m_processMonitor.latest().contextSwitchesPerSecond );
+}
+
+float StatisticsTabController::overlayRunQueueWait() const
+{
+    return static_cast<float>( m_processMonitor.latest().runQueueWaitPercent );
+}
+
+int StatisticsTabController::overlayPriorityChanges() const
+{
+    return static_cast<int>( parent->processScheduler().priorityChanges() );
+}
+
+float StatisticsTabController::overlayCpuBudget() const
+{
+    return m_overlayCpuBudget;
+}
+
+bool StatisticsTabController::overlayCpuBudgetExceeded() const
+{
+    return m_overlayCpuBudgetExceeded;
+}
+
+QVariantList StatisticsTabController::overlayCpuHistory() const
+{
+    QVariantList history;
+    for ( unsigned i = 0; i < m_processMonitor.count(); i++ )
+    {
+        history.push_back( m_processMonitor.at( i ).cpuPercent );
+    }
+    return history;
+}
+
+QVariantList StatisticsTabController::statisticsHistory( int days )
+{
+    const auto now = QDateTime::currentDateTime();
+    QVariantList history;
+    if ( !m_statisticsLog.refresh( now.offsetFromUtc() ) )
+    {
+        return history;
+    }
+    const int64_t today
+        = m_statisticsLog.dayOf( now.toMSecsSinceEpoch() / 1000 );
+    for ( int i = 0; i < days; i++ )
+    {
+        const auto& day = m_statisticsLog.day( today - i );
+        const utils::StatisticsLog::Totals* topApp = nullptr;
+        QString topAppKey;
+        for ( const auto& app : day.apps )
+        {
+            if ( !topApp || app.second.seconds > topApp->seconds )
+            {
+                topApp = &app.second;
+                topAppKey = QString::fromStdString( app.first );
+            }
+        }
+        QVariantMap entry;
+        entry["date"] = now.date().addDays( -i ).toString( Qt::ISODate );
+        entry["minutes"] = day.total.seconds / 60.0;
+        entry["distance"] = day.total.distance;
+        entry["rotations"] = day.total.rotations;
+        entry["sessions"] = day.total.sessions;
+        // Show the name if the application is still installed.
+        char name[256] = {};
+        if ( topApp )
+        {
+            vr::VRApplications()->GetApplicationPropertyString(
+                topAppKey.toStdString().c_str(),
+                vr::VRApplicationProperty_Name_String,
+                name,
+                sizeof( name ) );
+        }
+        entry["topApp"] = name[0] != '\0' ? QString( name ) : topAppKey;
+        history.push_back( entry );
+    }
+    return history;
+}
+
+void StatisticsTabController::setPerformanceHud( bool value, bool notify )
+{
+    if ( m_performanceHud != value )
+    {
+        m_performanceHud = value;
+        if ( m_performanceHud )
+        {
+            createPerformanceHud();
+        }
+        else if ( m_hudOverlayHandle != vr::k_ulOverlayHandleInvalid )
+        {
+            vr::VROverlay()->HideOverlay( m_hudOverlayHandle );
+        }
+        auto settings = OverlayController::appSettings();
+        settings->beginGroup( "statisticsSettings" );
+        settings->setValue( "performanceHud", m_performanceHud );
+        settings->endGroup();
+        settings->sync();
+        if ( notify )
+        {
+            emit performanceHudChanged( m_performanceHud );
+        }
+    }
+}
+
+void StatisticsTabController::setOverlayCpuBudget( float value, bool notify )
+{
+    if ( m_overlayCpuBudget != value )
+    {
+        m_overlayCpuBudget = value;
+        auto settings = OverlayController::appSettings();
+        settings->beginGroup( "statisticsSettings" );
+        settings->setValue( "overlayCpuBudget", m_overlayCpuBudget );
+        settings->endGroup();
+        settings->sync();
+        if ( notify )
+        {
+            emit overlayCpuBudgetChanged( m_overlayCpuBudget );
+        }
+    }
+}
+
 } // namespace advsettings
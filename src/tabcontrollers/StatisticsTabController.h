@@ -2,7 +2,14 @@
 #pragma once
 
 #include <QObject>
+#include <QVariantList>
+#include <chrono>
+#include <string>
 #include <openvr.h>
+#include "../utils/RasterCanvas.h"
+#include "../utils/ProcessMonitor.h"
+#include "../utils/Odometer.h"
+#include "../utils/StatisticsLog.h"
 
 class QQuickWindow;
 // application namespace
@@ -15,6 +22,7 @@ class StatisticsTabController : public QObject
 {
     Q_OBJECT
     Q_PROPERTY( float hmdDistanceMoved READ hmdDistanceMoved )
+    Q_PROPERTY( float hmdDistanceMoved3D READ hmdDistanceMoved3D )
     Q_PROPERTY( float hmdRotations READ hmdRotations )
     Q_PROPERTY( float leftControllerMaxSpeed READ leftControllerMaxSpeed )
     Q_PROPERTY( float rightControllerMaxSpeed READ rightControllerMaxSpeed )
@@ -23,6 +31,18 @@ class StatisticsTabController : public QObject
     Q_PROPERTY( int reprojectedFrames READ reprojectedFrames )
     Q_PROPERTY( int timedOut READ timedOut )
     Q_PROPERTY( float totalReprojectedRatio READ totalReprojectedRatio )
+    Q_PROPERTY( bool performanceHud READ performanceHud WRITE
+                    setPerformanceHud NOTIFY performanceHudChanged )
+    Q_PROPERTY( float overlayCpuUsage READ overlayCpuUsage )
+    Q_PROPERTY( float overlayMemoryUsage READ overlayMemoryUsage )
+    Q_PROPERTY( int overlayThreadCount READ overlayThreadCount )
+    Q_PROPERTY( float overlayContextSwitches READ overlayContextSwitches )
+    Q_PROPERTY( float overlayRunQueueWait READ overlayRunQueueWait )
+    Q_PROPERTY( int overlayPriorityChanges READ overlayPriorityChanges )
+    Q_PROPERTY( float overlayCpuBudget READ overlayCpuBudget WRITE
+                    setOverlayCpuBudget NOTIFY overlayCpuBudgetChanged )
+    Q_PROPERTY( bool overlayCpuBudgetExceeded READ overlayCpuBudgetExceeded
+                    NOTIFY overlayCpuBudgetExceededChanged )
 
 private:
     OverlayController* parent;
@@ -33,17 +53,14 @@ private:
     int rotationDir = 0;
     int64_t rotationCounter = 0;
     float lastYaw = -1.0f;
-    unsigned lastPosTimer = 0;
-    float lastHmdPos[3];
-    bool lastHmdPosValid = false;
 
     float m_hmdRotation = 0.0f;
-    double m_hmdDistanceMoved = 0.0;
+    utils::Odometer m_hmdOdometer;
 
     float m_leftControllerMaxSpeed = 0.0f;
     float m_rightControllerMaxSpeed = 0.0f;
 
-    vr::Compositor_CumulativeStats m_cumStats;
+    vr::Compositor_CumulativeStats m_cumStats = {};
     unsigned m_presentedFramesOffset = 0;
     unsigned m_droppedFramesOffset = 0;
     unsigned m_reprojectedFramesOffset = 0;
@@ -51,15 +68,61 @@ private:
     unsigned m_totalRatioPresentedOffset = 0;
     unsigned m_totalRatioReprojectedOffset = 0;
 
+    // Performance HUD, drawn on the CPU and independent of the dashboard.
+    static constexpr unsigned k_hudHistorySize = 64;
+    bool m_performanceHud = false;
+    vr::VROverlayHandle_t m_hudOverlayHandle = vr::k_ulOverlayHandleInvalid;
+    utils::RasterCanvas m_hudCanvas;
+    float m_hudFrameTimes[k_hudHistorySize] = {};
+    unsigned m_hudHistoryIndex = 0;
+    unsigned m_hudPresentedFrames = 0;
+    unsigned m_hudReprojectedFrames = 0;
+    unsigned m_hudDroppedFrames = 0;
+    double m_hudEventLoopMilliseconds = 0.0;
+    double m_hudDrawMilliseconds = 0.0;
+    unsigned hudUpdateCounter = 0;
+
+    void createPerformanceHud();
+    void updatePerformanceHud();
+
+    // Resource usage of the overlay process itself.
+    utils::ProcessMonitor m_processMonitor;
+    float m_overlayCpuBudget = 5.0f;
+    bool m_overlayCpuBudgetExceeded = false;
+    unsigned processMonitorUpdateCounter = 0;
+
+    void updateProcessMonitor();
+
+    // Statistics history, one record per interval and application.
+    utils::StatisticsLog m_statisticsLog;
+    int64_t m_sessionId = 0;
+    std::string m_logAppKey;
+    std::chrono::steady_clock::time_point m_logIntervalStart;
+    double m_logDistanceBase = 0.0;
+    float m_logRotationBase = 0.0f;
+    float m_logLeftMaxSpeed = 0.0f;
+    float m_logRightMaxSpeed = 0.0f;
+    unsigned m_logPresentedBase = 0;
+    unsigned m_logDroppedBase = 0;
+    unsigned m_logReprojectedBase = 0;
+
+    void writeStatisticsRecord();
+
 public:
+    ~StatisticsTabController();
+
     void initStage1();
     void initStage2( OverlayController* parent, QQuickWindow* widget );
 
     void eventLoopTick( vr::TrackedDevicePose_t* devicePoses,
                         float leftSpeed,
                         float rightSpeed );
+    // Called from OverlayController::Shutdown() while OpenVR is still up.
+    void destroyPerformanceHud();
 
+    // Projected onto the floor.
     float hmdDistanceMoved() const;
+    float hmdDistanceMoved3D() const;
     float hmdRotations() const;
     float rightControllerMaxSpeed() const;
     float leftControllerMaxSpeed() const;
@@ -69,6 +132,19 @@ public:
     unsigned reprojectedFrames() const;
     unsigned timedOut() const;
     float totalReprojectedRatio() const;
+    bool performanceHud() const;
+
+    float overlayCpuUsage() const;
+    float overlayMemoryUsage() const;
+    int overlayThreadCount() const;
+    float overlayContextSwitches() const;
+    float overlayRunQueueWait() const;
+    int overlayPriorityChanges() const;
+    float overlayCpuBudget() const;
+    bool overlayCpuBudgetExceeded() const;
+    Q_INVOKABLE QVariantList overlayCpuHistory() const;
+    // Totals of the last days from the statistics log, newest first.
+    Q_INVOKABLE QVariantList statisticsHistory( int days );
 
 public slots:
     void statsDistanceResetClicked();
@@ -80,6 +156,14 @@ public slots:
     void reprojectedFramesResetClicked();
     void timedOutResetClicked();
     void totalRatioResetClicked();
+
+    void setPerformanceHud( bool value, bool notify = true );
+    void setOverlayCpuBudget( float value, bool notify = true );
+
+signals:
+    void performanceHudChanged( bool value );
+    void overlayCpuBudgetChanged( float value );
+    void overlayCpuBudgetExceededChanged( bool value );
 };
 
 } // namespace advsettings
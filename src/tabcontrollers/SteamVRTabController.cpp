@@ -20,6 +20,11 @@ void SteamVRTabController::initStage2( OverlayController* var_parent,
     this->widget = var_widget;
 }
 
+void SteamVRTabController::refreshSettings() noexcept
+{
+    settingsUpdateCounter = k_steamVrSettingsUpdateCounter;
+}
+
 void SteamVRTabController::eventLoopTick()
 {
     if ( settingsUpdateCounter >= k_steamVrSettingsUpdateCounter )
@@ -196,81 +201,18 @@ void SteamVRTabController::deleteSteamVRProfile( const unsigned index )
 
 void SteamVRTabController::reloadSteamVRProfiles()
 {
-    steamvrProfiles.clear();
-    auto settings = OverlayController::appSettings();
-    settings->beginGroup( "steamVRSettings" );
-    auto profileCount = settings->beginReadArray( "steamVRProfiles" );
-    for ( int i = 0; i < profileCount; i++ )
-    {
-        settings->setArrayIndex( i );
-        steamvrProfiles.emplace_back();
-        auto& entry = steamvrProfiles[static_cast<size_t>( i )];
-        entry.profileName
-            = settings->value( "profileName" ).toString().toStdString();
-        entry.includesSupersampling
-            = settings->value( "includesSupersampling", false ).toBool();
-        if ( entry.includesSupersampling )
-        {
-            entry.supersampleOverride
-                = settings->value( "supersamplingOverride", false ).toBool();
-            entry.supersampling
-                = settings->value( "supersampling", 1.0f ).toFloat();
-        }
-        entry.includesSupersampleFiltering
-            = settings->value( "includesSupersampleFiltering", false ).toBool();
-        if ( entry.includesSupersampleFiltering )
-        {
-            entry.supersampleFiltering
-                = settings->value( "supersampleFiltering", true ).toBool();
-        }
-        entry.includesMotionSmoothing
-            = settings->value( "includesMotionSmoothing", false ).toBool();
-        if ( entry.includesMotionSmoothing )
-        {
-            entry.motionSmooth
-                = settings->value( "motionSmooth", true ).toBool();
-        }
-    }
-    settings->endArray();
-    settings->endGroup();
+    steamvrProfiles = steamvr_profile::k_schema.readIniArray(
+        *OverlayController::appSettings(),
+        "steamVRSettings",
+        "steamVRProfiles" );
 }
 
 void SteamVRTabController::saveSteamVRProfiles()
 {
-    auto settings = OverlayController::appSettings();
-    settings->beginGroup( "steamVRSettings" );
-    settings->beginWriteArray( "steamVRProfiles" );
-    unsigned i = 0;
-    for ( auto& p : steamvrProfiles )
-    {
-        settings->setArrayIndex( static_cast<int>( i ) );
-        settings->setValue( "profileName",
-                            QString::fromStdString( p.profileName ) );
-        settings->setValue( "includesSupersampling", p.includesSupersampling );
-        if ( p.includesSupersampling )
-        {
-            settings->setValue( "supersamplingOverride",
-                                p.supersampleOverride );
-            settings->setValue( "supersampling", p.supersampling );
-        }
-        settings->setValue( "includesSupersampleFiltering",
-                            p.includesSupersampleFiltering );
-        if ( p.includesSupersampleFiltering )
-        {
-            settings->setValue( "supersampleFiltering",
-                                p.supersampleFiltering );
-        }
-        settings->setValue( "includesMotionSmoothing",
-                            p.includesMotionSmoothing );
-        if ( p.includesMotionSmoothing )
-        {
-            settings->setValue( "motionSmooth", p.motionSmooth );
-        }
-
-        i++;
-    }
-    settings->endArray();
-    settings->endGroup();
+    steamvr_profile::k_schema.writeIniArray( *OverlayController::appSettings(),
+                                             "steamVRSettings",
+                                             "steamVRProfiles",
+                                             steamvrProfiles );
 }
 int SteamVRTabController::getSteamVRProfileCount()
 {
@@ -2,6 +2,7 @@
 #pragma once
 
 #include <QObject>
+#include "../utils/ProfileSchema.h"
 
 class QQuickWindow;
 // application namespace
@@ -18,12 +19,40 @@ struct SteamVRProfile
     float supersampling = 1.0f;
 
     bool includesSupersampleFiltering = false;
-    bool supersampleFiltering = false;
-    bool motionSmooth = false;
+    bool supersampleFiltering = true;
+    bool motionSmooth = true;
     bool includesMotionSmoothing = false;
     bool supersampleOverride = false;
 };
 
+// How SteamVRProfile is stored in the settings, see utils::ProfileSchema.
+namespace steamvr_profile
+{
+    using Profile = SteamVRProfile;
+
+    inline constexpr auto k_schema = utils::profileSchema<Profile>(
+        1,
+        utils::profileField( "profileName", &Profile::profileName ),
+        utils::profileField( "includesSupersampling",
+                             &Profile::includesSupersampling ),
+        utils::profileField( "supersamplingOverride",
+                             &Profile::supersampleOverride,
+                             &Profile::includesSupersampling ),
+        utils::profileField( "supersampling",
+                             &Profile::supersampling,
+                             &Profile::includesSupersampling ),
+        utils::profileField( "includesSupersampleFiltering",
+                             &Profile::includesSupersampleFiltering ),
+        utils::profileField( "supersampleFiltering",
+                             &Profile::supersampleFiltering,
+                             &Profile::includesSupersampleFiltering ),
+        utils::profileField( "includesMotionSmoothing",
+                             &Profile::includesMotionSmoothing ),
+        utils::profileField( "motionSmooth",
+                             &Profile::motionSmooth,
+                             &Profile::includesMotionSmoothing ) );
+} // namespace steamvr_profile
+
 class SteamVRTabController : public QObject
 {
     Q_OBJECT
@@ -60,6 +89,8 @@ public:
     void initStage2( OverlayController* parent, QQuickWindow* widget );
 
     void eventLoopTick();
+    // The values shown on the page are read again with the next tick.
+    void refreshSettings() noexcept;
 
     float superSampling() const;
     bool motionSmoothing() const;
@@ -2,6 +2,7 @@
 #include <QQuickWindow>
 #include <QApplication>
 #include "../overlaycontroller.h"
+#include <chrono>
 #include <thread>
 #ifdef _WIN32
 #    include "keyboardinput/KeyboardInputWindows.h"
@@ -272,51 +273,77 @@ void UtilitiesTabController::modAlarmTimeMinute( int value, bool notify )
     }
 }
 
-QString getBatteryIconPath( int batteryState )
+namespace
 {
-    QString batteryPrefix = "/res/img/battery/battery_";
-    return QStandardPaths::locate(
-        QStandardPaths::AppDataLocation,
-        batteryPrefix + QString::number( batteryState ) + ".png" );
-}
+    // How long the non-modal alarm banner stays up.
+    constexpr auto k_alarmNotificationDuration = std::chrono::seconds( 10 );
 
-vr::VROverlayHandle_t createBatteryOverlay( vr::TrackedDeviceIndex_t index )
-{
-    vr::VROverlayHandle_t handle = vr::k_ulOverlayHandleInvalid;
-    std::string batteryKey = std::string( OverlayController::applicationKey )
-                             + ".battery." + std::to_string( index );
-    vr::VROverlayError overlayError = vr::VROverlay()->CreateOverlay(
-        batteryKey.c_str(), batteryKey.c_str(), &handle );
-    if ( overlayError == vr::VROverlayError_None )
+    // Battery outline with one segment per fifth of charge.
+    void drawBatteryNotification( utils::RasterCanvas& canvas,
+                                  int batteryState )
     {
-        QString batteryIconPath = getBatteryIconPath( 0 );
-        if ( QFile::exists( batteryIconPath ) )
+        constexpr uint32_t outline = 0xFFFFFFFF;
+        uint32_t fill = 0x2B8A3EFF;
+        if ( batteryState <= 1 )
         {
-            vr::VROverlay()->SetOverlayFromFile(
-                handle, batteryIconPath.toStdString().c_str() );
-            vr::VROverlay()->SetOverlayWidthInMeters( handle, 0.05f );
-            vr::HmdMatrix34_t notificationTransform
-                = { { { 1.0f, 0.0f, 0.0f, 0.00f },
-                      { 0.0f, -1.0f, 0.0f, 0.01f },
-                      { 0.0f, 0.0f, -1.0f, -0.013f } } };
-            vr::VROverlay()->SetOverlayTransformTrackedDeviceRelative(
-                handle, index, &notificationTransform );
-            LOG( INFO ) << "Created battery overlay for device " << index;
+            fill = 0xE03131FF;
         }
-        else
+        else if ( batteryState == 2 )
+        {
+            fill = 0xF08C00FF;
+        }
+        canvas.clear( 0x00000000 );
+        canvas.fillRect( 2, 8, 56, 24, outline );
+        canvas.fillRect( 58, 14, 4, 12, outline );
+        canvas.fillRect( 4, 10, 52, 20, 0x000000FF );
+        for ( int i = 0; i < batteryState && i < 5; i++ )
         {
-            LOG( ERROR ) << "Could not find battery icon \"" << batteryIconPath
-                         << "\"";
+            canvas.fillRect( 6 + i * 10, 12, 8, 16, fill );
         }
     }
-    else
+
+    void drawAlarmNotification( utils::RasterCanvas& canvas,
+                                const char* text )
     {
-        LOG( ERROR ) << "Could not create ptt notification overlay: "
-                     << vr::VROverlay()->GetOverlayErrorNameFromEnum(
-                            overlayError );
+        constexpr int scale = 2;
+        canvas.clear( 0x000000C0 );
+        canvas.fillRect(
+            0, 0, static_cast<int>( canvas.width() ), 2, 0xF08C00FF );
+        const int textX = ( static_cast<int>( canvas.width() )
+                            - utils::RasterCanvas::textWidth( text, scale ) )
+                          / 2;
+        const int textY = ( static_cast<int>( canvas.height() )
+                            - utils::RasterCanvas::glyphHeight * scale )
+                          / 2;
+        canvas.drawText( textX, textY, text, 0xFFFFFFFF, scale );
     }
+} // namespace
 
-    return handle;
+void UtilitiesTabController::showAlarmNotification( const char* text )
+{
+    auto& notifications = m_parent->notifications();
+    if ( m_alarmNotification == utils::NotificationCompositor::invalidId )
+    {
+        m_alarmNotification = notifications.create( 256, 40, 0.25f );
+        vr::HmdMatrix34_t notificationTransform
+            = { { { 1.0f, 0.0f, 0.0f, 0.0f },
+                  { 0.0f, 1.0f, 0.0f, 0.1f },
+                  { 0.0f, 0.0f, 1.0f, -0.5f } } };
+        notifications.attachToDevice( m_alarmNotification,
+                                      vr::k_unTrackedDeviceIndex_Hmd,
+                                      notificationTransform );
+    }
+    if ( auto canvas = notifications.draw( m_alarmNotification ) )
+    {
+        drawAlarmNotification( *canvas, text );
+        notifications.setVisible( m_alarmNotification, true );
+        m_alarmNotificationTime = std::chrono::steady_clock::now();
+    }
+}
+
+void UtilitiesTabController::refreshSettings() noexcept
+{
+    settingsUpdateCounter = k_utilitiesSettingsUpdateCounter;
 }
 
 void UtilitiesTabController::eventLoopTick()
@@ -419,75 +446,26 @@ void UtilitiesTabController::eventLoopTick()
                 }
                 else
                 {
-                    vr::VRNotificationId notificationId;
-                    vr::EVRInitError eError;
-                    vr::IVRNotifications* vrnotification
-                        = static_cast<vr::IVRNotifications*>(
-                            vr::VR_GetGenericInterface(
-                                vr::IVRNotifications_Version, &eError ) );
-                    if ( eError != vr::VRInitError_None )
-                    {
-                        LOG( ERROR )
-                            << "Error while getting IVRNotifications interface"
-                            << vr::VR_GetVRInitErrorAsEnglishDescription(
-                                   eError );
-                        vrnotification = nullptr;
-                    }
-                    else
-                    {
-                        vr::NotificationBitmap_t* messageIconPtr = nullptr;
-                        /*
-                        // Can i even create this object on the stack, who takes
-                        ownership? vr::NotificationBitmap_t messageIcon;
-
-                        // First get image width and height
-                        vr::VROverlay()->GetOverlayImageData(parent->overlayThumbnailHandle(),
-                        nullptr, 0, (uint32_t*)&messageIcon.m_nWidth,
-                        (uint32_t*)&messageIcon.m_nHeight);
-
-                        messageIcon.m_nBytesPerPixel = 4;
-                        unsigned bufferSize =
-                        messageIcon.m_nWidth*messageIcon.m_nHeight*messageIcon.m_nBytesPerPixel;
-
-                        // Can I delete this buffer after this section? Who
-                        takes ownership? std::unique_ptr<char> imageBuffer;
-                        imageBuffer.reset(new char[bufferSize]);
-                        messageIcon.m_pImageData = imageBuffer.get();
-
-                        // Get image data
-                        auto iconError =
-                        vr::VROverlay()->GetOverlayImageData(parent->overlayThumbnailHandle(),
-                        messageIcon.m_pImageData, bufferSize,
-                        (uint32_t*)&messageIcon.m_nWidth,
-                        (uint32_t*)&messageIcon.m_nHeight); if (iconError !=
-                        vr::VROverlayError_None) { LOG(ERROR) << "Error while
-                        getting message overlay icon: " <<
-                        vr::VROverlay()->GetOverlayErrorNameFromEnum(iconError);
-                        } else {
-                            messageIconPtr = &messageIcon;
-                        }
-                        */
-                        auto nError = vrnotification->CreateNotification(
-                            m_parent->overlayHandle(),
-                            666,
-                            vr::EVRNotificationType_Transient,
-                            alarmMessageBuffer,
-                            vr::EVRNotificationStyle_Application,
-                            messageIconPtr,
-                            &notificationId );
-                        if ( nError != vr::VRNotificationError_OK )
-                        {
-                            LOG( ERROR )
-                                << "Error while creating notification: "
-                                << nError;
-                            vrnotification = nullptr;
-                        }
-                    }
+                    char bannerBuffer[32];
+                    std::snprintf( bannerBuffer,
+                                   32,
+                                   "Alarm %02i:%02i",
+                                   alarmTimeHour(),
+                                   alarmTimeMinute() );
+                    showAlarmNotification( bannerBuffer );
                 }
             }
             m_alarmLastCheckTime = now;
         }
 
+        // Steady clock, QTime wraps at midnight.
+        if ( m_parent->notifications().isVisible( m_alarmNotification )
+             && std::chrono::steady_clock::now() - m_alarmNotificationTime
+                    >= k_alarmNotificationDuration )
+        {
+            m_parent->notifications().setVisible( m_alarmNotification, false );
+        }
+
         // attach battery overlay to all tracked devices that aren't a
         // controller or hmd
         for ( vr::TrackedDeviceIndex_t i = 0; i < vr::k_unMaxTrackedDeviceCount;
@@ -498,30 +476,33 @@ void UtilitiesTabController::eventLoopTick()
             if ( deviceClass
                  == vr::ETrackedDeviceClass::TrackedDeviceClass_GenericTracker )
             {
-                if ( m_batteryOverlayHandles[i] == 0 )
+                auto& notifications = m_parent->notifications();
+                if ( m_batteryNotifications[i]
+                     == utils::NotificationCompositor::invalidId )
                 {
-                    LOG( INFO ) << "Creating battery overlay for device " << i;
-                    m_batteryOverlayHandles[i] = createBatteryOverlay( i );
-                    m_batteryVisible[i] = true;
-                }
-
-                bool shouldShow = vr::VROverlay()->IsDashboardVisible();
-
-                if ( shouldShow != m_batteryVisible[i] )
-                {
-                    if ( shouldShow )
-                    {
-                        vr::VROverlay()->ShowOverlay(
-                            m_batteryOverlayHandles[i] );
-                    }
-                    else
+                    // Fails quietly while the compositor waits to retry.
+                    m_batteryNotifications[i]
+                        = notifications.create( 64, 40, 0.05f );
+                    if ( m_batteryNotifications[i]
+                         != utils::NotificationCompositor::invalidId )
                     {
-                        vr::VROverlay()->HideOverlay(
-                            m_batteryOverlayHandles[i] );
+                        LOG( INFO ) << "Created battery overlay for device "
+                                    << i;
                     }
-                    m_batteryVisible[i] = shouldShow;
+                    vr::HmdMatrix34_t notificationTransform
+                        = { { { 1.0f, 0.0f, 0.0f, 0.00f },
+                              { 0.0f, -1.0f, 0.0f, 0.01f },
+                              { 0.0f, 0.0f, -1.0f, -0.013f } } };
+                    notifications.attachToDevice(
+                        m_batteryNotifications[i], i, notificationTransform );
+                    m_batteryState[i] = -1;
                 }
 
+                // Only a flag, the compositor shows or hides it once per
+                // frame if it changed.
+                notifications.setVisible( m_batteryNotifications[i],
+                                          m_parent->isDashboardVisible() );
+
                 bool hasBatteryStatus
                     = vr::VRSystem()->GetBoolTrackedDeviceProperty(
                         i,
@@ -539,22 +520,14 @@ void UtilitiesTabController::eventLoopTick()
 
                     if ( batteryState != m_batteryState[i] )
                     {
-                        LOG( INFO )
-                            << "Updating battery overlay for device " << i
-                            << " to " << batteryState << "(" << battery << ")"
-                            << QString::number( m_batteryOverlayHandles[i] );
-                        QString batteryIconPath
-                            = getBatteryIconPath( batteryState );
-                        if ( QFile::exists( batteryIconPath ) )
-                        {
-                            vr::VROverlay()->SetOverlayFromFile(
-                                m_batteryOverlayHandles[i],
-                                batteryIconPath.toStdString().c_str() );
-                        }
-                        else
+                        if ( auto canvas
+                             = notifications.draw( m_batteryNotifications[i] ) )
                         {
-                            LOG( ERROR ) << "Could not find battery icon \""
-                                         << batteryIconPath << "\"";
+                            LOG( INFO )
+                                << "Updating battery overlay for device " << i
+                                << " to " << batteryState << "(" << battery
+                                << ")";
+                            drawBatteryNotification( *canvas, batteryState );
                         }
                         m_batteryState[i] = batteryState;
                     }
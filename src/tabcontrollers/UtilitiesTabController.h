@@ -4,8 +4,10 @@
 #include <QObject>
 #include <QTime>
 #include <openvr.h>
+#include <chrono>
 #include <memory>
 #include "KeyboardInput.h"
+#include "../utils/NotificationCompositor.h"
 
 class QQuickWindow;
 // application namespace
@@ -44,10 +46,15 @@ private:
     QTime m_alarmLastCheckTime;
     bool m_steamDesktopOverlayAvailable = false;
     float m_steamDesktopOverlayWidth = 4.0f;
-    vr::VROverlayHandle_t m_batteryOverlayHandles[vr::k_unMaxTrackedDeviceCount]
-        = { 0 };
-    int m_batteryState[vr::k_unMaxTrackedDeviceCount];
-    bool m_batteryVisible[vr::k_unMaxTrackedDeviceCount];
+    utils::NotificationCompositor::Id
+        m_batteryNotifications[vr::k_unMaxTrackedDeviceCount]
+        = {};
+    int m_batteryState[vr::k_unMaxTrackedDeviceCount] = {};
+    utils::NotificationCompositor::Id m_alarmNotification
+        = utils::NotificationCompositor::invalidId;
+    std::chrono::steady_clock::time_point m_alarmNotificationTime;
+
+    void showAlarmNotification( const char* text );
 
     std::unique_ptr<KeyboardInput> keyboardInput;
 
@@ -56,6 +63,8 @@ public:
     void initStage2( OverlayController* var_parent, QQuickWindow* var_widget );
 
     void eventLoopTick();
+    // The values shown on the page are read again with the next tick.
+    void refreshSettings() noexcept;
 
     bool alarmEnabled() const;
     bool alarmIsModal() const;
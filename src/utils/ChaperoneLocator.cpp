@@ -0,0 +1,242 @@
+#include "ChaperoneLocator.h"
+#include <algorithm>
+#include <cmath>
+
+namespace utils
+{
+namespace
+{
+    // Edge length of the grid cells, in m.
+    constexpr float k_cellSize = 1.0f;
+    // Larger spaces aren't entered into the grid.
+    constexpr int k_maxSpaceCells = 1024;
+    // Keeps the cell indices in range whatever the finite coordinates are.
+    constexpr float k_maxCell = 1.0e6f;
+    constexpr char k_signatureSeparator = ';';
+
+    int cellOf( float value ) noexcept
+    {
+        const float cell = value / k_cellSize;
+        return static_cast<int>(
+            std::floor( std::min( std::max( cell, -k_maxCell ), k_maxCell ) ) );
+    }
+} // namespace
+
+uint64_t ChaperoneLocator::cellKey( int x, int z ) noexcept
+{
+    return ( static_cast<uint64_t>( static_cast<uint32_t>( x ) ) << 32 )
+           | static_cast<uint32_t>( z );
+}
+
+bool ChaperoneLocator::contains( const Space& space,
+                                 float x,
+                                 float z ) noexcept
+{
+    if ( x < space.minX || x > space.maxX || z < space.minZ
+         || z > space.maxZ )
+    {
+        return false;
+    }
+    // Crossing number of a ray in +x direction.
+    bool inside = false;
+    const float* corners = space.corners.data();
+    const size_t count = space.corners.size() / 2;
+    for ( size_t i = 0, j = count - 1; i < count; j = i++ )
+    {
+        const float xi = corners[2 * i];
+        const float zi = corners[2 * i + 1];
+        const float xj = corners[2 * j];
+        const float zj = corners[2 * j + 1];
+        if ( ( zi > z ) != ( zj > z )
+             && x < xi + ( z - zi ) * ( xj - xi ) / ( zj - zi ) )
+        {
+            inside = !inside;
+        }
+    }
+    return inside;
+}
+
+bool ChaperoneLocator::isInSetup( const Space& space ) const
+{
+    if ( space.references.empty() )
+    {
+        return true;
+    }
+    // Both are sorted.
+    auto a = space.references.begin();
+    auto b = _setup.begin();
+    while ( a != space.references.end() && b != _setup.end() )
+    {
+        if ( *a < *b )
+        {
+            ++a;
+        }
+        else if ( *b < *a )
+        {
+            ++b;
+        }
+        else
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+std::vector<std::string>
+    ChaperoneLocator::splitSignature( const std::string& value )
+{
+    std::vector<std::string> references;
+    size_t start = 0;
+    while ( start < value.size() )
+    {
+        size_t end = value.find( k_signatureSeparator, start );
+        if ( end == std::string::npos )
+        {
+            end = value.size();
+        }
+        if ( end > start )
+        {
+            references.emplace_back( value, start, end - start );
+        }
+        start = end + 1;
+    }
+    std::sort( references.begin(), references.end() );
+    return references;
+}
+
+std::string
+    ChaperoneLocator::joinSignature( std::vector<std::string> references )
+{
+    std::sort( references.begin(), references.end() );
+    std::string value;
+    for ( const auto& reference : references )
+    {
+        if ( !value.empty() )
+        {
+            value += k_signatureSeparator;
+        }
+        value += reference;
+    }
+    return value;
+}
+
+void ChaperoneLocator::clear()
+{
+    _spaces.clear();
+    _cells.clear();
+    _largeSpaces.clear();
+}
+
+void ChaperoneLocator::add( int id,
+                            const std::string& signature,
+                            const vr::HmdQuad_t* quads,
+                            uint32_t count,
+                            const vr::HmdMatrix34_t& standingToRaw )
+{
+    if ( count < 3 )
+    {
+        return;
+    }
+    Space space;
+    space.id = id;
+    space.references = splitSignature( signature );
+    space.isInSetup = isInSetup( space );
+    space.corners.resize( 2 * count );
+    const auto& m = standingToRaw.m;
+    for ( uint32_t i = 0; i < count; i++ )
+    {
+        // Same corners ChaperoneUtils uses, they lie on the floor.
+        const auto& c = quads[i].vCorners[0].v;
+        const float x = m[0][0] * c[0] + m[0][1] * c[1] + m[0][2] * c[2]
+                        + m[0][3];
+        const float z = m[2][0] * c[0] + m[2][1] * c[1] + m[2][2] * c[2]
+                        + m[2][3];
+        if ( !std::isfinite( x ) || !std::isfinite( z ) )
+        {
+            return;
+        }
+        space.corners[2 * i] = x;
+        space.corners[2 * i + 1] = z;
+        if ( i == 0 )
+        {
+            space.minX = space.maxX = x;
+            space.minZ = space.maxZ = z;
+        }
+        else
+        {
+            space.minX = std::min( space.minX, x );
+            space.maxX = std::max( space.maxX, x );
+            space.minZ = std::min( space.minZ, z );
+            space.maxZ = std::max( space.maxZ, z );
+        }
+    }
+    for ( uint32_t i = 0, j = count - 1; i < count; j = i++ )
+    {
+        space.area += space.corners[2 * j] * space.corners[2 * i + 1]
+                      - space.corners[2 * i] * space.corners[2 * j + 1];
+    }
+    space.area = std::abs( space.area ) / 2.0f;
+
+    const auto index = static_cast<uint32_t>( _spaces.size() );
+    const int minCellX = cellOf( space.minX );
+    const int maxCellX = cellOf( space.maxX );
+    const int minCellZ = cellOf( space.minZ );
+    const int maxCellZ = cellOf( space.maxZ );
+    // Up to 2e6 cells per axis, their product only fits into 64 bits.
+    const int64_t cells
+        = ( static_cast<int64_t>( maxCellX ) - minCellX + 1 )
+          * ( static_cast<int64_t>( maxCellZ ) - minCellZ + 1 );
+    if ( cells > k_maxSpaceCells )
+    {
+        _largeSpaces.push_back( index );
+    }
+    else
+    {
+        for ( int x = minCellX; x <= maxCellX; x++ )
+        {
+            for ( int z = minCellZ; z <= maxCellZ; z++ )
+            {
+                _cells[cellKey( x, z )].push_back( index );
+            }
+        }
+    }
+    _spaces.push_back( std::move( space ) );
+}
+
+void ChaperoneLocator::setSetup( const std::string& signature )
+{
+    _setup = splitSignature( signature );
+    for ( auto& space : _spaces )
+    {
+        space.isInSetup = isInSetup( space );
+    }
+}
+
+int ChaperoneLocator::locate( float rawX, float rawZ ) const
+{
+    const Space* found = nullptr;
+    auto test = [&]( uint32_t index ) {
+        const Space& space = _spaces[index];
+        if ( space.isInSetup && ( !found || space.area < found->area )
+             && contains( space, rawX, rawZ ) )
+        {
+            found = &space;
+        }
+    };
+    auto cell = _cells.find( cellKey( cellOf( rawX ), cellOf( rawZ ) ) );
+    if ( cell != _cells.end() )
+    {
+        for ( auto index : cell->second )
+        {
+            test( index );
+        }
+    }
+    for ( auto index : _largeSpaces )
+    {
+        test( index );
+    }
+    return found ? found->id : -1;
+}
+
+} // end namespace utils
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <openvr.h>
+
+namespace utils
+{
+/*!
+Finds the saved space (chaperone profile) a point on the floor is in.
+
+A space is the floor polygon of its bounds in raw tracking coordinates, which
+stay the same when the playspace is moved, together with the serial numbers
+of the tracking references (base stations, sensors) that were connected when
+it was saved. Raw coordinates of different tracking setups have nothing to do
+with each other, so only spaces sharing a tracking reference with the current
+setup are considered. Spaces saved without any are considered everywhere.
+
+The bounding boxes of the polygons are entered into a uniform grid, a query
+only tests the polygons overlapping the cell of the point. If spaces overlap
+the smallest one containing the point is returned.
+*/
+class ChaperoneLocator
+{
+private:
+    struct Space
+    {
+        int id = -1;
+        // Sorted serial numbers.
+        std::vector<std::string> references;
+        bool isInSetup = true;
+        // Floor polygon, x and z of every corner.
+        std::vector<float> corners;
+        float minX = 0.0f;
+        float maxX = 0.0f;
+        float minZ = 0.0f;
+        float maxZ = 0.0f;
+        float area = 0.0f;
+    };
+
+    std::vector<Space> _spaces;
+    std::unordered_map<uint64_t, std::vector<uint32_t>> _cells;
+    // Spaces covering too many cells, tested on every query.
+    std::vector<uint32_t> _largeSpaces;
+    std::vector<std::string> _setup;
+
+    static uint64_t cellKey( int x, int z ) noexcept;
+    static bool contains( const Space& space, float x, float z ) noexcept;
+    bool isInSetup( const Space& space ) const;
+
+public:
+    static std::vector<std::string> splitSignature( const std::string& value );
+    // Sorts the serial numbers and joins them to one string.
+    static std::string joinSignature( std::vector<std::string> references );
+
+    void clear();
+    /*!
+    Adds a space given its bounds and standing zero pose as stored by
+    IVRChaperoneSetup, and its signature from joinSignature(). Spaces without
+    at least three corners or with corners that aren't finite are ignored.
+    */
+    void add( int id,
+              const std::string& signature,
+              const vr::HmdQuad_t* quads,
+              uint32_t count,
+              const vr::HmdMatrix34_t& standingToRaw );
+    // Signature of the tracking references that are connected now.
+    void setSetup( const std::string& signature );
+
+    // Id of the space the point is in, -1 if there is none.
+    int locate( float rawX, float rawZ ) const;
+
+    size_t size() const noexcept
+    {
+        return _spaces.size();
+    }
+};
+
+} // end namespace utils
@@ -1,20 +1,196 @@
 #include "ChaperoneUtils.h"
+#include <algorithm>
+#include <cstddef>
 #include <iostream>
 #include <cmath>
 
 namespace utils
 {
+namespace
+{
+    float distance2( const vr::HmdVector2_t& a,
+                     const vr::HmdVector2_t& b ) noexcept
+    {
+        return std::hypot( a.v[0] - b.v[0], a.v[1] - b.v[1] );
+    }
+
+    // Distance of p to the line through a and b.
+    float lineDistance( const vr::HmdVector2_t& p,
+                        const vr::HmdVector2_t& a,
+                        const vr::HmdVector2_t& b ) noexcept
+    {
+        const float length = distance2( a, b );
+        if ( length <= 0.0f )
+        {
+            return distance2( p, a );
+        }
+        return std::abs( ( b.v[0] - a.v[0] ) * ( a.v[1] - p.v[1] )
+                         - ( a.v[0] - p.v[0] ) * ( b.v[1] - a.v[1] ) )
+               / length;
+    }
+
+    // Aspect ratios the play area is tried with per pass, each pass narrows
+    // the range down to the neighbours of the best one.
+    constexpr int k_playAreaAspects = 16;
+    constexpr int k_playAreaAspectPasses = 4;
+    // Grid of centers tried when the centroid is outside the polygon, the
+    // best one is then moved in steps down to a centimeter.
+    constexpr int k_playAreaCenters = 8;
+    constexpr float k_playAreaCenterStep = 0.01f;
+
+    bool isInPolygon( const std::vector<vr::HmdVector2_t>& corners,
+                      const vr::HmdVector2_t& p ) noexcept
+    {
+        bool inside = false;
+        for ( size_t i = 0, j = corners.size() - 1; i < corners.size();
+              j = i++ )
+        {
+            const auto& a = corners[i].v;
+            const auto& b = corners[j].v;
+            if ( ( a[1] > p.v[1] ) != ( b[1] > p.v[1] )
+                 && p.v[0] < a[0]
+                                 + ( p.v[1] - a[1] ) * ( b[0] - a[0] )
+                                       / ( b[1] - a[1] ) )
+            {
+                inside = !inside;
+            }
+        }
+        return inside;
+    }
+
+    /*
+    Smallest max( |x| / rx, |z| / rz ) over the segment from a to b, with x
+    and z relative to p: how far the rectangle with the half sizes rx and rz
+    around p can be scaled until it touches the segment. The function is
+    piecewise linear along the segment, its minimum is at an end point or
+    where one of the terms is zero or both are equal.
+    */
+    float rectangleDistance( const vr::HmdVector2_t& p,
+                             const vr::HmdVector2_t& a,
+                             const vr::HmdVector2_t& b,
+                             float rx,
+                             float rz ) noexcept
+    {
+        const float ax = ( a.v[0] - p.v[0] ) / rx;
+        const float az = ( a.v[1] - p.v[1] ) / rz;
+        const float dx = ( b.v[0] - p.v[0] ) / rx - ax;
+        const float dz = ( b.v[1] - p.v[1] ) / rz - az;
+        auto at = [&]( float t ) {
+            t = std::min( std::max( t, 0.0f ), 1.0f );
+            return std::max( std::abs( ax + t * dx ), std::abs( az + t * dz ) );
+        };
+        float distance = std::min( at( 0.0f ), at( 1.0f ) );
+        // Where ax + t dx equals 0, az + t dz and -( az + t dz ).
+        const float candidates[][2] = { { -ax, dx },
+                                        { -az, dz },
+                                        { az - ax, dx - dz },
+                                        { -az - ax, dx + dz } };
+        for ( const auto& c : candidates )
+        {
+            if ( c[1] != 0.0f )
+            {
+                distance = std::min( distance, at( c[0] / c[1] ) );
+            }
+        }
+        return distance;
+    }
+
+    // Area of the largest rectangle around center inside the polygon.
+    float largestRectangle( const std::vector<vr::HmdVector2_t>& corners,
+                            const vr::HmdVector2_t& center,
+                            vr::HmdVector2_t& halfSize ) noexcept
+    {
+        float largest = 0.0f;
+        // Angles of the diagonal, from atan( 1 / 40 ) to atan( 40 ).
+        float from = 0.025f;
+        float to = 1.5458f;
+        for ( int pass = 0; pass < k_playAreaAspectPasses; pass++ )
+        {
+            const float step
+                = ( to - from ) / static_cast<float>( k_playAreaAspects - 1 );
+            float best = from;
+            for ( int i = 0; i < k_playAreaAspects; i++ )
+            {
+                const float angle = from + step * static_cast<float>( i );
+                const float rx = std::cos( angle );
+                const float rz = std::sin( angle );
+                float scale = INFINITY;
+                for ( size_t j = 0; j < corners.size(); j++ )
+                {
+                    scale = std::min(
+                        scale,
+                        rectangleDistance( center,
+                                           corners[j],
+                                           corners[( j + 1 ) % corners.size()],
+                                           rx,
+                                           rz ) );
+                }
+                const float area = scale * scale * rx * rz;
+                if ( area > largest )
+                {
+                    largest = area;
+                    best = angle;
+                    halfSize = { { scale * rx, scale * rz } };
+                }
+            }
+            from = std::max( best - step, 0.025f );
+            to = std::min( best + step, 1.5458f );
+        }
+        return largest;
+    }
+
+    // Moves center as long as the rectangle around it gets larger.
+    void refineCenter( const std::vector<vr::HmdVector2_t>& corners,
+                       float step,
+                       vr::HmdVector2_t& center,
+                       vr::HmdVector2_t& halfSize,
+                       float& largest ) noexcept
+    {
+        const float directions[4][2] = {
+            { 1.0f, 0.0f }, { -1.0f, 0.0f }, { 0.0f, 1.0f }, { 0.0f, -1.0f }
+        };
+        while ( step >= k_playAreaCenterStep )
+        {
+            bool moved = false;
+            for ( const auto& direction : directions )
+            {
+                const vr::HmdVector2_t candidate
+                    = { { center.v[0] + step * direction[0],
+                          center.v[1] + step * direction[1] } };
+                vr::HmdVector2_t candidateHalfSize;
+                if ( !isInPolygon( corners, candidate ) )
+                {
+                    continue;
+                }
+                const float area
+                    = largestRectangle( corners, candidate, candidateHalfSize );
+                if ( area > largest )
+                {
+                    largest = area;
+                    center = candidate;
+                    halfSize = candidateHalfSize;
+                    moved = true;
+                }
+            }
+            if ( !moved )
+            {
+                step /= 2.0f;
+            }
+        }
+    }
+} // namespace
+
 float ChaperoneUtils::_getDistanceToChaperone(
     const vr::HmdVector3_t& x,
     vr::HmdVector3_t* projectedPoint )
 {
     float distance = NAN;
-    vr::HmdVector3_t* _cornersPtr = _corners.get();
+    const vr::HmdVector3_t* _cornersPtr = _corners.data();
     for ( uint32_t i = 0; i < _quadsCount; i++ )
     {
         uint32_t i2 = ( i + 1 ) % _quadsCount;
-        vr::HmdVector3_t& r0 = _cornersPtr[i];
-        vr::HmdVector3_t& r1 = _cornersPtr[i2];
+        const vr::HmdVector3_t& r0 = _cornersPtr[i];
+        const vr::HmdVector3_t& r1 = _cornersPtr[i2];
         float u_x = r1.v[0] - r0.v[0];
         float u_z = r1.v[2] - r0.v[2];
         float r = ( ( x.v[0] - r0.v[0] ) * u_x + ( x.v[2] - r0.v[2] ) * u_z )
@@ -74,36 +250,282 @@ float ChaperoneUtils::_getDistanceToChaperone(
     return distance;
 }
 
-void ChaperoneUtils::loadChaperoneData()
+bool ChaperoneUtils::rebuild( const vr::HmdQuad_t* quads, uint32_t count )
+{
+    // FNV-1a over the raw quads, equal bounds always give equal bytes.
+    uint64_t hash = 14695981039346656037ull;
+    const auto bytes = reinterpret_cast<const unsigned char*>( quads );
+    for ( size_t i = 0; i < count * sizeof( vr::HmdQuad_t ); i++ )
+    {
+        hash = ( hash ^ bytes[i] ) * 1099511628211ull;
+    }
+    if ( _generation > 0 && count == _quadsCount && hash == _boundsHash )
+    {
+        return false;
+    }
+
+    if ( quads != _quads.data() )
+    {
+        _quads.assign( quads, quads + count );
+    }
+    _quadsCount = count;
+    _boundsHash = hash;
+    _generation++;
+    _corners.resize( count );
+    _chaperoneWellFormed = true;
+    for ( uint32_t i = 0; i < count; i++ )
+    {
+        _corners[i] = quads[i].vCorners[0];
+        uint32_t i2 = ( i + 1 ) % count;
+        if ( quads[i].vCorners[3].v[0] != quads[i2].vCorners[0].v[0]
+             || quads[i].vCorners[3].v[1] != quads[i2].vCorners[0].v[1]
+             || quads[i].vCorners[3].v[2] != quads[i2].vCorners[0].v[2]
+             || quads[i].vCorners[0].v[1] != 0.0f )
+        {
+            _chaperoneWellFormed = false;
+        }
+    }
+    updateBoundsInfo();
+    return true;
+}
+
+void ChaperoneUtils::updateBoundsInfo()
+{
+    BoundsInfo info;
+    if ( _quadsCount == 0 )
+    {
+        _boundsInfo = info;
+        return;
+    }
+    info.minX = info.maxX = _corners[0].v[0];
+    info.minZ = info.maxZ = _corners[0].v[2];
+    // Shoelace formula over the floor corners, in double because the terms
+    // cancel out a lot for bounds far from the origin.
+    double area2 = 0.0;
+    double centroidX = 0.0;
+    double centroidZ = 0.0;
+    double sumX = 0.0;
+    double sumZ = 0.0;
+    for ( uint32_t i = 0; i < _quadsCount; i++ )
+    {
+        const auto& quad = _quads[i];
+        info.maxY = std::isnan( info.maxY )
+                        ? std::max( quad.vCorners[1].v[1],
+                                    quad.vCorners[2].v[1] )
+                        : std::max( { info.maxY,
+                                      quad.vCorners[1].v[1],
+                                      quad.vCorners[2].v[1] } );
+
+        const auto& r0 = _corners[i];
+        const auto& r1 = _corners[( i + 1 ) % _quadsCount];
+        info.minX = std::min( info.minX, r0.v[0] );
+        info.maxX = std::max( info.maxX, r0.v[0] );
+        info.minZ = std::min( info.minZ, r0.v[2] );
+        info.maxZ = std::max( info.maxZ, r0.v[2] );
+        const double x0 = static_cast<double>( r0.v[0] );
+        const double z0 = static_cast<double>( r0.v[2] );
+        const double x1 = static_cast<double>( r1.v[0] );
+        const double z1 = static_cast<double>( r1.v[2] );
+        const double cross = x0 * z1 - x1 * z0;
+        area2 += cross;
+        centroidX += ( x0 + x1 ) * cross;
+        centroidZ += ( z0 + z1 ) * cross;
+        sumX += x0;
+        sumZ += z0;
+    }
+    info.area = static_cast<float>( std::abs( area2 ) * 0.5 );
+    if ( std::abs( area2 ) > 1e-9 )
+    {
+        info.centroidX = static_cast<float>( centroidX / ( 3.0 * area2 ) );
+        info.centroidZ = static_cast<float>( centroidZ / ( 3.0 * area2 ) );
+    }
+    else
+    {
+        // Degenerate bounds (a line or a single point), no area to weigh.
+        info.centroidX = static_cast<float>( sumX / _quadsCount );
+        info.centroidZ = static_cast<float>( sumZ / _quadsCount );
+    }
+    _boundsInfo = info;
+}
+
+bool ChaperoneUtils::loadChaperoneData()
 {
     std::lock_guard<std::recursive_mutex> lock( _mutex );
-    vr::VRChaperoneSetup()->GetLiveCollisionBoundsInfo( nullptr, &_quadsCount );
-    if ( _quadsCount > 0 )
-    {
-        std::unique_ptr<vr::HmdQuad_t> quadsBuffer(
-            new vr::HmdQuad_t[_quadsCount] );
-        vr::HmdQuad_t* quadsBufferPtr = quadsBuffer.get();
-        _corners.reset( reinterpret_cast<vr::HmdVector3_t*>(
-            new vr::HmdQuad_t[_quadsCount] ) );
-        vr::HmdVector3_t* _cornersPtr = _corners.get();
-        vr::VRChaperoneSetup()->GetLiveCollisionBoundsInfo( quadsBufferPtr,
-                                                            &_quadsCount );
-        for ( uint32_t i = 0; i < _quadsCount; i++ )
+    uint32_t count = 0;
+    vr::VRChaperoneSetup()->GetLiveCollisionBoundsInfo( nullptr, &count );
+    _quads.resize( count );
+    if ( count > 0 )
+    {
+        vr::VRChaperoneSetup()->GetLiveCollisionBoundsInfo( _quads.data(),
+                                                            &count );
+    }
+    return rebuild( _quads.data(), count );
+}
+
+void ChaperoneUtils::ownCommit( const vr::HmdQuad_t* quads, uint32_t count )
+{
+    std::lock_guard<std::recursive_mutex> lock( _mutex );
+    rebuild( quads, count );
+}
+
+bool ChaperoneUtils::quadsFromPolygon( std::vector<vr::HmdVector2_t> corners,
+                                       float height,
+                                       float tolerance,
+                                       std::vector<vr::HmdQuad_t>& quads )
+{
+    quads.clear();
+    size_t count = 0;
+    for ( const auto& corner : corners )
+    {
+        if ( count == 0
+             || distance2( corner, corners[count - 1] ) >= tolerance )
+        {
+            corners[count++] = corner;
+        }
+    }
+    // The polygon is closed, the last corner may be where the first one is.
+    while ( count > 1
+            && distance2( corners[count - 1], corners[0] ) < tolerance )
+    {
+        count--;
+    }
+    corners.resize( count );
+
+    bool removed = true;
+    while ( removed && corners.size() >= 3 )
+    {
+        removed = false;
+        for ( size_t i = 0; i < corners.size() && corners.size() >= 3; i++ )
         {
-            _cornersPtr[i] = quadsBufferPtr[i].vCorners[0];
-            uint32_t i2 = ( i + 1 ) % _quadsCount;
-            if ( quadsBufferPtr[i].vCorners[3].v[0]
-                     != quadsBufferPtr[i2].vCorners[0].v[0]
-                 || quadsBufferPtr[i].vCorners[3].v[1]
-                        != quadsBufferPtr[i2].vCorners[0].v[1]
-                 || quadsBufferPtr[i].vCorners[3].v[2]
-                        != quadsBufferPtr[i2].vCorners[0].v[2]
-                 || quadsBufferPtr[i].vCorners[0].v[1] != 0.0f )
+            const auto& previous
+                = corners[( i + corners.size() - 1 ) % corners.size()];
+            const auto& next = corners[( i + 1 ) % corners.size()];
+            if ( lineDistance( corners[i], previous, next ) < tolerance )
             {
-                _chaperoneWellFormed = false;
+                corners.erase( corners.begin()
+                               + static_cast<std::ptrdiff_t>( i ) );
+                removed = true;
             }
         }
     }
+    if ( corners.size() < 3 )
+    {
+        return false;
+    }
+
+    quads.resize( corners.size() );
+    for ( size_t i = 0; i < corners.size(); i++ )
+    {
+        const auto& a = corners[i];
+        const auto& b = corners[( i + 1 ) % corners.size()];
+        auto& quad = quads[i];
+        quad.vCorners[0] = { { a.v[0], 0.0f, a.v[1] } };
+        quad.vCorners[1] = { { a.v[0], height, a.v[1] } };
+        quad.vCorners[2] = { { b.v[0], height, b.v[1] } };
+        quad.vCorners[3] = { { b.v[0], 0.0f, b.v[1] } };
+    }
+    return true;
+}
+
+bool ChaperoneUtils::playAreaFromPolygon(
+    const std::vector<vr::HmdQuad_t>& quads,
+    vr::HmdVector2_t& center,
+    vr::HmdVector2_t& size )
+{
+    std::vector<vr::HmdVector2_t> corners;
+    corners.reserve( quads.size() );
+    for ( const auto& quad : quads )
+    {
+        corners.push_back(
+            { { quad.vCorners[0].v[0], quad.vCorners[0].v[2] } } );
+    }
+    if ( corners.size() < 3 )
+    {
+        return false;
+    }
+
+    // Area centroid, relative to the first corner to keep the precision.
+    const auto& origin = corners[0].v;
+    float area = 0.0f;
+    float cx = 0.0f;
+    float cz = 0.0f;
+    float minX = corners[0].v[0];
+    float maxX = minX;
+    float minZ = corners[0].v[1];
+    float maxZ = minZ;
+    for ( size_t i = 0; i < corners.size(); i++ )
+    {
+        const auto& a = corners[i].v;
+        const auto& b = corners[( i + 1 ) % corners.size()].v;
+        const float ax = a[0] - origin[0];
+        const float az = a[1] - origin[1];
+        const float bx = b[0] - origin[0];
+        const float bz = b[1] - origin[1];
+        const float cross = ax * bz - bx * az;
+        area += cross;
+        cx += ( ax + bx ) * cross;
+        cz += ( az + bz ) * cross;
+        minX = std::min( minX, a[0] );
+        maxX = std::max( maxX, a[0] );
+        minZ = std::min( minZ, a[1] );
+        maxZ = std::max( maxZ, a[1] );
+    }
+    if ( std::abs( area ) <= 0.0f || !std::isfinite( area ) )
+    {
+        return false;
+    }
+    center = { { origin[0] + cx / ( 3.0f * area ),
+                 origin[1] + cz / ( 3.0f * area ) } };
+
+    vr::HmdVector2_t halfSize = { { 0.0f, 0.0f } };
+    float largest = 0.0f;
+    if ( isInPolygon( corners, center ) )
+    {
+        largest = largestRectangle( corners, center, halfSize );
+    }
+    else
+    {
+        const float stepX
+            = ( maxX - minX ) / static_cast<float>( k_playAreaCenters );
+        const float stepZ
+            = ( maxZ - minZ ) / static_cast<float>( k_playAreaCenters );
+        for ( int i = 0; i < k_playAreaCenters; i++ )
+        {
+            for ( int j = 0; j < k_playAreaCenters; j++ )
+            {
+                const vr::HmdVector2_t candidate
+                    = { { minX + stepX * ( static_cast<float>( i ) + 0.5f ),
+                          minZ + stepZ * ( static_cast<float>( j ) + 0.5f ) } };
+                vr::HmdVector2_t candidateHalfSize;
+                if ( !isInPolygon( corners, candidate ) )
+                {
+                    continue;
+                }
+                const float candidateArea = largestRectangle(
+                    corners, candidate, candidateHalfSize );
+                if ( candidateArea > largest )
+                {
+                    largest = candidateArea;
+                    center = candidate;
+                    halfSize = candidateHalfSize;
+                }
+            }
+        }
+        if ( largest > 0.0f )
+        {
+            refineCenter( corners,
+                          std::max( stepX, stepZ ) / 2.0f,
+                          center,
+                          halfSize,
+                          largest );
+        }
+    }
+    if ( largest <= 0.0f )
+    {
+        return false;
+    }
+    size = { { 2.0f * halfSize.v[0], 2.0f * halfSize.v[1] } };
+    return true;
 }
 
 } // end namespace utils
@@ -1,18 +1,45 @@
 #pragma once
 
-#include <memory>
+#include <cmath>
 #include <mutex>
+#include <vector>
 #include <openvr.h>
 
 namespace utils
 {
 class ChaperoneUtils
 {
+public:
+    /*!
+    Values derived from the bounds, computed once whenever they change. On
+    the floor plane x/z, the centroid is the one of the enclosed area.
+    */
+    struct BoundsInfo
+    {
+        float maxY = NAN;
+        float area = 0.0f;
+        float minX = 0.0f;
+        float maxX = 0.0f;
+        float minZ = 0.0f;
+        float maxZ = 0.0f;
+        float centroidX = 0.0f;
+        float centroidZ = 0.0f;
+    };
+
 private:
     std::recursive_mutex _mutex;
     uint32_t _quadsCount = 0;
-    std::unique_ptr<vr::HmdVector3_t> _corners;
+    // Both keep their capacity between reloads.
+    std::vector<vr::HmdQuad_t> _quads;
+    std::vector<vr::HmdVector3_t> _corners;
     bool _chaperoneWellFormed = true;
+    // Hash of the quads the corners were built from.
+    uint64_t _boundsHash = 0;
+    uint64_t _generation = 0;
+    BoundsInfo _boundsInfo;
+
+    bool rebuild( const vr::HmdQuad_t* quads, uint32_t count );
+    void updateBoundsInfo();
 
     float _getDistanceToChaperone( const vr::HmdVector3_t& point,
                                    vr::HmdVector3_t* projectedPoint );
@@ -26,13 +53,57 @@ public:
     {
         return _chaperoneWellFormed;
     }
+    // Increased whenever the bounds actually changed.
+    uint64_t generation() const noexcept
+    {
+        return _generation;
+    }
+    const BoundsInfo& boundsInfo() const noexcept
+    {
+        return _boundsInfo;
+    }
+    // Copies the cached bounds, lock mutex() when other threads may reload.
+    void copyQuads( std::vector<vr::HmdQuad_t>& quads ) const
+    {
+        quads.assign( _quads.begin(), _quads.begin() + _quadsCount );
+    }
 
     std::recursive_mutex& mutex() noexcept
     {
         return _mutex;
     }
 
-    void loadChaperoneData();
+    // Returns true if the bounds changed.
+    bool loadChaperoneData();
+    /*!
+    Takes the bounds we just committed to the live chaperone. The change
+    event our own commit causes then reads back bounds with the same hash and
+    doesn't count as a change, while a change by anyone else still does.
+    */
+    void ownCommit( const vr::HmdQuad_t* quads, uint32_t count );
+
+    /*!
+    Builds well formed bounds from the corners of a closed floor polygon, x
+    and z of every corner: one wall per edge from the floor to the height,
+    each starting where the previous one ended. Corners closer than the
+    tolerance to the previous corner or to the line between their neighbours
+    are dropped. Returns false if less than three corners are left.
+    */
+    static bool quadsFromPolygon( std::vector<vr::HmdVector2_t> corners,
+                                  float height,
+                                  float tolerance,
+                                  std::vector<vr::HmdQuad_t>& quads );
+
+    /*!
+    Largest play area (an axis aligned rectangle) inside the floor polygon of
+    bounds, centered on the centroid of the polygon. If the centroid lies
+    outside, as in some L shaped rooms, the center is searched for inside
+    the polygon where the rectangle gets largest. Returns false if the
+    polygon has no area.
+    */
+    static bool playAreaFromPolygon( const std::vector<vr::HmdQuad_t>& quads,
+                                     vr::HmdVector2_t& center,
+                                     vr::HmdVector2_t& size );
 
     float getDistanceToChaperone( const vr::HmdVector3_t& point,
                                   vr::HmdVector3_t* projectedPoint = nullptr,
@@ -0,0 +1,37 @@
+#include "Debounce.h"
+
+namespace utils
+{
+bool Debounce::set( bool state, Clock::time_point time ) noexcept
+{
+    if ( _known && state == _state )
+    {
+        return false;
+    }
+    _known = true;
+    _state = state;
+    _pending = true;
+    _changeTime = time;
+    return true;
+}
+
+bool Debounce::settle( Clock::time_point time,
+                       Clock::duration delay,
+                       bool& state ) noexcept
+{
+    if ( !_pending || time - _changeTime < delay )
+    {
+        return false;
+    }
+    _pending = false;
+    state = _state;
+    return true;
+}
+
+void Debounce::reset() noexcept
+{
+    _known = false;
+    _pending = false;
+}
+
+} // end namespace utils
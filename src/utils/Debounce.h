@@ -0,0 +1,51 @@
+#pragma once
+
+#include <chrono>
+
+namespace utils
+{
+/*!
+Debounces a binary sensor, like the proximity sensor of the HMD.
+
+Changes are fed in as they are seen (from events or polling), settle() is
+called every frame and reports a change once it has held for the delay. A
+sensor flickering faster than that is ignored. The first state after reset()
+always counts as a change, so whatever follows the sensor starts out matching
+it.
+*/
+class Debounce
+{
+public:
+    using Clock = std::chrono::steady_clock;
+
+private:
+    bool _known = false;
+    bool _state = false;
+    bool _pending = false;
+    Clock::time_point _changeTime;
+
+public:
+    // Returns true if the state differs from the last one set.
+    bool set( bool state, Clock::time_point time ) noexcept;
+    /*!
+    Returns true once per change, as soon as it has held for delay. state is
+    the new state then.
+    */
+    bool settle( Clock::time_point time,
+                 Clock::duration delay,
+                 bool& state ) noexcept;
+    // Forgets the state, the next one set counts as a change.
+    void reset() noexcept;
+
+    bool isKnown() const noexcept
+    {
+        return _known;
+    }
+    // When the last change was seen.
+    Clock::time_point changeTime() const noexcept
+    {
+        return _changeTime;
+    }
+};
+
+} // end namespace utils
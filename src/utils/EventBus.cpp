@@ -0,0 +1,119 @@
+#include "EventBus.h"
+#include <algorithm>
+#include <chrono>
+#include <easylogging++.h>
+
+namespace utils
+{
+namespace
+{
+    // Events usually come in small bursts, this avoids reallocating the
+    // batch in the common case.
+    constexpr size_t k_initialBatchCapacity = 64;
+} // namespace
+
+EventBus::EventBus()
+    : _table( tableSize ), _stats( tableSize + 1 )
+{
+    _batch.reserve( k_initialBatchCapacity );
+}
+
+void EventBus::subscribe( uint32_t eventType, Handler handler )
+{
+    if ( eventType >= tableSize )
+    {
+        LOG( ERROR ) << "Can't subscribe to event type " << eventType;
+        return;
+    }
+    _table[eventType].push_back(
+        static_cast<uint32_t>( _subscriptions.size() ) );
+    _subscriptions.push_back( Subscription{ std::move( handler ), false, 0 } );
+}
+
+void EventBus::subscribeCoalesced( std::initializer_list<uint32_t> eventTypes,
+                                   Handler handler )
+{
+    const auto index = static_cast<uint32_t>( _subscriptions.size() );
+    _subscriptions.push_back( Subscription{ std::move( handler ), true, 0 } );
+    for ( auto eventType : eventTypes )
+    {
+        if ( eventType >= tableSize )
+        {
+            LOG( ERROR ) << "Can't subscribe to event type " << eventType;
+            continue;
+        }
+        _table[eventType].push_back( index );
+    }
+}
+
+bool EventBus::dispatch()
+{
+    _frame++;
+    _stopped = false;
+    for ( const auto& event : _batch )
+    {
+        auto& stats = _stats[slot( event.eventType )];
+        stats.count++;
+        if ( event.eventType >= tableSize || _table[event.eventType].empty() )
+        {
+            continue;
+        }
+        const auto start = std::chrono::steady_clock::now();
+        for ( auto index : _table[event.eventType] )
+        {
+            auto& subscription = _subscriptions[index];
+            if ( subscription.coalesced )
+            {
+                if ( subscription.lastFrame == _frame )
+                {
+                    continue;
+                }
+                subscription.lastFrame = _frame;
+            }
+            subscription.handler( event );
+            if ( _stopped )
+            {
+                break;
+            }
+        }
+        stats.milliseconds += std::chrono::duration<double, std::milli>(
+                                  std::chrono::steady_clock::now() - start )
+                                  .count();
+        if ( _stopped )
+        {
+            break;
+        }
+    }
+    _batch.clear();
+    return !_stopped;
+}
+
+void EventBus::logStatistics() const
+{
+    std::vector<uint32_t> seen;
+    for ( uint32_t i = 0; i <= tableSize; i++ )
+    {
+        if ( _stats[i].count > 0 )
+        {
+            seen.push_back( i );
+        }
+    }
+    std::sort( seen.begin(), seen.end(), [this]( uint32_t a, uint32_t b ) {
+        return _stats[a].milliseconds > _stats[b].milliseconds;
+    } );
+    for ( auto i : seen )
+    {
+        const char* name
+            = i < tableSize && vr::VRSystem()
+                  ? vr::VRSystem()->GetEventTypeNameFromEnum(
+                      static_cast<vr::EVREventType>( i ) )
+                  : "Other";
+        LOG( INFO ) << "Event " << name << ": " << _stats[i].count
+                    << " events, " << _stats[i].milliseconds << " ms, "
+                    << _stats[i].milliseconds * 1000.0
+                           / static_cast<double>( _stats[i].count )
+                    << " us per event";
+    }
+}
+
+} // end namespace utils
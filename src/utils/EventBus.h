@@ -0,0 +1,100 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <initializer_list>
+#include <vector>
+#include <openvr.h>
+
+namespace utils
+{
+/*!
+Dispatches OpenVR events to the handlers that subscribed to their type.
+
+Events are collected once per frame with pump() and handed out in one batch
+by dispatch(). Handlers are found through a table indexed directly by the
+event type, so dispatching costs the same no matter how many types are
+subscribed. Vendor specific events (10000 and above) are counted but can't be
+subscribed to.
+
+For every event type the number of events and the time spent in its
+handlers is recorded.
+*/
+class EventBus
+{
+public:
+    using Handler = std::function<void( const vr::VREvent_t& )>;
+
+    // Larger than every EVREventType below the vendor specific range.
+    static constexpr uint32_t tableSize = 2000;
+
+    struct EventStats
+    {
+        uint64_t count = 0;
+        double milliseconds = 0.0;
+    };
+
+private:
+    struct Subscription
+    {
+        Handler handler;
+        bool coalesced = false;
+        uint64_t lastFrame = 0;
+    };
+
+    std::vector<Subscription> _subscriptions;
+    // Indices into _subscriptions, per event type.
+    std::vector<std::vector<uint32_t>> _table;
+    std::vector<vr::VREvent_t> _batch;
+    // The last slot counts everything outside of the table.
+    std::vector<EventStats> _stats;
+    uint64_t _frame = 0;
+    bool _stopped = false;
+
+    static uint32_t slot( uint32_t eventType ) noexcept
+    {
+        return eventType < tableSize ? eventType : tableSize;
+    }
+
+public:
+    EventBus();
+
+    void subscribe( uint32_t eventType, Handler handler );
+    /*!
+    Like subscribe(), but the handler is called at most once per dispatch()
+    even if several of the event types arrived. For handlers that reload
+    state and don't need to see every event.
+    */
+    void subscribeCoalesced( std::initializer_list<uint32_t> eventTypes,
+                             Handler handler );
+
+    // Appends all events poll() returns to the current batch. poll is called
+    // as bool poll( vr::VREvent_t* ).
+    template <typename Poll> void pump( Poll poll )
+    {
+        vr::VREvent_t event;
+        while ( poll( &event ) )
+        {
+            _batch.push_back( event );
+        }
+    }
+
+    /*!
+    Hands the batch to the handlers and clears it. Returns false if a handler
+    called stop(), the rest of the batch is dropped in that case.
+    */
+    bool dispatch();
+    void stop() noexcept
+    {
+        _stopped = true;
+    }
+
+    const EventStats& stats( uint32_t eventType ) const noexcept
+    {
+        return _stats[slot( eventType )];
+    }
+    // Logs the event types that were seen, most expensive first.
+    void logStatistics() const;
+};
+
+} // end namespace utils
@@ -0,0 +1,192 @@
+#include "EventLoad.h"
+#include <algorithm>
+#include <cstring>
+#include <sstream>
+#include <easylogging++.h>
+
+namespace utils
+{
+namespace
+{
+    constexpr const char* k_kindNames[] = {
+        "mousemove",
+        "scroll",
+        "chaperone",
+        "keyboard",
+    };
+    // Largest pointer step per move, as a fraction of the overlay.
+    constexpr float k_maxPointerStep = 0.02f;
+    constexpr float k_scrollDelta = 0.05f;
+    constexpr uint64_t k_keysPerInput = 8;
+    // Up to 99999 events of a kind per frame, beyond that the batch of a
+    // single frame takes gigabytes.
+    constexpr size_t k_maxCountDigits = 5;
+} // namespace
+
+bool EventLoad::setMix( const std::string& mix )
+{
+    uint32_t perFrame[kindCount] = {};
+    std::istringstream stream( mix );
+    std::string entry;
+    while ( std::getline( stream, entry, ',' ) )
+    {
+        const auto separator = entry.find( '=' );
+        const auto name = entry.substr( 0, separator );
+        const auto kind = std::find_if(
+            std::begin( k_kindNames ),
+            std::end( k_kindNames ),
+            [&name]( const char* kindName ) { return name == kindName; } );
+        if ( separator == std::string::npos || kind == std::end( k_kindNames ) )
+        {
+            LOG( ERROR ) << "Unknown event load entry \"" << entry << "\"";
+            return false;
+        }
+        // std::stoul would take a sign and wrap negative counts around.
+        const auto digits = entry.substr( separator + 1 );
+        if ( digits.empty() || digits.size() > k_maxCountDigits
+             || digits.find_first_not_of( "0123456789" ) != std::string::npos )
+        {
+            LOG( ERROR ) << "Invalid event count in \"" << entry << "\"";
+            return false;
+        }
+        perFrame[kind - std::begin( k_kindNames )]
+            = static_cast<uint32_t>( std::stoul( digits ) );
+    }
+    std::memcpy( _perFrame, perFrame, sizeof( _perFrame ) );
+    std::fill( std::begin( _remaining ), std::end( _remaining ), 0u );
+    return true;
+}
+
+void EventLoad::setArea( float width, float height ) noexcept
+{
+    _area[0] = std::max( width, 1.0f );
+    _area[1] = std::max( height, 1.0f );
+}
+
+bool EventLoad::active() const noexcept
+{
+    return eventsPerFrame() > 0;
+}
+
+uint32_t EventLoad::eventsPerFrame() const noexcept
+{
+    uint32_t events = 0;
+    for ( auto count : _perFrame )
+    {
+        events += count;
+    }
+    return events;
+}
+
+void EventLoad::beginFrame() noexcept
+{
+    std::memcpy( _remaining, _perFrame, sizeof( _remaining ) );
+}
+
+// xorshift64*, mapped to 0 .. 1.
+float EventLoad::nextRandom() noexcept
+{
+    _random ^= _random >> 12;
+    _random ^= _random << 25;
+    _random ^= _random >> 27;
+    const uint64_t value = _random * 0x2545F4914F6CDD1D;
+    return static_cast<float>( value >> 40 ) / static_cast<float>( 1 << 24 );
+}
+
+void EventLoad::fill( Kind kind, vr::VREvent_t& event ) noexcept
+{
+    event = {};
+    event.trackedDeviceIndex = vr::k_unTrackedDeviceIndex_Hmd;
+    switch ( kind )
+    {
+    case Kind::MouseMove:
+        for ( int i = 0; i < 2; i++ )
+        {
+            _pointer[i] += ( nextRandom() * 2.0f - 1.0f ) * k_maxPointerStep;
+            _pointer[i] = std::min( std::max( _pointer[i], 0.0f ), 1.0f );
+        }
+        event.eventType = vr::VREvent_MouseMove;
+        event.data.mouse.x = _pointer[0] * _area[0];
+        event.data.mouse.y = _pointer[1] * _area[1];
+        break;
+    case Kind::Scroll:
+        event.eventType = vr::VREvent_ScrollSmooth;
+        event.data.scroll.ydelta
+            = _scrolls++ % 2 == 0 ? k_scrollDelta : -k_scrollDelta;
+        break;
+    case Kind::Chaperone:
+        event.eventType = vr::VREvent_ChaperoneDataHasChanged;
+        break;
+    case Kind::Keyboard:
+        if ( ++_keys % k_keysPerInput == 0 )
+        {
+            event.eventType = vr::VREvent_KeyboardDone;
+        }
+        else
+        {
+            event.eventType = vr::VREvent_KeyboardCharInput;
+            event.data.keyboard.cNewInput[0]
+                = static_cast<char>( 'a' + _keys % 26 );
+        }
+        event.data.keyboard.uUserValue = keyboardUserValue;
+        break;
+    case Kind::Count:
+        break;
+    }
+}
+
+bool EventLoad::next( vr::VREvent_t* event ) noexcept
+{
+    for ( size_t i = 0; i < kindCount; i++ )
+    {
+        const size_t kind = ( _nextKind + i ) % kindCount;
+        if ( _remaining[kind] > 0 )
+        {
+            _remaining[kind]--;
+            _nextKind = kind + 1;
+            fill( static_cast<Kind>( kind ), *event );
+            _events++;
+            return true;
+        }
+    }
+    return false;
+}
+
+void EventLoad::recordTick( double tickMilliseconds,
+                            double dispatchMilliseconds ) noexcept
+{
+    _ticks++;
+    _dispatchSeconds += dispatchMilliseconds / 1000.0;
+    _maxTickMilliseconds = std::max( _maxTickMilliseconds, tickMilliseconds );
+    _tickMedian.add( tickMilliseconds );
+    _tick95.add( tickMilliseconds );
+    _tick99.add( tickMilliseconds );
+}
+
+void EventLoad::logStatistics( double elapsedSeconds )
+{
+    if ( _ticks == 0 || elapsedSeconds <= 0.0 )
+    {
+        return;
+    }
+    const auto events = static_cast<double>( _events );
+    LOG( INFO ) << "Event load of " << eventsPerFrame()
+                << " events per frame: " << events / elapsedSeconds
+                << " events/s over " << _ticks << " ticks, "
+                << ( _dispatchSeconds > 0.0 ? events / _dispatchSeconds
+                                            : 0.0 )
+                << " events/s of dispatch time";
+    LOG( INFO ) << "Event load tick time: " << _tickMedian.value()
+                << " ms median, " << _tick95.value() << " ms 95th, "
+                << _tick99.value() << " ms 99th percentile, "
+                << _maxTickMilliseconds << " ms max";
+    _events = 0;
+    _ticks = 0;
+    _dispatchSeconds = 0.0;
+    _maxTickMilliseconds = 0.0;
+    _tickMedian.reset();
+    _tick95.reset();
+    _tick99.reset();
+}
+
+} // end namespace utils
@@ -0,0 +1,94 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <openvr.h>
+#include "StreamingQuantile.h"
+
+namespace utils
+{
+/*!
+Feeds synthetic OpenVR events into the event pump, to compare the cost of
+changes to event handling under a load far above what a user produces.
+
+The mix is a number of events per frame for every kind, e.g.
+"mousemove=400,scroll=40,keyboard=8". next() is the poll function for
+EventBus::pump(): after beginFrame() it hands out one frame worth of events,
+the kinds interleaved like real input, then returns false. The events go
+through the same handlers as real ones:
+
+- mousemove: the pointer wanders over the whole overlay without buttons.
+- scroll: smooth scrolls at the pointer, alternating up and down.
+- chaperone: ChaperoneDataHasChanged. Its handlers do real work: they reload
+  the chaperone data and the live universe center from the runtime. The
+  working copy of the chaperone setup isn't touched. Left out of the
+  examples.
+- keyboard: character input, every eighth event finishes the input with
+  KeyboardDone for a user value no text field uses.
+
+Mouse buttons are left out, clicks would change settings.
+
+recordTick() collects the time the whole tick and the dispatch of its events
+took. The tick times go into streaming quantiles, nothing is stored per tick.
+*/
+class EventLoad
+{
+public:
+    enum class Kind
+    {
+        MouseMove,
+        Scroll,
+        Chaperone,
+        Keyboard,
+        Count
+    };
+
+    static constexpr uint64_t keyboardUserValue = 0xFFFFFFFF;
+
+private:
+    static constexpr size_t kindCount = static_cast<size_t>( Kind::Count );
+
+    uint32_t _perFrame[kindCount] = {};
+    uint32_t _remaining[kindCount] = {};
+    size_t _nextKind = 0;
+    uint64_t _random = 0x9E3779B97F4A7C15;
+    float _area[2] = { 1.0f, 1.0f };
+    float _pointer[2] = { 0.5f, 0.5f };
+    uint64_t _scrolls = 0;
+    uint64_t _keys = 0;
+
+    uint64_t _events = 0;
+    uint64_t _ticks = 0;
+    double _dispatchSeconds = 0.0;
+    double _maxTickMilliseconds = 0.0;
+    StreamingQuantile _tickMedian{ 0.5 };
+    StreamingQuantile _tick95{ 0.95 };
+    StreamingQuantile _tick99{ 0.99 };
+
+    float nextRandom() noexcept;
+    void fill( Kind kind, vr::VREvent_t& event ) noexcept;
+
+public:
+    /*!
+    Sets the mix, the kinds are "mousemove", "scroll", "chaperone" and
+    "keyboard", counts are 0 to 99999. Returns false and leaves the load as
+    it was if the mix can't be parsed.
+    */
+    bool setMix( const std::string& mix );
+    // Size of the overlay in pixels, the pointer stays inside.
+    void setArea( float width, float height ) noexcept;
+
+    bool active() const noexcept;
+    uint32_t eventsPerFrame() const noexcept;
+
+    void beginFrame() noexcept;
+    bool next( vr::VREvent_t* event ) noexcept;
+
+    void recordTick( double tickMilliseconds,
+                     double dispatchMilliseconds ) noexcept;
+    // Logs events per second over the given time and per dispatch time, and
+    // the tick time quantiles, then starts over.
+    void logStatistics( double elapsedSeconds );
+};
+
+} // end namespace utils
@@ -0,0 +1,229 @@
+#include "FloorDriftMonitor.h"
+#include <algorithm>
+#include <cmath>
+
+namespace utils
+{
+namespace
+{
+    // Velocities below these count as lying still (m/s and rad/s).
+    constexpr double k_stillSpeed = 0.01;
+    constexpr double k_stillAngularSpeed = 0.05;
+    // Frames to wait after a device has come to rest before sampling it, so
+    // it has stopped wobbling.
+    constexpr unsigned k_settleFrames = 45;
+    // Samples averaged into the reference pose of a rest period.
+    constexpr unsigned k_referenceSamples = 90;
+    // A controller has to lie still this long (about ten seconds at 90 Hz)
+    // before it is used as floor reference.
+    constexpr unsigned k_floorMinSamples = 900;
+    // A resting device has to be sampled this long (about half a minute at
+    // 90 Hz) before its drift is trusted.
+    constexpr unsigned k_driftMinSamples = 2700;
+    constexpr double k_driftSmoothing = 1.0 / 512.0;
+    // Height noise of a resting device that is still considered reliable.
+    constexpr double k_maxHeightStdDev = 0.002;
+    // Position/orientation jumps of a resting device larger than this are
+    // treated as the device (or the playspace) being moved.
+    constexpr double k_maxJump = 0.02;
+    constexpr double k_maxYawJump = 0.035;
+    // Only controllers below this height are floor reference candidates.
+    constexpr double k_floorCandidateHeight = 0.15;
+    // Yaw is meaningless for devices standing on their end.
+    constexpr double k_maxYawPitchSine = 0.9;
+
+    double wrapAngle( double angle ) noexcept
+    {
+        if ( angle > M_PI )
+        {
+            angle -= 2.0 * M_PI;
+        }
+        else if ( angle < -M_PI )
+        {
+            angle += 2.0 * M_PI;
+        }
+        return angle;
+    }
+
+    double lengthSquared( const float v[3] ) noexcept
+    {
+        return static_cast<double>( v[0] * v[0] + v[1] * v[1] + v[2] * v[2] );
+    }
+
+    vr::ETrackedDeviceClass runtimeDeviceClass( vr::TrackedDeviceIndex_t index )
+    {
+        return vr::VRSystem()->GetTrackedDeviceClass( index );
+    }
+} // namespace
+
+FloorDriftMonitor::FloorDriftMonitor( DeviceClassQuery deviceClass )
+    : _deviceClass( deviceClass ? deviceClass : &runtimeDeviceClass )
+{
+}
+
+bool FloorDriftMonitor::isStill( const vr::TrackedDevicePose_t& pose ) noexcept
+{
+    return pose.bPoseIsValid && pose.bDeviceIsConnected
+           && pose.eTrackingResult == vr::TrackingResult_Running_OK
+           && lengthSquared( pose.vVelocity.v ) < k_stillSpeed * k_stillSpeed
+           && lengthSquared( pose.vAngularVelocity.v )
+                  < k_stillAngularSpeed * k_stillAngularSpeed;
+}
+
+bool FloorDriftMonitor::isSteady( const RestState& state ) noexcept
+{
+    const unsigned n = std::min( state.samples, k_referenceSamples );
+    return n > 0
+           && state.m2Y / static_cast<double>( n )
+                  <= k_maxHeightStdDev * k_maxHeightStdDev;
+}
+
+void FloorDriftMonitor::addSample( RestState& state,
+                                   const vr::HmdMatrix34_t& m ) noexcept
+{
+    const double y = static_cast<double>( m.m[1][3] );
+    const bool hasYaw
+        = std::abs( static_cast<double>( m.m[1][2] ) ) < k_maxYawPitchSine;
+    // See FixFloorTabController for the angle conventions.
+    const double yaw = hasYaw ? std::atan2( static_cast<double>( m.m[0][2] ),
+                                            static_cast<double>( m.m[2][2] ) )
+                              : 0.0;
+
+    if ( state.samples > 0
+         && ( std::abs( y - ( state.refY + state.driftY ) ) > k_maxJump
+              || std::abs( wrapAngle( yaw - state.refYaw - state.driftYaw ) )
+                     > k_maxYawJump ) )
+    {
+        // Moved without us seeing any velocity, start over.
+        state.samples = 0;
+    }
+
+    state.samples++;
+    if ( state.samples == 1 )
+    {
+        state.meanY = y;
+        state.m2Y = 0.0;
+        state.roll = std::atan2( static_cast<double>( m.m[1][0] ),
+                                 static_cast<double>( m.m[1][1] ) );
+        state.refY = y;
+        state.refYaw = yaw;
+        state.driftY = 0.0;
+        state.driftYaw = 0.0;
+        return;
+    }
+
+    if ( state.samples <= k_referenceSamples )
+    {
+        // The noise is only measured here, later on it would include the
+        // drift we are looking for.
+        const double n = static_cast<double>( state.samples );
+        const double delta = y - state.meanY;
+        state.meanY += delta / n;
+        state.m2Y += delta * ( y - state.meanY );
+        state.refY = state.meanY;
+        state.refYaw = wrapAngle( state.refYaw
+                                  + wrapAngle( yaw - state.refYaw ) / n );
+    }
+    else
+    {
+        state.driftY
+            += k_driftSmoothing * ( ( y - state.refY ) - state.driftY );
+        state.driftYaw
+            += k_driftSmoothing
+               * ( wrapAngle( yaw - state.refYaw ) - state.driftYaw );
+    }
+}
+
+void FloorDriftMonitor::update( const vr::TrackedDevicePose_t* devicePoses )
+{
+    // The hmd is skipped, it is hardly ever lying still on the floor.
+    for ( unsigned i = vr::k_unTrackedDeviceIndex_Hmd + 1;
+          i < vr::k_unMaxTrackedDeviceCount;
+          i++ )
+    {
+        auto& state = _devices[i];
+        if ( !isStill( devicePoses[i] ) )
+        {
+            state.stillFrames = 0;
+            state.samples = 0;
+            continue;
+        }
+        state.stillFrames++;
+        if ( state.stillFrames == 1 )
+        {
+            // Only queried once per rest period. Base stations and the like
+            // are always still and never sampled.
+            const auto deviceClass = _deviceClass( i );
+            state.isController
+                = deviceClass == vr::TrackedDeviceClass_Controller;
+            state.isSampled
+                = state.isController
+                  || deviceClass == vr::TrackedDeviceClass_GenericTracker;
+        }
+        if ( state.isSampled && state.stillFrames > k_settleFrames )
+        {
+            addSample( state, devicePoses[i].mDeviceToAbsoluteTracking );
+        }
+    }
+}
+
+void FloorDriftMonitor::reset() noexcept
+{
+    for ( auto& state : _devices )
+    {
+        state.samples = 0;
+    }
+}
+
+bool FloorDriftMonitor::floorReference( FloorSample& first,
+                                        FloorSample& second ) const noexcept
+{
+    unsigned found = 0;
+    for ( const auto& state : _devices )
+    {
+        if ( !state.isController || state.samples < k_floorMinSamples
+             || state.refY + state.driftY > k_floorCandidateHeight
+             || !isSteady( state ) )
+        {
+            continue;
+        }
+        const FloorSample sample{ state.refY + state.driftY, state.roll };
+        if ( found == 0 || sample.height < first.height )
+        {
+            second = first;
+            first = sample;
+        }
+        else if ( found == 1 || sample.height < second.height )
+        {
+            second = sample;
+        }
+        found++;
+    }
+    return found >= 2;
+}
+
+bool FloorDriftMonitor::drift( double& height, double& yaw ) const noexcept
+{
+    unsigned count = 0;
+    double heightSum = 0.0;
+    double yawSum = 0.0;
+    for ( const auto& state : _devices )
+    {
+        if ( state.samples < k_driftMinSamples || !isSteady( state ) )
+        {
+            continue;
+        }
+        heightSum += state.driftY;
+        yawSum += state.driftYaw;
+        count++;
+    }
+    if ( count == 0 )
+    {
+        return false;
+    }
+    height = heightSum / static_cast<double>( count );
+    yaw = yawSum / static_cast<double>( count );
+    return true;
+}
+
+} // end namespace utils
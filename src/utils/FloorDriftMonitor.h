@@ -0,0 +1,82 @@
+#pragma once
+
+#include <openvr.h>
+
+namespace utils
+{
+/*!
+Watches tracked devices that are lying still (a tracker on the floor, a
+controller put down) and estimates floor height and tracking drift from them.
+
+Every device gets a fixed size running estimate, so memory use doesn't grow
+with the time a device is at rest. Per frame only the velocities of the
+already fetched poses are checked, the estimates are only touched for devices
+that are at rest.
+
+Estimates are relative to the current playspace. Call reset() whenever the
+universe center is changed, otherwise the change is reported as drift.
+*/
+class FloorDriftMonitor
+{
+public:
+    // Looks up the class of a device, the runtime's by default.
+    using DeviceClassQuery
+        = vr::ETrackedDeviceClass ( * )( vr::TrackedDeviceIndex_t );
+
+    struct FloorSample
+    {
+        double height = 0.0;
+        double roll = 0.0;
+    };
+
+private:
+    struct RestState
+    {
+        // Consecutive frames the device has been still.
+        unsigned stillFrames = 0;
+        bool isSampled = false;
+        bool isController = false;
+        // Running mean and variance (Welford) of the height over the
+        // reference samples of a rest period.
+        unsigned samples = 0;
+        double meanY = 0.0;
+        double m2Y = 0.0;
+        double roll = 0.0;
+        // Pose at the beginning of the rest period, and the exponentially
+        // weighted difference to it.
+        double refY = 0.0;
+        double refYaw = 0.0;
+        double driftY = 0.0;
+        double driftYaw = 0.0;
+    };
+
+    RestState _devices[vr::k_unMaxTrackedDeviceCount];
+    DeviceClassQuery _deviceClass;
+
+    static bool isStill( const vr::TrackedDevicePose_t& pose ) noexcept;
+    static bool isSteady( const RestState& state ) noexcept;
+    void addSample( RestState& state, const vr::HmdMatrix34_t& m ) noexcept;
+
+public:
+    explicit FloorDriftMonitor( DeviceClassQuery deviceClass = nullptr );
+
+    void update( const vr::TrackedDevicePose_t* devicePoses );
+    void reset() noexcept;
+
+    /*!
+    Height and roll of the two lowest controllers that have both been
+    lying on the floor long enough to be trusted. Returns false unless two
+    such controllers are resting, a single one is too easily lying on a shoe
+    or a cable.
+    */
+    bool floorReference( FloorSample& first,
+                         FloorSample& second ) const noexcept;
+
+    /*!
+    Average height and yaw drift of all devices that have been resting long
+    enough to be trusted. Returns false if there are none.
+    */
+    bool drift( double& height, double& yaw ) const noexcept;
+};
+
+} // end namespace utils
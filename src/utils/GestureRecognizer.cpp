@@ -0,0 +1,240 @@
+#include "GestureRecognizer.h"
+#include <cmath>
+
+namespace utils
+{
+namespace
+{
+    // The HMD acceleration is taken over this many frames, a single frame
+    // is too noisy.
+    constexpr unsigned k_accelerationFrames = 2;
+    // A tap ends once the acceleration dropped below this part of the
+    // threshold, so one tap isn't counted twice.
+    constexpr double k_tapReleaseFactor = 0.5;
+
+    bool isPoseUsable( const vr::TrackedDevicePose_t& pose ) noexcept
+    {
+        return pose.bPoseIsValid
+               && pose.eTrackingResult == vr::TrackingResult_Running_OK;
+    }
+
+    double length( const double v[3] ) noexcept
+    {
+        return std::sqrt( v[0] * v[0] + v[1] * v[1] + v[2] * v[2] );
+    }
+} // namespace
+
+const GestureRecognizer::Frame&
+    GestureRecognizer::previous( unsigned age ) const noexcept
+{
+    return _history[( _next + historySize - 1 - age ) % historySize];
+}
+
+bool GestureRecognizer::updateDoubleTap( const Frame& frame )
+{
+    if ( _firstTap
+         && frame.time - _firstTapTime > _thresholds.doubleTapMaxInterval )
+    {
+        _firstTap = false;
+    }
+    if ( _count <= k_accelerationFrames || !frame.hmdValid )
+    {
+        return false;
+    }
+    const Frame& old = previous( k_accelerationFrames );
+    const double seconds = frame.time - old.time;
+    if ( !old.hmdValid || seconds <= 0.0 )
+    {
+        return false;
+    }
+    const double change[3] = { frame.hmdVelocity[0] - old.hmdVelocity[0],
+                               frame.hmdVelocity[1] - old.hmdVelocity[1],
+                               frame.hmdVelocity[2] - old.hmdVelocity[2] };
+    const double acceleration = length( change ) / seconds;
+    if ( _tapSpike )
+    {
+        if ( acceleration < _thresholds.tapAcceleration * k_tapReleaseFactor )
+        {
+            _tapSpike = false;
+        }
+        return false;
+    }
+    if ( acceleration < _thresholds.tapAcceleration )
+    {
+        return false;
+    }
+
+    // Quick head movements also cause spikes, a hand near the HMD tells
+    // them apart from taps.
+    bool handNear = false;
+    for ( unsigned hand = 0; hand < 2; hand++ )
+    {
+        if ( frame.handValid[hand] )
+        {
+            const double offset[3]
+                = { frame.handPosition[hand][0] - frame.hmdPosition[0],
+                    frame.handPosition[hand][1] - frame.hmdPosition[1],
+                    frame.handPosition[hand][2] - frame.hmdPosition[2] };
+            handNear = handNear
+                       || length( offset ) < _thresholds.tapHandDistance;
+        }
+    }
+    if ( !handNear )
+    {
+        return false;
+    }
+
+    _tapSpike = true;
+    const double interval = frame.time - _firstTapTime;
+    if ( _firstTap && interval >= _thresholds.doubleTapMinInterval )
+    {
+        _firstTap = false;
+        _lastLatency = interval;
+        return true;
+    }
+    if ( !_firstTap )
+    {
+        _firstTap = true;
+        _firstTapTime = frame.time;
+    }
+    return false;
+}
+
+bool GestureRecognizer::updateFlick( const Frame& frame, unsigned hand )
+{
+    FlickState& state = _flicks[hand];
+    if ( !frame.handValid[hand] )
+    {
+        state = FlickState();
+        return false;
+    }
+    if ( frame.handAngularSpeed[hand] >= _thresholds.flickAngularSpeed )
+    {
+        if ( !state.fast )
+        {
+            state.fast = true;
+            state.tooLong = false;
+            state.start = frame.time;
+        }
+        else if ( frame.time - state.start > _thresholds.flickMaxDuration )
+        {
+            state.tooLong = true;
+        }
+        return false;
+    }
+    if ( !state.fast )
+    {
+        return false;
+    }
+    state.fast = false;
+    if ( state.tooLong
+         || frame.time - state.start > _thresholds.flickMaxDuration )
+    {
+        return false;
+    }
+    _lastLatency = frame.time - state.start;
+    return true;
+}
+
+GestureRecognizer::Gesture GestureRecognizer::update( const Frame& frame )
+{
+    _history[_next] = frame;
+    _next = ( _next + 1 ) % historySize;
+    if ( _count < historySize )
+    {
+        _count++;
+    }
+
+    // All state machines see every frame, also during the cooldown.
+    const bool doubleTap = updateDoubleTap( frame );
+    const bool leftFlick = updateFlick( frame, 0 );
+    const bool rightFlick = updateFlick( frame, 1 );
+
+    Gesture gesture = Gesture::None;
+    if ( doubleTap )
+    {
+        gesture = Gesture::HeadDoubleTap;
+    }
+    else if ( leftFlick )
+    {
+        gesture = Gesture::LeftFlick;
+    }
+    else if ( rightFlick )
+    {
+        gesture = Gesture::RightFlick;
+    }
+    if ( gesture == Gesture::None || frame.time < _cooldownUntil )
+    {
+        return Gesture::None;
+    }
+    _cooldownUntil = frame.time + _thresholds.cooldown;
+    return gesture;
+}
+
+GestureRecognizer::Gesture
+    GestureRecognizer::update( const vr::TrackedDevicePose_t* devicePoses,
+                               vr::TrackedDeviceIndex_t leftId,
+                               vr::TrackedDeviceIndex_t rightId,
+                               double time )
+{
+    Frame frame;
+    frame.time = time;
+    const auto& hmd = devicePoses[vr::k_unTrackedDeviceIndex_Hmd];
+    frame.hmdValid = isPoseUsable( hmd );
+    for ( unsigned i = 0; i < 3; i++ )
+    {
+        frame.hmdPosition[i]
+            = static_cast<double>( hmd.mDeviceToAbsoluteTracking.m[i][3] );
+        frame.hmdVelocity[i] = static_cast<double>( hmd.vVelocity.v[i] );
+    }
+    const vr::TrackedDeviceIndex_t handIds[2] = { leftId, rightId };
+    for ( unsigned hand = 0; hand < 2; hand++ )
+    {
+        if ( handIds[hand] >= vr::k_unMaxTrackedDeviceCount
+             || !isPoseUsable( devicePoses[handIds[hand]] ) )
+        {
+            continue;
+        }
+        const auto& pose = devicePoses[handIds[hand]];
+        frame.handValid[hand] = true;
+        double angularVelocity[3];
+        for ( unsigned i = 0; i < 3; i++ )
+        {
+            frame.handPosition[hand][i] = static_cast<double>(
+                pose.mDeviceToAbsoluteTracking.m[i][3] );
+            angularVelocity[i]
+                = static_cast<double>( pose.vAngularVelocity.v[i] );
+        }
+        frame.handAngularSpeed[hand] = length( angularVelocity );
+    }
+    return update( frame );
+}
+
+void GestureRecognizer::reset() noexcept
+{
+    _next = 0;
+    _count = 0;
+    _tapSpike = false;
+    _firstTap = false;
+    _flicks[0] = FlickState();
+    _flicks[1] = FlickState();
+    _cooldownUntil = 0.0;
+}
+
+const char* GestureRecognizer::name( Gesture gesture ) noexcept
+{
+    switch ( gesture )
+    {
+    case Gesture::HeadDoubleTap:
+        return "head double tap";
+    case Gesture::LeftFlick:
+        return "left hand flick";
+    case Gesture::RightFlick:
+        return "right hand flick";
+    case Gesture::None:
+        break;
+    }
+    return "none";
+}
+
+} // end namespace utils
@@ -0,0 +1,114 @@
+#pragma once
+
+#include <openvr.h>
+
+namespace utils
+{
+/*!
+Recognizes hands-free gestures from the poses fetched once per frame.
+
+Recognized are a double tap on the headset (two short acceleration spikes of
+the HMD while a hand is close to it) and a flick of a controller (a short
+burst of angular speed). Every gesture is a small state machine that only
+looks at the newest frame and the ones kept in a fixed ring buffer, so the
+cost per frame is constant.
+
+update() takes plain Frame values, recorded frames can be fed back in to
+check thresholds for false positives and latency without a headset.
+*/
+class GestureRecognizer
+{
+public:
+    enum class Gesture
+    {
+        None,
+        HeadDoubleTap,
+        LeftFlick,
+        RightFlick,
+    };
+
+    struct Thresholds
+    {
+        // HMD acceleration of a tap, in m/s^2.
+        double tapAcceleration = 30.0;
+        // A hand has to be this close to the HMD for taps to count, in m.
+        double tapHandDistance = 0.35;
+        // Time between the two taps of a double tap, in s.
+        double doubleTapMinInterval = 0.08;
+        double doubleTapMaxInterval = 0.5;
+        // Controller angular speed of a flick, in rad/s.
+        double flickAngularSpeed = 15.0;
+        // Longer fast turns are regular movement, in s.
+        double flickMaxDuration = 0.15;
+        // No gesture is recognized for this long after one was, in s.
+        double cooldown = 1.0;
+    };
+
+    struct Frame
+    {
+        // Seconds, any monotonic clock.
+        double time = 0.0;
+        bool hmdValid = false;
+        double hmdPosition[3] = { 0.0, 0.0, 0.0 };
+        double hmdVelocity[3] = { 0.0, 0.0, 0.0 };
+        // Left and right hand.
+        bool handValid[2] = { false, false };
+        double handPosition[2][3] = { { 0.0, 0.0, 0.0 }, { 0.0, 0.0, 0.0 } };
+        double handAngularSpeed[2] = { 0.0, 0.0 };
+    };
+
+    // Enough for the acceleration window at up to 144 Hz.
+    static constexpr unsigned historySize = 8;
+
+private:
+    struct FlickState
+    {
+        bool fast = false;
+        bool tooLong = false;
+        double start = 0.0;
+    };
+
+    Thresholds _thresholds;
+    Frame _history[historySize];
+    unsigned _next = 0;
+    unsigned _count = 0;
+
+    bool _tapSpike = false;
+    bool _firstTap = false;
+    double _firstTapTime = 0.0;
+    FlickState _flicks[2];
+    double _cooldownUntil = 0.0;
+    double _lastLatency = 0.0;
+
+    const Frame& previous( unsigned age ) const noexcept;
+    bool updateDoubleTap( const Frame& frame );
+    bool updateFlick( const Frame& frame, unsigned hand );
+
+public:
+    Gesture update( const Frame& frame );
+    // Builds the frame from the poses of the current frame.
+    Gesture update( const vr::TrackedDevicePose_t* devicePoses,
+                    vr::TrackedDeviceIndex_t leftId,
+                    vr::TrackedDeviceIndex_t rightId,
+                    double time );
+    void reset() noexcept;
+
+    const Thresholds& thresholds() const noexcept
+    {
+        return _thresholds;
+    }
+    void setThresholds( const Thresholds& thresholds ) noexcept
+    {
+        _thresholds = thresholds;
+    }
+    // Seconds from the start of the last recognized gesture until it was
+    // recognized.
+    double lastLatency() const noexcept
+    {
+        return _lastLatency;
+    }
+
+    static const char* name( Gesture gesture ) noexcept;
+};
+
+} // end namespace utils
@@ -0,0 +1,170 @@
+#include "NotificationCompositor.h"
+#include <algorithm>
+#include <easylogging++.h>
+
+namespace utils
+{
+namespace
+{
+    // SetOverlayRaw() copies the whole image to the compositor, so only a
+    // few of them are done per frame.
+    constexpr unsigned k_maxUploadsPerFlush = 4;
+    constexpr std::chrono::seconds k_minRetryDelay{ 1 };
+    constexpr std::chrono::seconds k_maxRetryDelay{ 64 };
+} // namespace
+
+NotificationCompositor::Indicator*
+    NotificationCompositor::get( Id id ) noexcept
+{
+    if ( id == invalidId || id > _indicators.size()
+         || !_indicators[id - 1].inUse )
+    {
+        return nullptr;
+    }
+    return &_indicators[id - 1];
+}
+
+NotificationCompositor::Id NotificationCompositor::create(
+    unsigned width,
+    unsigned height,
+    float widthInMeters )
+{
+    size_t index = 0;
+    while ( index < _indicators.size() && _indicators[index].inUse )
+    {
+        index++;
+    }
+    if ( index == _indicators.size() )
+    {
+        const auto now = std::chrono::steady_clock::now();
+        if ( now < _retryTime )
+        {
+            return invalidId;
+        }
+        Indicator indicator;
+        const std::string key = _keyPrefix + std::to_string( index );
+        auto error = vr::VROverlay()->CreateOverlay(
+            key.c_str(), key.c_str(), &indicator.handle );
+        if ( error != vr::VROverlayError_None )
+        {
+            _retryDelay = std::min(
+                std::max( _retryDelay * 2, k_minRetryDelay ), k_maxRetryDelay );
+            _retryTime = now + _retryDelay;
+            LOG( ERROR ) << "Could not create notification overlay: "
+                         << vr::VROverlay()->GetOverlayErrorNameFromEnum(
+                                error )
+                         << ", trying again in " << _retryDelay.count()
+                         << " s";
+            return invalidId;
+        }
+        _retryDelay = std::chrono::seconds( 0 );
+        _indicators.push_back( std::move( indicator ) );
+    }
+
+    auto& indicator = _indicators[index];
+    indicator.inUse = true;
+    indicator.dirty = true;
+    indicator.visible = false;
+    indicator.canvas.resize( width, height );
+    indicator.canvas.clear( 0x00000000 );
+    vr::VROverlay()->SetOverlayWidthInMeters( indicator.handle,
+                                              widthInMeters );
+    return index + 1;
+}
+
+void NotificationCompositor::release( Id id )
+{
+    if ( auto indicator = get( id ) )
+    {
+        // Hidden right away, the overlay may be handed out again before the
+        // next flush.
+        if ( indicator->shown )
+        {
+            vr::VROverlay()->HideOverlay( indicator->handle );
+            indicator->shown = false;
+        }
+        indicator->inUse = false;
+        indicator->visible = false;
+        indicator->dirty = false;
+    }
+}
+
+void NotificationCompositor::attachToDevice(
+    Id id,
+    vr::TrackedDeviceIndex_t device,
+    const vr::HmdMatrix34_t& transform )
+{
+    if ( auto indicator = get( id ) )
+    {
+        vr::VROverlay()->SetOverlayTransformTrackedDeviceRelative(
+            indicator->handle, device, &transform );
+    }
+}
+
+RasterCanvas* NotificationCompositor::draw( Id id ) noexcept
+{
+    if ( auto indicator = get( id ) )
+    {
+        indicator->dirty = true;
+        return &indicator->canvas;
+    }
+    return nullptr;
+}
+
+void NotificationCompositor::setVisible( Id id, bool visible ) noexcept
+{
+    if ( auto indicator = get( id ) )
+    {
+        indicator->visible = visible;
+    }
+}
+
+bool NotificationCompositor::isVisible( Id id ) const noexcept
+{
+    return id != invalidId && id <= _indicators.size()
+           && _indicators[id - 1].inUse && _indicators[id - 1].visible;
+}
+
+void NotificationCompositor::flush()
+{
+    unsigned uploads = 0;
+    const size_t count = _indicators.size();
+    for ( size_t i = 0; i < count; i++ )
+    {
+        auto& indicator = _indicators[( _flushStart + i ) % count];
+        if ( !indicator.inUse )
+        {
+            continue;
+        }
+        // Hidden indicators are only uploaded once they are shown again.
+        if ( indicator.dirty && indicator.visible )
+        {
+            if ( uploads >= k_maxUploadsPerFlush )
+            {
+                // Not shown before the new image is there.
+                continue;
+            }
+            indicator.canvas.upload( indicator.handle );
+            indicator.dirty = false;
+            uploads++;
+        }
+        if ( indicator.visible != indicator.shown )
+        {
+            if ( indicator.visible )
+            {
+                vr::VROverlay()->ShowOverlay( indicator.handle );
+            }
+            else
+            {
+                vr::VROverlay()->HideOverlay( indicator.handle );
+            }
+            indicator.shown = indicator.visible;
+        }
+    }
+    if ( count > 0 )
+    {
+        _flushStart = ( _flushStart + 1 ) % count;
+    }
+}
+
+} // end namespace utils
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <chrono>
+#include <string>
+#include <utility>
+#include <vector>
+#include <openvr.h>
+#include "RasterCanvas.h"
+
+namespace utils
+{
+/*!
+Shared owner of the small status overlays (PTT indicator, battery levels,
+alarm banner).
+
+Every indicator is a CPU drawn RasterCanvas backed by its own overlay.
+Drawing and visibility changes are only recorded, flush() is called once per
+frame and sends them to OpenVR. Several changes to the same indicator within a
+frame result in a single upload, and the number of uploads per flush is
+limited so the cost stays bounded no matter how many indicators change at
+once. Released indicators keep their overlay handle and pixel buffer and are
+handed out again by the next create().
+*/
+class NotificationCompositor
+{
+public:
+    // 0 is never a valid id, so zero initialized arrays of ids are empty.
+    using Id = size_t;
+    static constexpr Id invalidId = 0;
+
+private:
+    struct Indicator
+    {
+        vr::VROverlayHandle_t handle = vr::k_ulOverlayHandleInvalid;
+        RasterCanvas canvas;
+        bool inUse = false;
+        bool dirty = false;
+        bool visible = false;
+        bool shown = false;
+    };
+
+    std::string _keyPrefix;
+    std::vector<Indicator> _indicators;
+    // Where the next flush starts uploading, so a frequently changing
+    // indicator can't starve the others.
+    size_t _flushStart = 0;
+    // After a failed CreateOverlay() no new overlay is tried before
+    // _retryTime, the delay doubles with every failure.
+    std::chrono::steady_clock::time_point _retryTime;
+    std::chrono::seconds _retryDelay{ 0 };
+
+    Indicator* get( Id id ) noexcept;
+
+public:
+    explicit NotificationCompositor( std::string keyPrefix )
+        : _keyPrefix( std::move( keyPrefix ) )
+    {
+    }
+
+    /*!
+    Returns invalidId if no overlay could be created. Callers may try again
+    every frame, after a failure new overlays are only tried again after a
+    delay of 1 s that doubles up to a minute.
+    */
+    Id create( unsigned width, unsigned height, float widthInMeters );
+    void release( Id id );
+
+    void attachToDevice( Id id,
+                         vr::TrackedDeviceIndex_t device,
+                         const vr::HmdMatrix34_t& transform );
+
+    // The returned canvas is uploaded with the next flush().
+    RasterCanvas* draw( Id id ) noexcept;
+    void setVisible( Id id, bool visible ) noexcept;
+    bool isVisible( Id id ) const noexcept;
+
+    void flush();
+};
+
+} // end namespace utils
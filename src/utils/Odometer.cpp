@@ -0,0 +1,155 @@
+#include "Odometer.h"
+#include <algorithm>
+#include <cmath>
+
+namespace utils
+{
+namespace
+{
+    // Faster movement is a jump of the tracking or the playspace, in m/s.
+    constexpr double k_maxSpeed = 10.0;
+    // Longer gaps between poses restart the integration, in s.
+    constexpr double k_maxGap = 0.5;
+    // Time constant of the noise estimate, in s. Weighting by time instead
+    // of per frame keeps the estimate independent of the refresh rate.
+    constexpr double k_noiseTimeConstant = 2.0;
+    // The threshold is this many standard deviations of the noise, ...
+    constexpr double k_noiseFactor = 3.0;
+    // ... but not less or more than this, in m.
+    constexpr double k_minThreshold = 0.002;
+    constexpr double k_maxThreshold = 0.03;
+    // Typical jitter of a well tracked HMD, in m.
+    constexpr double k_initialNoise = 0.001;
+
+    double distance3( const double a[3], const double b[3] ) noexcept
+    {
+        const double dx = a[0] - b[0];
+        const double dy = a[1] - b[1];
+        const double dz = a[2] - b[2];
+        return std::sqrt( dx * dx + dy * dy + dz * dz );
+    }
+
+    double distance2( const double a[2], double x, double z ) noexcept
+    {
+        const double dx = a[0] - x;
+        const double dz = a[1] - z;
+        return std::sqrt( dx * dx + dz * dz );
+    }
+} // namespace
+
+Odometer::Odometer() noexcept
+    : _noiseVariance( k_initialNoise * k_initialNoise )
+{
+}
+
+void Odometer::restart( const double position[3],
+                        const double velocity[3],
+                        double time ) noexcept
+{
+    _hasAnchor = true;
+    _lastTime = time;
+    for ( unsigned i = 0; i < 3; i++ )
+    {
+        _last[i] = position[i];
+        _lastVelocity[i] = velocity[i];
+        _anchor[i] = position[i];
+    }
+    _floorAnchor[0] = position[0];
+    _floorAnchor[1] = position[2];
+}
+
+void Odometer::update( bool valid,
+                       const double position[3],
+                       const double velocity[3],
+                       double time ) noexcept
+{
+    if ( !valid )
+    {
+        _hasAnchor = false;
+        return;
+    }
+    const double seconds = time - _lastTime;
+    if ( !_hasAnchor || seconds <= 0.0 || seconds > k_maxGap
+         || distance3( position, _last ) > k_maxSpeed * seconds )
+    {
+        restart( position, velocity, time );
+        return;
+    }
+
+    // Tracking noise is what the velocity doesn't explain.
+    double predicted[3];
+    for ( unsigned i = 0; i < 3; i++ )
+    {
+        predicted[i] = _last[i] + _lastVelocity[i] * seconds;
+    }
+    const double error = distance3( position, predicted );
+    const double weight = 1.0 - std::exp( -seconds / k_noiseTimeConstant );
+    _noiseVariance += weight * ( error * error - _noiseVariance );
+
+    _lastTime = time;
+    for ( unsigned i = 0; i < 3; i++ )
+    {
+        _last[i] = position[i];
+        _lastVelocity[i] = velocity[i];
+    }
+
+    // The noise of both ends makes every step longer on average, the more
+    // so the shorter the steps are. Walking at a higher refresh rate gives
+    // shorter steps, so this is taken off. The prediction error is the
+    // difference of two noisy positions too, in 3D its variance is the
+    // one a step gets, on the floor two thirds of it.
+    const double minStep = threshold();
+    const double step = distance3( position, _anchor );
+    if ( step >= minStep )
+    {
+        _distance
+            += std::sqrt( std::max( step * step - _noiseVariance, 0.0 ) );
+        for ( unsigned i = 0; i < 3; i++ )
+        {
+            _anchor[i] = position[i];
+        }
+    }
+    const double floorStep
+        = distance2( _floorAnchor, position[0], position[2] );
+    if ( floorStep >= minStep )
+    {
+        _floorDistance += std::sqrt( std::max(
+            floorStep * floorStep - _noiseVariance * 2.0 / 3.0, 0.0 ) );
+        _floorAnchor[0] = position[0];
+        _floorAnchor[1] = position[2];
+    }
+}
+
+void Odometer::update( const vr::TrackedDevicePose_t& pose,
+                       double time ) noexcept
+{
+    double position[3];
+    double velocity[3];
+    for ( unsigned i = 0; i < 3; i++ )
+    {
+        position[i]
+            = static_cast<double>( pose.mDeviceToAbsoluteTracking.m[i][3] );
+        velocity[i] = static_cast<double>( pose.vVelocity.v[i] );
+    }
+    update( pose.bPoseIsValid
+                && pose.eTrackingResult == vr::TrackingResult_Running_OK,
+            position,
+            velocity,
+            time );
+}
+
+void Odometer::resetDistance() noexcept
+{
+    _distance = 0.0;
+    _floorDistance = 0.0;
+}
+
+double Odometer::threshold() const noexcept
+{
+    return std::min(
+        std::max( k_noiseFactor * std::sqrt( _noiseVariance ),
+                  k_minThreshold ),
+        k_maxThreshold );
+}
+
+} // end namespace utils
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <openvr.h>
+
+namespace utils
+{
+/*!
+Integrates the distance a tracked device moved from its pose of every frame.
+
+Summing the distance between consecutive frames would also sum the tracking
+jitter, and how much of it depends on the refresh rate. Instead the distance
+is only counted once the position moved further than the noise from the
+last counted point (the anchor). The noise is estimated continuously from
+how far each position is off the one predicted by the previous position and
+velocity, so a setup with worse tracking gets a larger threshold. The path
+between anchors is the same at any refresh rate high enough to sample it.
+
+Jumps (lost tracking, teleports of the playspace) restart the integration
+without counting the jump. The 3D distance and the distance projected onto
+the floor are integrated separately. Every update takes constant time.
+*/
+class Odometer
+{
+private:
+    bool _hasAnchor = false;
+    double _lastTime = 0.0;
+    double _last[3] = { 0.0, 0.0, 0.0 };
+    double _lastVelocity[3] = { 0.0, 0.0, 0.0 };
+    double _anchor[3] = { 0.0, 0.0, 0.0 };
+    double _floorAnchor[2] = { 0.0, 0.0 };
+    // Mean squared prediction error, in m^2.
+    double _noiseVariance;
+
+    double _distance = 0.0;
+    double _floorDistance = 0.0;
+
+    void restart( const double position[3],
+                  const double velocity[3],
+                  double time ) noexcept;
+
+public:
+    Odometer() noexcept;
+
+    // Positions in m, velocities in m/s, time in seconds of any monotonic
+    // clock.
+    void update( bool valid,
+                 const double position[3],
+                 const double velocity[3],
+                 double time ) noexcept;
+    void update( const vr::TrackedDevicePose_t& pose, double time ) noexcept;
+
+    // Sets the distances to zero, the noise estimate is kept.
+    void resetDistance() noexcept;
+
+    double distance() const noexcept
+    {
+        return _distance;
+    }
+    double floorDistance() const noexcept
+    {
+        return _floorDistance;
+    }
+    // Distance the position has to move before it is counted, in m.
+    double threshold() const noexcept;
+};
+
+} // end namespace utils
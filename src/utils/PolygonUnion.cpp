@@ -0,0 +1,443 @@
+#include "PolygonUnion.h"
+#include <algorithm>
+#include <cmath>
+
+namespace utils
+{
+namespace
+{
+    using Point = PolygonUnion::Point;
+
+    bool operator==( const Point& a, const Point& b ) noexcept
+    {
+        return a.x == b.x && a.z == b.z;
+    }
+
+    bool operator<( const Point& a, const Point& b ) noexcept
+    {
+        return a.x < b.x || ( a.x == b.x && a.z < b.z );
+    }
+
+    // Twice the signed area of the triangle, positive if c is left of a->b.
+    int64_t orient( const Point& a, const Point& b, const Point& c ) noexcept
+    {
+        return ( b.x - a.x ) * ( c.z - a.z ) - ( b.z - a.z ) * ( c.x - a.x );
+    }
+
+    int sign( int64_t value ) noexcept
+    {
+        return ( value > 0 ) - ( value < 0 );
+    }
+
+    // p is known to be on the line through a and b.
+    bool isWithin( const Point& p, const Point& a, const Point& b ) noexcept
+    {
+        return std::min( a.x, b.x ) <= p.x && p.x <= std::max( a.x, b.x )
+               && std::min( a.z, b.z ) <= p.z && p.z <= std::max( a.z, b.z );
+    }
+
+    double signedArea( const std::vector<Point>& polygon ) noexcept
+    {
+        double area = 0.0;
+        for ( size_t i = 0, j = polygon.size() - 1; i < polygon.size();
+              j = i++ )
+        {
+            area += static_cast<double>( polygon[j].x )
+                        * static_cast<double>( polygon[i].z )
+                    - static_cast<double>( polygon[i].x )
+                          * static_cast<double>( polygon[j].z );
+        }
+        return area / 2.0;
+    }
+
+    struct Piece
+    {
+        Point a;
+        Point b;
+        uint32_t polygon;
+        // The piece starts on the outline of another polygon.
+        bool startsOnOutline = false;
+        // Lies on an edge of another polygon.
+        bool isShared = false;
+        bool isKept = false;
+        // Undirected key, the smaller point first.
+        Point low() const noexcept
+        {
+            return a < b ? a : b;
+        }
+        Point high() const noexcept
+        {
+            return a < b ? b : a;
+        }
+    };
+} // namespace
+
+PolygonUnion::PolygonUnion( double gridSize ) noexcept : _gridSize( gridSize )
+{
+}
+
+void PolygonUnion::clear()
+{
+    _polygons.clear();
+    _pieces = 0;
+}
+
+void PolygonUnion::add( const std::vector<vr::HmdVector2_t>& corners )
+{
+    std::vector<Point> polygon;
+    polygon.reserve( corners.size() );
+    for ( const auto& corner : corners )
+    {
+        const Point point{
+            std::llround( static_cast<double>( corner.v[0] ) / _gridSize ),
+            std::llround( static_cast<double>( corner.v[1] ) / _gridSize ) };
+        if ( polygon.empty() || !( polygon.back() == point ) )
+        {
+            polygon.push_back( point );
+        }
+    }
+    while ( polygon.size() > 1 && polygon.back() == polygon.front() )
+    {
+        polygon.pop_back();
+    }
+    if ( polygon.size() < 3 )
+    {
+        return;
+    }
+    const double area = signedArea( polygon );
+    if ( area == 0.0 )
+    {
+        return;
+    }
+    if ( area < 0.0 )
+    {
+        std::reverse( polygon.begin(), polygon.end() );
+    }
+    _polygons.push_back( std::move( polygon ) );
+}
+
+bool PolygonUnion::isInside( const Point& doubledPoint,
+                             uint32_t polygon ) const
+{
+    // Winding number, with the polygon scaled by two like the point.
+    const auto& corners = _polygons[polygon];
+    int winding = 0;
+    for ( size_t i = 0, j = corners.size() - 1; i < corners.size(); j = i++ )
+    {
+        const Point u{ 2 * corners[j].x, 2 * corners[j].z };
+        const Point v{ 2 * corners[i].x, 2 * corners[i].z };
+        if ( u.z <= doubledPoint.z )
+        {
+            if ( v.z > doubledPoint.z && orient( u, v, doubledPoint ) > 0 )
+            {
+                winding++;
+            }
+        }
+        else if ( v.z <= doubledPoint.z && orient( u, v, doubledPoint ) < 0 )
+        {
+            winding--;
+        }
+    }
+    return winding != 0;
+}
+
+std::vector<vr::HmdVector2_t> PolygonUnion::compute()
+{
+    _pieces = 0;
+    std::vector<Edge> edges;
+    for ( uint32_t p = 0; p < _polygons.size(); p++ )
+    {
+        const auto& polygon = _polygons[p];
+        for ( size_t i = 0; i < polygon.size(); i++ )
+        {
+            edges.push_back(
+                { polygon[i], polygon[( i + 1 ) % polygon.size()], p } );
+        }
+    }
+
+    // Points every edge has to be split at, found with a sweep in x, and
+    // all points where edges of different polygons meet.
+    std::vector<std::vector<Point>> splits( edges.size() );
+    std::vector<Point> contacts;
+    std::vector<uint32_t> order( edges.size() );
+    for ( uint32_t i = 0; i < order.size(); i++ )
+    {
+        order[i] = i;
+    }
+    auto minX = [&edges]( uint32_t i ) {
+        return std::min( edges[i].a.x, edges[i].b.x );
+    };
+    std::sort( order.begin(), order.end(), [&minX]( uint32_t a, uint32_t b ) {
+        return minX( a ) < minX( b );
+    } );
+    for ( size_t oi = 0; oi < order.size(); oi++ )
+    {
+        const Edge& p = edges[order[oi]];
+        const int64_t maxX = std::max( p.a.x, p.b.x );
+        const int64_t pMinZ = std::min( p.a.z, p.b.z );
+        const int64_t pMaxZ = std::max( p.a.z, p.b.z );
+        for ( size_t oj = oi + 1;
+              oj < order.size() && minX( order[oj] ) <= maxX;
+              oj++ )
+        {
+            const Edge& q = edges[order[oj]];
+            if ( q.polygon == p.polygon
+                 || std::max( q.a.z, q.b.z ) < pMinZ
+                 || std::min( q.a.z, q.b.z ) > pMaxZ )
+            {
+                continue;
+            }
+            auto& pSplits = splits[order[oi]];
+            auto& qSplits = splits[order[oj]];
+            const int64_t d1 = orient( q.a, q.b, p.a );
+            const int64_t d2 = orient( q.a, q.b, p.b );
+            const int64_t d3 = orient( p.a, p.b, q.a );
+            const int64_t d4 = orient( p.a, p.b, q.b );
+            if ( sign( d1 ) * sign( d2 ) < 0 && sign( d3 ) * sign( d4 ) < 0 )
+            {
+                // Proper crossing, the only place anything is rounded.
+                const double t = static_cast<double>( d1 )
+                                 / static_cast<double>( d1 - d2 );
+                const double x = static_cast<double>( p.a.x )
+                                 + t * static_cast<double>( p.b.x - p.a.x );
+                const double z = static_cast<double>( p.a.z )
+                                 + t * static_cast<double>( p.b.z - p.a.z );
+                const Point crossing{ std::llround( x ), std::llround( z ) };
+                pSplits.push_back( crossing );
+                qSplits.push_back( crossing );
+                contacts.push_back( crossing );
+                continue;
+            }
+            // Touching or overlapping, split at the corners on the other edge.
+            if ( d1 == 0 && isWithin( p.a, q.a, q.b ) )
+            {
+                qSplits.push_back( p.a );
+                contacts.push_back( p.a );
+            }
+            if ( d2 == 0 && isWithin( p.b, q.a, q.b ) )
+            {
+                qSplits.push_back( p.b );
+                contacts.push_back( p.b );
+            }
+            if ( d3 == 0 && isWithin( q.a, p.a, p.b ) )
+            {
+                pSplits.push_back( q.a );
+                contacts.push_back( q.a );
+            }
+            if ( d4 == 0 && isWithin( q.b, p.a, p.b ) )
+            {
+                pSplits.push_back( q.b );
+                contacts.push_back( q.b );
+            }
+        }
+    }
+
+    auto pointLess = []( const Point& a, const Point& b ) { return a < b; };
+    auto pointEqual = []( const Point& a, const Point& b ) { return a == b; };
+    std::sort( contacts.begin(), contacts.end(), pointLess );
+    contacts.erase(
+        std::unique( contacts.begin(), contacts.end(), pointEqual ),
+        contacts.end() );
+
+    // Pieces of every polygon in order around it.
+    std::vector<Piece> pieces;
+    for ( size_t e = 0; e < edges.size(); e++ )
+    {
+        const Edge& edge = edges[e];
+        auto& points = splits[e];
+        points.push_back( edge.a );
+        points.push_back( edge.b );
+        const int64_t dx = edge.b.x - edge.a.x;
+        const int64_t dz = edge.b.z - edge.a.z;
+        auto along = [&edge, dx, dz]( const Point& point ) {
+            return ( point.x - edge.a.x ) * dx + ( point.z - edge.a.z ) * dz;
+        };
+        std::sort( points.begin(),
+                   points.end(),
+                   [&along]( const Point& a, const Point& b ) {
+                       return along( a ) < along( b );
+                   } );
+        points.erase( std::unique( points.begin(), points.end(), pointEqual ),
+                      points.end() );
+        for ( size_t i = 0; i + 1 < points.size(); i++ )
+        {
+            Piece piece{ points[i], points[i + 1], edge.polygon };
+            piece.startsOnOutline = std::binary_search(
+                contacts.begin(), contacts.end(), points[i], pointLess );
+            pieces.push_back( piece );
+        }
+    }
+
+    // Pieces on the same segment are next to each other after sorting.
+    std::vector<uint32_t> byKey( pieces.size() );
+    for ( uint32_t i = 0; i < byKey.size(); i++ )
+    {
+        byKey[i] = i;
+    }
+    std::sort(
+        byKey.begin(), byKey.end(), [&pieces]( uint32_t a, uint32_t b ) {
+            const Point aLow = pieces[a].low();
+            const Point bLow = pieces[b].low();
+            return aLow < bLow
+                   || ( aLow == bLow && pieces[a].high() < pieces[b].high() );
+        } );
+    std::vector<uint32_t> shared;
+    for ( size_t first = 0; first < byKey.size(); )
+    {
+        const Piece& piece = pieces[byKey[first]];
+        size_t last = first + 1;
+        bool opposite = false;
+        shared.assign( 1, piece.polygon );
+        while ( last < byKey.size()
+                && pieces[byKey[last]].low() == piece.low()
+                && pieces[byKey[last]].high() == piece.high() )
+        {
+            opposite = opposite || !( pieces[byKey[last]].a == piece.a );
+            shared.push_back( pieces[byKey[last]].polygon );
+            last++;
+        }
+        if ( last - first > 1 )
+        {
+            // Kept once if all polygons are on the same side of it.
+            const Point middle{ piece.a.x + piece.b.x, piece.a.z + piece.b.z };
+            bool covered = opposite;
+            for ( uint32_t p = 0; p < _polygons.size() && !covered; p++ )
+            {
+                covered = std::find( shared.begin(), shared.end(), p )
+                              == shared.end()
+                          && isInside( middle, p );
+            }
+            for ( size_t i = first; i < last; i++ )
+            {
+                pieces[byKey[i]].isShared = true;
+            }
+            pieces[byKey[first]].isKept = !covered;
+        }
+        first = last;
+    }
+
+    // Whether a piece is inside another polygon can only change where the
+    // outline of one is reached, in between the last answer still holds.
+    std::vector<Piece> outline;
+    bool covered = false;
+    bool isCoveredKnown = false;
+    for ( size_t i = 0; i < pieces.size(); i++ )
+    {
+        Piece& piece = pieces[i];
+        if ( piece.isShared )
+        {
+            isCoveredKnown = false;
+        }
+        else
+        {
+            if ( !isCoveredKnown || piece.startsOnOutline
+                 || piece.polygon != pieces[i - 1].polygon )
+            {
+                const Point middle{ piece.a.x + piece.b.x,
+                                    piece.a.z + piece.b.z };
+                covered = false;
+                for ( uint32_t p = 0; p < _polygons.size() && !covered; p++ )
+                {
+                    covered = p != piece.polygon && isInside( middle, p );
+                }
+                isCoveredKnown = true;
+            }
+            piece.isKept = !covered;
+        }
+        if ( piece.isKept )
+        {
+            outline.push_back( piece );
+        }
+    }
+
+    // Link the pieces into loops. Where several loops touch in a corner the
+    // sharpest left turn is taken, which keeps the loops apart.
+    std::sort( outline.begin(),
+               outline.end(),
+               []( const Piece& a, const Piece& b ) { return a.a < b.a; } );
+    std::vector<bool> used( outline.size(), false );
+    std::vector<Point> best;
+    double bestArea = 0.0;
+    std::vector<Point> loop;
+    for ( size_t start = 0; start < outline.size(); start++ )
+    {
+        if ( used[start] )
+        {
+            continue;
+        }
+        loop.clear();
+        size_t current = start;
+        bool closed = false;
+        while ( true )
+        {
+            used[current] = true;
+            loop.push_back( outline[current].a );
+            const Piece& in = outline[current];
+            if ( in.b == outline[start].a )
+            {
+                closed = true;
+                break;
+            }
+            auto range = std::equal_range(
+                outline.begin(),
+                outline.end(),
+                Piece{ in.b, in.b, 0 },
+                []( const Piece& a, const Piece& b ) { return a.a < b.a; } );
+            size_t next = outline.size();
+            double nextTurn = 0.0;
+            for ( auto it = range.first; it != range.second; ++it )
+            {
+                const auto index
+                    = static_cast<size_t>( it - outline.begin() );
+                if ( used[index] )
+                {
+                    continue;
+                }
+                const double inX = static_cast<double>( in.b.x - in.a.x );
+                const double inZ = static_cast<double>( in.b.z - in.a.z );
+                const double outX = static_cast<double>( it->b.x - it->a.x );
+                const double outZ = static_cast<double>( it->b.z - it->a.z );
+                const double turn = std::atan2( inX * outZ - inZ * outX,
+                                                inX * outX + inZ * outZ );
+                if ( next == outline.size() || turn > nextTurn )
+                {
+                    next = index;
+                    nextTurn = turn;
+                }
+            }
+            if ( next == outline.size() )
+            {
+                break;
+            }
+            current = next;
+        }
+        if ( !closed || loop.size() < 3 )
+        {
+            continue;
+        }
+        // Holes run clockwise.
+        const double area = signedArea( loop );
+        if ( area > 0.0 )
+        {
+            _pieces++;
+            if ( area > bestArea )
+            {
+                bestArea = area;
+                best.swap( loop );
+            }
+        }
+    }
+
+    std::vector<vr::HmdVector2_t> result;
+    result.reserve( best.size() );
+    for ( const auto& point : best )
+    {
+        const double x = static_cast<double>( point.x ) * _gridSize;
+        const double z = static_cast<double>( point.z ) * _gridSize;
+        result.push_back(
+            { { static_cast<float>( x ), static_cast<float>( z ) } } );
+    }
+    return result;
+}
+
+} // end namespace utils
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include <openvr.h>
+
+namespace utils
+{
+/*!
+Unites polygons on the floor, for merging the bounds of several chaperone
+profiles into one.
+
+All corners are snapped to a grid and the predicates (which side of an edge
+a point is on) are evaluated exactly in integers, so nearly parallel or
+touching edges can't give contradicting answers. Only the intersection
+points of crossing edges are rounded to the grid.
+
+The edges of all polygons are split where they cross or touch edges of the
+other polygons. A piece of an edge is part of the outline if it lies outside
+of all other polygons; pieces shared by two polygons are kept once if both
+polygons are on the same side and dropped otherwise. The kept pieces are
+linked into loops again. Crossing edges are found with a sweep over the
+edges sorted by x. Whether a piece is inside another polygon can only change
+where it meets the outline of another polygon, so the point in polygon test
+only runs for the first piece after such a point.
+
+Polygons must be simple (not intersect themselves), their orientation
+doesn't matter. Coordinates must stay below 10^8 grid units.
+*/
+class PolygonUnion
+{
+public:
+    struct Point
+    {
+        int64_t x = 0;
+        int64_t z = 0;
+    };
+
+private:
+    struct Edge
+    {
+        Point a;
+        Point b;
+        uint32_t polygon = 0;
+    };
+
+    double _gridSize;
+    // Counterclockwise, without repeated corners.
+    std::vector<std::vector<Point>> _polygons;
+    size_t _pieces = 0;
+
+    bool isInside( const Point& doubledPoint, uint32_t polygon ) const;
+
+public:
+    // Size of the grid the corners are snapped to, in m.
+    explicit PolygonUnion( double gridSize = 0.001 ) noexcept;
+
+    void clear();
+    // Corners as x and z. Polygons with less than three corners are ignored.
+    void add( const std::vector<vr::HmdVector2_t>& corners );
+
+    /*!
+    Returns the outline of the union, with the inside on the left of every
+    edge for x to the right and z up. If the polygons don't all overlap the
+    union falls apart into several pieces and the largest one is returned.
+    Holes are left out. Empty if nothing was added.
+    */
+    std::vector<vr::HmdVector2_t> compute();
+
+    // Pieces the last union fell apart into.
+    size_t pieces() const noexcept
+    {
+        return _pieces;
+    }
+};
+
+} // end namespace utils
@@ -0,0 +1,145 @@
+#include "PolylineSimplifier.h"
+#include <algorithm>
+#include <cmath>
+
+namespace utils
+{
+namespace
+{
+    using Point = PolylineSimplifier::Point;
+
+    float squaredDistance( const Point& a, const Point& b ) noexcept
+    {
+        const float dx = a.x - b.x;
+        const float dz = a.z - b.z;
+        return dx * dx + dz * dz;
+    }
+
+    // Squared distance of p to the segment from a to b.
+    float squaredSegmentDistance( const Point& p,
+                                  const Point& a,
+                                  const Point& b ) noexcept
+    {
+        const float ux = b.x - a.x;
+        const float uz = b.z - a.z;
+        const float length = ux * ux + uz * uz;
+        if ( length <= 0.0f )
+        {
+            return squaredDistance( p, a );
+        }
+        const float t = std::min(
+            std::max( ( ( p.x - a.x ) * ux + ( p.z - a.z ) * uz ) / length,
+                      0.0f ),
+            1.0f );
+        return squaredDistance( p, { a.x + t * ux, a.z + t * uz } );
+    }
+} // namespace
+
+PolylineSimplifier::PolylineSimplifier( float minDistance,
+                                        float tolerance,
+                                        size_t windowSize ) noexcept
+    : _minDistance( minDistance ), _tolerance( tolerance ),
+      _windowSize( std::max( windowSize, size_t( 3 ) ) )
+{
+}
+
+void PolylineSimplifier::reset() noexcept
+{
+    _window.clear();
+    _result.clear();
+}
+
+void PolylineSimplifier::add( float x, float z )
+{
+    const Point point{ x, z };
+    if ( !_window.empty()
+         && squaredDistance( point, _window.back() )
+                < _minDistance * _minDistance )
+    {
+        return;
+    }
+    if ( _window.empty() )
+    {
+        // The start of the trace is always a vertex.
+        _result.push_back( point );
+    }
+    _window.push_back( point );
+    if ( _window.size() >= _windowSize )
+    {
+        simplifyWindow( false );
+    }
+}
+
+void PolylineSimplifier::simplifyWindow( bool final )
+{
+    const size_t count = _window.size();
+    if ( count < 2 )
+    {
+        return;
+    }
+    // The first point of the window is already in the result.
+    _keep.assign( count, false );
+    _keep.front() = true;
+    _keep.back() = true;
+    const float tolerance = _tolerance * _tolerance;
+    _ranges.clear();
+    _ranges.emplace_back( 0, count - 1 );
+    while ( !_ranges.empty() )
+    {
+        const auto range = _ranges.back();
+        _ranges.pop_back();
+        float maxDistance = 0.0f;
+        size_t farthest = range.first;
+        for ( size_t i = range.first + 1; i < range.second; i++ )
+        {
+            const float distance = squaredSegmentDistance(
+                _window[i], _window[range.first], _window[range.second] );
+            if ( distance > maxDistance )
+            {
+                maxDistance = distance;
+                farthest = i;
+            }
+        }
+        if ( maxDistance > tolerance )
+        {
+            _keep[farthest] = true;
+            _ranges.emplace_back( range.first, farthest );
+            _ranges.emplace_back( farthest, range.second );
+        }
+    }
+
+    // All vertices but the last are final, the last one starts the next
+    // window. If the window was a straight line it is shortened to its end
+    // points, which are within the tolerance of everything in between.
+    size_t last = 0;
+    for ( size_t i = 1; i < count - 1; i++ )
+    {
+        if ( _keep[i] )
+        {
+            _result.push_back( _window[i] );
+            last = i;
+        }
+    }
+    if ( final )
+    {
+        _result.push_back( _window.back() );
+        _window.clear();
+    }
+    else if ( last > 0 )
+    {
+        _window.erase( _window.begin(),
+                       _window.begin() + static_cast<std::ptrdiff_t>( last ) );
+    }
+    else
+    {
+        _window.erase( _window.begin() + 1, _window.end() - 1 );
+    }
+}
+
+const std::vector<PolylineSimplifier::Point>& PolylineSimplifier::finish()
+{
+    simplifyWindow( true );
+    return _result;
+}
+
+} // end namespace utils
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+namespace utils
+{
+/*!
+Simplifies a stream of points on the floor while they are added.
+
+Points closer than the minimum distance to the last accepted one are dropped
+right away (radial distance filter). The accepted points are collected in a
+window of fixed size; whenever it is full it is simplified with
+Douglas-Peucker and the vertices found are moved to the result. Only the last
+vertex stays in the window as the start of the next one, so memory is bounded
+by the window size plus the vertices of the result, however long the trace.
+
+Within a window no point is further than the tolerance from the result. A
+full window that is a straight line is shortened to its end points, which can
+add up to the tolerance again for the points dropped with it.
+*/
+class PolylineSimplifier
+{
+public:
+    struct Point
+    {
+        float x = 0.0f;
+        float z = 0.0f;
+    };
+
+private:
+    float _minDistance;
+    float _tolerance;
+    size_t _windowSize;
+    std::vector<Point> _window;
+    std::vector<Point> _result;
+    // Reused by simplifyWindow().
+    std::vector<bool> _keep;
+    std::vector<std::pair<size_t, size_t>> _ranges;
+
+    void simplifyWindow( bool final );
+
+public:
+    PolylineSimplifier( float minDistance,
+                        float tolerance,
+                        size_t windowSize ) noexcept;
+
+    void reset() noexcept;
+    void add( float x, float z );
+    // Simplifies the rest of the window and returns all vertices.
+    const std::vector<Point>& finish();
+
+    // Vertices found so far, without the ones still in the window.
+    size_t vertexCount() const noexcept
+    {
+        return _result.size();
+    }
+};
+
+} // end namespace utils
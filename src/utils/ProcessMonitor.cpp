@@ -0,0 +1,254 @@
+#include "ProcessMonitor.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#ifdef _WIN32
+#    include <Windows.h>
+#    include <Psapi.h>
+#    include <TlHelp32.h>
+#else
+#    include <dirent.h>
+#    include <unistd.h>
+#endif
+
+namespace utils
+{
+#ifdef _WIN32
+bool ProcessMonitor::readCounters( Counters& counters )
+{
+    HANDLE process = GetCurrentProcess();
+    FILETIME creationTime, exitTime, kernelTime, userTime;
+    if ( !GetProcessTimes(
+             process, &creationTime, &exitTime, &kernelTime, &userTime ) )
+    {
+        return false;
+    }
+    auto toSeconds = []( const FILETIME& time ) {
+        ULARGE_INTEGER value;
+        value.LowPart = time.dwLowDateTime;
+        value.HighPart = time.dwHighDateTime;
+        // 100 ns units
+        return static_cast<double>( value.QuadPart ) * 1e-7;
+    };
+    counters.cpuSeconds = toSeconds( kernelTime ) + toSeconds( userTime );
+
+    PROCESS_MEMORY_COUNTERS memory;
+    if ( GetProcessMemoryInfo( process, &memory, sizeof( memory ) ) )
+    {
+        counters.residentBytes = memory.WorkingSetSize;
+    }
+
+    // Windows only reports context switches per thread through the native
+    // API, so they are left out.
+    counters.threads = 0;
+    HANDLE snapshot = CreateToolhelp32Snapshot( TH32CS_SNAPTHREAD, 0 );
+    if ( snapshot != INVALID_HANDLE_VALUE )
+    {
+        const DWORD processId = GetCurrentProcessId();
+        THREADENTRY32 entry;
+        entry.dwSize = sizeof( entry );
+        for ( BOOL ok = Thread32First( snapshot, &entry ); ok;
+              ok = Thread32Next( snapshot, &entry ) )
+        {
+            if ( entry.th32OwnerProcessID == processId )
+            {
+                counters.threads++;
+            }
+        }
+        CloseHandle( snapshot );
+    }
+    return true;
+}
+#else
+namespace
+{
+    // Voluntary and involuntary context switches of a thread.
+    int64_t readContextSwitches( const char* statusPath )
+    {
+        FILE* file = std::fopen( statusPath, "r" );
+        if ( !file )
+        {
+            // The thread has exited in the meantime.
+            return 0;
+        }
+        int64_t contextSwitches = 0;
+        char line[128];
+        long value = 0;
+        while ( std::fgets( line, sizeof( line ), file ) )
+        {
+            if ( std::sscanf( line, "voluntary_ctxt_switches: %ld", &value )
+                     == 1
+                 || std::sscanf(
+                        line, "nonvoluntary_ctxt_switches: %ld", &value )
+                        == 1 )
+            {
+                contextSwitches += value;
+            }
+        }
+        std::fclose( file );
+        return contextSwitches;
+    }
+
+    // Time a thread has been runnable but waiting for a core.
+    int64_t readWaitNanoseconds( const char* schedstatPath )
+    {
+        FILE* file = std::fopen( schedstatPath, "r" );
+        if ( !file )
+        {
+            return 0;
+        }
+        long long waitNanoseconds = 0;
+        if ( std::fscanf( file, "%*u %lld", &waitNanoseconds ) != 1 )
+        {
+            waitNanoseconds = 0;
+        }
+        std::fclose( file );
+        return waitNanoseconds;
+    }
+} // namespace
+
+bool ProcessMonitor::readCounters( Counters& counters )
+{
+    // /proc/self/stat, the process name in field 2 may contain spaces so
+    // parsing starts after its closing parenthesis.
+    char buffer[1024];
+    FILE* file = std::fopen( "/proc/self/stat", "r" );
+    if ( !file )
+    {
+        return false;
+    }
+    const size_t length = std::fread( buffer, 1, sizeof( buffer ) - 1, file );
+    std::fclose( file );
+    buffer[length] = '\0';
+    const char* fields = std::strrchr( buffer, ')' );
+    unsigned long userTicks = 0;
+    unsigned long systemTicks = 0;
+    long threads = 0;
+    if ( !fields
+         || std::sscanf( fields + 1,
+                         " %*c %*d %*d %*d %*d %*d %*u %*u %*u %*u %*u %lu %lu"
+                         " %*d %*d %*d %*d %ld",
+                         &userTicks,
+                         &systemTicks,
+                         &threads )
+                != 3 )
+    {
+        return false;
+    }
+    static const double ticksPerSecond
+        = static_cast<double>( sysconf( _SC_CLK_TCK ) );
+    counters.cpuSeconds
+        = static_cast<double>( userTicks + systemTicks ) / ticksPerSecond;
+    counters.threads = static_cast<unsigned>( threads );
+
+    file = std::fopen( "/proc/self/statm", "r" );
+    if ( file )
+    {
+        unsigned long residentPages = 0;
+        if ( std::fscanf( file, "%*u %lu", &residentPages ) == 1 )
+        {
+            static const uint64_t pageSize
+                = static_cast<uint64_t>( sysconf( _SC_PAGESIZE ) );
+            counters.residentBytes = residentPages * pageSize;
+        }
+        std::fclose( file );
+    }
+
+    // Context switches and run queue waits are only reported per thread,
+    // /proc/self/status and /proc/self/schedstat only cover the main thread.
+    // They are summed up over all threads instead.
+    DIR* tasks = opendir( "/proc/self/task" );
+    if ( tasks )
+    {
+        counters.contextSwitches = 0;
+        counters.waitNanoseconds = 0;
+        char path[sizeof( "/proc/self/task//schedstat" )
+                  + sizeof( dirent::d_name )];
+        while ( const dirent* task = readdir( tasks ) )
+        {
+            if ( task->d_name[0] == '.' )
+            {
+                continue;
+            }
+            std::snprintf( path,
+                           sizeof( path ),
+                           "/proc/self/task/%s/status",
+                           task->d_name );
+            counters.contextSwitches += readContextSwitches( path );
+            std::snprintf( path,
+                           sizeof( path ),
+                           "/proc/self/task/%s/schedstat",
+                           task->d_name );
+            counters.waitNanoseconds += readWaitNanoseconds( path );
+        }
+        closedir( tasks );
+    }
+    return true;
+}
+#endif
+
+bool ProcessMonitor::sample()
+{
+    Counters counters;
+    if ( !readCounters( counters ) )
+    {
+        return false;
+    }
+    const auto now = std::chrono::steady_clock::now();
+    if ( _hasPrevious )
+    {
+        const double seconds
+            = std::chrono::duration<double>( now - _previousTime ).count();
+        if ( seconds > 0.0 )
+        {
+            Sample& sample = _history[_next];
+            sample.cpuPercent
+                = 100.0 * ( counters.cpuSeconds - _previous.cpuSeconds )
+                  / seconds;
+            sample.residentBytes = counters.residentBytes;
+            sample.threads = counters.threads;
+            // The per thread sums drop when a thread exits.
+            sample.contextSwitchesPerSecond
+                = counters.contextSwitches >= 0
+                          && _previous.contextSwitches >= 0
+                      ? static_cast<double>( std::max<int64_t>(
+                            counters.contextSwitches
+                                - _previous.contextSwitches,
+                            0 ) )
+                            / seconds
+                      : -1.0;
+            sample.runQueueWaitPercent
+                = counters.waitNanoseconds >= 0
+                          && _previous.waitNanoseconds >= 0
+                      ? 100.0e-9
+                            * static_cast<double>( std::max<int64_t>(
+                                counters.waitNanoseconds
+                                    - _previous.waitNanoseconds,
+                                0 ) )
+                            / seconds
+                      : -1.0;
+            _next = ( _next + 1 ) % historySize;
+            if ( _count < historySize )
+            {
+                _count++;
+            }
+        }
+    }
+    _previous = counters;
+    _previousTime = now;
+    _hasPrevious = true;
+    return true;
+}
+
+const ProcessMonitor::Sample&
+    ProcessMonitor::at( unsigned index ) const noexcept
+{
+    return _history[( _next + historySize - _count + index ) % historySize];
+}
+
+const ProcessMonitor::Sample& ProcessMonitor::latest() const noexcept
+{
+    return at( _count > 0 ? _count - 1 : 0 );
+}
+
+} // end namespace utils
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+
+namespace utils
+{
+/*!
+Samples the resource usage of the overlay process itself.
+
+Reads CPU time, resident memory, thread count, context switches and run
+queue wait time from /proc/self on Linux and the process APIs on Windows.
+All figures cover the whole process, the per thread counters are summed up
+over /proc/self/task. Meant to be called at low frequency, every sample()
+does a few small reads per thread from the OS. The last historySize samples
+are kept in a fixed ring buffer.
+*/
+class ProcessMonitor
+{
+public:
+    struct Sample
+    {
+        // Percent of one core since the previous sample.
+        double cpuPercent = 0.0;
+        uint64_t residentBytes = 0;
+        unsigned threads = 0;
+        // Voluntary and involuntary of all threads, per second since the
+        // previous sample. Negative if the platform doesn't report them.
+        double contextSwitchesPerSecond = -1.0;
+        // Time all threads together were runnable but waiting for a core,
+        // in percent of one core. Negative if the platform doesn't report
+        // it.
+        double runQueueWaitPercent = -1.0;
+    };
+
+    static constexpr unsigned historySize = 60;
+
+private:
+    struct Counters
+    {
+        double cpuSeconds = 0.0;
+        uint64_t residentBytes = 0;
+        unsigned threads = 0;
+        int64_t contextSwitches = -1;
+        int64_t waitNanoseconds = -1;
+    };
+
+    Sample _history[historySize];
+    unsigned _next = 0;
+    unsigned _count = 0;
+    bool _hasPrevious = false;
+    Counters _previous;
+    std::chrono::steady_clock::time_point _previousTime;
+
+    static bool readCounters( Counters& counters );
+
+public:
+    // Returns false if the counters could not be read.
+    bool sample();
+
+    unsigned count() const noexcept
+    {
+        return _count;
+    }
+    // 0 is the oldest sample, count() - 1 the newest.
+    const Sample& at( unsigned index ) const noexcept;
+    const Sample& latest() const noexcept;
+};
+
+} // end namespace utils
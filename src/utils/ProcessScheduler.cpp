@@ -0,0 +1,307 @@
+#include "ProcessScheduler.h"
+#include <algorithm>
+#include <cstdlib>
+#include <thread>
+#include <easylogging++.h>
+#ifdef _WIN32
+#    include <Windows.h>
+#else
+#    include <cerrno>
+#    include <cstring>
+#    include <dirent.h>
+#    include <sched.h>
+#    include <sys/resource.h>
+#    include <sys/syscall.h>
+#    include <sys/types.h>
+#    include <unistd.h>
+#endif
+
+namespace utils
+{
+namespace
+{
+#ifndef _WIN32
+    // Calls fn( tid ) for every thread of the process, threads created later
+    // inherit the settings of their creator.
+    template <typename Fn> bool forEachThread( Fn fn )
+    {
+        DIR* tasks = opendir( "/proc/self/task" );
+        if ( !tasks )
+        {
+            return false;
+        }
+        bool ok = true;
+        while ( dirent* entry = readdir( tasks ) )
+        {
+            if ( entry->d_name[0] == '.' )
+            {
+                continue;
+            }
+            ok = fn( static_cast<pid_t>( std::atoi( entry->d_name ) ) ) && ok;
+        }
+        closedir( tasks );
+        return ok;
+    }
+
+    // Nice value of background threads. SCHED_BATCH alone keeps the nice
+    // value and only makes the scheduler assume the thread is CPU bound.
+    constexpr int k_backgroundNice = 10;
+
+    pid_t currentThreadId()
+    {
+        return static_cast<pid_t>( syscall( SYS_gettid ) );
+    }
+
+    /*!
+    Without CAP_SYS_NICE a thread can only lower its nice value within
+    RLIMIT_NICE, which is 0 by default. Then a lowered priority can't be
+    raised again.
+    */
+    bool canRaisePriority()
+    {
+        rlimit limit{};
+        return geteuid() == 0
+               || ( getrlimit( RLIMIT_NICE, &limit ) == 0
+                    && ( limit.rlim_cur == RLIM_INFINITY
+                         || limit.rlim_cur >= 20 ) );
+    }
+
+    /*!
+    Fails if the scheduling policy can't be changed or, when going back to
+    normal, the nice value can't be restored. The latter sets niceDenied and
+    isn't logged here, it happens for every thread.
+    */
+    bool setPolicy( pid_t tid, bool background, bool& niceDenied )
+    {
+        sched_param param{};
+        if ( sched_setscheduler(
+                 tid, background ? SCHED_BATCH : SCHED_OTHER, &param )
+             != 0 )
+        {
+            LOG( WARNING ) << "Could not change scheduling policy of thread "
+                           << tid << ": " << std::strerror( errno );
+            return false;
+        }
+        // The thread id selects a single thread on Linux.
+        if ( setpriority( PRIO_PROCESS,
+                          static_cast<id_t>( tid ),
+                          background ? k_backgroundNice : 0 )
+             != 0 )
+        {
+            if ( !background && ( errno == EACCES || errno == EPERM ) )
+            {
+                niceDenied = true;
+                return false;
+            }
+            LOG( WARNING ) << "Could not change nice value of thread " << tid
+                           << ": " << std::strerror( errno );
+        }
+        return true;
+    }
+#endif
+} // namespace
+
+bool ProcessScheduler::setBackground( bool background )
+{
+    if ( background == _background )
+    {
+        return true;
+    }
+#ifdef _WIN32
+    const bool ok
+        = SetPriorityClass( GetCurrentProcess(),
+                            background ? BELOW_NORMAL_PRIORITY_CLASS
+                                       : NORMAL_PRIORITY_CLASS )
+          != 0;
+#else
+    // The main thread is handled by applyMainThreadPriority().
+    const pid_t mainThread = currentThreadId();
+    bool niceDenied = false;
+    const bool ok
+        = forEachThread( [background, mainThread, &niceDenied]( pid_t tid ) {
+              return tid == mainThread
+                     || setPolicy( tid, background, niceDenied );
+          } );
+    if ( niceDenied )
+    {
+        // Stays in background mode, the threads keep nice 10.
+        if ( !_niceDeniedLogged )
+        {
+            LOG( ERROR ) << "Background mode can't be left without "
+                            "CAP_SYS_NICE or an RLIMIT_NICE of at least 20, "
+                            "restart to run at normal priority again";
+            _niceDeniedLogged = true;
+        }
+        return false;
+    }
+#endif
+    if ( !ok )
+    {
+        LOG( ERROR ) << "Could not change process priority";
+        return false;
+    }
+    _background = background;
+    if ( background )
+    {
+#ifndef _WIN32
+        // Starts out raised, so it is only lowered if it can be raised
+        // again.
+        _mainThreadRaised = true;
+        if ( !canRaisePriority() )
+        {
+            LOG( INFO ) << "RLIMIT_NICE doesn't allow raising the priority "
+                           "again, the main thread stays at normal priority";
+        }
+#endif
+        applyMainThreadPriority( _latencyCritical );
+    }
+    else if ( _mainThreadRaised )
+    {
+#ifdef _WIN32
+        SetThreadPriority( GetCurrentThread(), THREAD_PRIORITY_NORMAL );
+#endif
+        _mainThreadRaised = false;
+    }
+#ifndef _WIN32
+    else
+    {
+        setPolicy( currentThreadId(), false, niceDenied );
+    }
+#endif
+    LOG( INFO ) << "Background mode "
+                << ( background ? "enabled" : "disabled" );
+    return true;
+}
+
+void ProcessScheduler::setLatencyCritical( bool latencyCritical )
+{
+    _latencyCritical = latencyCritical;
+    if ( _background )
+    {
+        applyMainThreadPriority( latencyCritical );
+    }
+}
+
+bool ProcessScheduler::applyMainThreadPriority( bool raised )
+{
+    if ( raised == _mainThreadRaised )
+    {
+        return true;
+    }
+#ifdef _WIN32
+    // Highest in the below normal class is the same as normal in the normal
+    // class.
+    const bool ok
+        = SetThreadPriority( GetCurrentThread(),
+                             raised ? THREAD_PRIORITY_HIGHEST
+                                    : THREAD_PRIORITY_NORMAL )
+          != 0;
+#else
+    if ( !raised && !canRaisePriority() )
+    {
+        return false;
+    }
+    bool niceDenied = false;
+    const bool ok = setPolicy( currentThreadId(), !raised, niceDenied );
+#endif
+    if ( ok )
+    {
+        _mainThreadRaised = raised;
+        _priorityChanges++;
+    }
+    return ok;
+}
+
+bool ProcessScheduler::setAffinity( uint64_t mask )
+{
+    if ( mask == _affinityMask )
+    {
+        return true;
+    }
+#ifdef _WIN32
+    DWORD_PTR processMask = 0;
+    DWORD_PTR systemMask = 0;
+    bool ok = GetProcessAffinityMask(
+                  GetCurrentProcess(), &processMask, &systemMask )
+              != 0;
+    if ( ok )
+    {
+        const DWORD_PTR newMask
+            = mask != 0 ? static_cast<DWORD_PTR>( mask ) & systemMask
+                        : systemMask;
+        ok = newMask != 0
+             && SetProcessAffinityMask( GetCurrentProcess(), newMask ) != 0;
+    }
+#else
+    cpu_set_t set;
+    CPU_ZERO( &set );
+    for ( unsigned core = 0; core < coreCount(); core++ )
+    {
+        if ( mask == 0 || ( mask & ( uint64_t{ 1 } << core ) ) )
+        {
+            CPU_SET( core, &set );
+        }
+    }
+    const bool ok = forEachThread( [&set]( pid_t tid ) {
+        return sched_setaffinity( tid, sizeof( set ), &set ) == 0;
+    } );
+#endif
+    if ( !ok )
+    {
+        LOG( ERROR ) << "Could not set cpu affinity to " << mask;
+        return false;
+    }
+    _affinityMask = mask;
+    return true;
+}
+
+unsigned ProcessScheduler::coreCount() noexcept
+{
+    // The mask has 64 bits.
+    return std::min( std::max( std::thread::hardware_concurrency(), 1u ),
+                     64u );
+}
+
+bool ProcessScheduler::parseCoreList( const std::string& list,
+                                      uint64_t& mask )
+{
+    uint64_t result = 0;
+    const char* p = list.c_str();
+    while ( *p != '\0' )
+    {
+        if ( *p == ' ' || *p == ',' )
+        {
+            p++;
+            continue;
+        }
+        char* end = nullptr;
+        const unsigned long first = std::strtoul( p, &end, 10 );
+        if ( end == p )
+        {
+            return false;
+        }
+        unsigned long last = first;
+        p = end;
+        if ( *p == '-' )
+        {
+            last = std::strtoul( p + 1, &end, 10 );
+            if ( end == p + 1 || last < first )
+            {
+                return false;
+            }
+            p = end;
+        }
+        if ( last >= coreCount() )
+        {
+            return false;
+        }
+        for ( unsigned long core = first; core <= last; core++ )
+        {
+            result |= uint64_t{ 1 } << core;
+        }
+    }
+    mask = result;
+    return true;
+}
+
+} // end namespace utils
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+namespace utils
+{
+/*!
+Controls how the overlay competes with the game for CPU time.
+
+In background mode the process runs below normal priority (Windows) or as a
+batch process with nice 10 (Linux), only the main thread is raised back to
+normal while it is latency critical. On Linux that needs CAP_SYS_NICE or an
+RLIMIT_NICE of at least 20, without them the main thread stays at normal
+priority. For the same reason background mode is one way on Linux for an
+unprivileged process: setBackground( false ) can't restore nice 0, returns
+false and leaves the process in background mode until it is restarted. The
+input and drag handling share the main thread with QML rendering, so that is
+the only split possible. Changes are only sent to
+the OS when the requested state differs from the current one.
+
+The affinity mask applies to all threads of the process, 0 means all cores.
+Must be used from the main thread.
+*/
+class ProcessScheduler
+{
+private:
+    bool _background = false;
+    bool _latencyCritical = false;
+    // Main thread back at normal priority while in background mode.
+    bool _mainThreadRaised = false;
+    uint64_t _affinityMask = 0;
+    unsigned _priorityChanges = 0;
+    // Leaving background mode was refused, only said once.
+    bool _niceDeniedLogged = false;
+
+    bool applyMainThreadPriority( bool raised );
+
+public:
+    bool setBackground( bool background );
+    void setLatencyCritical( bool latencyCritical );
+    bool setAffinity( uint64_t mask );
+
+    bool background() const noexcept
+    {
+        return _background;
+    }
+    uint64_t affinity() const noexcept
+    {
+        return _affinityMask;
+    }
+    // How often the main thread priority was changed, to see how often the
+    // latency critical path is hit.
+    unsigned priorityChanges() const noexcept
+    {
+        return _priorityChanges;
+    }
+
+    static unsigned coreCount() noexcept;
+    /*!
+    Parses a list like "2,3,6-7" into a mask. An empty list gives 0. Returns
+    false on syntax errors or cores that don't exist.
+    */
+    static bool parseCoreList( const std::string& list, uint64_t& mask );
+};
+
+} // end namespace utils
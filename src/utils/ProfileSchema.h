@@ -0,0 +1,365 @@
+#pragma once
+
+#include <QSettings>
+#include <QString>
+#include <QVariant>
+#include <openvr.h>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace utils
+{
+/*!
+Values a profile field can have, with their conversion to settings values.
+They are converted exactly like the hand written profile code did, so
+existing settings files stay readable both ways.
+*/
+template <typename T> struct ProfileValue;
+
+template <> struct ProfileValue<bool>
+{
+    static QVariant toVariant( bool value )
+    {
+        return value;
+    }
+    static void fromVariant( const QVariant& variant, bool& value )
+    {
+        value = variant.toBool();
+    }
+};
+
+template <> struct ProfileValue<int>
+{
+    static QVariant toVariant( int value )
+    {
+        return value;
+    }
+    static void fromVariant( const QVariant& variant, int& value )
+    {
+        value = variant.toInt();
+    }
+};
+
+template <> struct ProfileValue<unsigned>
+{
+    static QVariant toVariant( unsigned value )
+    {
+        return value;
+    }
+    static void fromVariant( const QVariant& variant, unsigned& value )
+    {
+        value = variant.toUInt();
+    }
+};
+
+template <> struct ProfileValue<float>
+{
+    static QVariant toVariant( float value )
+    {
+        return value;
+    }
+    static void fromVariant( const QVariant& variant, float& value )
+    {
+        value = variant.toFloat();
+    }
+};
+
+template <> struct ProfileValue<std::string>
+{
+    static QVariant toVariant( const std::string& value )
+    {
+        return QString::fromStdString( value );
+    }
+    static void fromVariant( const QVariant& variant, std::string& value )
+    {
+        value = variant.toString().toStdString();
+    }
+};
+
+template <> struct ProfileValue<QVariantList>
+{
+    static QVariant toVariant( const QVariantList& value )
+    {
+        return value;
+    }
+    static void fromVariant( const QVariant& variant, QVariantList& value )
+    {
+        value = variant.toList();
+    }
+};
+
+template <typename T, size_t N> struct ProfileValue<T[N]>
+{
+    static QVariant toVariant( const T ( &value )[N] )
+    {
+        QVariantList list;
+        for ( const auto& v : value )
+        {
+            list.push_back( ProfileValue<T>::toVariant( v ) );
+        }
+        return list;
+    }
+    static void fromVariant( const QVariant& variant, T ( &value )[N] )
+    {
+        const auto list = variant.toList();
+        for ( size_t i = 0; i < N && i < static_cast<size_t>( list.size() );
+              i++ )
+        {
+            ProfileValue<T>::fromVariant( list[static_cast<int>( i )],
+                                          value[i] );
+        }
+    }
+};
+
+template <> struct ProfileValue<vr::HmdMatrix34_t>
+{
+    using Rows = ProfileValue<float[3][4]>;
+
+    static QVariant toVariant( const vr::HmdMatrix34_t& value )
+    {
+        return Rows::toVariant( value.m );
+    }
+    static void fromVariant( const QVariant& variant,
+                             vr::HmdMatrix34_t& value )
+    {
+        Rows::fromVariant( variant, value.m );
+    }
+};
+
+template <> struct ProfileValue<std::vector<vr::HmdQuad_t>>
+{
+    using Corners = ProfileValue<float[4][3]>;
+
+    static QVariant toVariant( const std::vector<vr::HmdQuad_t>& value )
+    {
+        QVariantList list;
+        list.reserve( static_cast<int>( value.size() ) );
+        for ( const auto& quad : value )
+        {
+            float corners[4][3];
+            for ( unsigned i = 0; i < 4; i++ )
+            {
+                for ( unsigned j = 0; j < 3; j++ )
+                {
+                    corners[i][j] = quad.vCorners[i].v[j];
+                }
+            }
+            list.push_back( Corners::toVariant( corners ) );
+        }
+        return list;
+    }
+    static void fromVariant( const QVariant& variant,
+                             std::vector<vr::HmdQuad_t>& value )
+    {
+        const auto list = variant.toList();
+        value.resize( static_cast<size_t>( list.size() ) );
+        for ( size_t q = 0; q < value.size(); q++ )
+        {
+            float corners[4][3] = {};
+            Corners::fromVariant( list[static_cast<int>( q )], corners );
+            for ( unsigned i = 0; i < 4; i++ )
+            {
+                for ( unsigned j = 0; j < 3; j++ )
+                {
+                    value[q].vCorners[i].v[j] = corners[i][j];
+                }
+            }
+        }
+    }
+};
+
+/*!
+One stored field of a profile. Ref returns a reference to the value inside a
+profile, for const and non-const profiles. Gate is the optional
+"includes..." flag of the profile; if it is false the field is neither
+written nor read.
+*/
+template <typename Profile, typename Ref> struct ProfileField
+{
+    const char* key;
+    Ref ref;
+    bool Profile::*gate;
+};
+
+template <typename Profile, typename T> struct MemberRef
+{
+    T Profile::*member;
+
+    constexpr T& operator()( Profile& profile ) const
+    {
+        return profile.*member;
+    }
+    constexpr const T& operator()( const Profile& profile ) const
+    {
+        return profile.*member;
+    }
+};
+
+template <typename Profile, typename T>
+constexpr ProfileField<Profile, MemberRef<Profile, T>>
+    profileField( const char* key,
+                  T Profile::*member,
+                  bool Profile::*gate = nullptr )
+{
+    return { key, MemberRef<Profile, T>{ member }, gate };
+}
+
+// For values that aren't direct members, ref is a generic lambda like
+// []( auto& p ) -> auto& { return p.configs[0].mode; }.
+template <typename Profile, typename Ref>
+constexpr ProfileField<Profile, Ref> profileField( const char* key,
+                                                   Ref ref,
+                                                   bool Profile::*gate
+                                                   = nullptr )
+{
+    return { key, ref, gate };
+}
+
+/*!
+Compile-time description of a profile struct from which its settings reader
+and writer are generated. Defaults are the member initializers of the
+struct: a field missing from the settings keeps the value of a default
+constructed profile.
+
+The version is stored next to the profile array as <array>Version, arrays
+written by the hand written code have none and count as version 0. When an
+older array is read, the migration set with withMigration() is called for
+every profile after its fields were read, for changes that can't be
+expressed by adding fields. A newer array is read field by field as usual,
+keys the schema doesn't know are ignored.
+
+Profiles are only stored in the QSettings file, so there is only an INI
+reader and writer. A binary format has no place to be stored or sent to.
+*/
+template <typename Profile, typename... Fields> struct ProfileSchema
+{
+    // Gets the settings positioned at the profile's array index.
+    using Migration = void ( * )( QSettings& settings,
+                                  Profile& profile,
+                                  quint32 storedVersion );
+
+    quint32 version;
+    std::tuple<Fields...> fields;
+    Migration migration;
+
+    constexpr ProfileSchema withMigration( Migration newMigration ) const
+    {
+        return { version, fields, newMigration };
+    }
+
+    void readIni( QSettings& settings, Profile& profile ) const
+    {
+        std::apply(
+            [&settings, &profile]( const auto&... field ) {
+                ( readIniField( settings, profile, field ), ... );
+            },
+            fields );
+    }
+
+    void writeIni( QSettings& settings, const Profile& profile ) const
+    {
+        std::apply(
+            [&settings, &profile]( const auto&... field ) {
+                ( writeIniField( settings, profile, field ), ... );
+            },
+            fields );
+    }
+
+    // Reads the profiles of a settings array like the hand written code did.
+    std::vector<Profile> readIniArray( QSettings& settings,
+                                       const QString& group,
+                                       const QString& array ) const
+    {
+        std::vector<Profile> profiles;
+        settings.beginGroup( group );
+        const quint32 storedVersion
+            = settings.value( array + "Version", 0 ).toUInt();
+        const bool migrate = migration && storedVersion < version;
+        const int count = settings.beginReadArray( array );
+        profiles.reserve( static_cast<size_t>( count ) );
+        for ( int i = 0; i < count; i++ )
+        {
+            settings.setArrayIndex( i );
+            profiles.emplace_back();
+            readIni( settings, profiles.back() );
+            if ( migrate )
+            {
+                migration( settings, profiles.back(), storedVersion );
+            }
+        }
+        settings.endArray();
+        settings.endGroup();
+        return profiles;
+    }
+
+    void writeIniArray( QSettings& settings,
+                        const QString& group,
+                        const QString& array,
+                        const std::vector<Profile>& profiles ) const
+    {
+        settings.beginGroup( group );
+        settings.setValue( array + "Version", version );
+        settings.beginWriteArray( array );
+        int i = 0;
+        for ( const auto& profile : profiles )
+        {
+            settings.setArrayIndex( i++ );
+            writeIni( settings, profile );
+        }
+        settings.endArray();
+        settings.endGroup();
+    }
+
+private:
+    template <typename Field, typename P>
+    using ValueOf = ProfileValue<std::remove_cv_t<std::remove_reference_t<
+        decltype( std::declval<const Field&>().ref( std::declval<P&>() ) )>>>;
+
+    template <typename Field>
+    static bool isGatedOut( const Profile& profile, const Field& field )
+    {
+        return field.gate && !( profile.*field.gate );
+    }
+
+    template <typename Field>
+    static void
+        readIniField( QSettings& settings, Profile& profile, const Field& field )
+    {
+        if ( isGatedOut( profile, field ) )
+        {
+            return;
+        }
+        const QVariant variant = settings.value( field.key );
+        if ( variant.isValid() )
+        {
+            ValueOf<Field, Profile>::fromVariant( variant,
+                                                  field.ref( profile ) );
+        }
+    }
+
+    template <typename Field>
+    static void writeIniField( QSettings& settings,
+                               const Profile& profile,
+                               const Field& field )
+    {
+        if ( isGatedOut( profile, field ) )
+        {
+            return;
+        }
+        settings.setValue( field.key,
+                           ValueOf<Field, const Profile>::toVariant(
+                               field.ref( profile ) ) );
+    }
+};
+
+template <typename Profile, typename... Fields>
+constexpr ProfileSchema<Profile, Fields...> profileSchema( quint32 version,
+                                                           Fields... fields )
+{
+    return { version, std::tuple<Fields...>( fields... ), nullptr };
+}
+
+} // end namespace utils
@@ -0,0 +1,49 @@
+#include "ProximityMute.h"
+
+namespace utils
+{
+void ProximityMute::handleEvent( const vr::VREvent_t& event,
+                                 Clock::time_point time )
+{
+    if ( ( event.eventType == vr::VREvent_ButtonPress
+           || event.eventType == vr::VREvent_ButtonUnpress )
+         && event.trackedDeviceIndex == vr::k_unTrackedDeviceIndex_Hmd
+         && event.data.controller.button == vr::k_EButton_ProximitySensor )
+    {
+        _sensor.set( event.eventType == vr::VREvent_ButtonPress, time );
+    }
+}
+
+bool ProximityMute::poll( Clock::time_point time )
+{
+    vr::VRControllerState_t controllerState;
+    if ( !vr::VRSystem()->GetControllerState(
+             vr::k_unTrackedDeviceIndex_Hmd,
+             &controllerState,
+             sizeof( vr::VRControllerState_t ) ) )
+    {
+        _sensor.reset();
+        return false;
+    }
+    _sensor.set( ( controllerState.ulButtonPressed
+                   & vr::ButtonMaskFromId( vr::k_EButton_ProximitySensor ) )
+                     != 0,
+                 time );
+    return true;
+}
+
+bool ProximityMute::update( Clock::time_point time,
+                            Clock::duration delay,
+                            bool micMuted,
+                            bool& mute ) noexcept
+{
+    bool worn = false;
+    if ( !_sensor.settle( time, delay, worn ) || micMuted != worn )
+    {
+        return false;
+    }
+    mute = !worn;
+    return true;
+}
+
+} // end namespace utils
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <openvr.h>
+#include "Debounce.h"
+
+namespace utils
+{
+/*!
+Follows the proximity sensor of the HMD to mute the microphone while the
+headset is off, the part of AudioTabController that talks to the runtime.
+
+The sensor is reported like a button of the HMD. Its press events only reach
+the event queues we read some of the time, so they can't be relied on:
+poll() reads the runtime's cached controller state of the HMD, which is
+meant to be called every tick, and events only make a change seen earlier.
+Both feed the same Debounce, a state seen twice doesn't restart the delay.
+*/
+class ProximityMute
+{
+public:
+    using Clock = Debounce::Clock;
+
+private:
+    Debounce _sensor;
+
+public:
+    // Takes the sensor's ButtonPress and ButtonUnpress, ignores other events.
+    void handleEvent( const vr::VREvent_t& event, Clock::time_point time );
+    /*!
+    Reads the sensor from the controller state of the HMD. Returns false if
+    it can't be read, the state is forgotten then.
+    */
+    bool poll( Clock::time_point time );
+    /*!
+    Returns true once the microphone has to change, after the sensor held its
+    new state for delay. mute is the new microphone state then.
+    */
+    bool update( Clock::time_point time,
+                 Clock::duration delay,
+                 bool micMuted,
+                 bool& mute ) noexcept;
+    void reset() noexcept
+    {
+        _sensor.reset();
+    }
+
+    bool isKnown() const noexcept
+    {
+        return _sensor.isKnown();
+    }
+    // When the sensor last changed.
+    Clock::time_point changeTime() const noexcept
+    {
+        return _sensor.changeTime();
+    }
+};
+
+} // end namespace utils
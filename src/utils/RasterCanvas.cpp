@@ -0,0 +1,228 @@
+#include "RasterCanvas.h"
+#include <algorithm>
+#include <cstring>
+
+namespace utils
+{
+namespace
+{
+    // Column-wise 5x7 glyphs for ' ' to 'Z', least significant bit is the
+    // top row.
+    constexpr char k_firstGlyph = ' ';
+    constexpr char k_lastGlyph = 'Z';
+    constexpr uint8_t k_glyphs[][RasterCanvas::glyphWidth] = {
+        { 0x00, 0x00, 0x00, 0x00, 0x00 }, // ' '
+        { 0x00, 0x00, 0x5F, 0x00, 0x00 }, // '!'
+        { 0x00, 0x07, 0x00, 0x07, 0x00 }, // '"'
+        { 0x14, 0x7F, 0x14, 0x7F, 0x14 }, // '#'
+        { 0x24, 0x2A, 0x7F, 0x2A, 0x12 }, // '$'
+        { 0x23, 0x13, 0x08, 0x64, 0x62 }, // '%'
+        { 0x36, 0x49, 0x55, 0x22, 0x50 }, // '&'
+        { 0x00, 0x05, 0x03, 0x00, 0x00 }, // '''
+        { 0x00, 0x1C, 0x22, 0x41, 0x00 }, // '('
+        { 0x00, 0x41, 0x22, 0x1C, 0x00 }, // ')'
+        { 0x08, 0x2A, 0x1C, 0x2A, 0x08 }, // '*'
+        { 0x08, 0x08, 0x3E, 0x08, 0x08 }, // '+'
+        { 0x00, 0x50, 0x30, 0x00, 0x00 }, // ','
+        { 0x08, 0x08, 0x08, 0x08, 0x08 }, // '-'
+        { 0x00, 0x60, 0x60, 0x00, 0x00 }, // '.'
+        { 0x20, 0x10, 0x08, 0x04, 0x02 }, // '/'
+        { 0x3E, 0x51, 0x49, 0x45, 0x3E }, // '0'
+        { 0x00, 0x42, 0x7F, 0x40, 0x00 }, // '1'
+        { 0x42, 0x61, 0x51, 0x49, 0x46 }, // '2'
+        { 0x21, 0x41, 0x45, 0x4B, 0x31 }, // '3'
+        { 0x18, 0x14, 0x12, 0x7F, 0x10 }, // '4'
+        { 0x27, 0x45, 0x45, 0x45, 0x39 }, // '5'
+        { 0x3C, 0x4A, 0x49, 0x49, 0x30 }, // '6'
+        { 0x01, 0x71, 0x09, 0x05, 0x03 }, // '7'
+        { 0x36, 0x49, 0x49, 0x49, 0x36 }, // '8'
+        { 0x06, 0x49, 0x49, 0x29, 0x1E }, // '9'
+        { 0x00, 0x36, 0x36, 0x00, 0x00 }, // ':'
+        { 0x00, 0x56, 0x36, 0x00, 0x00 }, // ';'
+        { 0x08, 0x14, 0x22, 0x41, 0x00 }, // '<'
+        { 0x14, 0x14, 0x14, 0x14, 0x14 }, // '='
+        { 0x00, 0x41, 0x22, 0x14, 0x08 }, // '>'
+        { 0x02, 0x01, 0x51, 0x09, 0x06 }, // '?'
+        { 0x32, 0x49, 0x79, 0x41, 0x3E }, // '@'
+        { 0x7E, 0x11, 0x11, 0x11, 0x7E }, // 'A'
+        { 0x7F, 0x49, 0x49, 0x49, 0x36 }, // 'B'
+        { 0x3E, 0x41, 0x41, 0x41, 0x22 }, // 'C'
+        { 0x7F, 0x41, 0x41, 0x22, 0x1C }, // 'D'
+        { 0x7F, 0x49, 0x49, 0x49, 0x41 }, // 'E'
+        { 0x7F, 0x09, 0x09, 0x09, 0x01 }, // 'F'
+        { 0x3E, 0x41, 0x49, 0x49, 0x7A }, // 'G'
+        { 0x7F, 0x08, 0x08, 0x08, 0x7F }, // 'H'
+        { 0x00, 0x41, 0x7F, 0x41, 0x00 }, // 'I'
+        { 0x20, 0x40, 0x41, 0x3F, 0x01 }, // 'J'
+        { 0x7F, 0x08, 0x14, 0x22, 0x41 }, // 'K'
+        { 0x7F, 0x40, 0x40, 0x40, 0x40 }, // 'L'
+        { 0x7F, 0x02, 0x0C, 0x02, 0x7F }, // 'M'
+        { 0x7F, 0x04, 0x08, 0x10, 0x7F }, // 'N'
+        { 0x3E, 0x41, 0x41, 0x41, 0x3E }, // 'O'
+        { 0x7F, 0x09, 0x09, 0x09, 0x06 }, // 'P'
+        { 0x3E, 0x41, 0x51, 0x21, 0x5E }, // 'Q'
+        { 0x7F, 0x09, 0x19, 0x29, 0x46 }, // 'R'
+        { 0x46, 0x49, 0x49, 0x49, 0x31 }, // 'S'
+        { 0x01, 0x01, 0x7F, 0x01, 0x01 }, // 'T'
+        { 0x3F, 0x40, 0x40, 0x40, 0x3F }, // 'U'
+        { 0x1F, 0x20, 0x40, 0x20, 0x1F }, // 'V'
+        { 0x3F, 0x40, 0x38, 0x40, 0x3F }, // 'W'
+        { 0x63, 0x14, 0x08, 0x14, 0x63 }, // 'X'
+        { 0x07, 0x08, 0x70, 0x08, 0x07 }, // 'Y'
+        { 0x61, 0x51, 0x49, 0x45, 0x43 }, // 'Z'
+    };
+
+    const uint8_t* glyph( char c ) noexcept
+    {
+        if ( c >= 'a' && c <= 'z' )
+        {
+            c = static_cast<char>( c - 'a' + 'A' );
+        }
+        if ( c < k_firstGlyph || c > k_lastGlyph )
+        {
+            c = '?';
+        }
+        return k_glyphs[c - k_firstGlyph];
+    }
+} // namespace
+
+RasterCanvas::RasterCanvas( unsigned width, unsigned height )
+{
+    resize( width, height );
+}
+
+void RasterCanvas::resize( unsigned width, unsigned height )
+{
+    _width = width;
+    _height = height;
+    _pixels.resize( static_cast<size_t>( width ) * height * 4 );
+}
+
+void RasterCanvas::clear( uint32_t color ) noexcept
+{
+    fillRect( 0,
+              0,
+              static_cast<int>( _width ),
+              static_cast<int>( _height ),
+              color );
+}
+
+void RasterCanvas::fillRect( int x,
+                             int y,
+                             int w,
+                             int h,
+                             uint32_t color ) noexcept
+{
+    const int x0 = std::max( x, 0 );
+    const int y0 = std::max( y, 0 );
+    const int x1 = std::min( x + w, static_cast<int>( _width ) );
+    const int y1 = std::min( y + h, static_cast<int>( _height ) );
+    if ( x0 >= x1 || y0 >= y1 )
+    {
+        return;
+    }
+    const uint8_t rgba[4] = { static_cast<uint8_t>( color >> 24 ),
+                              static_cast<uint8_t>( color >> 16 ),
+                              static_cast<uint8_t>( color >> 8 ),
+                              static_cast<uint8_t>( color ) };
+    // Fill the first row, then copy it to the others.
+    uint8_t* first
+        = _pixels.data() + ( static_cast<size_t>( y0 ) * _width + x0 ) * 4;
+    for ( int i = 0; i < x1 - x0; i++ )
+    {
+        std::memcpy( first + i * 4, rgba, 4 );
+    }
+    const size_t rowBytes = static_cast<size_t>( x1 - x0 ) * 4;
+    for ( int row = y0 + 1; row < y1; row++ )
+    {
+        std::memcpy(
+            _pixels.data() + ( static_cast<size_t>( row ) * _width + x0 ) * 4,
+            first,
+            rowBytes );
+    }
+}
+
+void RasterCanvas::fillCircle( int centerX,
+                               int centerY,
+                               int radius,
+                               uint32_t color ) noexcept
+{
+    // One span per row.
+    for ( int dy = -radius; dy <= radius; dy++ )
+    {
+        int dx = 0;
+        while ( ( dx + 1 ) * ( dx + 1 ) + dy * dy <= radius * radius )
+        {
+            dx++;
+        }
+        fillRect( centerX - dx, centerY + dy, 2 * dx + 1, 1, color );
+    }
+}
+
+int RasterCanvas::drawText( int x,
+                            int y,
+                            const char* text,
+                            uint32_t color,
+                            int scale ) noexcept
+{
+    for ( ; *text != '\0'; text++ )
+    {
+        const uint8_t* columns = glyph( *text );
+        for ( int col = 0; col < glyphWidth; col++ )
+        {
+            for ( int row = 0; row < glyphHeight; row++ )
+            {
+                if ( columns[col] & ( 1 << row ) )
+                {
+                    fillRect( x + col * scale,
+                              y + row * scale,
+                              scale,
+                              scale,
+                              color );
+                }
+            }
+        }
+        x += glyphAdvance * scale;
+    }
+    return x;
+}
+
+void RasterCanvas::drawBars( int x,
+                             int y,
+                             int w,
+                             int h,
+                             const float* values,
+                             unsigned count,
+                             float maxValue,
+                             uint32_t color ) noexcept
+{
+    if ( count == 0 || maxValue <= 0.0f )
+    {
+        return;
+    }
+    const int barWidth = std::max( w / static_cast<int>( count ), 1 );
+    for ( unsigned i = 0; i < count; i++ )
+    {
+        const float value = std::min( std::max( values[i], 0.0f ), maxValue );
+        const int barHeight = static_cast<int>(
+            static_cast<float>( h ) * value / maxValue + 0.5f );
+        fillRect( x + static_cast<int>( i ) * barWidth,
+                  y + h - barHeight,
+                  barWidth,
+                  barHeight,
+                  color );
+    }
+}
+
+int RasterCanvas::textWidth( const char* text, int scale ) noexcept
+{
+    return static_cast<int>( std::strlen( text ) ) * glyphAdvance * scale;
+}
+
+vr::EVROverlayError RasterCanvas::upload( vr::VROverlayHandle_t handle )
+{
+    return vr::VROverlay()->SetOverlayRaw(
+        handle, _pixels.data(), _width, _height, 4 );
+}
+
+} // end namespace utils
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include <openvr.h>
+
+namespace utils
+{
+/*!
+Small CPU rasterizer for overlays that don't need the QML scene graph.
+
+Draws filled rectangles, a built-in 5x7 pixel font and bar graphs into an
+RGBA buffer that is reused between frames and uploaded with SetOverlayRaw().
+Colors are packed as 0xRRGGBBAA. Everything is clipped to the canvas.
+*/
+class RasterCanvas
+{
+private:
+    unsigned _width = 0;
+    unsigned _height = 0;
+    std::vector<uint8_t> _pixels;
+
+public:
+    static constexpr int glyphWidth = 5;
+    static constexpr int glyphHeight = 7;
+    // Horizontal distance between two characters at scale 1.
+    static constexpr int glyphAdvance = glyphWidth + 1;
+
+    RasterCanvas() = default;
+    RasterCanvas( unsigned width, unsigned height );
+
+    unsigned width() const noexcept
+    {
+        return _width;
+    }
+    unsigned height() const noexcept
+    {
+        return _height;
+    }
+    const uint8_t* data() const noexcept
+    {
+        return _pixels.data();
+    }
+
+    // Keeps the allocation when shrinking.
+    void resize( unsigned width, unsigned height );
+
+    void clear( uint32_t color ) noexcept;
+    void fillRect( int x, int y, int w, int h, uint32_t color ) noexcept;
+    void fillCircle( int centerX,
+                     int centerY,
+                     int radius,
+                     uint32_t color ) noexcept;
+    // Returns the x coordinate after the last character. Lower case letters
+    // are drawn as upper case, unknown characters as '?'.
+    int drawText( int x,
+                  int y,
+                  const char* text,
+                  uint32_t color,
+                  int scale = 1 ) noexcept;
+    // Draws count bars from left to right, values are clamped to maxValue.
+    void drawBars( int x,
+                   int y,
+                   int w,
+                   int h,
+                   const float* values,
+                   unsigned count,
+                   float maxValue,
+                   uint32_t color ) noexcept;
+
+    static int textWidth( const char* text, int scale = 1 ) noexcept;
+
+    vr::EVROverlayError upload( vr::VROverlayHandle_t handle );
+};
+
+} // end namespace utils
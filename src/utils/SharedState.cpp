@@ -0,0 +1,231 @@
+#include "SharedState.h"
+#include <cstring>
+#include <thread>
+#ifdef _WIN32
+#    include <Windows.h>
+#else
+#    include <fcntl.h>
+#    include <sys/mman.h>
+#    include <sys/stat.h>
+#    include <unistd.h>
+#endif
+
+namespace utils
+{
+namespace
+{
+#ifdef _WIN32
+    constexpr char k_name[] = "Local\\OpenVRAdvancedSettingsState";
+#else
+    constexpr char k_name[] = "/OpenVRAdvancedSettingsState";
+#endif
+    constexpr size_t k_segmentSize
+        = sizeof( SharedStateHeader ) + sizeof( SharedStateFrame );
+    // A copy takes microseconds, the writer can't overlap this often.
+    constexpr int k_maxReadAttempts = 100;
+} // namespace
+
+SharedStateMapping::~SharedStateMapping()
+{
+    unmap();
+}
+
+void SharedStateMapping::unmap() noexcept
+{
+#ifdef _WIN32
+    if ( _mapped )
+    {
+        UnmapViewOfFile( _mapped );
+    }
+    if ( _mappingHandle )
+    {
+        CloseHandle( _mappingHandle );
+        _mappingHandle = nullptr;
+    }
+#else
+    if ( _mapped )
+    {
+        munmap( _mapped, _mappedSize );
+    }
+#endif
+    _mapped = nullptr;
+    _mappedSize = 0;
+}
+
+SharedStateWriter::~SharedStateWriter()
+{
+    close();
+}
+
+bool SharedStateWriter::open()
+{
+    close();
+#ifdef _WIN32
+    _mappingHandle = CreateFileMappingA( INVALID_HANDLE_VALUE,
+                                         nullptr,
+                                         PAGE_READWRITE,
+                                         0,
+                                         static_cast<DWORD>( k_segmentSize ),
+                                         k_name );
+    if ( _mappingHandle )
+    {
+        _mapped = static_cast<unsigned char*>( MapViewOfFile(
+            _mappingHandle, FILE_MAP_ALL_ACCESS, 0, 0, k_segmentSize ) );
+    }
+#else
+    const int file = shm_open( k_name, O_CREAT | O_RDWR, 0644 );
+    if ( file >= 0 )
+    {
+        if ( ftruncate( file, static_cast<off_t>( k_segmentSize ) ) == 0 )
+        {
+            void* mapped = mmap( nullptr,
+                                 k_segmentSize,
+                                 PROT_READ | PROT_WRITE,
+                                 MAP_SHARED,
+                                 file,
+                                 0 );
+            if ( mapped != MAP_FAILED )
+            {
+                _mapped = static_cast<unsigned char*>( mapped );
+            }
+        }
+        ::close( file );
+    }
+#endif
+    if ( !_mapped )
+    {
+        unmap();
+        return false;
+    }
+    _mappedSize = k_segmentSize;
+
+    // A segment left behind by a crashed overlay is taken over. Its sequence
+    // goes on, so readers that still have it mapped notice the change.
+    auto& sequence = header()->sequence;
+    const uint64_t last = sequence.load( std::memory_order_relaxed );
+    sequence.store( last + 1, std::memory_order_relaxed );
+    std::atomic_thread_fence( std::memory_order_release );
+    header()->magic = k_sharedStateMagic;
+    header()->version = k_sharedStateVersion;
+    header()->frameSize = sizeof( SharedStateFrame );
+    std::memset( mappedFrame(), 0, sizeof( SharedStateFrame ) );
+    sequence.store( ( last | 1 ) + 1, std::memory_order_release );
+    _frame = {};
+    return true;
+}
+
+void SharedStateWriter::close() noexcept
+{
+    if ( !_mapped )
+    {
+        return;
+    }
+    unmap();
+#ifndef _WIN32
+    shm_unlink( k_name );
+#endif
+}
+
+void SharedStateWriter::publish() noexcept
+{
+    if ( !_mapped )
+    {
+        return;
+    }
+    _frame.frameIndex++;
+    auto& sequence = header()->sequence;
+    const uint64_t last = sequence.load( std::memory_order_relaxed );
+    sequence.store( last + 1, std::memory_order_relaxed );
+    std::atomic_thread_fence( std::memory_order_release );
+    std::memcpy( mappedFrame(), &_frame, sizeof( SharedStateFrame ) );
+    sequence.store( last + 2, std::memory_order_release );
+}
+
+bool SharedStateReader::open()
+{
+    close();
+    size_t size = 0;
+#ifdef _WIN32
+    _mappingHandle = OpenFileMappingA( FILE_MAP_READ, FALSE, k_name );
+    if ( _mappingHandle )
+    {
+        _mapped = static_cast<unsigned char*>(
+            MapViewOfFile( _mappingHandle, FILE_MAP_READ, 0, 0, 0 ) );
+        MEMORY_BASIC_INFORMATION info;
+        if ( _mapped && VirtualQuery( _mapped, &info, sizeof( info ) ) )
+        {
+            size = info.RegionSize;
+        }
+    }
+#else
+    const int file = shm_open( k_name, O_RDONLY, 0 );
+    if ( file >= 0 )
+    {
+        struct stat fileStat;
+        if ( fstat( file, &fileStat ) == 0 )
+        {
+            size = static_cast<size_t>( fileStat.st_size );
+        }
+        void* mapped = size >= sizeof( SharedStateHeader )
+                           ? mmap( nullptr,
+                                   size,
+                                   PROT_READ,
+                                   MAP_SHARED,
+                                   file,
+                                   0 )
+                           : MAP_FAILED;
+        ::close( file );
+        if ( mapped != MAP_FAILED )
+        {
+            _mapped = static_cast<unsigned char*>( mapped );
+        }
+    }
+#endif
+    _mappedSize = size;
+    if ( !_mapped || size < sizeof( SharedStateHeader )
+         || header()->magic != k_sharedStateMagic
+         || header()->version != k_sharedStateVersion
+         || header()->frameSize < sizeof( SharedStateFrame )
+         || size < sizeof( SharedStateHeader ) + header()->frameSize )
+    {
+        unmap();
+        return false;
+    }
+    return true;
+}
+
+void SharedStateReader::close() noexcept
+{
+    unmap();
+}
+
+uint64_t SharedStateReader::beginRead() const noexcept
+{
+    return header()->sequence.load( std::memory_order_acquire );
+}
+
+bool SharedStateReader::endRead( uint64_t sequence ) const noexcept
+{
+    // The reads of the frame may not move past the second load.
+    std::atomic_thread_fence( std::memory_order_acquire );
+    return ( sequence & 1 ) == 0
+           && header()->sequence.load( std::memory_order_relaxed )
+                  == sequence;
+}
+
+bool SharedStateReader::read( SharedStateFrame& frame ) const noexcept
+{
+    for ( int attempt = 0; attempt < k_maxReadAttempts; attempt++ )
+    {
+        const uint64_t sequence = beginRead();
+        std::memcpy( &frame, mappedFrame(), sizeof( SharedStateFrame ) );
+        if ( endRead( sequence ) )
+        {
+            return frame.frameIndex != 0;
+        }
+        std::this_thread::yield();
+    }
+    return false;
+}
+
+} // end namespace utils
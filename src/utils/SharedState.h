@@ -0,0 +1,182 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace utils
+{
+/*!
+Per frame state of the overlay in shared memory, for other local tools
+(recorders, stream plugins, telemetry) that would otherwise each poll OpenVR
+themselves.
+
+The segment is a file mapping named "Local\OpenVRAdvancedSettingsState" on
+Windows and the POSIX shared memory object "/OpenVRAdvancedSettingsState" on
+Linux. It starts with a SharedStateHeader, followed by one SharedStateFrame
+guarded by a sequence lock: the writer makes the sequence odd, copies the
+frame in and makes it even again. Readers never block the writer and need
+neither a lock nor a system call; they read the sequence, read the fields
+they need straight from the mapping and check that the sequence is still the
+same, otherwise they try again.
+
+Fields are only ever appended to SharedStateFrame, the version changes when
+existing ones change. A reader checks the version and that frameSize is at
+least the size of the frame it was built with.
+
+This file and SharedState.cpp only need the standard library and the OS, so
+other tools can build them as the reader library.
+*/
+constexpr uint32_t k_sharedStateMagic = 0x53535641; // "AVSS"
+constexpr uint32_t k_sharedStateVersion = 1;
+// Same as vr::k_unMaxTrackedDeviceCount.
+constexpr uint32_t k_sharedStateMaxPoses = 64;
+
+struct SharedStatePose
+{
+    // Row major like vr::HmdMatrix34_t.
+    float deviceToAbsoluteTracking[3][4];
+    // In m/s and rad/s.
+    float velocity[3];
+    float angularVelocity[3];
+    // vr::ETrackingResult.
+    int32_t trackingResult;
+    uint8_t poseIsValid;
+    uint8_t deviceIsConnected;
+    uint8_t padding[2];
+};
+
+struct SharedStateFrame
+{
+    // Counts up with every published frame, 0 before the first one.
+    uint64_t frameIndex;
+    // Unix time in microseconds, a frame that stops changing is stale.
+    int64_t timeMicroseconds;
+
+    // Playspace move of the play space page: vr::ETrackingUniverseOrigin it
+    // applies to, offsets in m before rotation, rotation in degrees.
+    int32_t trackingUniverse;
+    float universeRotation;
+    float universeOffset[3];
+
+    // Compositor frames since the last reset on the statistics page.
+    uint32_t presentedFrames;
+    uint32_t droppedFrames;
+    uint32_t reprojectedFrames;
+    uint32_t timedOutFrames;
+    float reprojectedRatio;
+
+    // Standing universe poses, indexed by tracked device index.
+    uint32_t poseCount;
+    SharedStatePose poses[k_sharedStateMaxPoses];
+};
+
+struct SharedStateHeader
+{
+    uint32_t magic;
+    uint32_t version;
+    // Size of the frame as written, at least sizeof( SharedStateFrame ).
+    uint32_t frameSize;
+    uint32_t reserved;
+    // Odd while the frame is written.
+    std::atomic<uint64_t> sequence;
+};
+
+static_assert( std::atomic<uint64_t>::is_always_lock_free,
+               "The sequence must work across processes" );
+
+class SharedStateMapping
+{
+protected:
+    unsigned char* _mapped = nullptr;
+    size_t _mappedSize = 0;
+#ifdef _WIN32
+    void* _mappingHandle = nullptr;
+#endif
+
+    SharedStateMapping() = default;
+    ~SharedStateMapping();
+    void unmap() noexcept;
+
+    SharedStateHeader* header() const noexcept
+    {
+        return reinterpret_cast<SharedStateHeader*>( _mapped );
+    }
+    SharedStateFrame* mappedFrame() const noexcept
+    {
+        return reinterpret_cast<SharedStateFrame*>(
+            _mapped + sizeof( SharedStateHeader ) );
+    }
+
+public:
+    SharedStateMapping( const SharedStateMapping& ) = delete;
+    SharedStateMapping& operator=( const SharedStateMapping& ) = delete;
+
+    bool isOpen() const noexcept
+    {
+        return _mapped != nullptr;
+    }
+};
+
+/*!
+Creates the segment and publishes frames into it. The frame is filled in
+outside of the mapping and copied in by publish(), so readers only have to
+retry if they overlap that copy.
+*/
+class SharedStateWriter : public SharedStateMapping
+{
+private:
+    SharedStateFrame _frame = {};
+
+public:
+    SharedStateWriter() = default;
+    ~SharedStateWriter();
+
+    bool open();
+    // Removes the name, readers that still have the segment mapped keep
+    // seeing the last frame.
+    void close() noexcept;
+
+    // Frame to fill in before publish().
+    SharedStateFrame& frame() noexcept
+    {
+        return _frame;
+    }
+    void publish() noexcept;
+};
+
+/*!
+Maps the segment of a running overlay read only.
+
+Zero copy access:
+
+    const auto sequence = reader.beginRead();
+    const float x = reader.frame().universeOffset[0];
+    if ( reader.endRead( sequence ) ) ...
+
+Everything read between beginRead() and a successful endRead() belongs to
+the same frame. read() does the same for a copy of the whole frame.
+*/
+class SharedStateReader : public SharedStateMapping
+{
+public:
+    SharedStateReader() = default;
+    ~SharedStateReader() = default;
+
+    // False if the overlay doesn't publish or has an incompatible version.
+    bool open();
+    void close() noexcept;
+
+    uint64_t beginRead() const noexcept;
+    const SharedStateFrame& frame() const noexcept
+    {
+        return *mappedFrame();
+    }
+    // True if nothing was published in between.
+    bool endRead( uint64_t sequence ) const noexcept;
+
+    // False if there is no frame yet or the writer kept overlapping.
+    bool read( SharedStateFrame& frame ) const noexcept;
+};
+
+} // end namespace utils
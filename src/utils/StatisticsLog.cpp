@@ -0,0 +1,357 @@
+#include "StatisticsLog.h"
+#include <algorithm>
+#include <cstring>
+#include <easylogging++.h>
+#ifdef _WIN32
+#    include <Windows.h>
+#else
+#    include <fcntl.h>
+#    include <sys/mman.h>
+#    include <sys/stat.h>
+#    include <unistd.h>
+#endif
+
+namespace utils
+{
+namespace
+{
+    constexpr char k_magic[8] = { 'A', 'V', 'S', 'S', 'T', 'A', 'T', 'S' };
+    constexpr int64_t k_secondsPerDay = 86400;
+
+    struct Header
+    {
+        char magic[8];
+        uint32_t version;
+        uint32_t recordSize;
+    };
+
+    constexpr size_t k_headerSize = sizeof( Header );
+
+    int64_t floorDiv( int64_t value, int64_t divisor ) noexcept
+    {
+        const int64_t result = value / divisor;
+        return value % divisor < 0 ? result - 1 : result;
+    }
+
+    void add( StatisticsLog::Totals& totals,
+              const StatisticsLog::Record& record )
+    {
+        totals.seconds += record.seconds;
+        totals.distance += static_cast<double>( record.distance );
+        totals.rotations += static_cast<double>( record.rotations );
+        totals.maxSpeed = std::max(
+            { totals.maxSpeed, record.leftMaxSpeed, record.rightMaxSpeed } );
+        totals.presentedFrames += record.presentedFrames;
+        totals.droppedFrames += record.droppedFrames;
+        totals.reprojectedFrames += record.reprojectedFrames;
+    }
+} // namespace
+
+StatisticsLog::~StatisticsLog()
+{
+    close();
+    unmap();
+}
+
+bool StatisticsLog::open( const std::string& path )
+{
+    close();
+    _path = path;
+    Header header;
+    std::FILE* file = std::fopen( path.c_str(), "r+b" );
+    if ( file )
+    {
+        if ( std::fread( &header, sizeof( header ), 1, file ) != 1
+             || std::memcmp( header.magic, k_magic, sizeof( k_magic ) ) != 0
+             || header.version != version
+             || header.recordSize != sizeof( Record ) )
+        {
+            LOG( ERROR ) << "Statistics log \"" << path
+                         << "\" has an unknown format, not writing to it";
+            std::fclose( file );
+            return false;
+        }
+        // A record cut short by a crash is overwritten.
+        std::fseek( file, 0, SEEK_END );
+        const long size = std::ftell( file );
+        const long records = ( size - static_cast<long>( k_headerSize ) )
+                             / static_cast<long>( sizeof( Record ) );
+        std::fseek( file,
+                    static_cast<long>( k_headerSize )
+                        + records * static_cast<long>( sizeof( Record ) ),
+                    SEEK_SET );
+    }
+    else
+    {
+        file = std::fopen( path.c_str(), "w+b" );
+        if ( !file )
+        {
+            LOG( ERROR ) << "Could not create statistics log \"" << path
+                         << "\"";
+            return false;
+        }
+        std::memcpy( header.magic, k_magic, sizeof( k_magic ) );
+        header.version = version;
+        header.recordSize = sizeof( Record );
+        std::fwrite( &header, sizeof( header ), 1, file );
+        std::fflush( file );
+    }
+    _stopWriter = false;
+    _writer = std::thread( &StatisticsLog::writerLoop, this, file );
+    return true;
+}
+
+void StatisticsLog::writerLoop( std::FILE* file )
+{
+    std::vector<Record> batch;
+    std::unique_lock<std::mutex> lock( _queueMutex );
+    while ( true )
+    {
+        _queueCondition.wait(
+            lock, [this]() { return _stopWriter || !_queue.empty(); } );
+        batch.swap( _queue );
+        const bool stop = _stopWriter;
+        lock.unlock();
+        if ( !batch.empty() )
+        {
+            if ( std::fwrite(
+                     batch.data(), sizeof( Record ), batch.size(), file )
+                 != batch.size() )
+            {
+                LOG( ERROR ) << "Could not write to statistics log \"" << _path
+                             << "\"";
+            }
+            std::fflush( file );
+            batch.clear();
+        }
+        lock.lock();
+        if ( stop && _queue.empty() )
+        {
+            break;
+        }
+    }
+    std::fclose( file );
+}
+
+void StatisticsLog::append( const Record& record )
+{
+    if ( !_writer.joinable() )
+    {
+        return;
+    }
+    _pending.push_back( record );
+    std::unique_lock<std::mutex> lock( _queueMutex, std::try_to_lock );
+    if ( !lock.owns_lock() )
+    {
+        return;
+    }
+    _queue.insert( _queue.end(), _pending.begin(), _pending.end() );
+    _pending.clear();
+    lock.unlock();
+    _queueCondition.notify_one();
+}
+
+void StatisticsLog::close()
+{
+    if ( !_writer.joinable() )
+    {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock( _queueMutex );
+        _queue.insert( _queue.end(), _pending.begin(), _pending.end() );
+        _pending.clear();
+        _stopWriter = true;
+    }
+    _queueCondition.notify_one();
+    _writer.join();
+}
+
+void StatisticsLog::unmap() noexcept
+{
+#ifdef _WIN32
+    if ( _mapped )
+    {
+        UnmapViewOfFile( _mapped );
+    }
+    if ( _mappingHandle )
+    {
+        CloseHandle( _mappingHandle );
+    }
+    if ( _fileHandle )
+    {
+        CloseHandle( _fileHandle );
+    }
+    _mappingHandle = nullptr;
+    _fileHandle = nullptr;
+#else
+    if ( _mapped )
+    {
+        munmap( const_cast<unsigned char*>( _mapped ), _mappedSize );
+    }
+#endif
+    _mapped = nullptr;
+    _mappedSize = 0;
+    _recordCount = 0;
+}
+
+bool StatisticsLog::refresh( int64_t utcOffset )
+{
+    if ( utcOffset != _utcOffset )
+    {
+        _utcOffset = utcOffset;
+        _days.clear();
+    }
+
+#ifdef _WIN32
+    HANDLE file = CreateFileA( _path.c_str(),
+                               GENERIC_READ,
+                               FILE_SHARE_READ | FILE_SHARE_WRITE,
+                               nullptr,
+                               OPEN_EXISTING,
+                               FILE_ATTRIBUTE_NORMAL,
+                               nullptr );
+    if ( file == INVALID_HANDLE_VALUE )
+    {
+        return false;
+    }
+    LARGE_INTEGER fileSize;
+    if ( !GetFileSizeEx( file, &fileSize ) )
+    {
+        CloseHandle( file );
+        return false;
+    }
+    const auto size = static_cast<size_t>( fileSize.QuadPart );
+#else
+    const int file = ::open( _path.c_str(), O_RDONLY );
+    if ( file < 0 )
+    {
+        return false;
+    }
+    struct stat fileStat;
+    if ( fstat( file, &fileStat ) != 0 )
+    {
+        ::close( file );
+        return false;
+    }
+    const auto size = static_cast<size_t>( fileStat.st_size );
+#endif
+    const size_t count
+        = size > k_headerSize ? ( size - k_headerSize ) / sizeof( Record ) : 0;
+    if ( count == _recordCount && _mapped )
+    {
+#ifdef _WIN32
+        CloseHandle( file );
+#else
+        ::close( file );
+#endif
+        return true;
+    }
+
+    // Days from the first new record on may have changed.
+    const int64_t firstChangedDay
+        = _recordCount > 0 && count > _recordCount
+              ? dayOf( records()[_recordCount - 1].endTime )
+              : INT64_MIN;
+    unmap();
+    if ( count > 0 )
+    {
+        const size_t mapSize = k_headerSize + count * sizeof( Record );
+#ifdef _WIN32
+        _fileHandle = file;
+        _mappingHandle = CreateFileMappingA(
+            file, nullptr, PAGE_READONLY, 0, 0, nullptr );
+        if ( _mappingHandle )
+        {
+            _mapped = static_cast<const unsigned char*>( MapViewOfFile(
+                _mappingHandle, FILE_MAP_READ, 0, 0, mapSize ) );
+        }
+#else
+        void* mapped
+            = mmap( nullptr, mapSize, PROT_READ, MAP_SHARED, file, 0 );
+        ::close( file );
+        if ( mapped != MAP_FAILED )
+        {
+            _mapped = static_cast<const unsigned char*>( mapped );
+        }
+#endif
+        if ( !_mapped )
+        {
+            LOG( ERROR ) << "Could not map statistics log \"" << _path << "\"";
+            unmap();
+            _days.clear();
+            return false;
+        }
+        _mappedSize = mapSize;
+        _recordCount = count;
+    }
+    else
+    {
+#ifdef _WIN32
+        CloseHandle( file );
+#else
+        ::close( file );
+#endif
+    }
+    _days.erase( _days.lower_bound( firstChangedDay ), _days.end() );
+    return true;
+}
+
+const StatisticsLog::Record* StatisticsLog::records() const noexcept
+{
+    return reinterpret_cast<const Record*>( _mapped + k_headerSize );
+}
+
+int64_t StatisticsLog::dayOf( int64_t unixTime ) const noexcept
+{
+    return floorDiv( unixTime + _utcOffset, k_secondsPerDay );
+}
+
+const StatisticsLog::DayTotals& StatisticsLog::day( int64_t dayIndex )
+{
+    auto cached = _days.find( dayIndex );
+    if ( cached != _days.end() )
+    {
+        return cached->second;
+    }
+
+    DayTotals totals;
+    const int64_t dayStart = dayIndex * k_secondsPerDay - _utcOffset;
+    const int64_t dayEnd = dayStart + k_secondsPerDay;
+    const Record* begin = _recordCount > 0 ? records() : nullptr;
+    const Record* end = begin ? begin + _recordCount : nullptr;
+    const Record* first = std::lower_bound(
+        begin, end, dayStart, []( const Record& record, int64_t time ) {
+            return record.endTime < time;
+        } );
+    int64_t lastSession = INT64_MIN;
+    std::map<std::string, int64_t> lastAppSession;
+    for ( const Record* record = first;
+          record != end && record->endTime < dayEnd;
+          record++ )
+    {
+        add( totals.total, *record );
+        if ( record->sessionId != lastSession )
+        {
+            totals.total.sessions++;
+            lastSession = record->sessionId;
+        }
+        const std::string appKey(
+            record->appKey, strnlen( record->appKey, appKeySize ) );
+        if ( appKey.empty() )
+        {
+            continue;
+        }
+        auto& app = totals.apps[appKey];
+        add( app, *record );
+        auto appSession = lastAppSession.emplace( appKey, INT64_MIN ).first;
+        if ( appSession->second != record->sessionId )
+        {
+            app.sessions++;
+            appSession->second = record->sessionId;
+        }
+    }
+    return _days.emplace( dayIndex, std::move( totals ) ).first->second;
+}
+
+} // end namespace utils
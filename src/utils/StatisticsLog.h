@@ -0,0 +1,124 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace utils
+{
+/*!
+Append-only binary log of session statistics.
+
+The file is a small header followed by fixed size records, each one covering
+an interval of play time in one application. append() never waits for the
+disk, records are handed to a writer thread; if that thread holds the queue
+at the moment the record is kept back and handed over with the next call.
+
+For browsing the history the file is memory-mapped. Per day totals are only
+computed when a day is asked for and cached until records for that day are
+added. Records are appended in time order, so the records of a day are found
+with a binary search.
+*/
+class StatisticsLog
+{
+public:
+    static constexpr uint32_t version = 1;
+    // Same as vr::k_unMaxApplicationKeyLength.
+    static constexpr unsigned appKeySize = 128;
+
+    struct Record
+    {
+        // Unix time at the end of the interval, in seconds.
+        int64_t endTime = 0;
+        // Start time of the overlay session the record belongs to.
+        int64_t sessionId = 0;
+        uint32_t seconds = 0;
+        uint32_t presentedFrames = 0;
+        uint32_t droppedFrames = 0;
+        uint32_t reprojectedFrames = 0;
+        float distance = 0.0f;
+        float rotations = 0.0f;
+        float leftMaxSpeed = 0.0f;
+        float rightMaxSpeed = 0.0f;
+        // Zero terminated, empty if no application was running.
+        char appKey[appKeySize] = {};
+    };
+
+    struct Totals
+    {
+        double seconds = 0.0;
+        double distance = 0.0;
+        double rotations = 0.0;
+        float maxSpeed = 0.0f;
+        uint64_t presentedFrames = 0;
+        uint64_t droppedFrames = 0;
+        uint64_t reprojectedFrames = 0;
+        unsigned sessions = 0;
+    };
+
+    struct DayTotals
+    {
+        Totals total;
+        std::map<std::string, Totals> apps;
+    };
+
+private:
+    std::string _path;
+
+    // Writer side.
+    std::thread _writer;
+    std::mutex _queueMutex;
+    std::condition_variable _queueCondition;
+    std::vector<Record> _queue;
+    bool _stopWriter = false;
+    // Only touched by the thread calling append().
+    std::vector<Record> _pending;
+
+    // Reader side.
+    const unsigned char* _mapped = nullptr;
+    size_t _mappedSize = 0;
+#ifdef _WIN32
+    void* _fileHandle = nullptr;
+    void* _mappingHandle = nullptr;
+#endif
+    size_t _recordCount = 0;
+    int64_t _utcOffset = 0;
+    std::map<int64_t, DayTotals> _days;
+
+    void writerLoop( std::FILE* file );
+    void unmap() noexcept;
+    const Record* records() const noexcept;
+
+public:
+    StatisticsLog() = default;
+    ~StatisticsLog();
+    StatisticsLog( const StatisticsLog& ) = delete;
+    StatisticsLog& operator=( const StatisticsLog& ) = delete;
+
+    // Opens or creates the log and starts the writer thread.
+    bool open( const std::string& path );
+    void append( const Record& record );
+    // Writes everything queued and stops the writer thread.
+    void close();
+
+    /*!
+    Maps the current contents of the file for reading. Cheap if nothing was
+    added since the last call. Day boundaries are local midnight given the
+    offset of local time to UTC in seconds.
+    */
+    bool refresh( int64_t utcOffset );
+    size_t recordCount() const noexcept
+    {
+        return _recordCount;
+    }
+    // Day 0 starts at local midnight of 1970-01-01.
+    const DayTotals& day( int64_t dayIndex );
+    int64_t dayOf( int64_t unixTime ) const noexcept;
+};
+
+} // end namespace utils
@@ -0,0 +1,128 @@
+#include "StreamingQuantile.h"
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+
+namespace utils
+{
+StreamingQuantile::StreamingQuantile( double quantile ) noexcept
+    : _quantile( std::min( std::max( quantile, 0.0 ), 1.0 ) )
+{
+    reset();
+}
+
+void StreamingQuantile::reset() noexcept
+{
+    _count = 0;
+    const double p = _quantile;
+    for ( int i = 0; i < 5; i++ )
+    {
+        _positions[i] = i + 1;
+    }
+    _desired[0] = 1.0;
+    _desired[1] = 1.0 + 2.0 * p;
+    _desired[2] = 1.0 + 4.0 * p;
+    _desired[3] = 3.0 + 2.0 * p;
+    _desired[4] = 5.0;
+    _increments[0] = 0.0;
+    _increments[1] = p / 2.0;
+    _increments[2] = p;
+    _increments[3] = ( 1.0 + p ) / 2.0;
+    _increments[4] = 1.0;
+}
+
+double StreamingQuantile::parabolic( int i, double direction ) const noexcept
+{
+    const double* q = _heights;
+    const double* n = _positions;
+    return q[i]
+           + direction / ( n[i + 1] - n[i - 1] )
+                 * ( ( n[i] - n[i - 1] + direction ) * ( q[i + 1] - q[i] )
+                         / ( n[i + 1] - n[i] )
+                     + ( n[i + 1] - n[i] - direction ) * ( q[i] - q[i - 1] )
+                           / ( n[i] - n[i - 1] ) );
+}
+
+double StreamingQuantile::linear( int i, int direction ) const noexcept
+{
+    return _heights[i]
+           + direction * ( _heights[i + direction] - _heights[i] )
+                 / ( _positions[i + direction] - _positions[i] );
+}
+
+void StreamingQuantile::add( double value ) noexcept
+{
+    if ( _count < 5 )
+    {
+        // Kept sorted until the markers take over.
+        int i = static_cast<int>( _count );
+        for ( ; i > 0 && _heights[i - 1] > value; i-- )
+        {
+            _heights[i] = _heights[i - 1];
+        }
+        _heights[i] = value;
+        _count++;
+        return;
+    }
+    _count++;
+
+    // Cell the value falls into, the outer markers follow the extremes.
+    int cell = 0;
+    if ( value < _heights[0] )
+    {
+        _heights[0] = value;
+    }
+    else if ( value >= _heights[4] )
+    {
+        _heights[4] = value;
+        cell = 3;
+    }
+    else
+    {
+        while ( value >= _heights[cell + 1] )
+        {
+            cell++;
+        }
+    }
+    for ( int i = cell + 1; i < 5; i++ )
+    {
+        _positions[i] += 1.0;
+    }
+    for ( int i = 0; i < 5; i++ )
+    {
+        _desired[i] += _increments[i];
+    }
+
+    for ( int i = 1; i < 4; i++ )
+    {
+        const double offset = _desired[i] - _positions[i];
+        if ( ( offset >= 1.0 && _positions[i + 1] - _positions[i] > 1.0 )
+             || ( offset <= -1.0 && _positions[i - 1] - _positions[i] < -1.0 ) )
+        {
+            const int direction = offset > 0.0 ? 1 : -1;
+            const double height = parabolic( i, direction );
+            _heights[i] = _heights[i - 1] < height && height < _heights[i + 1]
+                              ? height
+                              : linear( i, direction );
+            _positions[i] += direction;
+        }
+    }
+}
+
+double StreamingQuantile::value() const noexcept
+{
+    if ( _count >= 5 )
+    {
+        return _heights[2];
+    }
+    if ( _count == 0 )
+    {
+        return 0.0;
+    }
+    // Nearest rank of the values seen so far.
+    const auto rank = static_cast<size_t>(
+        std::lround( _quantile * static_cast<double>( _count - 1 ) ) );
+    return _heights[rank];
+}
+
+} // end namespace utils
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <cstdint>
+
+namespace utils
+{
+/*!
+Estimates a quantile of a stream of values in constant memory with the P²
+algorithm (Jain and Chlamtac, 1985).
+
+Five markers track the minimum, the maximum, the quantile and the quantiles
+halfway to either end. Every value moves the marker positions, a marker that
+is off its desired position by one or more is shifted there and its height
+adjusted with a piecewise parabolic fit through its neighbours. add() costs
+a handful of comparisons and at most three fits, nothing is allocated.
+
+Up to five values the quantile is exact.
+*/
+class StreamingQuantile
+{
+private:
+    double _quantile;
+    uint64_t _count = 0;
+    // Marker heights and positions (1 based), desired positions and their
+    // increments per value.
+    double _heights[5] = {};
+    double _positions[5] = {};
+    double _desired[5] = {};
+    double _increments[5] = {};
+
+    double parabolic( int i, double direction ) const noexcept;
+    double linear( int i, int direction ) const noexcept;
+
+public:
+    // Quantile between 0 and 1, e.g. 0.5 for the median.
+    explicit StreamingQuantile( double quantile ) noexcept;
+
+    void reset() noexcept;
+    void add( double value ) noexcept;
+
+    uint64_t count() const noexcept
+    {
+        return _count;
+    }
+    // 0 if nothing was added.
+    double value() const noexcept;
+};
+
+} // end namespace utils
@@ -0,0 +1,328 @@
+#include "UniverseTransform.h"
+#include <cmath>
+#include <cstring>
+
+namespace utils
+{
+namespace
+{
+    // Same orientation as initRotationMatrix( matrix, 1, yaw ) in Matrix.h
+    void initYawMatrix( double matrix[3][3], double yaw )
+    {
+        const double c = std::cos( yaw );
+        const double s = std::sin( yaw );
+        matrix[0][0] = c;
+        matrix[0][1] = 0.0;
+        matrix[0][2] = s;
+        matrix[1][0] = 0.0;
+        matrix[1][1] = 1.0;
+        matrix[1][2] = 0.0;
+        matrix[2][0] = -s;
+        matrix[2][1] = 0.0;
+        matrix[2][2] = c;
+    }
+
+    bool sameState( const double offsetA[3],
+                    double yawA,
+                    const double offsetB[3],
+                    double yawB )
+    {
+        return offsetA[0] == offsetB[0] && offsetA[1] == offsetB[1]
+               && offsetA[2] == offsetB[2] && yawA == yawB;
+    }
+
+    void getWorkingPose( vr::ETrackingUniverseOrigin universe,
+                         vr::HmdMatrix34_t& pose )
+    {
+        if ( universe == vr::TrackingUniverseStanding )
+        {
+            vr::VRChaperoneSetup()->GetWorkingStandingZeroPoseToRawTrackingPose(
+                &pose );
+        }
+        else
+        {
+            vr::VRChaperoneSetup()->GetWorkingSeatedZeroPoseToRawTrackingPose(
+                &pose );
+        }
+    }
+
+    void setWorkingPose( vr::ETrackingUniverseOrigin universe,
+                         vr::HmdMatrix34_t& pose )
+    {
+        if ( universe == vr::TrackingUniverseStanding )
+        {
+            vr::VRChaperoneSetup()->SetWorkingStandingZeroPoseToRawTrackingPose(
+                &pose );
+        }
+        else
+        {
+            vr::VRChaperoneSetup()->SetWorkingSeatedZeroPoseToRawTrackingPose(
+                &pose );
+        }
+    }
+} // namespace
+
+bool UniverseTransform::apply( vr::ETrackingUniverseOrigin universe,
+                               const double offset[3],
+                               double yaw,
+                               bool adjustBounds )
+{
+    _boundsWritten = false;
+    bool changed = applyPose( universe, offset, yaw );
+
+    // Collision bounds only exist in the standing universe.
+    if ( adjustBounds && universe == vr::TrackingUniverseStanding )
+    {
+        changed = applyBounds( offset, yaw ) || changed;
+    }
+    else
+    {
+        const double zero[3] = { 0.0, 0.0, 0.0 };
+        changed = applyBounds( zero, 0.0 ) || changed;
+    }
+    return changed;
+}
+
+void UniverseTransform::rebase() noexcept
+{
+    for ( unsigned i = 0; i < 3; i++ )
+    {
+        _offset[i] = 0.0;
+        _boundsOffset[i] = 0.0;
+    }
+    _yaw = 0.0;
+    _boundsYaw = 0.0;
+    _poseSnapshotValid = false;
+    _boundsSnapshotValid = false;
+}
+
+/*!
+Reads the working zero pose. If it isn't what we wrote last, the baseline is
+(re)captured by removing the transform the working copy was at.
+*/
+void UniverseTransform::capturePose( vr::ETrackingUniverseOrigin universe,
+                                     vr::HmdMatrix34_t& pose )
+{
+    getWorkingPose( universe, pose );
+    if ( _poseSnapshotValid && _lastUniverse == universe
+         && std::memcmp( &pose, &_lastPose, sizeof( pose ) ) == 0 )
+    {
+        return;
+    }
+
+    // Rotation is applied in raw tracking space like
+    // OverlayController::RotateUniverseCenter() does.
+    double unrotate[3][3];
+    initYawMatrix( unrotate, -_yaw );
+    for ( unsigned i = 0; i < 3; i++ )
+    {
+        for ( unsigned j = 0; j < 3; j++ )
+        {
+            _basePose[i][j] = 0.0;
+            for ( unsigned k = 0; k < 3; k++ )
+            {
+                _basePose[i][j]
+                    += unrotate[i][k] * static_cast<double>( pose.m[k][j] );
+            }
+        }
+        _basePose[i][3] = static_cast<double>( pose.m[i][3] );
+        for ( unsigned k = 0; k < 3; k++ )
+        {
+            _basePose[i][3] -= _basePose[i][k] * _offset[k];
+        }
+    }
+    // The working copy is at the current state of the new baseline.
+    _lastPose = pose;
+    _lastUniverse = universe;
+    _poseSnapshotValid = true;
+}
+
+void UniverseTransform::composePose( const double offset[3],
+                                     double yaw,
+                                     vr::HmdMatrix34_t& pose ) const
+{
+    double rotate[3][3];
+    initYawMatrix( rotate, yaw );
+    for ( unsigned i = 0; i < 3; i++ )
+    {
+        for ( unsigned j = 0; j < 3; j++ )
+        {
+            double value = 0.0;
+            for ( unsigned k = 0; k < 3; k++ )
+            {
+                value += rotate[i][k] * _basePose[k][j];
+            }
+            pose.m[i][j] = static_cast<float>( value );
+        }
+        double translation = _basePose[i][3];
+        for ( unsigned k = 0; k < 3; k++ )
+        {
+            translation += _basePose[i][k] * offset[k];
+        }
+        pose.m[i][3] = static_cast<float>( translation );
+    }
+}
+
+bool UniverseTransform::applyPose( vr::ETrackingUniverseOrigin universe,
+                                   const double offset[3],
+                                   double yaw )
+{
+    if ( _poseSnapshotValid && _lastUniverse == universe
+         && sameState( _offset, _yaw, offset, yaw ) )
+    {
+        return false;
+    }
+
+    vr::HmdMatrix34_t pose;
+    capturePose( universe, pose );
+    composePose( offset, yaw, pose );
+    setWorkingPose( universe, pose );
+
+    _lastPose = pose;
+    for ( unsigned i = 0; i < 3; i++ )
+    {
+        _offset[i] = offset[i];
+    }
+    _yaw = yaw;
+    return true;
+}
+
+vr::HmdMatrix34_t
+    UniverseTransform::poseFor( vr::ETrackingUniverseOrigin universe,
+                                const double offset[3],
+                                double yaw )
+{
+    vr::HmdMatrix34_t pose;
+    capturePose( universe, pose );
+    composePose( offset, yaw, pose );
+    return pose;
+}
+
+void UniverseTransform::stateFor( vr::ETrackingUniverseOrigin universe,
+                                  const vr::HmdMatrix34_t& pose,
+                                  double offset[3],
+                                  double& yaw )
+{
+    vr::HmdMatrix34_t working;
+    capturePose( universe, working );
+
+    // pose = Ry( yaw ) * base, the base rotation is orthonormal.
+    double rotate[3][3];
+    for ( unsigned i = 0; i < 3; i++ )
+    {
+        for ( unsigned j = 0; j < 3; j++ )
+        {
+            rotate[i][j] = 0.0;
+            for ( unsigned k = 0; k < 3; k++ )
+            {
+                rotate[i][j]
+                    += static_cast<double>( pose.m[i][k] ) * _basePose[j][k];
+            }
+        }
+    }
+    yaw = std::atan2( rotate[0][2], rotate[0][0] );
+
+    // translation = base translation + base rotation * offset
+    for ( unsigned i = 0; i < 3; i++ )
+    {
+        offset[i] = 0.0;
+        for ( unsigned k = 0; k < 3; k++ )
+        {
+            offset[i] += _basePose[k][i]
+                         * ( static_cast<double>( pose.m[k][3] )
+                             - _basePose[k][3] );
+        }
+    }
+}
+
+bool UniverseTransform::applyBounds( const double offset[3], double yaw )
+{
+    if ( sameState( _boundsOffset, _boundsYaw, offset, yaw ) )
+    {
+        return false;
+    }
+
+    uint32_t quadsCount = 0;
+    vr::VRChaperoneSetup()->GetWorkingCollisionBoundsInfo( nullptr,
+                                                           &quadsCount );
+    _bounds.resize( quadsCount );
+    if ( quadsCount > 0 )
+    {
+        vr::VRChaperoneSetup()->GetWorkingCollisionBoundsInfo( _bounds.data(),
+                                                               &quadsCount );
+    }
+
+    if ( !_boundsSnapshotValid || _bounds.size() != _lastBounds.size()
+         || std::memcmp( _bounds.data(),
+                         _lastBounds.data(),
+                         _bounds.size() * sizeof( vr::HmdQuad_t ) )
+                != 0 )
+    {
+        // Bounds were changed by someone else. Move them back to the
+        // untransformed playspace: B0 = Ry( yaw ) * B + offset
+        const double c = std::cos( _boundsYaw );
+        const double s = std::sin( _boundsYaw );
+        _baseBounds.resize( _bounds.size() * 12 );
+        double* base = _baseBounds.data();
+        for ( const auto& quad : _bounds )
+        {
+            for ( const auto& corner : quad.vCorners )
+            {
+                const double x = static_cast<double>( corner.v[0] );
+                const double y = static_cast<double>( corner.v[1] );
+                const double z = static_cast<double>( corner.v[2] );
+                base[0] = c * x + s * z + _boundsOffset[0];
+                // Lower corners have to stay on the ground, otherwise SteamVR
+                // resets the y coordinates of all corners.
+                base[1] = ( corner.v[1] != 0.0f ) ? y + _boundsOffset[1] : 0.0;
+                base[2] = -s * x + c * z + _boundsOffset[2];
+                base += 3;
+            }
+        }
+    }
+
+    if ( _bounds.empty() )
+    {
+        _lastBounds.clear();
+        _boundsSnapshotValid = true;
+        for ( unsigned i = 0; i < 3; i++ )
+        {
+            _boundsOffset[i] = offset[i];
+        }
+        _boundsYaw = yaw;
+        return false;
+    }
+
+    // B = Ry( -yaw ) * ( B0 - offset )
+    const double c = std::cos( yaw );
+    const double s = std::sin( yaw );
+    const double* base = _baseBounds.data();
+    for ( auto& quad : _bounds )
+    {
+        for ( auto& corner : quad.vCorners )
+        {
+            const double dx = base[0] - offset[0];
+            const double dz = base[2] - offset[2];
+            corner.v[0] = static_cast<float>( c * dx - s * dz );
+            corner.v[1] = ( base[1] != 0.0 )
+                              ? static_cast<float>( base[1] - offset[1] )
+                              : 0.0f;
+            corner.v[2] = static_cast<float>( s * dx + c * dz );
+            base += 3;
+        }
+    }
+    vr::VRChaperoneSetup()->SetWorkingCollisionBoundsInfo(
+        _bounds.data(), static_cast<uint32_t>( _bounds.size() ) );
+
+    _lastBounds = _bounds;
+    _boundsSnapshotValid = true;
+    _boundsWritten = true;
+    for ( unsigned i = 0; i < 3; i++ )
+    {
+        _boundsOffset[i] = offset[i];
+    }
+    _boundsYaw = yaw;
+    return true;
+}
+
+} // end namespace utils
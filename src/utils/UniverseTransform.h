@@ -0,0 +1,98 @@
+#pragma once
+
+#include <vector>
+#include <openvr.h>
+
+namespace utils
+{
+/*!
+Canonical double precision state of the playspace move.
+
+Instead of adding small float deltas to the live universe center and collision
+bounds every frame, the working copy is derived from a baseline that
+represents the untransformed playspace. The offset is kept in un-rotated
+coordinates and the yaw in radians, both as doubles, so a long drag session
+can't drift away from the values shown in the UI.
+
+Anything else that modifies the working copy (floor fix, chaperone profiles,
+SteamVR room setup) is detected by comparing against the values that were
+last written, and is folded into the baseline before the next write.
+
+The caller is responsible for RevertWorkingCopy() and CommitWorkingCopy().
+*/
+class UniverseTransform
+{
+private:
+    // State that the current working copy corresponds to.
+    double _offset[3] = { 0.0, 0.0, 0.0 };
+    double _yaw = 0.0;
+    // State that the current collision bounds correspond to. Stays at zero
+    // while bounds adjustment is disabled.
+    double _boundsOffset[3] = { 0.0, 0.0, 0.0 };
+    double _boundsYaw = 0.0;
+
+    bool _poseSnapshotValid = false;
+    vr::ETrackingUniverseOrigin _lastUniverse = vr::TrackingUniverseStanding;
+    vr::HmdMatrix34_t _lastPose = {};
+    double _basePose[3][4] = {};
+
+    bool _boundsSnapshotValid = false;
+    std::vector<vr::HmdQuad_t> _lastBounds;
+    std::vector<vr::HmdQuad_t> _bounds;
+    // quadCount * 4 corners * 3 coordinates
+    std::vector<double> _baseBounds;
+    bool _boundsWritten = false;
+
+    void capturePose( vr::ETrackingUniverseOrigin universe,
+                      vr::HmdMatrix34_t& pose );
+    void composePose( const double offset[3],
+                      double yaw,
+                      vr::HmdMatrix34_t& pose ) const;
+    bool applyPose( vr::ETrackingUniverseOrigin universe,
+                    const double offset[3],
+                    double yaw );
+    bool applyBounds( const double offset[3], double yaw );
+
+public:
+    /*!
+    Writes the universe center (and the collision bounds if adjustBounds is
+    set) for the given state into the working copy.
+    Returns true if anything was written and a commit is needed.
+    */
+    bool apply( vr::ETrackingUniverseOrigin universe,
+                const double offset[3],
+                double yaw,
+                bool adjustBounds );
+
+    /*!
+    Declares the current working copy as the untransformed playspace. Used
+    when the offsets are zeroed without moving anything.
+    */
+    void rebase() noexcept;
+
+    /*!
+    Absolute zero pose the working copy gets for the given state. Unlike the
+    state it stays valid across rebase() and outside changes, for anything
+    that is saved for later.
+    */
+    vr::HmdMatrix34_t poseFor( vr::ETrackingUniverseOrigin universe,
+                               const double offset[3],
+                               double yaw );
+    /*!
+    Inverse of poseFor(): the state that moves the current baseline to the
+    given zero pose. Only the yaw part of a rotation can be reached.
+    */
+    void stateFor( vr::ETrackingUniverseOrigin universe,
+                   const vr::HmdMatrix34_t& pose,
+                   double offset[3],
+                   double& yaw );
+
+    // Collision bounds written by the last apply(), nullptr if they weren't
+    // touched.
+    const std::vector<vr::HmdQuad_t>* writtenBounds() const noexcept
+    {
+        return _boundsWritten ? &_lastBounds : nullptr;
+    }
+};
+
+} // end namespace utils